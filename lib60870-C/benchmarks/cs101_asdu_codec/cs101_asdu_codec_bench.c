@@ -0,0 +1,124 @@
+/*
+ * Benchmark for the ASDU encoder and decoder
+ *
+ * Encodes and decodes ASDUs with short floating point values with CP56Time2a time tag (M_ME_TF_1)
+ * and reports the average time per ASDU.
+ *
+ * To compare the fixed application layer profile with the runtime parameters build the benchmark
+ * twice (cmake option WITH_FIXED_AL_PROFILE=ON/OFF) and compare the results.
+ *
+ * Usage: cs101_asdu_codec_bench [number of iterations]
+ */
+
+#include "lib60870_config.h"
+#include "iec60870_common.h"
+#include "cs101_information_objects.h"
+#include "hal_time.h"
+#include "buffer_frame.h"
+#include "apl_types_internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef CONFIG_CS101_FIXED_AL_PROFILE
+#define CONFIG_CS101_FIXED_AL_PROFILE 0
+#endif
+
+#define ELEMENTS_PER_ASDU 20
+
+static struct sCS101_AppLayerParameters alParameters = {
+    /* .sizeOfTypeId =  */ 1,
+    /* .sizeOfVSQ = */ 1,
+    /* .sizeOfCOT = */ 2,
+    /* .originatorAddress = */ 0,
+    /* .sizeOfCA = */ 2,
+    /* .sizeOfIOA = */ 3,
+    /* .maxSizeOfASDU = */ 249
+};
+
+int
+main(int argc, char** argv)
+{
+    int iterations = 1000000;
+
+    if (argc > 1)
+        iterations = atoi(argv[1]);
+
+    if (iterations < 1)
+        iterations = 1;
+
+    InformationObject ios[ELEMENTS_PER_ASDU];
+    struct sCP56Time2a timestamp;
+    int i;
+
+    CP56Time2a_createFromMsTimestamp(&timestamp, Hal_getTimeInMs());
+
+    for (i = 0; i < ELEMENTS_PER_ASDU; i++)
+        ios[i] = (InformationObject) MeasuredValueShortWithCP56Time2a_create(NULL, 4000 + i, 1.5f * i, IEC60870_QUALITY_GOOD, &timestamp);
+
+    sCS101_StaticASDU staticAsdu;
+    uint8_t buffer[256];
+
+    /* encoding */
+    uint64_t start = Hal_getTimeInNs();
+
+    int n;
+
+    for (n = 0; n < iterations; n++) {
+        CS101_ASDU asdu = CS101_ASDU_initializeStatic(&staticAsdu, &alParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        for (i = 0; i < ELEMENTS_PER_ASDU; i++)
+            CS101_ASDU_addInformationObject(asdu, ios[i]);
+    }
+
+    uint64_t encodeTime = Hal_getTimeInNs() - start;
+
+    /* message for the decoding test */
+    CS101_ASDU asdu = CS101_ASDU_initializeStatic(&staticAsdu, &alParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    for (i = 0; i < ELEMENTS_PER_ASDU; i++)
+        CS101_ASDU_addInformationObject(asdu, ios[i]);
+
+    struct sBufferFrame bufferFrame;
+    Frame frame = BufferFrame_initialize(&bufferFrame, buffer, 0);
+
+    CS101_ASDU_encode(asdu, frame);
+
+    int msgSize = Frame_getMsgSize(frame);
+
+    /* decoding */
+    CS101_ASDUIterator iterator = CS101_ASDUIterator_create();
+    sCS101_ASDUView view;
+
+    uint64_t checksum = 0;
+
+    start = Hal_getTimeInNs();
+
+    for (n = 0; n < iterations; n++) {
+        CS101_ASDU received = CS101_ASDU_initializeView(&view, &alParameters, buffer, msgSize);
+
+        checksum += CS101_ASDU_getCA(received) + CS101_ASDU_getCOT(received);
+
+        CS101_ASDUIterator_start(iterator, received);
+
+        InformationObject io;
+
+        while ((io = CS101_ASDUIterator_next(iterator)) != NULL)
+            checksum += InformationObject_getObjectAddress(io);
+    }
+
+    uint64_t decodeTime = Hal_getTimeInNs() - start;
+
+    printf("application layer profile: %s\n", (CONFIG_CS101_FIXED_AL_PROFILE == 1) ? "fixed (COT = 2, CA = 2, IOA = 3)" : "runtime parameters");
+    printf("ASDUs: %i (%i x M_ME_TF_1, %i bytes)\n", iterations, ELEMENTS_PER_ASDU, msgSize);
+    printf("encode: %.1f ns/ASDU\n", (double) encodeTime / (double) iterations);
+    printf("decode: %.1f ns/ASDU\n", (double) decodeTime / (double) iterations);
+    printf("(checksum: %llu)\n", (unsigned long long) checksum);
+
+    CS101_ASDUIterator_destroy(iterator);
+
+    for (i = 0; i < ELEMENTS_PER_ASDU; i++)
+        InformationObject_destroy(ios[i]);
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Benchmark for the command send path of CS104_Connection
+ *
+ * Sends single commands (C_SC_NA_1) from one or more client connections to a local CS104 slave
+ * and reports the number of commands per second and connection and the average time of a
+ * CS104_Connection_sendProcessCommandEx call.
+ *
+ * Usage: cs104_client_commands_bench [number of connections] [duration in s]
+ */
+
+#include "cs104_slave.h"
+#include "cs104_connection.h"
+#include "hal_time.h"
+#include "hal_thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TCP_PORT 20105
+#define MAX_CONNECTIONS 64
+
+static volatile int receivedCommands = 0;
+
+static bool
+slaveAsduHandler(void* parameter, IMasterConnection connection, CS101_ASDU asdu)
+{
+    (void) parameter;
+    (void) connection;
+
+    if (CS101_ASDU_getTypeID(asdu) == C_SC_NA_1)
+        receivedCommands++;
+
+    /* command is accepted without response to measure only the client send path */
+    return true;
+}
+
+int
+main(int argc, char** argv)
+{
+    int numberOfConnections = 1;
+    int duration = 5;
+
+    if (argc > 1)
+        numberOfConnections = atoi(argv[1]);
+
+    if (argc > 2)
+        duration = atoi(argv[2]);
+
+    if ((numberOfConnections < 1) || (numberOfConnections > MAX_CONNECTIONS))
+        numberOfConnections = 1;
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+
+    CS104_Slave_setLocalPort(slave, TCP_PORT);
+    CS104_Slave_setServerMode(slave, CS104_MODE_CONNECTION_IS_REDUNDANCY_GROUP);
+    CS104_Slave_setMaxOpenConnections(slave, numberOfConnections);
+    CS104_Slave_setASDUHandler(slave, slaveAsduHandler, NULL);
+    CS104_Slave_start(slave);
+
+    if (CS104_Slave_isRunning(slave) == false) {
+        printf("Failed to start slave\n");
+        CS104_Slave_destroy(slave);
+        return 1;
+    }
+
+    CS104_Connection cons[MAX_CONNECTIONS];
+    uint64_t sentCommands[MAX_CONNECTIONS];
+
+    int i;
+
+    for (i = 0; i < numberOfConnections; i++) {
+        cons[i] = CS104_Connection_create("127.0.0.1", TCP_PORT);
+        sentCommands[i] = 0;
+
+        if (CS104_Connection_connect(cons[i]) == false) {
+            printf("Failed to connect\n");
+            return 1;
+        }
+
+        CS104_Connection_sendStartDT(cons[i]);
+    }
+
+    Thread_sleep(200);
+
+    /* command object is reused for all calls to exclude its allocation from the measurement */
+    SingleCommand command = SingleCommand_create(NULL, 5000, true, false, 0);
+
+    uint64_t sendTime = 0;
+    uint64_t sendCalls = 0;
+    uint64_t start = Hal_getTimeInMs();
+    uint64_t end = start + (duration * 1000);
+    uint64_t currentTime = start;
+
+    while (currentTime < end) {
+        bool sent = false;
+
+        for (i = 0; i < numberOfConnections; i++) {
+
+            uint64_t callStart = Hal_getTimeInNs();
+
+            if (CS104_Connection_sendProcessCommandEx(cons[i], CS101_COT_ACTIVATION, 1, (InformationObject) command)) {
+                sendTime += Hal_getTimeInNs() - callStart;
+                sendCalls++;
+                sentCommands[i]++;
+                sent = true;
+            }
+        }
+
+        /* k-window of all connections is full -> wait for the acknowledgements */
+        if (sent == false)
+            Thread_sleep(0);
+
+        currentTime = Hal_getTimeInMs();
+    }
+
+    uint64_t elapsed = Hal_getTimeInMs() - start;
+
+    uint64_t totalCommands = 0;
+
+    for (i = 0; i < numberOfConnections; i++)
+        totalCommands += sentCommands[i];
+
+    Thread_sleep(500);
+
+    printf("connections: %i\n", numberOfConnections);
+    printf("commands sent: %llu (received by slave: %i)\n", (unsigned long long) totalCommands, receivedCommands);
+    printf("commands/s per connection: %.0f\n", (double) totalCommands * 1000.0 / (double) elapsed / numberOfConnections);
+    printf("average send call: %.0f ns\n", sendCalls ? ((double) sendTime / (double) sendCalls) : 0.0);
+
+    SingleCommand_destroy(command);
+
+    for (i = 0; i < numberOfConnections; i++)
+        CS104_Connection_destroy(cons[i]);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    return 0;
+}
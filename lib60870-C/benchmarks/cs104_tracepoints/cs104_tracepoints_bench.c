@@ -0,0 +1,168 @@
+/*
+ * Benchmark for the static tracepoints (CMake option WITH_TRACEPOINTS)
+ *
+ * 1. measures the cost of a probe site in a tight loop (compared to the same loop without probe)
+ * 2. measures the event throughput from a CS104 slave to a CS104 client over the loopback interface
+ *
+ * Run the benchmark with a library built with and without WITH_TRACEPOINTS (and
+ * optionally with a tracer attached) and compare the results.
+ */
+
+#include "cs104_slave.h"
+#include "cs104_connection.h"
+#include "hal_time.h"
+#include "hal_thread.h"
+#include "lib60870_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOOP_COUNT 100000000
+#define EVENT_ROUNDS 5
+#define EVENTS_PER_ROUND 1000
+#define TCP_PORT 20104
+
+static volatile uint32_t sink = 0;
+
+static uint64_t
+loopWithoutProbe(int count)
+{
+    uint64_t start = Hal_getTimeInNs();
+
+    int i;
+
+    for (i = 0; i < count; i++) {
+        sink = sink + (uint32_t) i;
+    }
+
+    return Hal_getTimeInNs() - start;
+}
+
+static uint64_t
+loopWithProbe(int count)
+{
+    uint64_t start = Hal_getTimeInNs();
+
+    int i;
+
+    for (i = 0; i < count; i++) {
+        sink = sink + (uint32_t) i;
+        LIB60870_TRACE4(cs104_bench_probe, i, sink, count, 0);
+    }
+
+    return Hal_getTimeInNs() - start;
+}
+
+static volatile int receivedEvents = 0;
+
+static bool
+asduReceivedHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    (void) parameter;
+    (void) address;
+
+    if (CS101_ASDU_getCOT(asdu) == CS101_COT_SPONTANEOUS)
+        receivedEvents++;
+
+    return true;
+}
+
+static void
+enqueueEvents(CS104_Slave slave, int count, int offset)
+{
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slave);
+
+    int i;
+
+    for (i = 0; i < count; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100 + (i % 1000), (offset + i) % 30000, IEC60870_QUALITY_GOOD);
+
+        CS101_ASDU_addInformationObject(asdu, io);
+
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, asdu);
+
+        CS101_ASDU_destroy(asdu);
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    (void) argc;
+    (void) argv;
+
+    printf("tracepoints compiled in: %s\n", (CONFIG_LIB60870_TRACEPOINTS == 1) ? "yes" : "no");
+
+    /* 1. probe site cost */
+    loopWithoutProbe(LOOP_COUNT / 10); /* warm up */
+
+    uint64_t timeWithout = loopWithoutProbe(LOOP_COUNT);
+    uint64_t timeWith = loopWithProbe(LOOP_COUNT);
+
+    printf("loop without probe: %.3f ns/iteration\n", (double) timeWithout / LOOP_COUNT);
+    printf("loop with probe:    %.3f ns/iteration\n", (double) timeWith / LOOP_COUNT);
+
+    /* 2. slave -> client event throughput */
+    CS104_Slave slave = CS104_Slave_create(EVENTS_PER_ROUND * 2, 100);
+
+    CS104_Slave_setLocalPort(slave, TCP_PORT);
+    CS104_Slave_setServerMode(slave, CS104_MODE_SINGLE_REDUNDANCY_GROUP);
+    CS104_Slave_start(slave);
+
+    if (CS104_Slave_isRunning(slave) == false) {
+        printf("Failed to start slave\n");
+        CS104_Slave_destroy(slave);
+        return 1;
+    }
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", TCP_PORT);
+
+    CS104_Connection_setASDUReceivedHandler(con, asduReceivedHandler, NULL);
+
+    if (CS104_Connection_connect(con) == false) {
+        printf("Failed to connect\n");
+        CS104_Connection_destroy(con);
+        CS104_Slave_destroy(slave);
+        return 1;
+    }
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    uint64_t start = Hal_getTimeInNs();
+
+    int round;
+
+    for (round = 0; round < EVENT_ROUNDS; round++) {
+
+        enqueueEvents(slave, EVENTS_PER_ROUND, round * EVENTS_PER_ROUND);
+
+        uint64_t timeout = Hal_getTimeInMs() + 30000;
+
+        while (receivedEvents < (round + 1) * EVENTS_PER_ROUND) {
+            if (Hal_getTimeInMs() > timeout) {
+                printf("Timeout - received %i events\n", receivedEvents);
+                break;
+            }
+
+            Thread_sleep(1);
+        }
+    }
+
+    uint64_t duration = Hal_getTimeInNs() - start;
+
+    printf("events: %i in %.1f ms (%.0f events/s)\n", receivedEvents, (double) duration / 1000000.0,
+            (double) receivedEvents * 1000000000.0 / (double) duration);
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    return 0;
+}
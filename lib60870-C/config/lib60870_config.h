@@ -9,6 +9,19 @@
 /* print debugging information with printf if set to 1 */
 #define CONFIG_DEBUG_OUTPUT 0
 
+/**
+ * When set to 1 (and CONFIG_DEBUG_OUTPUT is 1) debug messages are not printed by the calling thread.
+ * Instead a compact binary record (timestamp, format string, arguments) is stored in a lock-free
+ * ring buffer. The records are converted to text by Lib60870_processLog.
+ */
+#define CONFIG_DEBUG_OUTPUT_BINARY_LOG 0
+
+/**
+ * Number of records in the binary log ring buffer (has to be a power of two). Each record
+ * requires 128 bytes of memory.
+ */
+#define CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE 1024
+
 /**
  * Define the maximum slave message queue size (for CS 101)
  *
@@ -77,5 +90,45 @@
 /* number of not missing keepalive responses until socket is considered dead */
 #define CONFIG_TCP_KEEPALIVE_CNT 2
 
+/**
+ * Compile the CS104 slave with support for enqueue-to-acknowledge latency histograms.
+ *
+ * The histograms have to be activated at runtime with CS104_Slave_setLatencyStatisticsEnabled.
+ * Each client connection requires about 6 kByte of memory for the histograms when activated.
+ * Each entry in the event queue requires 8 additional bytes for the enqueue time stamp.
+ *
+ * Can also be activated with the cmake option WITH_LATENCY_STATISTICS.
+ */
+#ifndef CONFIG_CS104_SLAVE_LATENCY_STATISTICS
+#define CONFIG_CS104_SLAVE_LATENCY_STATISTICS 0
+#endif
+
+/**
+ * Maximum number of socket events that are handled by a single iteration of a
+ * CS104_ConnectionManager (client connections handled by a single thread).
+ */
+#define CONFIG_CS104_CONNECTION_MANAGER_MAX_EVENTS 256
+
+/**
+ * Default maximum number of outstanding commands of a client connection (see CS104_Connection_sendCommand).
+ * Each command requires about 100 bytes of memory. The memory is allocated when the first command is sent.
+ */
+#define CONFIG_CS104_MAX_OUTSTANDING_COMMANDS 64
+
+/**
+ * Compile the ASDU and information object codec for the standard IEC 104 application layer
+ * profile (size of COT = 2, size of CA = 2, size of IOA = 3) instead of using the sizes of the
+ * CS101_AppLayerParameters at runtime.
+ *
+ * NOTE: When set to 1 all application layer parameters have to use this profile (this is the
+ * default for CS104 and CS101). Parameters with other field sizes are not supported! They are
+ * replaced by the profile sizes when the parameters are set or the slave is started (a warning
+ * is logged).
+ *
+ * Can also be activated with the cmake option WITH_FIXED_AL_PROFILE.
+ */
+#ifndef CONFIG_CS101_FIXED_AL_PROFILE
+#define CONFIG_CS101_FIXED_AL_PROFILE 0
+#endif
 
 #endif /* CONFIG_LIB60870_CONFIG_H_ */
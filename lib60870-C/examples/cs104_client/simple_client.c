@@ -43,6 +43,9 @@ connectionHandler (void* parameter, CS104_Connection connection, CS104_Connectio
     case CS104_CONNECTION_STOPDT_CON_RECEIVED:
         printf("Received STOPDT_CON");
         break;
+    case CS104_CONNECTION_SEND_QUEUE_AVAILABLE:
+        printf("Send queue available");
+        break;
     }
     printf(" ** \n");
 }
@@ -53,6 +53,11 @@ connectionHandler (void* parameter, CS104_Connection connection, CS104_Connectio
         break;
     case CS104_CONNECTION_FAILED:
         printf("Connection failed\n");
+        break;
+    case CS104_CONNECTION_SEND_QUEUE_AVAILABLE:
+        /* not a change of the connection state */
+        printf("Send queue available\n");
+        return;
     }
 
     Semaphore_wait(lastEventLock);
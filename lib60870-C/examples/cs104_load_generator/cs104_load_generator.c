@@ -0,0 +1,802 @@
+/*
+ * Load generator for CS 104 servers
+ *
+ * Opens many client connections to a server and sends general interrogations, counter
+ * interrogations, read commands and process commands (single commands) with configurable
+ * rates. The responses are checked and the throughput, the errors and the latencies (time
+ * until the final response) are reported for each request type.
+ *
+ * The connections are distributed over a small number of worker threads. Each worker
+ * handles its connections with a connection manager in non-threaded mode.
+ *
+ * Requests are sent with fixed rates (open loop). When a request is due and the previous
+ * request with the same type and IOA is still outstanding the request is skipped. An
+ * increasing number of skipped requests shows that the server cannot keep up.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+
+#include "cs104_connection.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+
+typedef enum {
+    REQUEST_GI = 0,
+    REQUEST_CI = 1,
+    REQUEST_READ = 2,
+    REQUEST_COMMAND = 3,
+    NUMBER_OF_REQUEST_TYPES = 4
+} RequestType;
+
+static const char* requestTypeNames[] = {"GI", "CI", "read", "command"};
+
+typedef enum {
+    RESULT_OK,
+    RESULT_NEGATIVE, /* negative confirmation or unexpected response */
+    RESULT_TIMEOUT,
+    RESULT_FAILED /* request could not be sent or connection closed before the response */
+} RequestResult;
+
+/*
+ * Latency histogram with about 3% resolution. Values (in us) below 64 have their own bucket.
+ * Larger values are stored in 32 buckets for each power of two.
+ */
+#define HISTOGRAM_LINEAR_BUCKETS 64
+#define HISTOGRAM_SUB_BUCKETS 32
+#define HISTOGRAM_MAX_EXPONENT 39
+#define HISTOGRAM_BUCKETS (HISTOGRAM_LINEAR_BUCKETS + (HISTOGRAM_MAX_EXPONENT - 5) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t sent;
+    uint64_t completed;
+    uint64_t negative;
+    uint64_t timeouts;
+    uint64_t failed;
+    uint64_t skipped;
+    uint64_t latencyMax;
+    uint64_t latencySum;
+    uint32_t histogram[HISTOGRAM_BUCKETS];
+} RequestStatistics;
+
+typedef struct {
+    CS104_CommandHandle handle; /* not used for read commands */
+    uint64_t sendTime; /* in us (0 = no outstanding request) */
+} RequestSlot;
+
+typedef struct sWorker* Worker;
+
+typedef struct {
+    Worker worker;
+    CS104_Connection connection;
+    bool active;
+    /* one slot per IOA (GI and CI have only one slot) */
+    RequestSlot* slots[NUMBER_OF_REQUEST_TYPES];
+    int nextSlot[NUMBER_OF_REQUEST_TYPES];
+    uint64_t nextRequestTime[NUMBER_OF_REQUEST_TYPES];
+} ClientConnection;
+
+struct sWorker {
+    Thread thread;
+    Semaphore lock; /* protects the statistics and counters (read by the main thread) */
+    bool running;
+    CS104_ConnectionManager manager;
+    ClientConnection* connections;
+    int numberOfConnections;
+    int activeConnections;
+    uint64_t receivedASDUs;
+    RequestStatistics stats[NUMBER_OF_REQUEST_TYPES]; /* since the last report */
+};
+
+typedef struct {
+    const char* hostname;
+    int port;
+    int numberOfConnections;
+    int numberOfWorkers;
+    int ca;
+    double rates[NUMBER_OF_REQUEST_TYPES]; /* requests per second and connection */
+    int readIOA;
+    int commandIOA;
+    int numberOfIOAs; /* number of IOAs for read commands and process commands */
+    bool selectBeforeOperate;
+    int timeout; /* in ms */
+    int duration; /* in s (0 = until Ctrl-C) */
+    int reportInterval; /* in s */
+} LoadConfiguration;
+
+static LoadConfiguration config;
+
+/* command objects (read only - shared by all workers) */
+static InformationObject giCommand = NULL;
+static InformationObject ciCommand = NULL;
+static InformationObject* processCommands = NULL;
+
+static bool running = true;
+
+static void
+sigint_handler(int signalId)
+{
+    running = false;
+}
+
+static uint64_t
+getTimeInUs(void)
+{
+    return Hal_getTimeInNs() / 1000;
+}
+
+static int
+getHistogramBucket(uint64_t value)
+{
+    int exponent = 0;
+
+    if (value < HISTOGRAM_LINEAR_BUCKETS)
+        return (int) value;
+
+    while ((value >> (exponent + 1)) != 0)
+        exponent++;
+
+    if (exponent > HISTOGRAM_MAX_EXPONENT)
+        return HISTOGRAM_BUCKETS - 1;
+
+    int subBucket = (int) ((value >> (exponent - 5)) & (HISTOGRAM_SUB_BUCKETS - 1));
+
+    return HISTOGRAM_LINEAR_BUCKETS + (exponent - 6) * HISTOGRAM_SUB_BUCKETS + subBucket;
+}
+
+/* get the mid value of a histogram bucket */
+static uint64_t
+getHistogramValue(int bucket)
+{
+    if (bucket < HISTOGRAM_LINEAR_BUCKETS)
+        return (uint64_t) bucket;
+
+    int exponent = ((bucket - HISTOGRAM_LINEAR_BUCKETS) / HISTOGRAM_SUB_BUCKETS) + 6;
+    int subBucket = (bucket - HISTOGRAM_LINEAR_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+
+    uint64_t lowerBound = (uint64_t) (HISTOGRAM_SUB_BUCKETS + subBucket) << (exponent - 5);
+
+    return lowerBound + ((uint64_t) 1 << (exponent - 6));
+}
+
+static uint64_t
+getPercentile(RequestStatistics* stats, double percentile)
+{
+    uint64_t count = stats->completed + stats->negative;
+    uint64_t rank = (uint64_t) ((double) count * percentile / 100.0);
+    uint64_t sum = 0;
+    int i;
+
+    if (count == 0)
+        return 0;
+
+    if (rank >= count)
+        rank = count - 1;
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        sum += stats->histogram[i];
+
+        if (sum > rank)
+            return getHistogramValue(i);
+    }
+
+    return stats->latencyMax;
+}
+
+static void
+addStatistics(RequestStatistics* sum, RequestStatistics* stats)
+{
+    int i;
+
+    sum->sent += stats->sent;
+    sum->completed += stats->completed;
+    sum->negative += stats->negative;
+    sum->timeouts += stats->timeouts;
+    sum->failed += stats->failed;
+    sum->skipped += stats->skipped;
+    sum->latencySum += stats->latencySum;
+
+    if (stats->latencyMax > sum->latencyMax)
+        sum->latencyMax = stats->latencyMax;
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++)
+        sum->histogram[i] += stats->histogram[i];
+}
+
+static int
+getNumberOfSlots(RequestType type)
+{
+    if ((type == REQUEST_READ) || (type == REQUEST_COMMAND))
+        return config.numberOfIOAs;
+    else
+        return 1;
+}
+
+/* has to be called by the worker thread */
+static void
+completeRequest(ClientConnection* con, RequestType type, RequestSlot* slot, RequestResult result)
+{
+    Worker worker = con->worker;
+    RequestStatistics* stats = &(worker->stats[type]);
+
+    Semaphore_wait(worker->lock);
+
+    if ((result == RESULT_OK) || (result == RESULT_NEGATIVE)) {
+        uint64_t now = getTimeInUs();
+        uint64_t latency = (now > slot->sendTime) ? (now - slot->sendTime) : 0;
+
+        if (result == RESULT_OK)
+            stats->completed++;
+        else
+            stats->negative++;
+
+        stats->histogram[getHistogramBucket(latency)]++;
+        stats->latencySum += latency;
+
+        if (latency > stats->latencyMax)
+            stats->latencyMax = latency;
+    }
+    else if (result == RESULT_TIMEOUT)
+        stats->timeouts++;
+    else
+        stats->failed++;
+
+    Semaphore_post(worker->lock);
+
+    slot->handle = 0;
+    slot->sendTime = 0;
+}
+
+static void
+commandHandler(void* parameter, CS104_Connection connection, CS104_CommandHandle handle,
+        CS104_CommandEvent event, CS101_ASDU asdu)
+{
+    ClientConnection* con = (ClientConnection*) parameter;
+    int type;
+
+    for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++) {
+        int i;
+
+        if (type == REQUEST_READ)
+            continue;
+
+        for (i = 0; i < getNumberOfSlots((RequestType) type); i++) {
+            RequestSlot* slot = &(con->slots[type][i]);
+
+            if (slot->handle != handle)
+                continue;
+
+            switch (event) {
+
+            case CS104_COMMAND_ACT_CON:
+                /* GI and CI are completed by ACT_TERM */
+                if (type == REQUEST_COMMAND)
+                    completeRequest(con, (RequestType) type, slot, RESULT_OK);
+                break;
+
+            case CS104_COMMAND_ACT_TERM:
+                completeRequest(con, (RequestType) type, slot, RESULT_OK);
+                break;
+
+            case CS104_COMMAND_NEGATIVE_CON:
+                completeRequest(con, (RequestType) type, slot, RESULT_NEGATIVE);
+                break;
+
+            case CS104_COMMAND_TIMEOUT:
+                completeRequest(con, (RequestType) type, slot, RESULT_TIMEOUT);
+                break;
+
+            default:
+                completeRequest(con, (RequestType) type, slot, RESULT_FAILED);
+                break;
+            }
+
+            return;
+        }
+    }
+}
+
+static bool
+asduReceivedHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    ClientConnection* con = (ClientConnection*) parameter;
+    CS101_CauseOfTransmission cot = CS101_ASDU_getCOT(asdu);
+
+    Semaphore_wait(con->worker->lock);
+    con->worker->receivedASDUs++;
+    Semaphore_post(con->worker->lock);
+
+    /* response to a read command: the requested data point or a negative C_RD_NA_1 */
+    if ((cot == CS101_COT_REQUEST) || (CS101_ASDU_getTypeID(asdu) == C_RD_NA_1)) {
+        int index = CS101_ASDU_getIOAAt(asdu, 0) - config.readIOA;
+
+        if ((CS101_ASDU_getCA(asdu) == config.ca) && (index >= 0) && (index < config.numberOfIOAs)) {
+            RequestSlot* slot = &(con->slots[REQUEST_READ][index]);
+
+            if (slot->sendTime != 0) {
+                bool positive = (cot == CS101_COT_REQUEST) && (CS101_ASDU_isNegative(asdu) == false) &&
+                        (CS101_ASDU_getTypeID(asdu) != C_RD_NA_1);
+
+                completeRequest(con, REQUEST_READ, slot, positive ? RESULT_OK : RESULT_NEGATIVE);
+            }
+        }
+    }
+
+    return true;
+}
+
+/* spread the requests of the connections over the request intervals */
+static void
+scheduleFirstRequests(ClientConnection* con)
+{
+    uint64_t now = getTimeInUs();
+    int type;
+
+    for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++) {
+        if (config.rates[type] > 0)
+            con->nextRequestTime[type] = now + (uint64_t) (rand() % (int) (1000000.0 / config.rates[type] + 1));
+    }
+}
+
+static void
+connectionHandler(void* parameter, CS104_Connection connection, CS104_ConnectionEvent event)
+{
+    ClientConnection* con = (ClientConnection*) parameter;
+    int i;
+
+    switch (event) {
+
+    case CS104_CONNECTION_OPENED:
+        CS104_Connection_sendStartDT(connection);
+        break;
+
+    case CS104_CONNECTION_STARTDT_CON_RECEIVED:
+        if (con->active == false) {
+            con->active = true;
+
+            scheduleFirstRequests(con);
+
+            Semaphore_wait(con->worker->lock);
+            con->worker->activeConnections++;
+            Semaphore_post(con->worker->lock);
+        }
+        break;
+
+    case CS104_CONNECTION_CLOSED:
+    case CS104_CONNECTION_FAILED:
+        if (con->active) {
+            con->active = false;
+
+            Semaphore_wait(con->worker->lock);
+            con->worker->activeConnections--;
+            Semaphore_post(con->worker->lock);
+        }
+
+        /* outstanding commands are reported by the command handler */
+        for (i = 0; i < config.numberOfIOAs; i++) {
+            if (con->slots[REQUEST_READ][i].sendTime != 0)
+                completeRequest(con, REQUEST_READ, &(con->slots[REQUEST_READ][i]), RESULT_FAILED);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void
+sendRequest(ClientConnection* con, RequestType type, uint64_t now)
+{
+    Worker worker = con->worker;
+    int index = con->nextSlot[type];
+    RequestSlot* slot = &(con->slots[type][index]);
+    bool sent = false;
+
+    con->nextSlot[type] = (index + 1) % getNumberOfSlots(type);
+
+    if (slot->sendTime != 0) {
+        Semaphore_wait(worker->lock);
+        worker->stats[type].skipped++;
+        Semaphore_post(worker->lock);
+
+        return;
+    }
+
+    slot->sendTime = now;
+
+    switch (type) {
+
+    case REQUEST_GI:
+        slot->handle = CS104_Connection_sendCommand(con->connection, config.ca, giCommand, CS104_COMMAND_DIRECT,
+                true, commandHandler, con);
+        sent = (slot->handle != 0);
+        break;
+
+    case REQUEST_CI:
+        slot->handle = CS104_Connection_sendCommand(con->connection, config.ca, ciCommand, CS104_COMMAND_DIRECT,
+                true, commandHandler, con);
+        sent = (slot->handle != 0);
+        break;
+
+    case REQUEST_READ:
+        sent = CS104_Connection_sendReadCommand(con->connection, config.ca, config.readIOA + index);
+        break;
+
+    case REQUEST_COMMAND:
+        slot->handle = CS104_Connection_sendCommand(con->connection, config.ca, processCommands[index],
+                config.selectBeforeOperate ? CS104_COMMAND_SELECT_AND_EXECUTE : CS104_COMMAND_DIRECT,
+                false, commandHandler, con);
+        sent = (slot->handle != 0);
+        break;
+
+    default:
+        break;
+    }
+
+    Semaphore_wait(worker->lock);
+    worker->stats[type].sent++;
+    Semaphore_post(worker->lock);
+
+    if (sent == false)
+        completeRequest(con, type, slot, RESULT_FAILED);
+}
+
+static void
+handleRequests(ClientConnection* con, uint64_t now)
+{
+    int type;
+    int i;
+
+    for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++) {
+        if (config.rates[type] <= 0)
+            continue;
+
+        uint64_t interval = (uint64_t) (1000000.0 / config.rates[type]);
+
+        /* don't send a burst of requests after the worker was blocked */
+        if (con->nextRequestTime[type] + 1000000 < now)
+            con->nextRequestTime[type] = now;
+
+        while (con->nextRequestTime[type] <= now) {
+            sendRequest(con, (RequestType) type, now);
+            con->nextRequestTime[type] += interval;
+        }
+    }
+
+    /* timeouts of read commands (timeouts of the other requests are handled by the connection) */
+    for (i = 0; i < config.numberOfIOAs; i++) {
+        RequestSlot* slot = &(con->slots[REQUEST_READ][i]);
+
+        if ((slot->sendTime != 0) && (now > slot->sendTime + (uint64_t) config.timeout * 1000))
+            completeRequest(con, REQUEST_READ, slot, RESULT_TIMEOUT);
+    }
+}
+
+static void*
+workerThread(void* parameter)
+{
+    Worker self = (Worker) parameter;
+    int i;
+
+    while (self->running) {
+        CS104_ConnectionManager_tick(self->manager, 1);
+
+        uint64_t now = getTimeInUs();
+
+        for (i = 0; i < self->numberOfConnections; i++) {
+            ClientConnection* con = &(self->connections[i]);
+
+            if (con->active)
+                handleRequests(con, now);
+        }
+    }
+
+    return NULL;
+}
+
+static Worker
+Worker_create(int numberOfConnections)
+{
+    Worker self = (Worker) calloc(1, sizeof(struct sWorker));
+    int i, type;
+
+    self->lock = Semaphore_create(1);
+    self->manager = CS104_ConnectionManager_create();
+    self->connections = (ClientConnection*) calloc(numberOfConnections, sizeof(ClientConnection));
+    self->numberOfConnections = numberOfConnections;
+
+    CS104_ConnectionManager_setReconnectInterval(self->manager, 1000);
+
+    for (i = 0; i < numberOfConnections; i++) {
+        ClientConnection* con = &(self->connections[i]);
+
+        con->worker = self;
+        con->connection = CS104_Connection_create(config.hostname, config.port);
+
+        for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++)
+            con->slots[type] = (RequestSlot*) calloc(getNumberOfSlots((RequestType) type), sizeof(RequestSlot));
+
+        CS104_Connection_setCommandTimeout(con->connection, config.timeout);
+        CS104_Connection_setConnectionHandler(con->connection, connectionHandler, con);
+        CS104_Connection_setASDUReceivedHandler(con->connection, asduReceivedHandler, con);
+
+        CS104_ConnectionManager_addConnection(self->manager, con->connection);
+
+        CS104_Connection_connectAsync(con->connection);
+    }
+
+    self->running = true;
+    self->thread = Thread_create(workerThread, self, false);
+
+    Thread_start(self->thread);
+
+    return self;
+}
+
+static void
+Worker_destroy(Worker self)
+{
+    int i, type;
+
+    self->running = false;
+    Thread_destroy(self->thread);
+
+    /* closes all connections */
+    CS104_ConnectionManager_destroy(self->manager);
+
+    for (i = 0; i < self->numberOfConnections; i++) {
+        CS104_Connection_destroy(self->connections[i].connection);
+
+        for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++)
+            free(self->connections[i].slots[type]);
+    }
+
+    free(self->connections);
+
+    Semaphore_destroy(self->lock);
+
+    free(self);
+}
+
+static void
+printStatistics(RequestStatistics* stats, double seconds)
+{
+    int type;
+
+    printf("  %-8s %9s %9s %7s %7s %7s %7s %9s %9s %9s %9s\n", "request", "sent/s", "ok/s", "neg", "timeout",
+            "failed", "skipped", "mean(ms)", "p50(ms)", "p99(ms)", "max(ms)");
+
+    for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++) {
+        RequestStatistics* s = &(stats[type]);
+        uint64_t responses = s->completed + s->negative;
+
+        if ((config.rates[type] <= 0) && (s->sent == 0))
+            continue;
+
+        printf("  %-8s %9.1f %9.1f %7llu %7llu %7llu %7llu %9.2f %9.2f %9.2f %9.2f\n", requestTypeNames[type],
+                (double) s->sent / seconds, (double) s->completed / seconds,
+                (unsigned long long) s->negative, (unsigned long long) s->timeouts,
+                (unsigned long long) s->failed, (unsigned long long) s->skipped,
+                responses ? ((double) s->latencySum / (double) responses / 1000.0) : 0.0,
+                (double) getPercentile(s, 50.0) / 1000.0, (double) getPercentile(s, 99.0) / 1000.0,
+                (double) s->latencyMax / 1000.0);
+    }
+}
+
+static void
+printReport(Worker* workers, RequestStatistics* totals, uint64_t intervalMs)
+{
+    RequestStatistics* interval = (RequestStatistics*) calloc(NUMBER_OF_REQUEST_TYPES, sizeof(RequestStatistics));
+    int activeConnections = 0;
+    uint64_t receivedASDUs = 0;
+    int i, type;
+
+    for (i = 0; i < config.numberOfWorkers; i++) {
+        Worker worker = workers[i];
+
+        Semaphore_wait(worker->lock);
+
+        activeConnections += worker->activeConnections;
+        receivedASDUs += worker->receivedASDUs;
+        worker->receivedASDUs = 0;
+
+        for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++)
+            addStatistics(&(interval[type]), &(worker->stats[type]));
+
+        memset(worker->stats, 0, sizeof(worker->stats));
+
+        Semaphore_post(worker->lock);
+    }
+
+    double seconds = (double) intervalMs / 1000.0;
+
+    printf("connections: %i/%i active | received ASDUs: %.0f/s\n", activeConnections, config.numberOfConnections,
+            (double) receivedASDUs / seconds);
+
+    printStatistics(interval, seconds);
+
+    for (type = 0; type < NUMBER_OF_REQUEST_TYPES; type++)
+        addStatistics(&(totals[type]), &(interval[type]));
+
+    free(interval);
+}
+
+static void
+printUsage(const char* name)
+{
+    printf("Usage: %s [options] [hostname] [port]\n\n", name);
+    printf("  -n <number>   number of client connections (default: 10)\n");
+    printf("  -w <number>   number of worker threads (default: 2)\n");
+    printf("  -a <ca>       common address of the server (default: 1)\n");
+    printf("  -g <rate>     general interrogations per second and connection (default: 0.1)\n");
+    printf("  -k <rate>     counter interrogations per second and connection (default: 0)\n");
+    printf("  -r <rate>     read commands per second and connection (default: 0)\n");
+    printf("  -x <rate>     single commands per second and connection (default: 1)\n");
+    printf("  -R <ioa>      first IOA for read commands (default: 100)\n");
+    printf("  -C <ioa>      first IOA for single commands (default: 5000)\n");
+    printf("  -N <number>   number of IOAs for read and single commands (default: 1)\n");
+    printf("  -e            select before operate for single commands\n");
+    printf("  -T <ms>       response timeout (default: 5000)\n");
+    printf("  -t <seconds>  duration of the test (default: 0 = until Ctrl-C)\n");
+    printf("  -s <seconds>  report interval (default: 5)\n");
+}
+
+static bool
+parseArguments(int argc, char** argv)
+{
+    int positional = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+
+        if (strcmp(argv[i], "-n") == 0 && hasValue)
+            config.numberOfConnections = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && hasValue)
+            config.numberOfWorkers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-a") == 0 && hasValue)
+            config.ca = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-g") == 0 && hasValue)
+            config.rates[REQUEST_GI] = atof(argv[++i]);
+        else if (strcmp(argv[i], "-k") == 0 && hasValue)
+            config.rates[REQUEST_CI] = atof(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && hasValue)
+            config.rates[REQUEST_READ] = atof(argv[++i]);
+        else if (strcmp(argv[i], "-x") == 0 && hasValue)
+            config.rates[REQUEST_COMMAND] = atof(argv[++i]);
+        else if (strcmp(argv[i], "-R") == 0 && hasValue)
+            config.readIOA = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-C") == 0 && hasValue)
+            config.commandIOA = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-N") == 0 && hasValue)
+            config.numberOfIOAs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-e") == 0)
+            config.selectBeforeOperate = true;
+        else if (strcmp(argv[i], "-T") == 0 && hasValue)
+            config.timeout = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && hasValue)
+            config.duration = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && hasValue)
+            config.reportInterval = atoi(argv[++i]);
+        else if (argv[i][0] == '-')
+            return false;
+        else if (positional == 0) {
+            config.hostname = argv[i];
+            positional++;
+        }
+        else if (positional == 1) {
+            config.port = atoi(argv[i]);
+            positional++;
+        }
+        else
+            return false;
+    }
+
+    return (config.numberOfConnections > 0) && (config.numberOfWorkers > 0) && (config.numberOfIOAs > 0) &&
+            (config.timeout > 0) && (config.reportInterval > 0);
+}
+
+int
+main(int argc, char** argv)
+{
+    RequestStatistics totals[NUMBER_OF_REQUEST_TYPES];
+    int i;
+
+    config.hostname = "localhost";
+    config.port = IEC_60870_5_104_DEFAULT_PORT;
+    config.numberOfConnections = 10;
+    config.numberOfWorkers = 2;
+    config.ca = 1;
+    config.rates[REQUEST_GI] = 0.1;
+    config.rates[REQUEST_CI] = 0;
+    config.rates[REQUEST_READ] = 0;
+    config.rates[REQUEST_COMMAND] = 1;
+    config.readIOA = 100;
+    config.commandIOA = 5000;
+    config.numberOfIOAs = 1;
+    config.selectBeforeOperate = false;
+    config.timeout = 5000;
+    config.duration = 0;
+    config.reportInterval = 5;
+
+    if (parseArguments(argc, argv) == false) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (config.numberOfWorkers > config.numberOfConnections)
+        config.numberOfWorkers = config.numberOfConnections;
+
+    signal(SIGINT, sigint_handler);
+
+    giCommand = (InformationObject) InterrogationCommand_create(NULL, 0, IEC60870_QOI_STATION);
+    ciCommand = (InformationObject) CounterInterrogationCommand_create(NULL, 0, IEC60870_QCC_RQT_GENERAL);
+
+    processCommands = (InformationObject*) calloc(config.numberOfIOAs, sizeof(InformationObject));
+
+    for (i = 0; i < config.numberOfIOAs; i++)
+        processCommands[i] = (InformationObject) SingleCommand_create(NULL, config.commandIOA + i, true, false, 0);
+
+    memset(totals, 0, sizeof(totals));
+
+    printf("Connecting %i connections with %i worker threads to %s:%i\n", config.numberOfConnections,
+            config.numberOfWorkers, config.hostname, config.port);
+
+    Worker* workers = (Worker*) calloc(config.numberOfWorkers, sizeof(Worker));
+
+    for (i = 0; i < config.numberOfWorkers; i++) {
+        /* distribute the connections equally */
+        int numberOfConnections = config.numberOfConnections / config.numberOfWorkers;
+
+        if (i < (config.numberOfConnections % config.numberOfWorkers))
+            numberOfConnections++;
+
+        workers[i] = Worker_create(numberOfConnections);
+    }
+
+    uint64_t startTime = Hal_getTimeInMs();
+    uint64_t lastReport = startTime;
+
+    while (running) {
+        Thread_sleep(100);
+
+        uint64_t now = Hal_getTimeInMs();
+
+        if (now >= lastReport + (uint64_t) config.reportInterval * 1000) {
+            printReport(workers, totals, now - lastReport);
+            lastReport = now;
+        }
+
+        if ((config.duration > 0) && (now >= startTime + (uint64_t) config.duration * 1000))
+            running = false;
+    }
+
+    uint64_t endTime = Hal_getTimeInMs();
+
+    /* last (incomplete) interval */
+    if (endTime > lastReport)
+        printReport(workers, totals, endTime - lastReport);
+
+    for (i = 0; i < config.numberOfWorkers; i++)
+        Worker_destroy(workers[i]);
+
+    if (endTime > startTime) {
+        printf("\nTotal (%.1f s):\n", (double) (endTime - startTime) / 1000.0);
+        printStatistics(totals, (double) (endTime - startTime) / 1000.0);
+    }
+
+    free(workers);
+
+    InformationObject_destroy(giCommand);
+    InformationObject_destroy(ciCommand);
+
+    for (i = 0; i < config.numberOfIOAs; i++)
+        InformationObject_destroy(processCommands[i]);
+
+    free(processCommands);
+
+    return 0;
+}
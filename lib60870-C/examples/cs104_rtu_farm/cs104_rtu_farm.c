@@ -0,0 +1,489 @@
+/*
+ * Simulator for a large number of CS 104 outstations (RTUs) in a single process
+ *
+ * All RTUs run in non-threaded mode and are handled by a single thread. The sockets
+ * of all RTUs are registered in one socket poller, so an RTU is only processed when
+ * one of its sockets is ready, when it has new events, or for the periodic tasks.
+ *
+ * Each RTU has a configurable number of data points (first half single point
+ * information, second half short floating point measurements). Spontaneous changes
+ * are generated with random (exponentially distributed) intervals. Station
+ * interrogation is supported.
+ *
+ * NOTE: Each RTU requires a listening socket and a socket for the client connection.
+ * The limit for open files (ulimit -n) has to be raised for large numbers of RTUs.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <math.h>
+
+#include "cs104_slave.h"
+
+#include "hal_socket.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+
+#define PERIODIC_TASKS_INTERVAL_MS 100
+#define EVENT_GENERATION_INTERVAL_MS 10
+
+static bool running = true;
+
+static void
+sigint_handler(int signalId)
+{
+    running = false;
+}
+
+typedef struct {
+    CS104_Slave slave;
+    int ca;
+    int numberOfPoints;
+    bool* states; /* single points: IOA 1 .. numberOfPoints / 2 */
+    float* values; /* measurements: IOA numberOfPoints / 2 + 1 .. numberOfPoints */
+    double eventRate; /* average number of events per second */
+    uint64_t nextEventTime;
+    bool active; /* a client connection is active (STARTDT) */
+} SimulatedRTU;
+
+typedef struct {
+    int numberOfRTUs;
+    const char* firstAddress;
+    bool useAddressAliases;
+    int port;
+    int numberOfPoints;
+    double eventRate;
+    int duration;
+    int reportInterval;
+    bool latencyStatistics;
+} FarmConfiguration;
+
+/* totals of the connection statistics at the last report */
+typedef struct {
+    uint64_t generatedEvents;
+    uint64_t sentIFrames;
+    uint64_t sentBytes;
+    uint64_t rcvdIFrames;
+} FarmCounters;
+
+static uint64_t generatedEvents = 0;
+
+static sCS101_StaticASDU _asdu;
+static uint8_t ioBuf[250];
+
+static double
+getRandomInterval(double rate)
+{
+    double u = ((double) rand() + 1.0) / ((double) RAND_MAX + 2.0);
+
+    return -log(u) / rate;
+}
+
+static int
+getNumberOfSinglePoints(SimulatedRTU* rtu)
+{
+    return rtu->numberOfPoints / 2;
+}
+
+static void
+sendInterrogationResponse(SimulatedRTU* rtu, IMasterConnection connection)
+{
+    CS101_AppLayerParameters alParams = IMasterConnection_getApplicationLayerParameters(connection);
+    int numberOfSinglePoints = getNumberOfSinglePoints(rtu);
+    int i;
+
+    CS101_ASDU newAsdu = NULL;
+
+    for (i = 0; i < rtu->numberOfPoints; i++) {
+        InformationObject io;
+
+        if (i < numberOfSinglePoints)
+            io = (InformationObject) SinglePointInformation_create((SinglePointInformation) &ioBuf, i + 1, rtu->states[i],
+                    IEC60870_QUALITY_GOOD);
+        else
+            io = (InformationObject) MeasuredValueShort_create((MeasuredValueShort) &ioBuf, i + 1,
+                    rtu->values[i - numberOfSinglePoints], IEC60870_QUALITY_GOOD);
+
+        /* start a new ASDU when the type changes or the ASDU is full */
+        if (newAsdu && ((i == numberOfSinglePoints) || (CS101_ASDU_addInformationObject(newAsdu, io) == false))) {
+            IMasterConnection_sendASDU(connection, newAsdu);
+            newAsdu = NULL;
+        }
+
+        if (newAsdu == NULL) {
+            newAsdu = CS101_ASDU_initializeStatic(&_asdu, alParams, false, CS101_COT_INTERROGATED_BY_STATION,
+                    0, rtu->ca, false, false);
+
+            CS101_ASDU_addInformationObject(newAsdu, io);
+        }
+    }
+
+    if (newAsdu)
+        IMasterConnection_sendASDU(connection, newAsdu);
+}
+
+static bool
+interrogationHandler(void* parameter, IMasterConnection connection, CS101_ASDU asdu, uint8_t qoi)
+{
+    SimulatedRTU* rtu = (SimulatedRTU*) parameter;
+
+    if ((qoi == IEC60870_QOI_STATION) && (CS101_ASDU_getCA(asdu) == rtu->ca)) {
+        IMasterConnection_sendACT_CON(connection, asdu, false);
+
+        sendInterrogationResponse(rtu, connection);
+
+        IMasterConnection_sendACT_TERM(connection, asdu);
+    }
+    else {
+        IMasterConnection_sendACT_CON(connection, asdu, true);
+    }
+
+    return true;
+}
+
+static void
+connectionEventHandler(void* parameter, IMasterConnection con, CS104_PeerConnectionEvent event)
+{
+    SimulatedRTU* rtu = (SimulatedRTU*) parameter;
+
+    /* only one client connection per RTU */
+    if (event == CS104_CON_EVENT_ACTIVATED) {
+        rtu->active = true;
+        rtu->nextEventTime = Hal_getTimeInMs() + (uint64_t) (getRandomInterval(rtu->eventRate) * 1000.0);
+    }
+    else if ((event == CS104_CON_EVENT_DEACTIVATED) || (event == CS104_CON_EVENT_CONNECTION_CLOSED))
+        rtu->active = false;
+}
+
+/* generate a spontaneous change of a random data point */
+static void
+generateEvent(SimulatedRTU* rtu, uint64_t timestamp)
+{
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(rtu->slave);
+    int numberOfSinglePoints = getNumberOfSinglePoints(rtu);
+    int index = rand() % rtu->numberOfPoints;
+    struct sCP56Time2a time;
+
+    CP56Time2a_createFromMsTimestamp(&time, timestamp);
+
+    CS101_ASDU newAsdu = CS101_ASDU_initializeStatic(&_asdu, alParams, false, CS101_COT_SPONTANEOUS, 0, rtu->ca, false, false);
+
+    if (index < numberOfSinglePoints) {
+        rtu->states[index] = !rtu->states[index];
+
+        CS101_ASDU_addInformationObject(newAsdu, (InformationObject) SinglePointWithCP56Time2a_create(
+                (SinglePointWithCP56Time2a) &ioBuf, index + 1, rtu->states[index], IEC60870_QUALITY_GOOD, &time));
+    }
+    else {
+        float* value = &(rtu->values[index - numberOfSinglePoints]);
+
+        *value += (float) ((rand() % 201) - 100) / 10.f;
+
+        CS101_ASDU_addInformationObject(newAsdu, (InformationObject) MeasuredValueShortWithCP56Time2a_create(
+                (MeasuredValueShortWithCP56Time2a) &ioBuf, index + 1, *value, IEC60870_QUALITY_GOOD, &time));
+    }
+
+    CS104_Slave_enqueueASDU(rtu->slave, newAsdu);
+
+    generatedEvents++;
+}
+
+/* IPv4 address of the RTU when address aliases are used (first address + index) */
+static bool
+getRTUAddress(const char* firstAddress, int index, char* buf, int bufSize)
+{
+    unsigned int a, b, c, d;
+
+    if (sscanf(firstAddress, "%u.%u.%u.%u", &a, &b, &c, &d) != 4)
+        return false;
+
+    uint32_t address = ((a << 24) | (b << 16) | (c << 8) | d) + (uint32_t) index;
+
+    snprintf(buf, bufSize, "%u.%u.%u.%u", (address >> 24) & 0xff, (address >> 16) & 0xff,
+            (address >> 8) & 0xff, address & 0xff);
+
+    return true;
+}
+
+static bool
+startRTU(SimulatedRTU* rtu, FarmConfiguration* config, SocketPoller poller, int index)
+{
+    char address[32];
+
+    rtu->ca = index + 1;
+    rtu->numberOfPoints = config->numberOfPoints;
+    rtu->states = (bool*) calloc(config->numberOfPoints, sizeof(bool));
+    rtu->values = (float*) calloc(config->numberOfPoints, sizeof(float));
+
+    /* randomize the event rates of the RTUs (0.5 to 1.5 times the configured rate) */
+    rtu->eventRate = config->eventRate * (0.5 + ((double) rand() / (double) RAND_MAX));
+
+    /* the high priority queue has to hold the complete interrogation response */
+    rtu->slave = CS104_Slave_create(100, 16 + (config->numberOfPoints / 8));
+
+    CS104_Slave_setServerMode(rtu->slave, CS104_MODE_SINGLE_REDUNDANCY_GROUP);
+    CS104_Slave_setMaxOpenConnections(rtu->slave, 1);
+
+    if (config->useAddressAliases) {
+        if (getRTUAddress(config->firstAddress, index, address, sizeof(address)) == false)
+            return false;
+
+        CS104_Slave_setLocalAddress(rtu->slave, address);
+        CS104_Slave_setLocalPort(rtu->slave, config->port);
+    }
+    else {
+        CS104_Slave_setLocalAddress(rtu->slave, config->firstAddress);
+        CS104_Slave_setLocalPort(rtu->slave, config->port + index);
+    }
+
+    CS104_Slave_setInterrogationHandler(rtu->slave, interrogationHandler, rtu);
+    CS104_Slave_setConnectionEventHandler(rtu->slave, connectionEventHandler, rtu);
+    CS104_Slave_setLatencyStatisticsEnabled(rtu->slave, config->latencyStatistics);
+
+    CS104_Slave_setSocketPoller(rtu->slave, poller);
+
+    CS104_Slave_startThreadless(rtu->slave);
+
+    return CS104_Slave_isRunning(rtu->slave);
+}
+
+static void
+printReport(SimulatedRTU* rtus, FarmConfiguration* config, FarmCounters* last, uint64_t intervalMs)
+{
+    FarmCounters current;
+    struct sCS104_ConnectionStatistics stats;
+    struct sCS104_LatencyStatistics latency;
+    int connectedRTUs = 0;
+    int activeRTUs = 0;
+    uint64_t ackCount = 0;
+    uint64_t ackRttSum = 0;
+    uint32_t ackRttMax = 0;
+    uint64_t latencyCount = 0;
+    uint64_t latencyP99 = 0;
+    int i;
+
+    memset(&current, 0, sizeof(current));
+
+    current.generatedEvents = generatedEvents;
+
+    for (i = 0; i < config->numberOfRTUs; i++) {
+        CS104_Slave slave = rtus[i].slave;
+
+        if (rtus[i].active)
+            activeRTUs++;
+
+        if (CS104_Slave_getStatistics(slave, &stats, 1) == 1) {
+            connectedRTUs++;
+
+            current.sentIFrames += stats.sentIFrames;
+            current.sentBytes += stats.sentBytes;
+            current.rcvdIFrames += stats.rcvdIFrames;
+
+            ackCount += stats.ackCount;
+            ackRttSum += stats.ackRttSum;
+
+            if (stats.ackRttMax > ackRttMax)
+                ackRttMax = stats.ackRttMax;
+
+            if (CS104_Slave_getLatencyStatistics(slave, stats.connectionId, CS104_LATENCY_TOTAL, &latency)) {
+                latencyCount += latency.count;
+
+                if (latency.p99 > latencyP99)
+                    latencyP99 = latency.p99;
+
+                CS104_Slave_resetLatencyStatistics(slave, stats.connectionId);
+            }
+        }
+    }
+
+    double seconds = (double) intervalMs / 1000.0;
+
+    /* counters of closed connections are lost -> no negative rates */
+    uint64_t sentIFrames = (current.sentIFrames > last->sentIFrames) ? (current.sentIFrames - last->sentIFrames) : 0;
+    uint64_t sentBytes = (current.sentBytes > last->sentBytes) ? (current.sentBytes - last->sentBytes) : 0;
+    uint64_t rcvdIFrames = (current.rcvdIFrames > last->rcvdIFrames) ? (current.rcvdIFrames - last->rcvdIFrames) : 0;
+
+    printf("RTUs: %i connected, %i active | events: %.0f/s | sent I frames: %.0f/s (%.1f kB/s) | received I frames: %.0f/s\n",
+            connectedRTUs, activeRTUs, (double) (current.generatedEvents - last->generatedEvents) / seconds,
+            (double) sentIFrames / seconds, (double) sentBytes / seconds / 1000.0, (double) rcvdIFrames / seconds);
+
+    if (ackCount > 0)
+        printf("      ack RTT: mean %.1f ms, max %u ms", (double) ackRttSum / (double) ackCount, ackRttMax);
+
+    if (latencyCount > 0)
+        printf(" | enqueue to ack: p99 %.1f ms (max of all RTUs)", (double) latencyP99 / 1000.0);
+
+    if ((ackCount > 0) || (latencyCount > 0))
+        printf("\n");
+
+    *last = current;
+}
+
+static void
+printUsage(const char* name)
+{
+    printf("Usage: %s [options]\n\n", name);
+    printf("  -n <number>   number of RTUs (default: 100)\n");
+    printf("  -a <address>  local IP address (default: 0.0.0.0)\n");
+    printf("  -i            use address aliases: RTU n listens on <address> + n (same port)\n");
+    printf("                instead of one port per RTU (<port> + n)\n");
+    printf("  -p <port>     (first) TCP port (default: 2404)\n");
+    printf("  -c <number>   number of data points per RTU (default: 100)\n");
+    printf("  -r <rate>     average number of spontaneous changes per RTU and second (default: 1.0)\n");
+    printf("  -t <seconds>  duration of the simulation (default: 0 = until Ctrl-C)\n");
+    printf("  -s <seconds>  report interval (default: 5)\n");
+    printf("  -l            record latency histograms (requires CONFIG_CS104_SLAVE_LATENCY_STATISTICS)\n");
+}
+
+static bool
+parseArguments(int argc, char** argv, FarmConfiguration* config)
+{
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+
+        if (strcmp(argv[i], "-n") == 0 && hasValue)
+            config->numberOfRTUs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-a") == 0 && hasValue)
+            config->firstAddress = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0)
+            config->useAddressAliases = true;
+        else if (strcmp(argv[i], "-p") == 0 && hasValue)
+            config->port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-c") == 0 && hasValue)
+            config->numberOfPoints = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && hasValue)
+            config->eventRate = atof(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && hasValue)
+            config->duration = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && hasValue)
+            config->reportInterval = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0)
+            config->latencyStatistics = true;
+        else
+            return false;
+    }
+
+    return (config->numberOfRTUs > 0) && (config->numberOfPoints > 1) && (config->eventRate > 0) &&
+            (config->reportInterval > 0);
+}
+
+int
+main(int argc, char** argv)
+{
+    FarmConfiguration config;
+    FarmCounters counters;
+    int startedRTUs = 0;
+    int i;
+
+    config.numberOfRTUs = 100;
+    config.firstAddress = "0.0.0.0";
+    config.useAddressAliases = false;
+    config.port = 2404;
+    config.numberOfPoints = 100;
+    config.eventRate = 1.0;
+    config.duration = 0;
+    config.reportInterval = 5;
+    config.latencyStatistics = false;
+
+    if (parseArguments(argc, argv, &config) == false) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, sigint_handler);
+
+    srand((unsigned int) Hal_getTimeInMs());
+
+    SimulatedRTU* rtus = (SimulatedRTU*) calloc(config.numberOfRTUs, sizeof(SimulatedRTU));
+
+    SocketPoller poller = SocketPoller_create(1024);
+
+    if ((rtus == NULL) || (poller == NULL)) {
+        printf("Failed to allocate resources!\n");
+        goto exit_program;
+    }
+
+    for (i = 0; i < config.numberOfRTUs; i++) {
+        startedRTUs++;
+
+        if (startRTU(&(rtus[i]), &config, poller, i) == false) {
+            printf("Failed to start RTU %i (check the address/port and the limit for open files)!\n", i);
+            goto exit_program;
+        }
+    }
+
+    printf("Started %i RTUs with %i data points each\n", config.numberOfRTUs, config.numberOfPoints);
+
+    memset(&counters, 0, sizeof(counters));
+
+    uint64_t startTime = Hal_getTimeInMs();
+    uint64_t nextPeriodicTasks = startTime + PERIODIC_TASKS_INTERVAL_MS;
+    uint64_t nextEventGeneration = startTime + EVENT_GENERATION_INTERVAL_MS;
+    uint64_t lastReport = startTime;
+
+    while (running) {
+        int readyCount = SocketPoller_wait(poller, EVENT_GENERATION_INTERVAL_MS);
+
+        for (i = 0; i < readyCount; i++)
+            CS104_Slave_tick((CS104_Slave) SocketPoller_getParameter(poller, i));
+
+        uint64_t now = Hal_getTimeInMs();
+
+        if (now >= nextEventGeneration) {
+            nextEventGeneration = now + EVENT_GENERATION_INTERVAL_MS;
+
+            for (i = 0; i < config.numberOfRTUs; i++) {
+                SimulatedRTU* rtu = &(rtus[i]);
+
+                if (rtu->active && (now >= rtu->nextEventTime)) {
+
+                    while (now >= rtu->nextEventTime) {
+                        generateEvent(rtu, now);
+
+                        rtu->nextEventTime += (uint64_t) (getRandomInterval(rtu->eventRate) * 1000.0) + 1;
+                    }
+
+                    /* send the new events */
+                    CS104_Slave_tick(rtu->slave);
+                }
+            }
+        }
+
+        if (now >= nextPeriodicTasks) {
+            nextPeriodicTasks = now + PERIODIC_TASKS_INTERVAL_MS;
+
+            for (i = 0; i < config.numberOfRTUs; i++)
+                CS104_Slave_tick(rtus[i].slave);
+        }
+
+        if (now >= lastReport + (uint64_t) config.reportInterval * 1000) {
+            printReport(rtus, &config, &counters, now - lastReport);
+            lastReport = now;
+        }
+
+        if ((config.duration > 0) && (now >= startTime + (uint64_t) config.duration * 1000))
+            running = false;
+    }
+
+exit_program:
+
+    for (i = 0; i < startedRTUs; i++) {
+        CS104_Slave_stopThreadless(rtus[i].slave);
+        CS104_Slave_destroy(rtus[i].slave);
+
+        free(rtus[i].states);
+        free(rtus[i].values);
+    }
+
+    if (poller)
+        SocketPoller_destroy(poller);
+
+    free(rtus);
+
+    return 0;
+}
@@ -0,0 +1,448 @@
+/*
+ * Compares the CS 104 transport over TCP loopback with a local unix domain socket
+ *
+ * For each transport a server and a client are started in this process and two
+ * measurements are made. The server runs in threadless mode with a socket poller so that
+ * the results are not limited by the polling interval of the connection threads:
+ *
+ * - command round trip: single commands are sent one after the other. The time until
+ *   the ACT_CON is received is measured for each command.
+ * - monitoring throughput: the server sends a number of spontaneous ASDUs as fast as the
+ *   k/w windows allow. The time until the client has received all ASDUs is measured.
+ *
+ * The unix domain socket transport is only available on Linux.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cs104_slave.h"
+#include "cs104_connection.h"
+#include "hal_socket.h"
+#include "hal_thread.h"
+#include "hal_time.h"
+
+typedef struct {
+    CS104_Slave slave;
+    SocketPoller poller;
+    Thread thread;
+    bool running;
+} BenchmarkServer;
+
+typedef struct {
+    Semaphore done;
+    CS104_CommandEvent lastEvent;
+
+    int receivedASDUs;
+    Semaphore receivedLock;
+
+    bool startDtConReceived;
+} BenchmarkClient;
+
+typedef struct {
+    const char* name;
+    int sentCommands;
+    int failedCommands;
+    uint64_t* rtt; /* in us */
+    uint64_t throughputTime; /* in us */
+    int throughputASDUs;
+    uint64_t throughputBytes;
+} BenchmarkResult;
+
+static uint64_t
+getTimeInUs(void)
+{
+    return Hal_getTimeInNs() / 1000;
+}
+
+static bool
+slaveAsduHandler(void* parameter, IMasterConnection connection, CS101_ASDU asdu)
+{
+    if (CS101_ASDU_getTypeID(asdu) == C_SC_NA_1) {
+        if (CS101_ASDU_getCOT(asdu) == CS101_COT_ACTIVATION)
+            CS101_ASDU_setCOT(asdu, CS101_COT_ACTIVATION_CON);
+        else
+            CS101_ASDU_setCOT(asdu, CS101_COT_UNKNOWN_COT);
+
+        IMasterConnection_sendASDU(connection, asdu);
+
+        return true;
+    }
+
+    return false;
+}
+
+static void*
+serverThread(void* parameter)
+{
+    BenchmarkServer* server = (BenchmarkServer*) parameter;
+
+    while (server->running) {
+        SocketPoller_wait(server->poller, 1);
+
+        /* handle received messages, send the enqueued ASDUs and check the timeouts */
+        CS104_Slave_tick(server->slave);
+    }
+
+    return NULL;
+}
+
+static void
+clientConnectionHandler(void* parameter, CS104_Connection connection, CS104_ConnectionEvent event)
+{
+    BenchmarkClient* client = (BenchmarkClient*) parameter;
+
+    if (event == CS104_CONNECTION_STARTDT_CON_RECEIVED)
+        client->startDtConReceived = true;
+}
+
+static bool
+clientAsduHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    BenchmarkClient* client = (BenchmarkClient*) parameter;
+
+    if (CS101_ASDU_getTypeID(asdu) == M_ME_NB_1) {
+        Semaphore_wait(client->receivedLock);
+        client->receivedASDUs++;
+        Semaphore_post(client->receivedLock);
+    }
+
+    return true;
+}
+
+static void
+commandHandler(void* parameter, CS104_Connection connection, CS104_CommandHandle handle,
+        CS104_CommandEvent event, CS101_ASDU asdu)
+{
+    BenchmarkClient* client = (BenchmarkClient*) parameter;
+
+    client->lastEvent = event;
+
+    Semaphore_post(client->done);
+}
+
+static int
+getReceivedASDUs(BenchmarkClient* client)
+{
+    int receivedASDUs;
+
+    Semaphore_wait(client->receivedLock);
+    receivedASDUs = client->receivedASDUs;
+    Semaphore_post(client->receivedLock);
+
+    return receivedASDUs;
+}
+
+static int
+compareUint64(const void* a, const void* b)
+{
+    uint64_t va = *((const uint64_t*) a);
+    uint64_t vb = *((const uint64_t*) b);
+
+    if (va < vb)
+        return -1;
+    else if (va > vb)
+        return 1;
+    else
+        return 0;
+}
+
+static void
+measureRoundTrip(CS104_Connection con, BenchmarkClient* client, int numberOfCommands, BenchmarkResult* result)
+{
+    int i;
+
+    for (i = 0; i < numberOfCommands; i++) {
+        InformationObject sc = (InformationObject) SingleCommand_create(NULL, 5000, (i % 2) == 0, false, 0);
+
+        uint64_t startTime = getTimeInUs();
+
+        CS104_CommandHandle handle = CS104_Connection_sendCommand(con, 1, sc, CS104_COMMAND_DIRECT, false,
+                commandHandler, client);
+
+        InformationObject_destroy(sc);
+
+        if (handle == 0) {
+            result->failedCommands++;
+            break;
+        }
+
+        Semaphore_wait(client->done);
+
+        if (client->lastEvent == CS104_COMMAND_ACT_CON)
+            result->rtt[result->sentCommands++] = getTimeInUs() - startTime;
+        else
+            result->failedCommands++;
+    }
+}
+
+static void
+measureThroughput(CS104_Slave slave, CS104_Connection con, BenchmarkClient* client, int numberOfASDUs, BenchmarkResult* result)
+{
+    int i;
+
+    struct sCS104_ConnectionStatistics statistics;
+
+    uint64_t rcvdBytes = 0;
+
+    if (CS104_Connection_getStatistics(con, &statistics))
+        rcvdBytes = statistics.rcvdBytes;
+
+    uint64_t startTime = getTimeInUs();
+
+    for (i = 0; i < numberOfASDUs; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(CS104_Slave_getAppLayerParameters(slave), false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100 + (i % 100), i % 32000, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, asdu);
+
+        CS101_ASDU_destroy(asdu);
+    }
+
+    /* wait until all ASDUs are received (or no progress for 2 s) */
+    int lastReceived = -1;
+    uint64_t lastProgress = Hal_getTimeInMs();
+
+    while (getReceivedASDUs(client) < numberOfASDUs) {
+        int received = getReceivedASDUs(client);
+
+        if (received != lastReceived) {
+            lastReceived = received;
+            lastProgress = Hal_getTimeInMs();
+        }
+        else if (Hal_getTimeInMs() > lastProgress + 2000) {
+            break;
+        }
+
+        Thread_sleep(1);
+    }
+
+    result->throughputTime = getTimeInUs() - startTime;
+    result->throughputASDUs = getReceivedASDUs(client);
+
+    if (CS104_Connection_getStatistics(con, &statistics))
+        result->throughputBytes = statistics.rcvdBytes - rcvdBytes;
+}
+
+static bool
+runBenchmark(const char* unixPath, int tcpPort, int numberOfCommands, int numberOfASDUs, BenchmarkResult* result)
+{
+    bool success = false;
+
+    BenchmarkServer server;
+    memset(&server, 0, sizeof(server));
+
+    server.poller = SocketPoller_create(16);
+
+    if (server.poller == NULL) {
+        printf("%s: failed to create socket poller\n", result->name);
+        return false;
+    }
+
+    CS104_Slave slave = CS104_Slave_create(numberOfASDUs, 10);
+
+    server.slave = slave;
+
+    if (unixPath) {
+        if (CS104_Slave_setLocalUnixPath(slave, unixPath) == false) {
+            printf("%s: failed to set the socket path\n", result->name);
+            CS104_Slave_destroy(slave);
+            SocketPoller_destroy(server.poller);
+            return false;
+        }
+    }
+    else {
+        CS104_Slave_setLocalAddress(slave, "127.0.0.1");
+        CS104_Slave_setLocalPort(slave, tcpPort);
+    }
+
+    CS104_Slave_setServerMode(slave, CS104_MODE_SINGLE_REDUNDANCY_GROUP);
+    CS104_Slave_setASDUHandler(slave, slaveAsduHandler, NULL);
+
+    CS104_Slave_setSocketPoller(slave, server.poller);
+
+    CS104_Slave_startThreadless(slave);
+
+    if (CS104_Slave_isRunning(slave) == false) {
+        printf("%s: failed to start server\n", result->name);
+        CS104_Slave_destroy(slave);
+        SocketPoller_destroy(server.poller);
+        return false;
+    }
+
+    server.running = true;
+    server.thread = Thread_create(serverThread, &server, false);
+    Thread_start(server.thread);
+
+    BenchmarkClient client;
+    memset(&client, 0, sizeof(client));
+
+    client.done = Semaphore_create(0);
+    client.receivedLock = Semaphore_create(1);
+
+    CS104_Connection con;
+
+    if (unixPath)
+        con = CS104_Connection_createUnix(unixPath);
+    else
+        con = CS104_Connection_create("127.0.0.1", tcpPort);
+
+    CS104_Connection_setConnectionHandler(con, clientConnectionHandler, &client);
+    CS104_Connection_setASDUReceivedHandler(con, clientAsduHandler, &client);
+
+    if (CS104_Connection_connect(con)) {
+        CS104_Connection_sendStartDT(con);
+
+        int wait = 0;
+
+        while ((client.startDtConReceived == false) && (wait++ < 1000))
+            Thread_sleep(1);
+
+        if (client.startDtConReceived) {
+            measureRoundTrip(con, &client, numberOfCommands, result);
+            measureThroughput(slave, con, &client, numberOfASDUs, result);
+
+            success = true;
+        }
+        else
+            printf("%s: no STARTDT_CON received\n", result->name);
+    }
+    else
+        printf("%s: failed to connect\n", result->name);
+
+    CS104_Connection_destroy(con);
+
+    server.running = false;
+    Thread_destroy(server.thread);
+
+    CS104_Slave_stopThreadless(slave);
+    CS104_Slave_destroy(slave);
+    SocketPoller_destroy(server.poller);
+
+    Semaphore_destroy(client.done);
+    Semaphore_destroy(client.receivedLock);
+
+    return success;
+}
+
+static void
+printResult(BenchmarkResult* result)
+{
+    uint64_t sum = 0;
+    int i;
+
+    printf("%-5s", result->name);
+
+    if (result->sentCommands > 0) {
+        qsort(result->rtt, result->sentCommands, sizeof(uint64_t), compareUint64);
+
+        for (i = 0; i < result->sentCommands; i++)
+            sum += result->rtt[i];
+
+        printf(" | %8llu %8llu %8llu %8llu %6i",
+                (unsigned long long) (sum / result->sentCommands),
+                (unsigned long long) result->rtt[result->sentCommands / 2],
+                (unsigned long long) result->rtt[((uint64_t) result->sentCommands * 99) / 100],
+                (unsigned long long) result->rtt[result->sentCommands - 1],
+                result->failedCommands);
+    }
+    else {
+        printf(" | %8s %8s %8s %8s %6i", "-", "-", "-", "-", result->failedCommands);
+    }
+
+    if (result->throughputTime > 0) {
+        double seconds = (double) result->throughputTime / 1000000.0;
+
+        printf(" | %8i %10.0f %8.2f\n", result->throughputASDUs,
+                (double) result->throughputASDUs / seconds,
+                (double) result->throughputBytes / seconds / 1000000.0);
+    }
+    else {
+        printf(" | %8s %10s %8s\n", "-", "-", "-");
+    }
+}
+
+static void
+printUsage(const char* program)
+{
+    printf("Usage: %s [options]\n\n", program);
+    printf("  -n <count>   number of command round trips (default: 10000)\n");
+    printf("  -m <count>   number of ASDUs for the throughput measurement (default: 100000)\n");
+    printf("  -p <port>    TCP port (default: 20404)\n");
+    printf("  -u <path>    path of the unix domain socket (default: /tmp/cs104_uds_benchmark.sock)\n");
+    printf("  -r <count>   number of repetitions (default: 1)\n");
+}
+
+int
+main(int argc, char** argv)
+{
+    int numberOfCommands = 10000;
+    int numberOfASDUs = 100000;
+    int tcpPort = 20404;
+    const char* unixPath = "/tmp/cs104_uds_benchmark.sock";
+    int repetitions = 1;
+
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+            numberOfCommands = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-m") == 0) && (i + 1 < argc))
+            numberOfASDUs = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-p") == 0) && (i + 1 < argc))
+            tcpPort = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-u") == 0) && (i + 1 < argc))
+            unixPath = argv[++i];
+        else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+            repetitions = atoi(argv[++i]);
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((numberOfCommands < 0) || (numberOfASDUs < 1) || (repetitions < 1)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    uint64_t* rtt = (uint64_t*) calloc(numberOfCommands + 1, sizeof(uint64_t));
+
+    if (rtt == NULL) {
+        printf("Failed to allocate memory\n");
+        return 1;
+    }
+
+    printf("%i command round trips, %i ASDUs\n\n", numberOfCommands, numberOfASDUs);
+    printf("      |      command round trip (us)           |    monitoring throughput\n");
+    printf("      |     mean      p50      p99      max  fail |     ASDUs    ASDUs/s     MB/s\n");
+
+    int rep;
+
+    for (rep = 0; rep < repetitions; rep++) {
+        BenchmarkResult result;
+
+        memset(&result, 0, sizeof(result));
+        result.name = "tcp";
+        result.rtt = rtt;
+
+        if (runBenchmark(NULL, tcpPort, numberOfCommands, numberOfASDUs, &result))
+            printResult(&result);
+
+        memset(&result, 0, sizeof(result));
+        result.name = "unix";
+        result.rtt = rtt;
+
+        if (runBenchmark(unixPath, tcpPort, numberOfCommands, numberOfASDUs, &result))
+            printResult(&result);
+    }
+
+    free(rtt);
+
+    return 0;
+}
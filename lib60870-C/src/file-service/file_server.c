@@ -19,6 +19,9 @@
  *  See COPYING file for the complete license text.
  */
 
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_FILE_SERVICE
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
 #include "cs101_file_service.h"
 #include "lib_memory.h"
 #include "iec60870_slave.h"
@@ -110,6 +110,20 @@ SerialPort_discardInBuffer(SerialPort self);
 PAL_API int
 SerialPort_readByte(SerialPort self);
 
+/**
+ * \brief Read the received bytes from the interface
+ *
+ * Waits up to the timeout (see \ref SerialPort_setTimeout) for the first byte. Then all bytes
+ * that are already received (up to maxSize) are returned without waiting for more bytes.
+ *
+ * \param buffer the buffer to store the received bytes
+ * \param maxSize the maximum number of bytes to read (size of the buffer)
+ *
+ * \return number of read bytes, 0 in case of a timeout, or -1 in case of an error
+ */
+PAL_API int
+SerialPort_read(SerialPort self, uint8_t* buffer, int maxSize);
+
 /**
  * \brief Write the number of bytes from the buffer to the serial interface
  *
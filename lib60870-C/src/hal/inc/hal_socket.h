@@ -115,6 +115,109 @@ Handleset_waitReady(HandleSet self, unsigned int timeoutMs);
 PAL_API void
 Handleset_destroy(HandleSet self);
 
+#ifndef HAL_SOCKET_POLLER_DEFINED
+#define HAL_SOCKET_POLLER_DEFINED
+/** Opaque reference for a socket poller (event notification for a large number of sockets) */
+typedef struct sSocketPoller* SocketPoller;
+#endif
+
+/** socket poller event: socket is readable */
+#define SOCKET_POLLER_READ 1
+
+/** socket poller event: socket is writable (e.g. asynchronous connect completed) */
+#define SOCKET_POLLER_WRITE 2
+
+/** socket poller event: error or hang-up on the socket */
+#define SOCKET_POLLER_ERROR 4
+
+/**
+ * \brief Create a new socket poller
+ *
+ * Different to the HandleSet the sockets stay registered between the calls of
+ * \ref SocketPoller_wait and the wait function reports which sockets are ready.
+ * On Linux the poller uses epoll. This makes it suitable for thousands of sockets.
+ *
+ * \param maxEvents maximum number of events that are reported by a single call of SocketPoller_wait
+ *
+ * \return new SocketPoller instance or NULL in case of an error
+ */
+PAL_API SocketPoller
+SocketPoller_create(int maxEvents);
+
+/**
+ * \brief Add a socket to the poller
+ *
+ * \param self the SocketPoller instance
+ * \param sock the socket to add
+ * \param events the events to wait for (SOCKET_POLLER_READ and/or SOCKET_POLLER_WRITE)
+ * \param parameter user provided parameter that is reported with the events of the socket
+ *
+ * \return true when the socket has been added, false otherwise
+ */
+PAL_API bool
+SocketPoller_addSocket(SocketPoller self, const Socket sock, int events, void* parameter);
+
+/**
+ * \brief Change the events to wait for of a socket that has been added before
+ */
+PAL_API bool
+SocketPoller_modifySocket(SocketPoller self, const Socket sock, int events, void* parameter);
+
+/**
+ * \brief Remove a socket from the poller
+ *
+ * Can be called while the results of the last \ref SocketPoller_wait are handled. The indices of
+ * the other ready sockets remain valid.
+ *
+ * NOTE: has to be called before the socket is destroyed
+ */
+PAL_API void
+SocketPoller_removeSocket(SocketPoller self, const Socket sock);
+
+/**
+ * \brief Wait until at least one of the sockets is ready or the timeout expired
+ *
+ * \param self the SocketPoller instance
+ * \param timeoutMs timeout in milliseconds
+ *
+ * \return number of ready sockets (use \ref SocketPoller_getEvents and \ref SocketPoller_getParameter to
+ *         get the details), 0 on timeout, or -1 in case of an error
+ */
+PAL_API int
+SocketPoller_wait(SocketPoller self, unsigned int timeoutMs);
+
+/**
+ * \brief Interrupt a running or the next \ref SocketPoller_wait
+ *
+ * Can be called by any thread. The wait function returns without reporting an event for the wakeup.
+ *
+ * \param self the SocketPoller instance
+ */
+PAL_API void
+SocketPoller_wakeup(SocketPoller self);
+
+/**
+ * \brief Get the events of a ready socket (SOCKET_POLLER_READ, SOCKET_POLLER_WRITE, SOCKET_POLLER_ERROR)
+ *
+ * \param index index of the ready socket (0 to the return value of SocketPoller_wait - 1)
+ */
+PAL_API int
+SocketPoller_getEvents(SocketPoller self, int index);
+
+/**
+ * \brief Get the parameter of a ready socket (as provided by SocketPoller_addSocket)
+ *
+ * \param index index of the ready socket (0 to the return value of SocketPoller_wait - 1)
+ */
+PAL_API void*
+SocketPoller_getParameter(SocketPoller self, int index);
+
+/**
+ * \brief destroy the SocketPoller instance (the sockets are not closed)
+ */
+PAL_API void
+SocketPoller_destroy(SocketPoller self);
+
 /**
  * \brief Create a new TcpServerSocket instance
  *
@@ -128,6 +231,22 @@ Handleset_destroy(HandleSet self);
 PAL_API ServerSocket
 TcpServerSocket_create(const char* address, int port);
 
+/**
+ * \brief Create a new server socket for a unix domain (AF_UNIX) stream socket
+ *
+ * An existing socket file with the same path is removed. The socket file is removed
+ * when the server socket is destroyed. The peer address of accepted connections
+ * is "unix".
+ *
+ * Implementation of this function is OPTIONAL (currently only implemented for Linux).
+ *
+ * \param path the path of the socket file
+ *
+ * \return the newly created server socket instance, or NULL when not supported or in case of an error
+ */
+PAL_API ServerSocket
+UnixServerSocket_create(const char* path);
+
 PAL_API UdpSocket
 UdpSocket_create(void);
 
@@ -219,6 +338,19 @@ ServerSocket_destroy(ServerSocket self);
 PAL_API Socket
 TcpSocket_create(void);
 
+/**
+ * \brief create a unix domain (AF_UNIX) stream client socket
+ *
+ * The socket is connected with \ref Socket_connect or \ref Socket_connectAsync. The
+ * address parameter is the path of the socket file of the server, the port is ignored.
+ *
+ * Implementation of this function is OPTIONAL (currently only implemented for Linux).
+ *
+ * \return a new client socket instance, or NULL when not supported or in case of an error
+ */
+PAL_API Socket
+UnixSocket_create(void);
+
 /**
  * \brief set the timeout to establish a new connection
  *
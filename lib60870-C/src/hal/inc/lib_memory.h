@@ -12,6 +12,36 @@
 
 #include "hal_base.h"
 
+/*
+ * When CONFIG_MEMORY_ACCOUNTING is set to 1 (e.g. by the cmake option WITH_MEMORY_ACCOUNTING) the number
+ * of allocations, the allocated bytes and the peak of allocated bytes are counted for each memory tag.
+ * Source files can select the tag for their allocations by defining MEMORY_ACCOUNTING_TAG before including
+ * this file. Each allocation then requires 16 additional bytes.
+ */
+#ifndef CONFIG_MEMORY_ACCOUNTING
+#define CONFIG_MEMORY_ACCOUNTING 0
+#endif
+
+#define MEMORY_ACCOUNTING_MAX_TAGS 8
+
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+
+#ifndef MEMORY_ACCOUNTING_TAG
+#define MEMORY_ACCOUNTING_TAG 0
+#endif
+
+#define CALLOC(nmemb, size) Memory_callocTagged(nmemb, size, MEMORY_ACCOUNTING_TAG)
+#define MALLOC(size)        Memory_mallocTagged(size, MEMORY_ACCOUNTING_TAG)
+#define REALLOC(oldptr, size)   Memory_reallocTagged(oldptr, size, MEMORY_ACCOUNTING_TAG)
+#define FREEMEM(ptr)        Memory_free(ptr)
+
+#define GLOBAL_CALLOC(nmemb, size) Memory_callocTagged(nmemb, size, MEMORY_ACCOUNTING_TAG)
+#define GLOBAL_MALLOC(size)        Memory_mallocTagged(size, MEMORY_ACCOUNTING_TAG)
+#define GLOBAL_REALLOC(oldptr, size)   Memory_reallocTagged(oldptr, size, MEMORY_ACCOUNTING_TAG)
+#define GLOBAL_FREEMEM(ptr)        Memory_free(ptr)
+
+#else
+
 #define CALLOC(nmemb, size) Memory_calloc(nmemb, size)
 #define MALLOC(size)        Memory_malloc(size)
 #define REALLOC(oldptr, size)   Memory_realloc(oldptr, size)
@@ -22,6 +52,8 @@
 #define GLOBAL_REALLOC(oldptr, size)   Memory_realloc(oldptr, size)
 #define GLOBAL_FREEMEM(ptr)        Memory_free(ptr)
 
+#endif /* (CONFIG_MEMORY_ACCOUNTING == 1) */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,6 +66,29 @@ typedef void
 PAL_API void
 Memory_installExceptionHandler(MemoryExceptionHandler handler, void* parameter);
 
+/**
+ * \brief Memory allocator used by the library
+ *
+ * The realloc function is only called with a ptr that is not NULL and a size that is not 0.
+ */
+typedef struct {
+    void* (*mallocFunction) (void* parameter, size_t size);
+    void* (*reallocFunction) (void* parameter, void* ptr, size_t size);
+    void (*freeFunction) (void* parameter, void* ptr);
+    void* parameter;
+} sMemoryAllocator;
+
+/**
+ * \brief Install an allocator for all memory allocations of the library
+ *
+ * NOTE: Has to be called before any library object is created (or after all library objects
+ * are released) because memory has to be released by the same allocator it was allocated with.
+ *
+ * \param allocator the allocator (will be copied) or NULL to use the C library functions
+ */
+PAL_API void
+Memory_installAllocator(const sMemoryAllocator* allocator);
+
 PAL_API void*
 Memory_malloc(size_t size);
 
@@ -46,6 +101,87 @@ Memory_realloc(void *ptr, size_t size);
 PAL_API void
 Memory_free(void* memb);
 
+PAL_API void*
+Memory_mallocTagged(size_t size, int tag);
+
+PAL_API void*
+Memory_callocTagged(size_t nmemb, size_t size, int tag);
+
+PAL_API void*
+Memory_reallocTagged(void* ptr, size_t size, int tag);
+
+/**
+ * \brief Memory statistics of a memory tag
+ */
+typedef struct {
+    size_t allocations; /**< number of allocations (including reallocations) */
+    size_t frees; /**< number of released memory blocks */
+    size_t bytesInUse; /**< currently allocated bytes */
+    size_t peakBytesInUse; /**< maximum of allocated bytes */
+} sMemoryStatistics;
+
+/**
+ * \brief Get the memory statistics of a memory tag
+ *
+ * In lib60870 the memory tags are the log subsystems (e.g. LIB60870_LOG_CS104_CLIENT).
+ *
+ * \param tag the memory tag (0 .. MEMORY_ACCOUNTING_MAX_TAGS - 1)
+ * \param stats the structure where the statistics are stored
+ *
+ * \return true when the statistics are available, false when the library is compiled without
+ *         CONFIG_MEMORY_ACCOUNTING or the tag is invalid
+ */
+PAL_API bool
+Memory_getStatistics(int tag, sMemoryStatistics* stats);
+
+/**
+ * \brief Memory pool with size classes for small memory blocks
+ *
+ * Blocks of up to 512 bytes are taken from free lists of the size classes 32, 64, 128, 256
+ * and 512 bytes. Released blocks are kept in the free lists and only returned to the C library
+ * when the pool is destroyed. Larger blocks are allocated with the C library functions.
+ *
+ * The pool can be used by multiple threads.
+ */
+typedef struct sMemoryPool* MemoryPool;
+
+/**
+ * \brief Statistics of a memory pool
+ */
+typedef struct {
+    size_t poolAllocations; /**< allocations that are handled by the size classes */
+    size_t largeAllocations; /**< allocations that are too large for the size classes */
+    size_t blocksInUse; /**< blocks of the size classes that are in use */
+    size_t blocksAllocated; /**< blocks of the size classes that are allocated from the C library */
+} sMemoryPoolStatistics;
+
+/**
+ * \brief Create a new memory pool
+ *
+ * NOTE: Create and destroy the pool when it is not installed as allocator.
+ *
+ * \param blocksPerChunk number of blocks that are allocated together when a size class has no free block
+ *
+ * \return the new memory pool instance
+ */
+PAL_API MemoryPool
+MemoryPool_create(int blocksPerChunk);
+
+/**
+ * \brief Get an allocator that uses the memory pool (to be used with \ref Memory_installAllocator)
+ */
+PAL_API void
+MemoryPool_getAllocator(MemoryPool self, sMemoryAllocator* allocator);
+
+PAL_API void
+MemoryPool_getStatistics(MemoryPool self, sMemoryPoolStatistics* stats);
+
+/**
+ * \brief Release the memory pool and all memory blocks of the pool
+ */
+PAL_API void
+MemoryPool_destroy(MemoryPool self);
+
 #ifdef __cplusplus
 }
 #endif
@@ -68,6 +68,26 @@ TLSSocket_create(Socket socket, TLSConfiguration configuration, bool storeClient
 PAL_API bool
 TLSSocket_performHandshake(TLSSocket self);
 
+/**
+ * \brief Handler for the debug messages of the TLS layer
+ *
+ * \param parameter user provided parameter
+ * \param message the formatted message, starting with the ID of the source (e.g. "TLS: ")
+ */
+typedef void (*TLSSocket_DebugHandler)(void* parameter, const char* message);
+
+/**
+ * \brief Set the handler for the debug messages of the TLS layer
+ *
+ * The debug messages are only formatted when a handler is set. The handler can be called
+ * by any thread that uses the TLS layer.
+ *
+ * \param handler the handler, or NULL to disable the debug messages
+ * \param parameter user provided parameter that is passed to the handler
+ */
+PAL_API void
+TLSSocket_setDebugHandler(TLSSocket_DebugHandler handler, void* parameter);
+
 /**
  * \brief Access the certificate used by the peer
  *
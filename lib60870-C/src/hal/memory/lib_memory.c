@@ -8,7 +8,9 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "lib_memory.h"
+#include "hal_thread.h"
 
 static MemoryExceptionHandler exceptionHandler = NULL;
 static void* exceptionHandlerParameter = NULL;
@@ -27,44 +29,502 @@ Memory_installExceptionHandler(MemoryExceptionHandler handler, void* parameter)
     exceptionHandlerParameter = parameter;
 }
 
+/**********************************************
+ * Allocator
+ **********************************************/
+
+static void*
+defaultMalloc(void* parameter, size_t size)
+{
+    (void) parameter;
+
+    return malloc(size);
+}
+
+static void*
+defaultRealloc(void* parameter, void* ptr, size_t size)
+{
+    (void) parameter;
+
+    return realloc(ptr, size);
+}
+
+static void
+defaultFree(void* parameter, void* ptr)
+{
+    (void) parameter;
+
+    free(ptr);
+}
+
+static sMemoryAllocator allocator = {
+    defaultMalloc,
+    defaultRealloc,
+    defaultFree,
+    NULL
+};
+
+void
+Memory_installAllocator(const sMemoryAllocator* newAllocator)
+{
+    if (newAllocator) {
+        allocator = *newAllocator;
+    }
+    else {
+        allocator.mallocFunction = defaultMalloc;
+        allocator.reallocFunction = defaultRealloc;
+        allocator.freeFunction = defaultFree;
+        allocator.parameter = NULL;
+    }
+}
+
+/**********************************************
+ * Memory accounting
+ **********************************************/
+
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+
+/* stored in front of each memory block to know the size and tag when the block is released */
+typedef union {
+    struct {
+        size_t size;
+        int tag;
+    } info;
+    uint64_t align[2];
+} AccountingHeader;
+
+static sMemoryStatistics statistics[MEMORY_ACCOUNTING_MAX_TAGS];
+
+#if defined(__GNUC__) || defined(__clang__)
+#define STATISTICS_ADD(ptr, value) __atomic_add_fetch((ptr), (value), __ATOMIC_RELAXED)
+#define STATISTICS_SUB(ptr, value) __atomic_sub_fetch((ptr), (value), __ATOMIC_RELAXED)
+#define STATISTICS_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define STATISTICS_CAS(ptr, expectedPtr, desired) \
+    __atomic_compare_exchange_n((ptr), (expectedPtr), (desired), 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#else
+/* without atomic operations the statistics are only exact when a single thread allocates memory */
+#define STATISTICS_ADD(ptr, value) (*(ptr) += (value))
+#define STATISTICS_SUB(ptr, value) (*(ptr) -= (value))
+#define STATISTICS_LOAD(ptr) (*(ptr))
+#define STATISTICS_CAS(ptr, expectedPtr, desired) ((*(ptr) = (desired)), 1)
+#endif
+
+static int
+checkTag(int tag)
+{
+    if ((tag < 0) || (tag >= MEMORY_ACCOUNTING_MAX_TAGS))
+        return 0;
+    else
+        return tag;
+}
+
+static void
+addAllocation(int tag, size_t size)
+{
+    sMemoryStatistics* stats = &(statistics[tag]);
+
+    STATISTICS_ADD(&(stats->allocations), 1);
+
+    size_t bytesInUse = STATISTICS_ADD(&(stats->bytesInUse), size);
+    size_t peak = STATISTICS_LOAD(&(stats->peakBytesInUse));
+
+    while (bytesInUse > peak) {
+        if (STATISTICS_CAS(&(stats->peakBytesInUse), &peak, bytesInUse))
+            break;
+    }
+}
+
+#endif /* (CONFIG_MEMORY_ACCOUNTING == 1) */
+
+bool
+Memory_getStatistics(int tag, sMemoryStatistics* stats)
+{
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+    if ((tag < 0) || (tag >= MEMORY_ACCOUNTING_MAX_TAGS))
+        return false;
+
+    stats->allocations = STATISTICS_LOAD(&(statistics[tag].allocations));
+    stats->frees = STATISTICS_LOAD(&(statistics[tag].frees));
+    stats->bytesInUse = STATISTICS_LOAD(&(statistics[tag].bytesInUse));
+    stats->peakBytesInUse = STATISTICS_LOAD(&(statistics[tag].peakBytesInUse));
+
+    return true;
+#else
+    (void) tag;
+    (void) stats;
+
+    return false;
+#endif
+}
+
+/**********************************************
+ * Memory functions
+ **********************************************/
+
 void*
-Memory_malloc(size_t size)
+Memory_mallocTagged(size_t size, int tag)
 {
-    void* memory = malloc(size);
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+    tag = checkTag(tag);
+
+    AccountingHeader* header = (AccountingHeader*) allocator.mallocFunction(allocator.parameter, sizeof(AccountingHeader) + size);
+
+    if (header == NULL) {
+        noMemoryAvailableHandler();
+        return NULL;
+    }
+
+    header->info.size = size;
+    header->info.tag = tag;
+
+    addAllocation(tag, size);
+
+    return (void*) (header + 1);
+#else
+    (void) tag;
+
+    void* memory = allocator.mallocFunction(allocator.parameter, size);
 
     if (memory == NULL)
         noMemoryAvailableHandler();
 
     return memory;
+#endif
 }
 
+void*
+Memory_callocTagged(size_t nmemb, size_t size, int tag)
+{
+    if ((size != 0) && (nmemb > ((size_t) -1) / size)) {
+        noMemoryAvailableHandler();
+        return NULL;
+    }
+
+    void* memory = Memory_mallocTagged(nmemb * size, tag);
+
+    if (memory != NULL)
+        memset(memory, 0, nmemb * size);
+
+    return memory;
+}
 
 void*
-Memory_calloc(size_t nmemb, size_t size)
+Memory_reallocTagged(void* ptr, size_t size, int tag)
 {
-    void* memory = calloc(nmemb, size);
+    if (ptr == NULL)
+        return Memory_mallocTagged(size, tag);
+
+    if (size == 0) {
+        Memory_free(ptr);
+        return NULL;
+    }
+
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+    tag = checkTag(tag);
+
+    AccountingHeader* header = ((AccountingHeader*) ptr) - 1;
+
+    size_t oldSize = header->info.size;
+    int oldTag = header->info.tag;
+
+    header = (AccountingHeader*) allocator.reallocFunction(allocator.parameter, header, sizeof(AccountingHeader) + size);
+
+    if (header == NULL) {
+        noMemoryAvailableHandler();
+        return NULL;
+    }
+
+    STATISTICS_SUB(&(statistics[oldTag].bytesInUse), oldSize);
+
+    header->info.size = size;
+    header->info.tag = tag;
+
+    addAllocation(tag, size);
+
+    return (void*) (header + 1);
+#else
+    (void) tag;
+
+    void* memory = allocator.reallocFunction(allocator.parameter, ptr, size);
 
     if (memory == NULL)
         noMemoryAvailableHandler();
 
     return memory;
+#endif
+}
+
+void*
+Memory_malloc(size_t size)
+{
+    return Memory_mallocTagged(size, 0);
+}
+
+
+void*
+Memory_calloc(size_t nmemb, size_t size)
+{
+    return Memory_callocTagged(nmemb, size, 0);
 }
 
 
 void *
 Memory_realloc(void *ptr, size_t size)
 {
-    void* memory = realloc(ptr, size);
+    return Memory_reallocTagged(ptr, size, 0);
+}
 
-    if (memory == NULL)
-        noMemoryAvailableHandler();
+void
+Memory_free(void* memb)
+{
+    if (memb == NULL)
+        return;
 
-    return memory;
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+    AccountingHeader* header = ((AccountingHeader*) memb) - 1;
+
+    sMemoryStatistics* stats = &(statistics[header->info.tag]);
+
+    STATISTICS_ADD(&(stats->frees), 1);
+    STATISTICS_SUB(&(stats->bytesInUse), header->info.size);
+
+    allocator.freeFunction(allocator.parameter, header);
+#else
+    allocator.freeFunction(allocator.parameter, memb);
+#endif
+}
+
+/**********************************************
+ * MemoryPool
+ **********************************************/
+
+#define POOL_SIZE_CLASSES 5
+
+static const size_t poolBlockSizes[POOL_SIZE_CLASSES] = { 32, 64, 128, 256, 512 };
+
+typedef union uPoolBlockHeader PoolBlockHeader;
+
+/* stored in front of each memory block of the pool */
+union uPoolBlockHeader {
+    struct {
+        int sizeClass; /* -1 for blocks that are too large for the size classes */
+        union {
+            PoolBlockHeader* next; /* next block in the free list */
+            size_t size; /* size of large blocks */
+        } u;
+    } info;
+    uint64_t align[2];
+};
+
+typedef union uPoolChunk PoolChunk;
+
+union uPoolChunk {
+    PoolChunk* next;
+    uint64_t align[2];
+};
+
+struct sMemoryPool {
+    Semaphore lock;
+    int blocksPerChunk;
+    PoolBlockHeader* freeLists[POOL_SIZE_CLASSES];
+    PoolChunk* chunks;
+    sMemoryPoolStatistics statistics;
+};
+
+static int
+getSizeClass(size_t size)
+{
+    int i;
+
+    for (i = 0; i < POOL_SIZE_CLASSES; i++) {
+        if (size <= poolBlockSizes[i])
+            return i;
+    }
+
+    return -1;
+}
+
+/* has to be called with the lock */
+static bool
+addChunk(MemoryPool self, int sizeClass)
+{
+    size_t blockSize = sizeof(PoolBlockHeader) + poolBlockSizes[sizeClass];
+
+    /* chunks are allocated with the C library to be independent of the installed allocator */
+    PoolChunk* chunk = (PoolChunk*) malloc(sizeof(PoolChunk) + (blockSize * self->blocksPerChunk));
+
+    if (chunk == NULL)
+        return false;
+
+    chunk->next = self->chunks;
+    self->chunks = chunk;
+
+    uint8_t* block = (uint8_t*) (chunk + 1);
+
+    int i;
+
+    for (i = 0; i < self->blocksPerChunk; i++) {
+        PoolBlockHeader* header = (PoolBlockHeader*) block;
+
+        header->info.sizeClass = sizeClass;
+        header->info.u.next = self->freeLists[sizeClass];
+        self->freeLists[sizeClass] = header;
+
+        block += blockSize;
+    }
+
+    self->statistics.blocksAllocated += self->blocksPerChunk;
+
+    return true;
+}
+
+static void*
+MemoryPool_malloc(void* parameter, size_t size)
+{
+    MemoryPool self = (MemoryPool) parameter;
+
+    PoolBlockHeader* header;
+
+    int sizeClass = getSizeClass(size);
+
+    if (sizeClass == -1) {
+        header = (PoolBlockHeader*) malloc(sizeof(PoolBlockHeader) + size);
+
+        if (header == NULL)
+            return NULL;
+
+        header->info.sizeClass = -1;
+        header->info.u.size = size;
+
+        Semaphore_wait(self->lock);
+        self->statistics.largeAllocations++;
+        Semaphore_post(self->lock);
+
+        return (void*) (header + 1);
+    }
+
+    Semaphore_wait(self->lock);
+
+    if (self->freeLists[sizeClass] == NULL)
+        addChunk(self, sizeClass);
+
+    header = self->freeLists[sizeClass];
+
+    if (header) {
+        self->freeLists[sizeClass] = header->info.u.next;
+
+        self->statistics.poolAllocations++;
+        self->statistics.blocksInUse++;
+    }
+
+    Semaphore_post(self->lock);
+
+    if (header)
+        return (void*) (header + 1);
+    else
+        return NULL;
+}
+
+static void
+MemoryPool_free(void* parameter, void* ptr)
+{
+    MemoryPool self = (MemoryPool) parameter;
+
+    if (ptr == NULL)
+        return;
+
+    PoolBlockHeader* header = ((PoolBlockHeader*) ptr) - 1;
+
+    if (header->info.sizeClass == -1) {
+        free(header);
+    }
+    else {
+        Semaphore_wait(self->lock);
+
+        header->info.u.next = self->freeLists[header->info.sizeClass];
+        self->freeLists[header->info.sizeClass] = header;
+
+        self->statistics.blocksInUse--;
+
+        Semaphore_post(self->lock);
+    }
+}
+
+static void*
+MemoryPool_realloc(void* parameter, void* ptr, size_t size)
+{
+    PoolBlockHeader* header = ((PoolBlockHeader*) ptr) - 1;
+
+    size_t oldSize;
+
+    if (header->info.sizeClass == -1)
+        oldSize = header->info.u.size;
+    else
+        oldSize = poolBlockSizes[header->info.sizeClass];
+
+    /* block is large enough */
+    if ((header->info.sizeClass != -1) && (size <= oldSize))
+        return ptr;
+
+    void* newPtr = MemoryPool_malloc(parameter, size);
+
+    if (newPtr) {
+        memcpy(newPtr, ptr, (size < oldSize) ? size : oldSize);
+
+        MemoryPool_free(parameter, ptr);
+    }
+
+    return newPtr;
+}
+
+MemoryPool
+MemoryPool_create(int blocksPerChunk)
+{
+    MemoryPool self = (MemoryPool) GLOBAL_CALLOC(1, sizeof(struct sMemoryPool));
+
+    if (self) {
+        self->lock = Semaphore_create(1);
+        self->blocksPerChunk = (blocksPerChunk > 0) ? blocksPerChunk : 1;
+    }
+
+    return self;
 }
 
 void
-Memory_free(void* memb)
+MemoryPool_getAllocator(MemoryPool self, sMemoryAllocator* poolAllocator)
 {
-    free(memb);
+    poolAllocator->mallocFunction = MemoryPool_malloc;
+    poolAllocator->reallocFunction = MemoryPool_realloc;
+    poolAllocator->freeFunction = MemoryPool_free;
+    poolAllocator->parameter = self;
 }
 
+void
+MemoryPool_getStatistics(MemoryPool self, sMemoryPoolStatistics* stats)
+{
+    Semaphore_wait(self->lock);
+
+    *stats = self->statistics;
+
+    Semaphore_post(self->lock);
+}
+
+void
+MemoryPool_destroy(MemoryPool self)
+{
+    if (self) {
+        PoolChunk* chunk = self->chunks;
+
+        while (chunk) {
+            PoolChunk* next = chunk->next;
+
+            free(chunk);
+
+            chunk = next;
+        }
+
+        Semaphore_destroy(self->lock);
+
+        GLOBAL_FREEMEM(self);
+    }
+}
@@ -15,6 +15,7 @@
 #include <termios.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <errno.h>
 #include <sys/time.h>
 #include <sys/select.h>
 
@@ -228,12 +229,15 @@ SerialPort_readByte(SerialPort self)
     uint8_t buf[1];
     fd_set set;
 
+    /* select can modify the timeout argument */
+    struct timeval timeout = self->timeout;
+
     self->lastError = SERIAL_PORT_ERROR_NONE;
 
     FD_ZERO(&set);
     FD_SET(self->fd, &set);
 
-    int ret = select(self->fd + 1, &set, NULL, NULL, &(self->timeout));
+    int ret = select(self->fd + 1, &set, NULL, NULL, &timeout);
 
     if (ret == -1) {
         self->lastError = SERIAL_PORT_ERROR_UNKNOWN;
@@ -248,6 +252,41 @@ SerialPort_readByte(SerialPort self)
     }
 }
 
+int
+SerialPort_read(SerialPort self, uint8_t* buffer, int maxSize)
+{
+    fd_set set;
+
+    /* select can modify the timeout argument */
+    struct timeval timeout = self->timeout;
+
+    self->lastError = SERIAL_PORT_ERROR_NONE;
+
+    FD_ZERO(&set);
+    FD_SET(self->fd, &set);
+
+    int ret = select(self->fd + 1, &set, NULL, NULL, &timeout);
+
+    if (ret == -1) {
+        self->lastError = SERIAL_PORT_ERROR_UNKNOWN;
+        return -1;
+    }
+    else if (ret == 0)
+        return 0;
+
+    ssize_t readBytes = read(self->fd, buffer, maxSize);
+
+    if (readBytes == -1) {
+        if ((errno == EAGAIN) || (errno == EINTR))
+            return 0;
+
+        self->lastError = SERIAL_PORT_ERROR_UNKNOWN;
+        return -1;
+    }
+
+    return (int) readBytes;
+}
+
 int
 SerialPort_write(SerialPort self, uint8_t* buffer, int startPos, int bufSize)
 {
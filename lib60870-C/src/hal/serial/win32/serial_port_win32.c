@@ -245,6 +245,41 @@ SerialPort_readByte(SerialPort self)
 		return (int) buf[0];
 }
 
+int
+SerialPort_read(SerialPort self, uint8_t* buffer, int maxSize)
+{
+	/* wait for the first byte */
+	int firstByte = SerialPort_readByte(self);
+
+	if (firstByte == -1) {
+		if (self->lastError == SERIAL_PORT_ERROR_NONE)
+			return 0;
+		else
+			return -1;
+	}
+
+	buffer[0] = (uint8_t) firstByte;
+
+	int readBytes = 1;
+
+	/* read the other bytes that are already received without waiting */
+	DWORD errors;
+	COMSTAT comStat;
+
+	if ((maxSize > 1) && ClearCommError(self->comPort, &errors, &comStat) && (comStat.cbInQue > 0)) {
+		DWORD bytesToRead = comStat.cbInQue;
+		DWORD bytesRead = 0;
+
+		if (bytesToRead > (DWORD) (maxSize - 1))
+			bytesToRead = (DWORD) (maxSize - 1);
+
+		if (ReadFile(self->comPort, buffer + 1, bytesToRead, &bytesRead, NULL))
+			readBytes += (int) bytesRead;
+	}
+
+	return readBytes;
+}
+
 int
 SerialPort_write(SerialPort self, uint8_t* buffer, int startPos, int bufSize)
 {
@@ -160,6 +160,288 @@ Handleset_destroy(HandleSet self)
     }
 }
 
+/* poll based implementation of the socket poller - the first entry is the read end of the wakeup pipe */
+struct sSocketPoller {
+    struct pollfd* fds;
+    void** parameters;
+    int nfds;
+    int maxFds;
+    int removedFds; /* removed entries that are compacted by the next wait */
+
+    int wakeupPipe[2];
+
+    /* indices of the ready sockets */
+    int* readyIndices;
+    int maxEvents;
+};
+
+static bool
+setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    return (flags != -1) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1) && (fcntl(fd, F_SETFD, FD_CLOEXEC) != -1);
+}
+
+SocketPoller
+SocketPoller_create(int maxEvents)
+{
+    SocketPoller self = (SocketPoller) GLOBAL_CALLOC(1, sizeof(struct sSocketPoller));
+
+    if (self) {
+        if (maxEvents < 1)
+            maxEvents = 1;
+
+        self->maxEvents = maxEvents;
+        self->readyIndices = (int*) GLOBAL_CALLOC(maxEvents, sizeof(int));
+
+        self->maxFds = 16;
+        self->fds = (struct pollfd*) GLOBAL_CALLOC(self->maxFds, sizeof(struct pollfd));
+        self->parameters = (void**) GLOBAL_CALLOC(self->maxFds, sizeof(void*));
+
+        self->wakeupPipe[0] = -1;
+        self->wakeupPipe[1] = -1;
+
+        bool wakeupCreated = false;
+
+        if (pipe(self->wakeupPipe) == 0)
+            wakeupCreated = setNonBlocking(self->wakeupPipe[0]) && setNonBlocking(self->wakeupPipe[1]);
+
+        if ((wakeupCreated == false) || (self->readyIndices == NULL) || (self->fds == NULL) ||
+                (self->parameters == NULL))
+        {
+            if (DEBUG_SOCKET)
+                printf("SOCKET: failed to create socket poller (errno: %i)\n", errno);
+
+            SocketPoller_destroy(self);
+            return NULL;
+        }
+
+        self->fds[0].fd = self->wakeupPipe[0];
+        self->fds[0].events = POLLIN;
+        self->fds[0].revents = 0;
+        self->parameters[0] = NULL;
+        self->nfds = 1;
+    }
+
+    return self;
+}
+
+static int
+getPollEvents(int events)
+{
+    int pollEvents = 0;
+
+    if (events & SOCKET_POLLER_READ)
+        pollEvents |= POLLIN;
+
+    if (events & SOCKET_POLLER_WRITE)
+        pollEvents |= POLLOUT;
+
+    return pollEvents;
+}
+
+static int
+findPollerSocket(SocketPoller self, const Socket sock)
+{
+    int i;
+
+    for (i = 1; i < self->nfds; i++) {
+        if (self->fds[i].fd == sock->fd)
+            return i;
+    }
+
+    return -1;
+}
+
+bool
+SocketPoller_addSocket(SocketPoller self, const Socket sock, int events, void* parameter)
+{
+    if ((self == NULL) || (sock == NULL) || (sock->fd == -1))
+        return false;
+
+    if (self->nfds == self->maxFds) {
+        int newSize = (self->maxFds == 0) ? 16 : (self->maxFds * 2);
+
+        struct pollfd* newFds = (struct pollfd*) GLOBAL_REALLOC(self->fds, newSize * sizeof(struct pollfd));
+
+        if (newFds == NULL)
+            return false;
+
+        self->fds = newFds;
+
+        void** newParameters = (void**) GLOBAL_REALLOC(self->parameters, newSize * sizeof(void*));
+
+        if (newParameters == NULL)
+            return false;
+
+        self->parameters = newParameters;
+        self->maxFds = newSize;
+    }
+
+    self->fds[self->nfds].fd = sock->fd;
+    self->fds[self->nfds].events = getPollEvents(events);
+    self->fds[self->nfds].revents = 0;
+    self->parameters[self->nfds] = parameter;
+    self->nfds++;
+
+    return true;
+}
+
+bool
+SocketPoller_modifySocket(SocketPoller self, const Socket sock, int events, void* parameter)
+{
+    if ((self == NULL) || (sock == NULL))
+        return false;
+
+    int index = findPollerSocket(self, sock);
+
+    if (index == -1)
+        return false;
+
+    self->fds[index].events = getPollEvents(events);
+    self->parameters[index] = parameter;
+
+    return true;
+}
+
+void
+SocketPoller_removeSocket(SocketPoller self, const Socket sock)
+{
+    if ((self == NULL) || (sock == NULL))
+        return;
+
+    int index = findPollerSocket(self, sock);
+
+    if (index != -1) {
+        /* the entry is only marked - the ready indices of the last wait have to remain valid */
+        self->fds[index].fd = -1;
+        self->fds[index].events = 0;
+        self->fds[index].revents = 0;
+        self->parameters[index] = NULL;
+        self->removedFds++;
+    }
+}
+
+/* remove the entries of removed sockets */
+static void
+compactPollerSockets(SocketPoller self)
+{
+    int i;
+    int count = 0;
+
+    for (i = 0; i < self->nfds; i++) {
+        if (self->fds[i].fd != -1) {
+            self->fds[count] = self->fds[i];
+            self->parameters[count] = self->parameters[i];
+            count++;
+        }
+    }
+
+    self->nfds = count;
+    self->removedFds = 0;
+}
+
+int
+SocketPoller_wait(SocketPoller self, unsigned int timeoutMs)
+{
+    if (self->removedFds > 0)
+        compactPollerSockets(self);
+
+    int result = poll(self->fds, self->nfds, timeoutMs);
+
+    if (result == -1) {
+        if (errno == EINTR)
+            return 0;
+
+        if (DEBUG_SOCKET)
+            printf("SOCKET: poll error (errno: %i)\n", errno);
+
+        return -1;
+    }
+
+    if (self->fds[0].revents != 0) {
+        uint8_t buffer[64];
+
+        while (read(self->wakeupPipe[0], buffer, sizeof(buffer)) > 0);
+    }
+
+    int readyCount = 0;
+    int i;
+
+    for (i = 1; (i < self->nfds) && (readyCount < self->maxEvents); i++) {
+        if (self->fds[i].revents != 0)
+            self->readyIndices[readyCount++] = i;
+    }
+
+    return readyCount;
+}
+
+void
+SocketPoller_wakeup(SocketPoller self)
+{
+    uint8_t value = 1;
+
+    /* fails with EAGAIN when the pipe is full - wakeup is already pending */
+    if (write(self->wakeupPipe[1], &value, 1) == -1) {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: failed to write wakeup event (errno: %i)\n", errno);
+    }
+}
+
+int
+SocketPoller_getEvents(SocketPoller self, int index)
+{
+    int events = 0;
+
+    if ((index >= 0) && (index < self->maxEvents)) {
+        int revents = self->fds[self->readyIndices[index]].revents;
+
+        if (revents & POLLIN)
+            events |= SOCKET_POLLER_READ;
+
+        if (revents & POLLOUT)
+            events |= SOCKET_POLLER_WRITE;
+
+        if (revents & (POLLERR | POLLHUP | POLLNVAL))
+            events |= SOCKET_POLLER_ERROR;
+    }
+
+    return events;
+}
+
+void*
+SocketPoller_getParameter(SocketPoller self, int index)
+{
+    if ((index >= 0) && (index < self->maxEvents))
+        return self->parameters[self->readyIndices[index]];
+    else
+        return NULL;
+}
+
+void
+SocketPoller_destroy(SocketPoller self)
+{
+    if (self) {
+        if (self->fds)
+            GLOBAL_FREEMEM(self->fds);
+
+        if (self->parameters)
+            GLOBAL_FREEMEM(self->parameters);
+
+        if (self->readyIndices)
+            GLOBAL_FREEMEM(self->readyIndices);
+
+        if (self->wakeupPipe[0] != -1)
+            close(self->wakeupPipe[0]);
+
+        if (self->wakeupPipe[1] != -1)
+            close(self->wakeupPipe[1]);
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
 void
 Socket_activateTcpKeepAlive(Socket self, int idleTime, int interval, int count)
 {
@@ -364,6 +646,22 @@ TcpSocket_create()
     return self;
 }
 
+ServerSocket
+UnixServerSocket_create(const char* path)
+{
+    /* unix domain sockets are not supported */
+    (void) path;
+
+    return NULL;
+}
+
+Socket
+UnixSocket_create(void)
+{
+    /* unix domain sockets are not supported */
+    return NULL;
+}
+
 void
 Socket_setConnectTimeout(Socket self, uint32_t timeoutInMs)
 {
@@ -11,6 +11,8 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <string.h>
@@ -25,6 +27,8 @@
 #define _GNU_SOURCE
 #include <signal.h>
 #include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 
 #include "linked_list.h"
@@ -35,14 +39,19 @@
 #define DEBUG_SOCKET 0
 #endif
 
+/* peer address of unix domain socket connections (the peer socket usually has no name) */
+#define UNIX_PEER_ADDRESS "unix"
+
 struct sSocket {
     int fd;
     uint32_t connectTimeout;
+    int domain; /* AF_INET or AF_UNIX (only for client sockets) */
 };
 
 struct sServerSocket {
     int fd;
     int backLog;
+    char* unixPath; /* path of the socket file (NULL for TCP server sockets) */
 };
 
 struct sUdpSocket {
@@ -168,6 +177,198 @@ Handleset_destroy(HandleSet self)
     }
 }
 
+struct sSocketPoller {
+    int epollFd;
+    int wakeupFd; /* eventfd for SocketPoller_wakeup - reported with the poller as parameter */
+    struct epoll_event* events;
+    int maxEvents;
+};
+
+SocketPoller
+SocketPoller_create(int maxEvents)
+{
+    SocketPoller self = (SocketPoller) GLOBAL_MALLOC(sizeof(struct sSocketPoller));
+
+    if (self) {
+        if (maxEvents < 1)
+            maxEvents = 1;
+
+        self->maxEvents = maxEvents;
+        self->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        self->wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        self->events = (struct epoll_event*) GLOBAL_CALLOC(maxEvents, sizeof(struct epoll_event));
+
+        bool wakeupRegistered = false;
+
+        if ((self->epollFd != -1) && (self->wakeupFd != -1)) {
+            struct epoll_event event;
+
+            memset(&event, 0, sizeof(event));
+
+            event.events = EPOLLIN;
+            event.data.ptr = self;
+
+            wakeupRegistered = (epoll_ctl(self->epollFd, EPOLL_CTL_ADD, self->wakeupFd, &event) == 0);
+        }
+
+        if ((wakeupRegistered == false) || (self->events == NULL)) {
+            if (DEBUG_SOCKET)
+                printf("SOCKET: failed to create epoll instance (errno: %i)\n", errno);
+
+            SocketPoller_destroy(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+static bool
+updatePollerSocket(SocketPoller self, const Socket sock, int op, int events, void* parameter)
+{
+    struct epoll_event event;
+
+    if ((self == NULL) || (sock == NULL) || (sock->fd == -1))
+        return false;
+
+    memset(&event, 0, sizeof(event));
+
+    if (events & SOCKET_POLLER_READ)
+        event.events |= EPOLLIN;
+
+    if (events & SOCKET_POLLER_WRITE)
+        event.events |= EPOLLOUT;
+
+    event.data.ptr = parameter;
+
+    if (epoll_ctl(self->epollFd, op, sock->fd, &event) == -1) {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: epoll_ctl failed (errno: %i)\n", errno);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool
+SocketPoller_addSocket(SocketPoller self, const Socket sock, int events, void* parameter)
+{
+    return updatePollerSocket(self, sock, EPOLL_CTL_ADD, events, parameter);
+}
+
+bool
+SocketPoller_modifySocket(SocketPoller self, const Socket sock, int events, void* parameter)
+{
+    return updatePollerSocket(self, sock, EPOLL_CTL_MOD, events, parameter);
+}
+
+void
+SocketPoller_removeSocket(SocketPoller self, const Socket sock)
+{
+    if ((self != NULL) && (sock != NULL) && (sock->fd != -1)) {
+        struct epoll_event event;
+
+        /* event argument is required by kernels before 2.6.9 */
+        epoll_ctl(self->epollFd, EPOLL_CTL_DEL, sock->fd, &event);
+    }
+}
+
+int
+SocketPoller_wait(SocketPoller self, unsigned int timeoutMs)
+{
+    int result = epoll_wait(self->epollFd, self->events, self->maxEvents, (int) timeoutMs);
+
+    if (result == -1) {
+        if (errno == EINTR)
+            return 0;
+
+        if (DEBUG_SOCKET)
+            printf("SOCKET: epoll_wait error (errno: %i)\n", errno);
+    }
+    else {
+        int i;
+
+        /* remove the wakeup event from the results */
+        for (i = 0; i < result; i++) {
+            if (self->events[i].data.ptr == self) {
+                uint64_t value;
+
+                if (read(self->wakeupFd, &value, sizeof(value)) == -1) {
+                    if (DEBUG_SOCKET)
+                        printf("SOCKET: failed to read wakeup event (errno: %i)\n", errno);
+                }
+
+                result--;
+                self->events[i] = self->events[result];
+
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+void
+SocketPoller_wakeup(SocketPoller self)
+{
+    uint64_t value = 1;
+
+    if (write(self->wakeupFd, &value, sizeof(value)) == -1) {
+        /* counter overflow (EAGAIN) - wakeup is already pending */
+        if (DEBUG_SOCKET)
+            printf("SOCKET: failed to write wakeup event (errno: %i)\n", errno);
+    }
+}
+
+int
+SocketPoller_getEvents(SocketPoller self, int index)
+{
+    int events = 0;
+
+    if ((index >= 0) && (index < self->maxEvents)) {
+        uint32_t epollEvents = self->events[index].events;
+
+        if (epollEvents & EPOLLIN)
+            events |= SOCKET_POLLER_READ;
+
+        if (epollEvents & EPOLLOUT)
+            events |= SOCKET_POLLER_WRITE;
+
+        if (epollEvents & (EPOLLERR | EPOLLHUP))
+            events |= SOCKET_POLLER_ERROR;
+    }
+
+    return events;
+}
+
+void*
+SocketPoller_getParameter(SocketPoller self, int index)
+{
+    if ((index >= 0) && (index < self->maxEvents))
+        return self->events[index].data.ptr;
+    else
+        return NULL;
+}
+
+void
+SocketPoller_destroy(SocketPoller self)
+{
+    if (self) {
+        if (self->epollFd != -1)
+            close(self->epollFd);
+
+        if (self->wakeupFd != -1)
+            close(self->wakeupFd);
+
+        if (self->events)
+            GLOBAL_FREEMEM(self->events);
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
 void
 Socket_activateTcpKeepAlive(Socket self, int idleTime, int interval, int count)
 {
@@ -296,6 +497,7 @@ TcpServerSocket_create(const char* address, int port)
             serverSocket = (ServerSocket) GLOBAL_MALLOC(sizeof(struct sServerSocket));
             serverSocket->fd = fd;
             serverSocket->backLog = 2;
+            serverSocket->unixPath = NULL;
 
             setSocketNonBlocking((Socket) serverSocket);
         }
@@ -308,6 +510,84 @@ TcpServerSocket_create(const char* address, int port)
     return serverSocket;
 }
 
+static bool
+prepareUnixAddress(const char* path, struct sockaddr_un* sockaddr)
+{
+    if ((path == NULL) || (strlen(path) >= sizeof(sockaddr->sun_path))) {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: invalid path for unix domain socket\n");
+
+        return false;
+    }
+
+    memset((char*) sockaddr, 0, sizeof(struct sockaddr_un));
+
+    sockaddr->sun_family = AF_UNIX;
+    strcpy(sockaddr->sun_path, path);
+
+    return true;
+}
+
+ServerSocket
+UnixServerSocket_create(const char* path)
+{
+    ServerSocket serverSocket = NULL;
+    struct sockaddr_un serverAddress;
+    struct stat fileStatus;
+
+    if (!prepareUnixAddress(path, &serverAddress))
+        return NULL;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: failed to create unix domain socket (errno=%i)\n", errno);
+
+        return NULL;
+    }
+
+    /* remove the socket file of a previous server instance (but no other files) */
+    if ((stat(path, &fileStatus) == 0) && S_ISSOCK(fileStatus.st_mode))
+        unlink(path);
+
+    if (bind(fd, (struct sockaddr *) &serverAddress, sizeof(serverAddress)) >= 0) {
+        serverSocket = (ServerSocket) GLOBAL_MALLOC(sizeof(struct sServerSocket));
+
+        /* the path is required to handle the socket as unix domain socket and to remove the file */
+        char* unixPath = (char*) GLOBAL_MALLOC(strlen(path) + 1);
+
+        if (serverSocket && unixPath) {
+            strcpy(unixPath, path);
+
+            serverSocket->fd = fd;
+            serverSocket->backLog = 2;
+            serverSocket->unixPath = unixPath;
+
+            setSocketNonBlocking((Socket) serverSocket);
+        }
+        else {
+            if (DEBUG_SOCKET)
+                printf("SOCKET: failed to allocate unix domain server socket\n");
+
+            GLOBAL_FREEMEM(serverSocket);
+            GLOBAL_FREEMEM(unixPath);
+            serverSocket = NULL;
+
+            close(fd);
+            unlink(path);
+        }
+    }
+    else {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: failed to bind unix domain socket (errno=%i)\n", errno);
+
+        close(fd);
+    }
+
+    return serverSocket;
+}
+
 void
 ServerSocket_listen(ServerSocket self)
 {
@@ -335,7 +615,13 @@ ServerSocket_accept(ServerSocket self)
 
             setSocketNonBlocking(conSocket);
 
-            activateTcpNoDelay(conSocket);
+            if (self->unixPath) {
+                conSocket->domain = AF_UNIX;
+            }
+            else {
+                conSocket->domain = AF_INET;
+                activateTcpNoDelay(conSocket);
+            }
         }
         else {
             /* out of memory */
@@ -393,6 +679,11 @@ ServerSocket_destroy(ServerSocket self)
 
     closeAndShutdownSocket(fd);
 
+    if (self->unixPath) {
+        unlink(self->unixPath);
+        GLOBAL_FREEMEM(self->unixPath);
+    }
+
     Thread_sleep(10);
 
     GLOBAL_FREEMEM(self);
@@ -411,6 +702,7 @@ TcpSocket_create()
         if (self) {
             self->fd = sock;
             self->connectTimeout = 5000;
+            self->domain = AF_INET;
 
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 37)
             int tcpUserTimeout = 10000;
@@ -438,6 +730,37 @@ TcpSocket_create()
     return self;
 }
 
+Socket
+UnixSocket_create(void)
+{
+    Socket self = (Socket) NULL;
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (sock != -1) {
+        self = (Socket) GLOBAL_MALLOC(sizeof(struct sSocket));
+
+        if (self) {
+            self->fd = sock;
+            self->connectTimeout = 5000;
+            self->domain = AF_UNIX;
+        }
+        else {
+            /* out of memory */
+            close(sock);
+
+            if (DEBUG_SOCKET)
+                printf("SOCKET: out of memory\n");
+        }
+    }
+    else {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: failed to create unix domain socket (errno=%i)\n", errno);
+    }
+
+    return self;
+}
+
 void
 Socket_setConnectTimeout(Socket self, uint32_t timeoutInMs)
 {
@@ -470,23 +793,31 @@ Socket_bind(Socket self, const char* srcAddress, int srcPort)
 bool
 Socket_connectAsync(Socket self, const char* address, int port)
 {
-    struct sockaddr_in serverAddress;
+    struct sockaddr_storage serverAddress;
+    socklen_t serverAddressLength;
 
     if (DEBUG_SOCKET)
         printf("SOCKET: connect: %s:%i\n", address, port);
 
-    if (!prepareAddress(address, port, &serverAddress))
-        return false;
+    if (self->domain == AF_UNIX) {
+        /* the address is the path of the socket file */
+        if (!prepareUnixAddress(address, (struct sockaddr_un*) &serverAddress))
+            return false;
 
-    fd_set fdSet;
-    FD_ZERO(&fdSet);
-    FD_SET(self->fd, &fdSet);
+        serverAddressLength = sizeof(struct sockaddr_un);
+    }
+    else {
+        if (!prepareAddress(address, port, (struct sockaddr_in*) &serverAddress))
+            return false;
 
-    activateTcpNoDelay(self);
+        serverAddressLength = sizeof(struct sockaddr_in);
+
+        activateTcpNoDelay(self);
+    }
 
     fcntl(self->fd, F_SETFL, O_NONBLOCK);
 
-    if (connect(self->fd, (struct sockaddr *) &serverAddress, sizeof(serverAddress)) < 0) {
+    if (connect(self->fd, (struct sockaddr *) &serverAddress, serverAddressLength) < 0) {
 
         if (errno != EINPROGRESS) {
             if (close(self->fd) == -1) {
@@ -505,15 +836,13 @@ Socket_connectAsync(Socket self, const char* address, int port)
 SocketState
 Socket_checkAsyncConnectState(Socket self)
 {
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 0;
-
-    fd_set fdSet;
-    FD_ZERO(&fdSet);
-    FD_SET(self->fd, &fdSet);
+    /* poll is used because select cannot handle file descriptors >= FD_SETSIZE */
+    struct pollfd pfd;
+    pfd.fd = self->fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
 
-    int selectVal = select(self->fd + 1, NULL, &fdSet , NULL, &timeout);
+    int selectVal = poll(&pfd, 1, 0);
 
     if (selectVal == 1) {
 
@@ -592,6 +921,14 @@ convertAddressToStr(struct sockaddr_storage* addr)
         inet_ntop(AF_INET6, &(ipv6Addr->sin6_addr), addrString, INET6_ADDRSTRLEN);
         isIPv6 = true;
     }
+    else if (addr->ss_family == AF_UNIX) {
+        char* unixAddress = (char*) GLOBAL_MALLOC(sizeof(UNIX_PEER_ADDRESS));
+
+        if (unixAddress)
+            strcpy(unixAddress, UNIX_PEER_ADDRESS);
+
+        return unixAddress;
+    }
     else
         return NULL ;
 
@@ -663,6 +1000,11 @@ Socket_getPeerAddressStatic(Socket self, char* peerAddressString)
         inet_ntop(AF_INET6, &(ipv6Addr->sin6_addr), addrString, INET6_ADDRSTRLEN);
         isIPv6 = true;
     }
+    else if (addr.ss_family == AF_UNIX) {
+        strcpy(peerAddressString, UNIX_PEER_ADDRESS);
+
+        return peerAddressString;
+    }
     else
         return NULL;
 
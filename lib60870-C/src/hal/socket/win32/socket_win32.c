@@ -9,6 +9,13 @@
 
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
 #define _CRT_SECURE_NO_WARNINGS
+
+/* WSAPoll requires Windows Vista or later */
+#if !defined(_WIN32_WINNT) || (_WIN32_WINNT < 0x0600)
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600
+#endif
+
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windows.h>
@@ -125,6 +132,319 @@ Handleset_destroy(HandleSet self)
 static bool wsaStartupCalled = false;
 static int socketCount = 0;
 
+static bool
+wsaStartUp(void);
+
+static void
+wsaShutdown(void);
+
+/*
+ * WSAPoll based implementation of the socket poller - the first entry is a UDP socket that is
+ * connected to itself and used to wake up the poller (WSAPoll only supports sockets)
+ */
+struct sSocketPoller {
+    WSAPOLLFD* fds;
+    void** parameters;
+    int nfds;
+    int maxFds;
+    int removedFds; /* removed entries that are compacted by the next wait */
+
+    SOCKET wakeupSocket;
+
+    /* indices of the ready sockets */
+    int* readyIndices;
+    int maxEvents;
+};
+
+static SOCKET
+createWakeupSocket(void)
+{
+    struct sockaddr_in addr;
+    int addrLen = sizeof(addr);
+    unsigned long mode = 1;
+
+    if (wsaStartUp() == false)
+        return INVALID_SOCKET;
+
+    SOCKET sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if (sock == INVALID_SOCKET) {
+        wsaShutdown();
+        return INVALID_SOCKET;
+    }
+
+    socketCount++;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    if ((bind(sock, (struct sockaddr*) &addr, sizeof(addr)) == SOCKET_ERROR) ||
+            (getsockname(sock, (struct sockaddr*) &addr, &addrLen) == SOCKET_ERROR) ||
+            (connect(sock, (struct sockaddr*) &addr, sizeof(addr)) == SOCKET_ERROR) ||
+            (ioctlsocket(sock, FIONBIO, &mode) != 0))
+    {
+        if (DEBUG_SOCKET)
+            printf("WIN32_SOCKET: failed to create wakeup socket (error: %i)\n", WSAGetLastError());
+
+        closesocket(sock);
+        socketCount--;
+        wsaShutdown();
+
+        return INVALID_SOCKET;
+    }
+
+    return sock;
+}
+
+SocketPoller
+SocketPoller_create(int maxEvents)
+{
+    SocketPoller self = (SocketPoller) GLOBAL_CALLOC(1, sizeof(struct sSocketPoller));
+
+    if (self) {
+        if (maxEvents < 1)
+            maxEvents = 1;
+
+        self->maxEvents = maxEvents;
+        self->readyIndices = (int*) GLOBAL_CALLOC(maxEvents, sizeof(int));
+
+        self->maxFds = 16;
+        self->fds = (WSAPOLLFD*) GLOBAL_CALLOC(self->maxFds, sizeof(WSAPOLLFD));
+        self->parameters = (void**) GLOBAL_CALLOC(self->maxFds, sizeof(void*));
+
+        self->wakeupSocket = createWakeupSocket();
+
+        if ((self->wakeupSocket == INVALID_SOCKET) || (self->readyIndices == NULL) || (self->fds == NULL) ||
+                (self->parameters == NULL))
+        {
+            SocketPoller_destroy(self);
+            return NULL;
+        }
+
+        self->fds[0].fd = self->wakeupSocket;
+        self->fds[0].events = POLLRDNORM;
+        self->fds[0].revents = 0;
+        self->parameters[0] = NULL;
+        self->nfds = 1;
+    }
+
+    return self;
+}
+
+static SHORT
+getPollEvents(int events)
+{
+    SHORT pollEvents = 0;
+
+    if (events & SOCKET_POLLER_READ)
+        pollEvents |= POLLRDNORM;
+
+    if (events & SOCKET_POLLER_WRITE)
+        pollEvents |= POLLWRNORM;
+
+    return pollEvents;
+}
+
+static int
+findPollerSocket(SocketPoller self, const Socket sock)
+{
+    int i;
+
+    for (i = 1; i < self->nfds; i++) {
+        if (self->fds[i].fd == sock->fd)
+            return i;
+    }
+
+    return -1;
+}
+
+bool
+SocketPoller_addSocket(SocketPoller self, const Socket sock, int events, void* parameter)
+{
+    if ((self == NULL) || (sock == NULL) || (sock->fd == INVALID_SOCKET))
+        return false;
+
+    if (self->nfds == self->maxFds) {
+        int newSize = (self->maxFds == 0) ? 16 : (self->maxFds * 2);
+
+        WSAPOLLFD* newFds = (WSAPOLLFD*) GLOBAL_REALLOC(self->fds, newSize * sizeof(WSAPOLLFD));
+
+        if (newFds == NULL)
+            return false;
+
+        self->fds = newFds;
+
+        void** newParameters = (void**) GLOBAL_REALLOC(self->parameters, newSize * sizeof(void*));
+
+        if (newParameters == NULL)
+            return false;
+
+        self->parameters = newParameters;
+        self->maxFds = newSize;
+    }
+
+    self->fds[self->nfds].fd = sock->fd;
+    self->fds[self->nfds].events = getPollEvents(events);
+    self->fds[self->nfds].revents = 0;
+    self->parameters[self->nfds] = parameter;
+    self->nfds++;
+
+    return true;
+}
+
+bool
+SocketPoller_modifySocket(SocketPoller self, const Socket sock, int events, void* parameter)
+{
+    if ((self == NULL) || (sock == NULL))
+        return false;
+
+    int index = findPollerSocket(self, sock);
+
+    if (index == -1)
+        return false;
+
+    self->fds[index].events = getPollEvents(events);
+    self->parameters[index] = parameter;
+
+    return true;
+}
+
+void
+SocketPoller_removeSocket(SocketPoller self, const Socket sock)
+{
+    if ((self == NULL) || (sock == NULL))
+        return;
+
+    int index = findPollerSocket(self, sock);
+
+    if (index != -1) {
+        /* the entry is only marked - the ready indices of the last wait have to remain valid */
+        self->fds[index].fd = INVALID_SOCKET;
+        self->fds[index].events = 0;
+        self->fds[index].revents = 0;
+        self->parameters[index] = NULL;
+        self->removedFds++;
+    }
+}
+
+/* remove the entries of removed sockets */
+static void
+compactPollerSockets(SocketPoller self)
+{
+    int i;
+    int count = 0;
+
+    for (i = 0; i < self->nfds; i++) {
+        if (self->fds[i].fd != INVALID_SOCKET) {
+            self->fds[count] = self->fds[i];
+            self->parameters[count] = self->parameters[i];
+            count++;
+        }
+    }
+
+    self->nfds = count;
+    self->removedFds = 0;
+}
+
+int
+SocketPoller_wait(SocketPoller self, unsigned int timeoutMs)
+{
+    if (self->removedFds > 0)
+        compactPollerSockets(self);
+
+    int result = WSAPoll(self->fds, (ULONG) self->nfds, (INT) timeoutMs);
+
+    if (result == SOCKET_ERROR) {
+        if (DEBUG_SOCKET)
+            printf("SOCKET: WSAPoll error (error: %i)\n", WSAGetLastError());
+
+        return -1;
+    }
+
+    if (self->fds[0].revents != 0) {
+        char buffer[64];
+
+        while (recv(self->wakeupSocket, buffer, sizeof(buffer), 0) > 0);
+    }
+
+    int readyCount = 0;
+    int i;
+
+    for (i = 1; (i < self->nfds) && (readyCount < self->maxEvents); i++) {
+        if (self->fds[i].revents != 0)
+            self->readyIndices[readyCount++] = i;
+    }
+
+    return readyCount;
+}
+
+void
+SocketPoller_wakeup(SocketPoller self)
+{
+    char value = 1;
+
+    /* can fail when the socket buffer is full - wakeup is already pending */
+    if (send(self->wakeupSocket, &value, 1, 0) == SOCKET_ERROR) {
+        if (DEBUG_SOCKET)
+            printf("WIN32_SOCKET: failed to send wakeup event (error: %i)\n", WSAGetLastError());
+    }
+}
+
+int
+SocketPoller_getEvents(SocketPoller self, int index)
+{
+    int events = 0;
+
+    if ((index >= 0) && (index < self->maxEvents)) {
+        SHORT revents = self->fds[self->readyIndices[index]].revents;
+
+        if (revents & POLLRDNORM)
+            events |= SOCKET_POLLER_READ;
+
+        if (revents & POLLWRNORM)
+            events |= SOCKET_POLLER_WRITE;
+
+        if (revents & (POLLERR | POLLHUP | POLLNVAL))
+            events |= SOCKET_POLLER_ERROR;
+    }
+
+    return events;
+}
+
+void*
+SocketPoller_getParameter(SocketPoller self, int index)
+{
+    if ((index >= 0) && (index < self->maxEvents))
+        return self->parameters[self->readyIndices[index]];
+    else
+        return NULL;
+}
+
+void
+SocketPoller_destroy(SocketPoller self)
+{
+    if (self) {
+        if (self->fds)
+            GLOBAL_FREEMEM(self->fds);
+
+        if (self->parameters)
+            GLOBAL_FREEMEM(self->parameters);
+
+        if (self->readyIndices)
+            GLOBAL_FREEMEM(self->readyIndices);
+
+        if (self->wakeupSocket != INVALID_SOCKET) {
+            closesocket(self->wakeupSocket);
+            socketCount--;
+            wsaShutdown();
+        }
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
 void
 Socket_activateTcpKeepAlive(Socket self, int idleTime, int interval, int count)
 {
@@ -367,6 +687,22 @@ TcpSocket_create()
     return self;
 }
 
+ServerSocket
+UnixServerSocket_create(const char* path)
+{
+    /* unix domain sockets are not supported */
+    (void) path;
+
+    return NULL;
+}
+
+Socket
+UnixSocket_create(void)
+{
+    /* unix domain sockets are not supported */
+    return NULL;
+}
+
 void
 Socket_setConnectTimeout(Socket self, uint32_t timeoutInMs)
 {
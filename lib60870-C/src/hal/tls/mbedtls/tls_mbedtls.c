@@ -10,6 +10,8 @@
  */
 
 #include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
 
 #include "tls_socket.h"
 #include "hal_thread.h"
@@ -32,15 +34,40 @@
 #define SEC_EVENT_WARNING 1
 #define SEC_EVENT_INFO 0
 
-#ifndef CONFIG_DEBUG_TLS
-#define CONFIG_DEBUG_TLS 0
-#endif
+/* debug output of the TLS layer - only formatted when a handler is set by TLSSocket_setDebugHandler */
+static TLSSocket_DebugHandler debugHandler = NULL;
+static void* debugHandlerParameter = NULL;
 
-#if (CONFIG_DEBUG_TLS == 1)
-#define DEBUG_PRINT(appId, fmt, ...) fprintf(stderr, "%s: " fmt, appId, ## __VA_ARGS__);
-#else
-#define DEBUG_PRINT(fmt, ...) {do {} while(0);}
-#endif
+static void
+debugPrint(const char* appId, const char* format, ...)
+{
+    TLSSocket_DebugHandler handler = debugHandler;
+
+    if (handler) {
+        char message[256];
+        va_list ap;
+
+        int len = snprintf(message, sizeof(message), "%s: ", appId);
+
+        if ((len < 0) || (len >= (int) sizeof(message)))
+            len = 0;
+
+        va_start(ap, format);
+        vsnprintf(message + len, sizeof(message) - len, format, ap);
+        va_end(ap);
+
+        handler(debugHandlerParameter, message);
+    }
+}
+
+#define DEBUG_PRINT(appId, ...) do { if (debugHandler) debugPrint(appId, __VA_ARGS__); } while (0)
+
+void
+TLSSocket_setDebugHandler(TLSSocket_DebugHandler handler, void* parameter)
+{
+    debugHandlerParameter = parameter;
+    debugHandler = handler;
+}
 
 
 struct sTLSConfiguration {
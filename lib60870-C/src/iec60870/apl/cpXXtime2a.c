@@ -34,6 +34,9 @@
 #include "iec60870_common.h"
 #include "apl_types_internal.h"
 
+#define MS_PER_MINUTE 60000
+#define MS_PER_HOUR 3600000
+
 /**********************************
  *  CP16Time2a type
  **********************************/
@@ -211,6 +214,31 @@ CP24Time2a_setMinute(CP24Time2a self, int value)
     setMinute(self->encodedValue, value);
 }
 
+void
+CP24Time2a_setFromMsTimestamp(CP24Time2a self, uint64_t timestamp)
+{
+    int msOfHour = (int) (timestamp % MS_PER_HOUR);
+    int msOfMinute = msOfHour % MS_PER_MINUTE;
+
+    self->encodedValue[0] = (uint8_t) (msOfMinute & 0xff);
+    self->encodedValue[1] = (uint8_t) (msOfMinute / 0x100);
+    self->encodedValue[2] = (uint8_t) ((self->encodedValue[2] & 0xc0) | ((msOfHour / MS_PER_MINUTE) & 0x3f));
+}
+
+uint64_t
+CP24Time2a_toMsTimestamp(const CP24Time2a self, uint64_t referenceTime)
+{
+    int msOfHour = (getMinute(self->encodedValue) * MS_PER_MINUTE) + self->encodedValue[0] + (self->encodedValue[1] * 0x100);
+
+    uint64_t timestamp = referenceTime - (referenceTime % MS_PER_HOUR) + msOfHour;
+
+    /* time is in the previous hour */
+    if ((timestamp > referenceTime) && (timestamp >= MS_PER_HOUR))
+        timestamp -= MS_PER_HOUR;
+
+    return timestamp;
+}
+
 bool
 CP24Time2a_isInvalid(const CP24Time2a self)
 {
@@ -269,42 +297,128 @@ time_t my_timegm(register struct tm * t)
 }
 #endif
 
-/* Conversion from UTC date to second, unsigned 32-bit Unix epoch version.
- * Written by François Grieu, 2015-07-21; public domain.
- *
- * my_mktime  converts from  struct tm  UTC to non-leap seconds since
- * 00:00:00 on the first UTC day of year 1970 (fixed).
- * It works from 1970 to 2105 inclusive. It strives to be compatible
- * with C compilers supporting // comments and claiming C89 conformance.
+/**********************************
+ *  Conversion between ms timestamps
+ *  and calendar time
+ **********************************/
+
+/* Convert the number of days since 1970-01-01 to year, month (1..12) and day of month (1..31)
+ * in the proleptic Gregorian calendar (see http://howardhinnant.github.io/date_algorithms.html) */
+static void
+civilFromDays(uint32_t days, int* year, int* month, int* day)
+{
+    /* days since 0000-03-01 */
+    uint32_t z = days + 719468;
+
+    uint32_t era = z / 146097;
+    uint32_t dayOfEra = z - (era * 146097);
+    uint32_t yearOfEra = (dayOfEra - (dayOfEra / 1460) + (dayOfEra / 36524) - (dayOfEra / 146096)) / 365;
+    uint32_t dayOfYear = dayOfEra - ((365 * yearOfEra) + (yearOfEra / 4) - (yearOfEra / 100));
+    uint32_t monthIndex = ((5 * dayOfYear) + 2) / 153; /* 0 = March */
+
+    *day = (int) (dayOfYear - (((153 * monthIndex) + 2) / 5) + 1);
+    *month = (int) ((monthIndex < 10) ? (monthIndex + 3) : (monthIndex - 9));
+    *year = (int) ((era * 400) + yearOfEra) + ((*month <= 2) ? 1 : 0);
+}
+
+/* encoded hour, day of month, month and year (bytes 3 to 6 of CP56Time2a) of an hour since epoch */
+static uint32_t
+encodeHour(uint32_t hourIndex)
+{
+    int year, month, day;
+
+    civilFromDays(hourIndex / 24, &year, &month, &day);
+
+    uint32_t hour = hourIndex % 24;
+
+    /* day of week is 0 (not present), summer time flag is not set */
+    return hour + ((uint32_t) day << 8) + ((uint32_t) month << 16) + ((uint32_t) (year % 100) << 24);
+}
+
+/*
+ * Start of the hour as ms timestamp (years 2000 to 2099).
  *
- * input:   Pointer to a  struct tm  with field tm_year, tm_mon, tm_mday,
- *          tm_hour, tm_min, tm_sec set per  mktime  convention; thus
- *          - tm_year is year minus 1900
- *          - tm_mon is [0..11] for January to December, but [-2..14]
- *            works for November of previous year to February of next year
- *          - tm_mday, tm_hour, tm_min, tm_sec similarly can be offset to
- *            the full range [-32767 to 32768], as long as the combination
- *            with tm_year gives a result within years [1970..2105], and
- *            tm_year>0.
- * output:  Number of non-leap seconds since beginning of the first UTC
- *          day of year 1970, as an unsigned at-least-32-bit integer.
- *          The input is not changed (in particular, fields tm_wday,
- *          tm_yday, and tm_isdst are unchanged and ignored).
+ * Based on the conversion from UTC date to seconds by François Grieu, 2015-07-21 (public domain).
  */
-static time_t
-my_mktime(const struct tm * ptm)
+static uint64_t
+getHourStart(const uint8_t* encodedValue)
 {
-    int m, y = ptm->tm_year;
+    int hour = encodedValue[3] & 0x1f;
+    int day = encodedValue[4] & 0x1f;
+    int m = (encodedValue[5] & 0x0f) - 1;
+    int y = (encodedValue[6] & 0x7f) + 100; /* years since 1900 */
 
-    if ((m = ptm->tm_mon) < 2) {
+    if (m < 2) {
         m += 12;
         --y;
     }
 
-    return ((((time_t) (y - 69) * 365u + y / 4 - y / 100 * 3 / 4 + (m + 2) * 153 / 5 - 446 +
-            ptm->tm_mday) * 24u + ptm->tm_hour) * 60u + ptm->tm_min) * 60u + ptm->tm_sec;
+    time_t seconds = ((((time_t) (y - 69) * 365u + y / 4 - y / 100 * 3 / 4 + (m + 2) * 153 / 5 - 446 +
+            day) * 24u + hour) * 60u) * 60u;
+
+    return (uint64_t) (seconds * (uint64_t) 1000);
+}
+
+void
+CP56Time2a_encodeMsTimestamp(uint8_t* encodedValue, uint64_t timestamp, CP56Time2aHourCache* cache)
+{
+    uint32_t hourIndex = (uint32_t) (timestamp / MS_PER_HOUR);
+    uint32_t encodedHour;
+
+    if (cache && cache->valid && (cache->hourIndex == hourIndex)) {
+        encodedHour = cache->encodedHour;
+    }
+    else {
+        encodedHour = encodeHour(hourIndex);
+
+        if (cache) {
+            cache->valid = true;
+            cache->hourIndex = hourIndex;
+            cache->encodedHour = encodedHour;
+            cache->hourStart = (uint64_t) hourIndex * MS_PER_HOUR;
+        }
+    }
+
+    int msOfHour = (int) (timestamp % MS_PER_HOUR);
+    int msOfMinute = msOfHour % MS_PER_MINUTE;
+
+    encodedValue[0] = (uint8_t) (msOfMinute & 0xff);
+    encodedValue[1] = (uint8_t) (msOfMinute / 0x100);
+    encodedValue[2] = (uint8_t) (msOfHour / MS_PER_MINUTE);
+    encodedValue[3] = (uint8_t) (encodedHour & 0xff);
+    encodedValue[4] = (uint8_t) ((encodedHour >> 8) & 0xff);
+    encodedValue[5] = (uint8_t) ((encodedHour >> 16) & 0xff);
+    encodedValue[6] = (uint8_t) (encodedHour >> 24);
 }
 
+uint64_t
+CP56Time2a_decodeMsTimestamp(const uint8_t* encodedValue, CP56Time2aHourCache* cache)
+{
+    uint64_t hourStart;
+
+    /* flags (invalid, substituted, summer time) and day of week are ignored */
+    uint32_t encodedHour = (encodedValue[3] & 0x1f) + ((uint32_t) (encodedValue[4] & 0x1f) << 8) +
+            ((uint32_t) (encodedValue[5] & 0x0f) << 16) + ((uint32_t) (encodedValue[6] & 0x7f) << 24);
+
+    if (cache && cache->valid && (cache->encodedHour == encodedHour)) {
+        hourStart = cache->hourStart;
+    }
+    else {
+        hourStart = getHourStart(encodedValue);
+
+        if (cache) {
+            cache->valid = true;
+            cache->hourIndex = (uint32_t) (hourStart / MS_PER_HOUR);
+            cache->encodedHour = encodedHour;
+            cache->hourStart = hourStart;
+        }
+    }
+
+    int minute = encodedValue[2] & 0x3f;
+    int msOfMinute = encodedValue[0] + (encodedValue[1] * 0x100);
+
+    return hourStart + (uint64_t) ((minute * MS_PER_MINUTE) + msOfMinute);
+}
 
 /**********************************
  *  CP32Time2a type
@@ -430,27 +544,13 @@ CP32Time2a_setSummerTime(CP32Time2a self, bool value)
 void
 CP32Time2a_setFromMsTimestamp(CP32Time2a self, uint64_t timestamp)
 {
-    memset(self->encodedValue, 0, 4);
-
-    time_t timeVal = timestamp / 1000;
+    int msOfHour = (int) (timestamp % MS_PER_HOUR);
+    int msOfMinute = msOfHour % MS_PER_MINUTE;
 
-    int msPart = timestamp % 1000;
-
-    struct tm tmTime;
-
-#ifdef _WIN32
-    gmtime_s(&tmTime, &timeVal);
-#else
-    gmtime_r(&timeVal, &tmTime);
-#endif
-
-    CP32Time2a_setSecond(self, tmTime.tm_sec);
-
-    CP32Time2a_setMillisecond(self, msPart);
-
-    CP32Time2a_setMinute(self, tmTime.tm_min);
-
-    CP32Time2a_setHour(self, tmTime.tm_hour);
+    self->encodedValue[0] = (uint8_t) (msOfMinute & 0xff);
+    self->encodedValue[1] = (uint8_t) (msOfMinute / 0x100);
+    self->encodedValue[2] = (uint8_t) (msOfHour / MS_PER_MINUTE);
+    self->encodedValue[3] = (uint8_t) ((timestamp / MS_PER_HOUR) % 24);
 }
 
 uint8_t*
@@ -481,56 +581,37 @@ CP56Time2a_createFromMsTimestamp(CP56Time2a self, uint64_t timestamp)
 void
 CP56Time2a_setFromMsTimestamp(CP56Time2a self, uint64_t timestamp)
 {
-    memset(self->encodedValue, 0, 7);
-
-    time_t timeVal = timestamp / 1000;
-    int msPart = timestamp % 1000;
-
-    struct tm tmTime;
-
-    /* TODO replace with portable implementation */
-#ifdef _WIN32
-	gmtime_s(&tmTime, &timeVal);
-#else
-    gmtime_r(&timeVal, &tmTime);
-#endif
-
-    CP56Time2a_setMillisecond(self, msPart);
-
-    CP56Time2a_setSecond(self, tmTime.tm_sec);
-
-    CP56Time2a_setMinute(self, tmTime.tm_min);
-
-    CP56Time2a_setHour(self, tmTime.tm_hour);
-
-    CP56Time2a_setDayOfMonth(self, tmTime.tm_mday);
-
-    /* set day of week to 0 = not present */
-    CP56Time2a_setDayOfWeek(self, 0);
-
-    CP56Time2a_setMonth(self, tmTime.tm_mon + 1);
-
-    CP56Time2a_setYear(self, tmTime.tm_year);
+    CP56Time2a_encodeMsTimestamp(self->encodedValue, timestamp, NULL);
 }
 
-
 uint64_t
 CP56Time2a_toMsTimestamp(const CP56Time2a self)
 {
-    struct tm tmTime;
+    return CP56Time2a_decodeMsTimestamp(self->encodedValue, NULL);
+}
+
+void
+CP56Time2a_setFromMsTimestamps(uint8_t* encodedValues, const uint64_t* timestamps, int count)
+{
+    CP56Time2aHourCache cache;
+    int i;
 
-    tmTime.tm_sec = CP56Time2a_getSecond(self);
-    tmTime.tm_min = CP56Time2a_getMinute(self);
-    tmTime.tm_hour = CP56Time2a_getHour(self);
-    tmTime.tm_mday = CP56Time2a_getDayOfMonth(self);
-    tmTime.tm_mon = CP56Time2a_getMonth(self) - 1;
-    tmTime.tm_year = CP56Time2a_getYear(self) + 100;
+    memset(&cache, 0, sizeof(cache));
 
-    time_t timestamp = my_mktime(&tmTime);
+    for (i = 0; i < count; i++)
+        CP56Time2a_encodeMsTimestamp(encodedValues + (i * 7), timestamps[i], &cache);
+}
+
+void
+CP56Time2a_toMsTimestamps(const uint8_t* encodedValues, uint64_t* timestamps, int count)
+{
+    CP56Time2aHourCache cache;
+    int i;
 
-    uint64_t msTimestamp = ((uint64_t) (timestamp * (uint64_t) 1000)) + CP56Time2a_getMillisecond(self);
+    memset(&cache, 0, sizeof(cache));
 
-    return msTimestamp;
+    for (i = 0; i < count; i++)
+        timestamps[i] = CP56Time2a_decodeMsTimestamp(encodedValues + (i * 7), &cache);
 }
 
 /* private */ bool
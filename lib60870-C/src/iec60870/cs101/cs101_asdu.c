@@ -29,6 +29,7 @@
 #include "lib_memory.h"
 #include "lib60870_internal.h"
 #include "cs101_asdu_internal.h"
+#include "platform_endian.h"
 
 typedef struct sASDUFrame* ASDUFrame;
 
@@ -122,7 +123,7 @@ CS101_ASDU
 CS101_ASDU_initializeStatic(CS101_StaticASDU self, CS101_AppLayerParameters parameters, bool isSequence, CS101_CauseOfTransmission cot, int oa, int ca,
         bool isTest, bool isNegative)
 {
-    int asduHeaderLength = 2 + parameters->sizeOfCOT + parameters->sizeOfCA;
+    int asduHeaderLength = 2 + CS101_SIZE_OF_COT(parameters) + CS101_SIZE_OF_CA(parameters);
 
     self->encodedData[0] = (uint8_t) 0;
 
@@ -141,7 +142,7 @@ CS101_ASDU_initializeStatic(CS101_StaticASDU self, CS101_AppLayerParameters para
 
     int caIndex;
 
-    if (parameters->sizeOfCOT > 1) {
+    if (CS101_SIZE_OF_COT(parameters) > 1) {
         self->encodedData[3] = (uint8_t) oa;
         caIndex = 4;
     }
@@ -150,7 +151,7 @@ CS101_ASDU_initializeStatic(CS101_StaticASDU self, CS101_AppLayerParameters para
 
     self->encodedData[caIndex] = ca % 0x100;
 
-    if (parameters->sizeOfCA > 1)
+    if (CS101_SIZE_OF_CA(parameters) > 1)
         self->encodedData[caIndex + 1] = ca / 0x100;
 
     self->asdu = self->encodedData;
@@ -175,24 +176,54 @@ CS101_ASDU_encode(CS101_ASDU self, Frame frame)
 }
 
 CS101_ASDU
-CS101_ASDU_createFromBuffer(CS101_AppLayerParameters parameters, uint8_t* msg, int msgLength)
+CS101_ASDU_initializeView(CS101_ASDUView self, CS101_AppLayerParameters parameters, uint8_t* msg, int msgLength)
 {
-    int asduHeaderLength = 2 + parameters->sizeOfCOT + parameters->sizeOfCA;
+    int asduHeaderLength = 2 + CS101_SIZE_OF_COT(parameters) + CS101_SIZE_OF_CA(parameters);
 
     if (msgLength < asduHeaderLength)
         return NULL;
 
-    CS101_ASDU self = (CS101_ASDU) GLOBAL_MALLOC(sizeof(struct sCS101_ASDU));
+    self->parameters = parameters;
+
+    self->asdu = msg;
+    self->asduHeaderLength = asduHeaderLength;
 
-    if (self != NULL) {
-        self->parameters = parameters;
+    self->payload = msg + asduHeaderLength;
+    self->payloadSize = msgLength - asduHeaderLength;
 
-        self->asdu = msg;
-        self->asduHeaderLength = asduHeaderLength;
+    return (CS101_ASDU) self;
+}
 
-        self->payload = msg + asduHeaderLength;
-        self->payloadSize = msgLength - asduHeaderLength;
-    }
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+bool
+CS101_AppLayerParameters_applyFixedProfile(CS101_AppLayerParameters parameters)
+{
+    if ((parameters->sizeOfCOT == 2) && (parameters->sizeOfCA == 2) && (parameters->sizeOfIOA == 3))
+        return true;
+
+    LIB60870_LOG(LIB60870_LOG_LEVEL_WARNING, "Application layer parameters (COT = %i, CA = %i, IOA = %i) not supported by the fixed profile -> using COT = 2, CA = 2, IOA = 3\n",
+            parameters->sizeOfCOT, parameters->sizeOfCA, parameters->sizeOfIOA);
+
+    parameters->sizeOfCOT = 2;
+    parameters->sizeOfCA = 2;
+    parameters->sizeOfIOA = 3;
+
+    return false;
+}
+#endif /* (CONFIG_CS101_FIXED_AL_PROFILE == 1) */
+
+CS101_ASDU
+CS101_ASDU_createFromBuffer(CS101_AppLayerParameters parameters, uint8_t* msg, int msgLength)
+{
+    int asduHeaderLength = 2 + CS101_SIZE_OF_COT(parameters) + CS101_SIZE_OF_CA(parameters);
+
+    if (msgLength < asduHeaderLength)
+        return NULL;
+
+    CS101_ASDU self = (CS101_ASDU) GLOBAL_MALLOC(sizeof(struct sCS101_ASDU));
+
+    if (self != NULL)
+        CS101_ASDU_initializeView((CS101_ASDUView) self, parameters, msg, msgLength);
 
     return self;
 }
@@ -231,10 +262,10 @@ getFirstIOA(CS101_ASDU self)
 
     int ioa = self->asdu[startIndex];
 
-    if (self->parameters->sizeOfIOA > 1)
+    if (CS101_SIZE_OF_IOA(self->parameters) > 1)
         ioa += (self->asdu [startIndex + 1] * 0x100);
 
-    if (self->parameters->sizeOfIOA > 2)
+    if (CS101_SIZE_OF_IOA(self->parameters) > 2)
         ioa += (self->asdu [startIndex + 2] * 0x10000);
 
     return ioa;
@@ -283,6 +314,220 @@ CS101_ASDU_addInformationObject(CS101_ASDU self, InformationObject io)
     return encoded;
 }
 
+/**********************************************
+ * Bulk encoding of information objects
+ **********************************************/
+
+/*
+ * Check how many of n information objects of the given type fit into the ASDU and set the type ID
+ * of an empty ASDU. For sequences only the information objects with subsequent IOAs are counted.
+ */
+static int
+getBulkCapacity(CS101_ASDU self, TypeID typeId, int elementSize, const int* ioas, int n)
+{
+    int numberOfElements = CS101_ASDU_getNumberOfElements(self);
+
+    if ((numberOfElements > 0) && (self->asdu[0] != (uint8_t) typeId))
+        return 0;
+
+    if (n > 0x7f - numberOfElements)
+        n = 0x7f - numberOfElements;
+
+    if (n <= 0)
+        return 0;
+
+    int sizeOfIOA = CS101_SIZE_OF_IOA(self->parameters);
+    int spaceLeft = self->parameters->maxSizeOfASDU - self->asduHeaderLength - self->payloadSize;
+    int count;
+
+    if (CS101_ASDU_isSequence(self)) {
+        int nextIOA;
+
+        if (numberOfElements == 0) {
+            /* the first information object carries the IOA of the sequence */
+            spaceLeft -= sizeOfIOA;
+            nextIOA = ioas[0];
+        }
+        else
+            nextIOA = getFirstIOA(self) + numberOfElements;
+
+        int maxCount = (spaceLeft > 0) ? (spaceLeft / elementSize) : 0;
+
+        if (n > maxCount)
+            n = maxCount;
+
+        for (count = 0; count < n; count++) {
+            if (ioas[count] != nextIOA + count)
+                break;
+        }
+    }
+    else {
+        int maxCount = (spaceLeft > 0) ? (spaceLeft / (sizeOfIOA + elementSize)) : 0;
+
+        count = (n > maxCount) ? maxCount : n;
+    }
+
+    if ((count > 0) && (numberOfElements == 0))
+        self->asdu[0] = (uint8_t) typeId;
+
+    return count;
+}
+
+/* writes the IOA when required (not a sequence or first information object of the sequence) */
+static uint8_t*
+encodeBulkIOA(CS101_ASDU self, uint8_t* p, int ioa)
+{
+    if ((CS101_ASDU_isSequence(self) == false) || (p == self->payload)) {
+        *p++ = (uint8_t) (ioa & 0xff);
+
+        if (CS101_SIZE_OF_IOA(self->parameters) > 1)
+            *p++ = (uint8_t) ((ioa / 0x100) & 0xff);
+
+        if (CS101_SIZE_OF_IOA(self->parameters) > 2)
+            *p++ = (uint8_t) ((ioa / 0x10000) & 0xff);
+    }
+
+    return p;
+}
+
+static void
+finishBulkEncoding(CS101_ASDU self, uint8_t* p, int count)
+{
+    self->payloadSize = (int) (p - self->payload);
+    self->asdu[1] += (uint8_t) count; /* increase number of elements in VSQ */
+}
+
+int
+CS101_ASDU_addSinglePoints(CS101_ASDU self, const int* ioas, const bool* values, const QualityDescriptor* qds, int n)
+{
+    int count = getBulkCapacity(self, M_SP_NA_1, 1, ioas, n);
+
+    uint8_t* p = self->payload + self->payloadSize;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        p = encodeBulkIOA(self, p, ioas[i]);
+
+        uint8_t siq = qds ? (uint8_t) (qds[i] & 0xf0) : 0;
+
+        if (values[i])
+            siq++;
+
+        *p++ = siq;
+    }
+
+    finishBulkEncoding(self, p, count);
+
+    return count;
+}
+
+int
+CS101_ASDU_addDoublePoints(CS101_ASDU self, const int* ioas, const DoublePointValue* values, const QualityDescriptor* qds, int n)
+{
+    int count = getBulkCapacity(self, M_DP_NA_1, 1, ioas, n);
+
+    uint8_t* p = self->payload + self->payloadSize;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        p = encodeBulkIOA(self, p, ioas[i]);
+
+        uint8_t diq = qds ? (uint8_t) (qds[i] & 0xf0) : 0;
+
+        *p++ = diq + (uint8_t) (values[i] & 0x03);
+    }
+
+    finishBulkEncoding(self, p, count);
+
+    return count;
+}
+
+int
+CS101_ASDU_addMeasuredValueNormalizeds(CS101_ASDU self, const int* ioas, const float* values, const QualityDescriptor* qds, int n)
+{
+    int count = getBulkCapacity(self, M_ME_NA_1, 3, ioas, n);
+
+    uint8_t* p = self->payload + self->payloadSize;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        p = encodeBulkIOA(self, p, ioas[i]);
+
+        float value = values[i];
+
+        if (value > 1.0f)
+            value = 1.0f;
+        else if (value < -1.0f)
+            value = -1.0f;
+
+        int scaledValue = (int) (value * 32767.f);
+
+        *p++ = (uint8_t) (scaledValue & 0xff);
+        *p++ = (uint8_t) ((scaledValue >> 8) & 0xff);
+        *p++ = qds ? (uint8_t) qds[i] : 0;
+    }
+
+    finishBulkEncoding(self, p, count);
+
+    return count;
+}
+
+int
+CS101_ASDU_addMeasuredValueScaleds(CS101_ASDU self, const int* ioas, const int* values, const QualityDescriptor* qds, int n)
+{
+    int count = getBulkCapacity(self, M_ME_NB_1, 3, ioas, n);
+
+    uint8_t* p = self->payload + self->payloadSize;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        p = encodeBulkIOA(self, p, ioas[i]);
+
+        *p++ = (uint8_t) (values[i] & 0xff);
+        *p++ = (uint8_t) ((values[i] >> 8) & 0xff);
+        *p++ = qds ? (uint8_t) qds[i] : 0;
+    }
+
+    finishBulkEncoding(self, p, count);
+
+    return count;
+}
+
+int
+CS101_ASDU_addMeasuredValueShorts(CS101_ASDU self, const int* ioas, const float* values, const QualityDescriptor* qds, int n)
+{
+    int count = getBulkCapacity(self, M_ME_NC_1, 5, ioas, n);
+
+    uint8_t* p = self->payload + self->payloadSize;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        p = encodeBulkIOA(self, p, ioas[i]);
+
+        const uint8_t* valueBytes = (const uint8_t*) &(values[i]);
+
+#if (ORDER_LITTLE_ENDIAN == 1)
+        p[0] = valueBytes[0];
+        p[1] = valueBytes[1];
+        p[2] = valueBytes[2];
+        p[3] = valueBytes[3];
+#else
+        p[0] = valueBytes[3];
+        p[1] = valueBytes[2];
+        p[2] = valueBytes[1];
+        p[3] = valueBytes[0];
+#endif
+
+        p[4] = qds ? (uint8_t) qds[i] : 0;
+
+        p += 5;
+    }
+
+    finishBulkEncoding(self, p, count);
+
+    return count;
+}
+
 void
 CS101_ASDU_removeAllElements(CS101_ASDU self)
 {
@@ -329,7 +574,7 @@ CS101_ASDU_setNegative(CS101_ASDU self, bool value)
 int
 CS101_ASDU_getOA(CS101_ASDU self)
 {
-    if (self->parameters->sizeOfCOT < 2)
+    if (CS101_SIZE_OF_COT(self->parameters) < 2)
         return -1;
     else
         return (int) self->asdu[3];
@@ -353,11 +598,11 @@ CS101_ASDU_setCOT(CS101_ASDU self, CS101_CauseOfTransmission value)
 int
 CS101_ASDU_getCA(CS101_ASDU self)
 {
-    int caIndex = 2 + self->parameters->sizeOfCOT;
+    int caIndex = 2 + CS101_SIZE_OF_COT(self->parameters);
 
     int ca = self->asdu[caIndex];
 
-    if (self->parameters->sizeOfCA > 1)
+    if (CS101_SIZE_OF_CA(self->parameters) > 1)
         ca += (self->asdu[caIndex + 1] * 0x100);
 
     return ca;
@@ -366,7 +611,7 @@ CS101_ASDU_getCA(CS101_ASDU self)
 void
 CS101_ASDU_setCA(CS101_ASDU self, int ca)
 {
-    int caIndex = 2 + self->parameters->sizeOfCOT;
+    int caIndex = 2 + CS101_SIZE_OF_COT(self->parameters);
 
     int setCa = ca;
 
@@ -374,17 +619,17 @@ CS101_ASDU_setCA(CS101_ASDU self, int ca)
     if (ca < 0)
         setCa = 0;
     else {
-        if (self->parameters->sizeOfCA == 1) {
+        if (CS101_SIZE_OF_CA(self->parameters) == 1) {
             if (ca > 255)
                 setCa = 255;
         }
-        else if (self->parameters->sizeOfCA > 1) {
+        else if (CS101_SIZE_OF_CA(self->parameters) > 1) {
             if (ca > 65535)
                 setCa = 65535;
         }
     }
 
-    if (self->parameters->sizeOfCA == 1) {
+    if (CS101_SIZE_OF_CA(self->parameters) == 1) {
         self->asdu[caIndex] = (uint8_t) setCa;
     }
     else {
@@ -442,798 +687,774 @@ CS101_ASDU_getElement(CS101_ASDU self, int index)
     return CS101_ASDU_getElementEx(self, NULL, index);
 }
 
+typedef InformationObject (*DecodeFunction)(InformationObject self, CS101_AppLayerParameters parameters,
+        uint8_t* msg, int msgSize, int startIndex, bool isSequence);
+
+typedef InformationObject (*DecodeCommandFunction)(InformationObject self, CS101_AppLayerParameters parameters,
+        uint8_t* msg, int msgSize, int startIndex);
+
+/* encoding of the value that is returned by CS101_ASDU_getFloatAt */
+typedef enum {
+    ELEMENT_VALUE_NONE,
+    ELEMENT_VALUE_NORMALIZED, /* value / 32767 */
+    ELEMENT_VALUE_NORMALIZED_CENTERED, /* (value + 0.5) / 32767.5 like the getters of M_ME_ND_1 and C_SE_Nx_1 */
+    ELEMENT_VALUE_SCALED,
+    ELEMENT_VALUE_SHORT
+} ElementValueType;
+
+/* decoding information for the information objects of a type ID */
+typedef struct {
+    uint8_t elementSize; /* size of an information object without IOA (0 = ASDU only contains a single information object) */
+    DecodeFunction decode; /* types that support sequences of information objects (SQ = 1) */
+    DecodeCommandFunction decodeCommand; /* types without sequence support */
+    uint8_t valueType; /* ElementValueType of the value at the start of the information object */
+    int8_t qualityOffset; /* offset of the quality descriptor (-1 = no quality, 0 = quality bits of SIQ/DIQ) */
+    int8_t timestampOffset; /* offset of the CP56Time2a time tag (-1 = no CP56Time2a time tag) */
+} ElementType;
+
+static const ElementType elementTypes[128] = {
+    /*   0 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*   1 M_SP_NA_1 */ { 1, (DecodeFunction) SinglePointInformation_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 0, -1 },
+    /*   2 M_SP_TA_1 */ { 4, (DecodeFunction) SinglePointWithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 0, -1 },
+    /*   3 M_DP_NA_1 */ { 1, (DecodeFunction) DoublePointInformation_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 0, -1 },
+    /*   4 M_DP_TA_1 */ { 4, (DecodeFunction) DoublePointWithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 0, -1 },
+    /*   5 M_ST_NA_1 */ { 2, (DecodeFunction) StepPositionInformation_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 1, -1 },
+    /*   6 M_ST_TA_1 */ { 5, (DecodeFunction) StepPositionWithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 1, -1 },
+    /*   7 M_BO_NA_1 */ { 5, (DecodeFunction) BitString32_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 4, -1 },
+    /*   8 M_BO_TA_1 */ { 8, (DecodeFunction) Bitstring32WithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 4, -1 },
+    /*   9 M_ME_NA_1 */ { 3, (DecodeFunction) MeasuredValueNormalized_getFromBuffer, NULL, ELEMENT_VALUE_NORMALIZED, 2, -1 },
+    /*  10 M_ME_TA_1 */ { 6, (DecodeFunction) MeasuredValueNormalizedWithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NORMALIZED, 2, -1 },
+    /*  11 M_ME_NB_1 */ { 3, (DecodeFunction) MeasuredValueScaled_getFromBuffer, NULL, ELEMENT_VALUE_SCALED, 2, -1 },
+    /*  12 M_ME_TB_1 */ { 6, (DecodeFunction) MeasuredValueScaledWithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_SCALED, 2, -1 },
+    /*  13 M_ME_NC_1 */ { 5, (DecodeFunction) MeasuredValueShort_getFromBuffer, NULL, ELEMENT_VALUE_SHORT, 4, -1 },
+    /*  14 M_ME_TC_1 */ { 8, (DecodeFunction) MeasuredValueShortWithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_SHORT, 4, -1 },
+    /*  15 M_IT_NA_1 */ { 5, (DecodeFunction) IntegratedTotals_getFromBuffer, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  16 M_IT_TA_1 */ { 8, (DecodeFunction) IntegratedTotalsWithCP24Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  17 M_EP_TA_1 */ { 6, (DecodeFunction) EventOfProtectionEquipment_getFromBuffer, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  18 M_EP_TB_1 */ { 7, (DecodeFunction) PackedStartEventsOfProtectionEquipment_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 1, -1 },
+    /*  19 M_EP_TC_1 */ { 7, (DecodeFunction) PackedOutputCircuitInfo_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 1, -1 },
+    /*  20 M_PS_NA_1 */ { 5, (DecodeFunction) PackedSinglePointWithSCD_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 4, -1 },
+    /*  21 M_ME_ND_1 */ { 2, (DecodeFunction) MeasuredValueNormalizedWithoutQuality_getFromBuffer, NULL, ELEMENT_VALUE_NORMALIZED_CENTERED, -1, -1 },
+    /*  22 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  23 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  24 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  25 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  26 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  27 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  28 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  29 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  30 M_SP_TB_1 */ { 8, (DecodeFunction) SinglePointWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 0, 1 },
+    /*  31 M_DP_TB_1 */ { 8, (DecodeFunction) DoublePointWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 0, 1 },
+    /*  32 M_ST_TB_1 */ { 9, (DecodeFunction) StepPositionWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 1, 2 },
+    /*  33 M_BO_TB_1 */ { 12, (DecodeFunction) Bitstring32WithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 4, 5 },
+    /*  34 M_ME_TD_1 */ { 10, (DecodeFunction) MeasuredValueNormalizedWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NORMALIZED, 2, 3 },
+    /*  35 M_ME_TE_1 */ { 10, (DecodeFunction) MeasuredValueScaledWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_SCALED, 2, 3 },
+    /*  36 M_ME_TF_1 */ { 12, (DecodeFunction) MeasuredValueShortWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_SHORT, 4, 5 },
+    /*  37 M_IT_TB_1 */ { 12, (DecodeFunction) IntegratedTotalsWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, -1, 5 },
+    /*  38 M_EP_TD_1 */ { 10, (DecodeFunction) EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, -1, 3 },
+    /*  39 M_EP_TE_1 */ { 11, (DecodeFunction) PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 1, 4 },
+    /*  40 M_EP_TF_1 */ { 11, (DecodeFunction) PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer, NULL, ELEMENT_VALUE_NONE, 1, 4 },
+    /*  41 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  42 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  43 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  44 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  45 C_SC_NA_1 */ { 1, NULL, (DecodeCommandFunction) SingleCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  46 C_DC_NA_1 */ { 1, NULL, (DecodeCommandFunction) DoubleCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  47 C_RC_NA_1 */ { 1, NULL, (DecodeCommandFunction) StepCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  48 C_SE_NA_1 */ { 3, NULL, (DecodeCommandFunction) SetpointCommandNormalized_getFromBuffer, ELEMENT_VALUE_NORMALIZED_CENTERED, -1, -1 },
+    /*  49 C_SE_NB_1 */ { 3, NULL, (DecodeCommandFunction) SetpointCommandScaled_getFromBuffer, ELEMENT_VALUE_SCALED, -1, -1 },
+    /*  50 C_SE_NC_1 */ { 5, NULL, (DecodeCommandFunction) SetpointCommandShort_getFromBuffer, ELEMENT_VALUE_SHORT, -1, -1 },
+    /*  51 C_BO_NA_1 */ { 4, NULL, (DecodeCommandFunction) Bitstring32Command_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  52 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  53 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  54 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  55 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  56 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  57 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  58 C_SC_TA_1 */ { 8, NULL, (DecodeCommandFunction) SingleCommandWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_NONE, -1, 1 },
+    /*  59 C_DC_TA_1 */ { 8, NULL, (DecodeCommandFunction) DoubleCommandWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_NONE, -1, 1 },
+    /*  60 C_RC_TA_1 */ { 8, NULL, (DecodeCommandFunction) StepCommandWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_NONE, -1, 1 },
+    /*  61 C_SE_TA_1 */ { 10, NULL, (DecodeCommandFunction) SetpointCommandNormalizedWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_NORMALIZED_CENTERED, -1, 3 },
+    /*  62 C_SE_TB_1 */ { 10, NULL, (DecodeCommandFunction) SetpointCommandScaledWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_SCALED, -1, 3 },
+    /*  63 C_SE_TC_1 */ { 12, NULL, (DecodeCommandFunction) SetpointCommandShortWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_SHORT, -1, 5 },
+    /*  64 C_BO_TA_1 */ { 11, NULL, (DecodeCommandFunction) Bitstring32CommandWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_NONE, -1, 4 },
+    /*  65 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  66 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  67 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  68 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  69 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  70 M_EI_NA_1 */ { 0, NULL, (DecodeCommandFunction) EndOfInitialization_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  71 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  72 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  73 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  74 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  75 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  76 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  77 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  78 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  79 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  80 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  81 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  82 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  83 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  84 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  85 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  86 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  87 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  88 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  89 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  90 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  91 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  92 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  93 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  94 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  95 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  96 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  97 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  98 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /*  99 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 100 C_IC_NA_1 */ { 0, NULL, (DecodeCommandFunction) InterrogationCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 101 C_CI_NA_1 */ { 0, NULL, (DecodeCommandFunction) CounterInterrogationCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 102 C_RD_NA_1 */ { 0, NULL, (DecodeCommandFunction) ReadCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 103 C_CS_NA_1 */ { 0, NULL, (DecodeCommandFunction) ClockSynchronizationCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 104 C_TS_NA_1 */ { 0, NULL, (DecodeCommandFunction) TestCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 105 C_RP_NA_1 */ { 0, NULL, (DecodeCommandFunction) ResetProcessCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 106 C_CD_NA_1 */ { 0, NULL, (DecodeCommandFunction) DelayAcquisitionCommand_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 107 C_TS_TA_1 */ { 0, NULL, (DecodeCommandFunction) TestCommandWithCP56Time2a_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 108 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 109 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 110 P_ME_NA_1 */ { 3, NULL, (DecodeCommandFunction) ParameterNormalizedValue_getFromBuffer, ELEMENT_VALUE_NORMALIZED, -1, -1 },
+    /* 111 P_ME_NB_1 */ { 3, NULL, (DecodeCommandFunction) ParameterScaledValue_getFromBuffer, ELEMENT_VALUE_SCALED, -1, -1 },
+    /* 112 P_ME_NC_1 */ { 5, NULL, (DecodeCommandFunction) ParameterFloatValue_getFromBuffer, ELEMENT_VALUE_SHORT, -1, -1 },
+    /* 113 P_AC_NA_1 */ { 1, NULL, (DecodeCommandFunction) ParameterActivation_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 114 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 115 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 116 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 117 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 118 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 119 */ { 0, NULL, NULL, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 120 F_FR_NA_1 */ { 0, NULL, (DecodeCommandFunction) FileReady_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 121 F_SR_NA_1 */ { 0, NULL, (DecodeCommandFunction) SectionReady_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 122 F_SC_NA_1 */ { 0, NULL, (DecodeCommandFunction) FileCallOrSelect_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 123 F_LS_NA_1 */ { 0, NULL, (DecodeCommandFunction) FileLastSegmentOrSection_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 124 F_AF_NA_1 */ { 0, NULL, (DecodeCommandFunction) FileACK_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 125 F_SG_NA_1 */ { 0, NULL, (DecodeCommandFunction) FileSegment_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 },
+    /* 126 F_DR_TA_1 */ { 13, (DecodeFunction) FileDirectory_getFromBuffer, NULL, ELEMENT_VALUE_NONE, -1, 6 },
+    /* 127 F_SC_NB_1 */ { 0, NULL, (DecodeCommandFunction) QueryLog_getFromBuffer, ELEMENT_VALUE_NONE, -1, -1 }
+};
+
+static const ElementType*
+getElementType(TypeID typeId)
+{
+    if (((int) typeId < 128) && (elementTypes[typeId].decode || elementTypes[typeId].decodeCommand))
+        return &(elementTypes[typeId]);
+    else
+        return NULL;
+}
+
 InformationObject
 CS101_ASDU_getElementEx(CS101_ASDU self, InformationObject io, int index)
 {
     InformationObject retVal = NULL;
 
-    int elementSize;
-
-    switch (CS101_ASDU_getTypeID(self)) {
+    const ElementType* elementType = getElementType(CS101_ASDU_getTypeID(self));
 
-    case M_SP_NA_1: /* 1 */
+    if (elementType == NULL) {
+        DEBUG_PRINT("type %d not supported\n", CS101_ASDU_getTypeID(self));
+        return NULL;
+    }
 
-        elementSize = 1;
+    int sizeOfIOA = CS101_SIZE_OF_IOA(self->parameters);
+    int elementSize = elementType->elementSize;
 
+    if (elementType->decode) {
         if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) SinglePointInformation_getFromBuffer((SinglePointInformation) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+            retVal = elementType->decode(io, self->parameters, self->payload, self->payloadSize, sizeOfIOA + (index * elementSize), true);
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
+            if (retVal)
+                InformationObject_setObjectAddress(retVal, getFirstIOA(self) + index);
         }
         else
-            retVal  = (InformationObject) SinglePointInformation_getFromBuffer((SinglePointInformation) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+            retVal = elementType->decode(io, self->parameters, self->payload, self->payloadSize, index * (sizeOfIOA + elementSize), false);
+    }
+    else if (elementSize > 0) {
+        retVal = elementType->decodeCommand(io, self->parameters, self->payload, self->payloadSize, index * (sizeOfIOA + elementSize));
+    }
+    else {
+        /* ASDU contains only a single information object */
+        retVal = elementType->decodeCommand(io, self->parameters, self->payload, self->payloadSize, 0);
+    }
 
-        break;
+    return retVal;
+}
 
-    case M_SP_TA_1: /* 2 */
+/**********************************************
+ * Direct access to the information objects
+ **********************************************/
 
-        elementSize = 4;
+/* returns the start of the information object (after the IOA) or NULL when not available */
+static const uint8_t*
+getElementPointer(CS101_ASDU self, const ElementType* elementType, int index)
+{
+    if ((elementType == NULL) || (elementType->elementSize == 0))
+        return NULL;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) SinglePointWithCP24Time2a_getFromBuffer((SinglePointWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    if ((index < 0) || (index >= CS101_ASDU_getNumberOfElements(self)))
+        return NULL;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) SinglePointWithCP24Time2a_getFromBuffer((SinglePointWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+    int sizeOfIOA = CS101_SIZE_OF_IOA(self->parameters);
+    int elementSize = elementType->elementSize;
+    int position;
 
-        break;
+    if (elementType->decode && CS101_ASDU_isSequence(self))
+        position = sizeOfIOA + (index * elementSize);
+    else
+        position = (index * (sizeOfIOA + elementSize)) + sizeOfIOA;
 
-    case M_DP_NA_1: /* 3 */
+    if (position + elementSize > self->payloadSize)
+        return NULL;
 
-        elementSize = 1;
+    return self->payload + position;
+}
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) DoublePointInformation_getFromBuffer((DoublePointInformation) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+static float
+getShortFloat(const uint8_t* p)
+{
+    float value;
+    uint8_t* valueBytes = (uint8_t*) &value;
+
+#if (ORDER_LITTLE_ENDIAN == 1)
+    valueBytes[0] = p[0];
+    valueBytes[1] = p[1];
+    valueBytes[2] = p[2];
+    valueBytes[3] = p[3];
+#else
+    valueBytes[3] = p[0];
+    valueBytes[2] = p[1];
+    valueBytes[1] = p[2];
+    valueBytes[0] = p[3];
+#endif
+
+    return value;
+}
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) DoublePointInformation_getFromBuffer((DoublePointInformation) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+int
+CS101_ASDU_getIOAAt(CS101_ASDU self, int index)
+{
+    const ElementType* elementType = getElementType(CS101_ASDU_getTypeID(self));
 
+    int sizeOfIOA = CS101_SIZE_OF_IOA(self->parameters);
+    const uint8_t* p;
 
-        break;
+    if (elementType && (elementType->elementSize == 0)) {
+        /* ASDU contains only a single information object */
+        if ((index != 0) || (self->payloadSize < sizeOfIOA))
+            return -1;
 
-    case M_DP_TA_1: /* 4 */
+        p = self->payload;
+    }
+    else {
+        p = getElementPointer(self, elementType, index);
 
-        elementSize = 4;
+        if (p == NULL)
+            return -1;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) DoublePointWithCP24Time2a_getFromBuffer((DoublePointWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+        if (elementType->decode && CS101_ASDU_isSequence(self))
+            return getFirstIOA(self) + index;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) DoublePointWithCP24Time2a_getFromBuffer((DoublePointWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+        p -= sizeOfIOA;
+    }
 
-        break;
+    int ioa = p[0];
 
-    case M_ST_NA_1: /* 5 */
+    if (sizeOfIOA > 1)
+        ioa += (p[1] * 0x100);
 
-        elementSize = 2;
+    if (sizeOfIOA > 2)
+        ioa += (p[2] * 0x10000);
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) StepPositionInformation_getFromBuffer((StepPositionInformation) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    return ioa;
+}
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) StepPositionInformation_getFromBuffer((StepPositionInformation) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+float
+CS101_ASDU_getFloatAt(CS101_ASDU self, int index)
+{
+    const ElementType* elementType = getElementType(CS101_ASDU_getTypeID(self));
 
-        break;
+    const uint8_t* p = getElementPointer(self, elementType, index);
 
-    case M_ST_TA_1: /* 6 */
+    if (p == NULL)
+        return 0.f;
 
-        elementSize = 5;
+    switch (elementType->valueType) {
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) StepPositionWithCP24Time2a_getFromBuffer((StepPositionWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    case ELEMENT_VALUE_NORMALIZED:
+        return (float) ((int16_t) (p[0] + (p[1] * 0x100))) / 32767.f;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) StepPositionWithCP24Time2a_getFromBuffer((StepPositionWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+    case ELEMENT_VALUE_NORMALIZED_CENTERED:
+        return ((float) ((int16_t) (p[0] + (p[1] * 0x100))) + 0.5f) / 32767.5f;
 
-        break;
+    case ELEMENT_VALUE_SCALED:
+        return (float) ((int16_t) (p[0] + (p[1] * 0x100)));
+
+    case ELEMENT_VALUE_SHORT:
+        return getShortFloat(p);
 
-    case M_BO_NA_1: /* 7 */
+    default:
+        return 0.f;
+    }
+}
 
-        elementSize = 5;
+QualityDescriptor
+CS101_ASDU_getQualityAt(CS101_ASDU self, int index)
+{
+    const ElementType* elementType = getElementType(CS101_ASDU_getTypeID(self));
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) BitString32_getFromBuffer((BitString32) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    const uint8_t* p = getElementPointer(self, elementType, index);
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) BitString32_getFromBuffer((BitString32) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+    if (p == NULL)
+        return IEC60870_QUALITY_INVALID;
 
-        break;
+    if (elementType->qualityOffset < 0)
+        return IEC60870_QUALITY_GOOD;
+    else if (elementType->qualityOffset == 0)
+        return (QualityDescriptor) (p[0] & 0xf0);
+    else
+        return (QualityDescriptor) p[elementType->qualityOffset];
+}
 
-    case M_BO_TA_1: /* 8 */
+uint64_t
+CS101_ASDU_getCP56TimeMsAt(CS101_ASDU self, int index)
+{
+    const ElementType* elementType = getElementType(CS101_ASDU_getTypeID(self));
 
-        elementSize = 8;
+    const uint8_t* p = getElementPointer(self, elementType, index);
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) Bitstring32WithCP24Time2a_getFromBuffer((Bitstring32WithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    if ((p == NULL) || (elementType->timestampOffset < 0))
+        return 0;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) Bitstring32WithCP24Time2a_getFromBuffer((Bitstring32WithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+    return CP56Time2a_decodeMsTimestamp(p + elementType->timestampOffset, NULL);
+}
 
-        break;
+/**********************************************
+ * CS101_ASDUIterator
+ **********************************************/
+
+struct sCS101_ASDUIterator {
+    CS101_ASDU asdu;
+    const ElementType* elementType;
+    bool isSequence;
+    int index;
+    int numberOfElements;
+    int position; /* start of the next information object in the payload */
+    int stride;
+    int firstIOA; /* only used for sequences */
+    union uInformationObject io; /* storage for the current information object */
+};
 
-    case M_ME_NA_1: /* 9 */
+CS101_ASDUIterator
+CS101_ASDUIterator_create(void)
+{
+    CS101_ASDUIterator self = (CS101_ASDUIterator) GLOBAL_CALLOC(1, sizeof(struct sCS101_ASDUIterator));
 
-        elementSize = 3;
+    return self;
+}
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalized_getFromBuffer((MeasuredValueNormalized) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+void
+CS101_ASDUIterator_start(CS101_ASDUIterator self, CS101_ASDU asdu)
+{
+    int sizeOfIOA = CS101_SIZE_OF_IOA(asdu->parameters);
+
+    self->asdu = asdu;
+    self->elementType = getElementType(CS101_ASDU_getTypeID(asdu));
+    self->isSequence = CS101_ASDU_isSequence(asdu);
+    self->index = 0;
+    self->numberOfElements = CS101_ASDU_getNumberOfElements(asdu);
+    self->position = 0;
+
+    if (self->elementType == NULL) {
+        DEBUG_PRINT("type %d not supported\n", CS101_ASDU_getTypeID(asdu));
+        self->numberOfElements = 0;
+    }
+    else if (self->elementType->elementSize == 0) {
+        /* ASDU contains only a single information object */
+        if (self->numberOfElements > 1)
+            self->numberOfElements = 1;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
+        self->stride = 0;
+    }
+    else if (self->isSequence && self->elementType->decode) {
+        if (asdu->payloadSize < sizeOfIOA) {
+            self->numberOfElements = 0;
         }
-        else
-            retVal  = (InformationObject) MeasuredValueNormalized_getFromBuffer((MeasuredValueNormalized) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+        else {
+            self->firstIOA = getFirstIOA(asdu);
+            self->position = sizeOfIOA;
+            self->stride = self->elementType->elementSize;
+        }
+    }
+    else {
+        self->isSequence = false;
+        self->stride = sizeOfIOA + self->elementType->elementSize;
+    }
+}
 
-        break;
+InformationObject
+CS101_ASDUIterator_next(CS101_ASDUIterator self)
+{
+    InformationObject retVal;
 
-    case M_ME_TA_1: /* 10 */
+    if (self->index >= self->numberOfElements)
+        return NULL;
 
-        elementSize = 6;
+    CS101_ASDU asdu = self->asdu;
+    InformationObject io = (InformationObject) &(self->io);
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP24Time2a_getFromBuffer((MeasuredValueNormalizedWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    if (self->elementType->decode) {
+        retVal = self->elementType->decode(io, asdu->parameters, asdu->payload, asdu->payloadSize, self->position, self->isSequence);
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP24Time2a_getFromBuffer((MeasuredValueNormalizedWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+        if (retVal && self->isSequence)
+            InformationObject_setObjectAddress(retVal, self->firstIOA + self->index);
+    }
+    else {
+        retVal = self->elementType->decodeCommand(io, asdu->parameters, asdu->payload, asdu->payloadSize, self->position);
+    }
 
-        break;
+    if (retVal) {
+        self->position += self->stride;
+        self->index++;
+    }
+    else {
+        /* payload too small -> stop iteration */
+        self->numberOfElements = self->index;
+    }
 
-    case M_ME_NB_1: /* 11 */
+    return retVal;
+}
 
-        elementSize = 3;
+void
+CS101_ASDUIterator_destroy(CS101_ASDUIterator self)
+{
+    GLOBAL_FREEMEM(self);
+}
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueScaled_getFromBuffer((MeasuredValueScaled) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+/**********************************************
+ * Columnar decoding (CS101_ASDU_decodeColumns)
+ **********************************************/
+
+typedef enum {
+    COLUMN_VALUE_POINT,
+    COLUMN_VALUE_STEP_POSITION,
+    COLUMN_VALUE_BITSTRING,
+    COLUMN_VALUE_NORMALIZED,
+    COLUMN_VALUE_NORMALIZED_CENTERED,
+    COLUMN_VALUE_SCALED,
+    COLUMN_VALUE_SHORT,
+    COLUMN_VALUE_INTEGRATED_TOTALS
+} ColumnValueType;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) MeasuredValueScaled_getFromBuffer((MeasuredValueScaled) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+static void
+decodeColumnsIOA(CS101_ASDU self, int* ioa, int n, int stride, bool isSequence)
+{
+    int i;
 
-        break;
+    if (isSequence) {
+        int firstIOA = getFirstIOA(self);
+
+        for (i = 0; i < n; i++)
+            ioa[i] = firstIOA + i;
+    }
+    else {
+        const uint8_t* p = self->payload;
+        int sizeOfIOA = CS101_SIZE_OF_IOA(self->parameters);
 
-    case M_ME_TB_1: /* 12 */
+        for (i = 0; i < n; i++) {
+            int value = p[0];
 
-        elementSize = 6;
+            if (sizeOfIOA > 1)
+                value += (p[1] * 0x100);
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueScaledWithCP24Time2a_getFromBuffer((MeasuredValueScaledWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+            if (sizeOfIOA > 2)
+                value += (p[2] * 0x10000);
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
+            ioa[i] = value;
+
+            p += stride;
         }
-        else
-            retVal  = (InformationObject) MeasuredValueScaledWithCP24Time2a_getFromBuffer((MeasuredValueScaledWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+    }
+}
 
-        break;
+/* single point (SIQ) and double point (DIQ) information */
+static void
+decodeColumnsPoints(const uint8_t* p, int stride, int n, CS101_ASDUColumns columns, uint8_t valueMask)
+{
+    int i;
 
+    for (i = 0; i < n; i++) {
+        int value = p[0] & valueMask;
 
-    case M_ME_NC_1: /* 13 */
+        if (columns->value)
+            columns->value[i] = (float) value;
 
-        elementSize = 5;
+        if (columns->intValue)
+            columns->intValue[i] = value;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueShort_getFromBuffer((MeasuredValueShort) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+        if (columns->quality)
+            columns->quality[i] = p[0] & 0xf0;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) MeasuredValueShort_getFromBuffer((MeasuredValueShort) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-
-        break;
-
-    case M_ME_TC_1: /* 14 */
-
-        elementSize = 8;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueShortWithCP24Time2a_getFromBuffer((MeasuredValueShortWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) MeasuredValueShortWithCP24Time2a_getFromBuffer((MeasuredValueShortWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_IT_NA_1: /* 15 */
-
-        elementSize = 5;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) IntegratedTotals_getFromBuffer((IntegratedTotals) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) IntegratedTotals_getFromBuffer((IntegratedTotals) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_IT_TA_1: /* 16 */
-
-        elementSize = 8;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) IntegratedTotalsWithCP24Time2a_getFromBuffer((IntegratedTotalsWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) IntegratedTotalsWithCP24Time2a_getFromBuffer((IntegratedTotalsWithCP24Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_EP_TA_1: /* 17 */
-
-        elementSize = 6;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) EventOfProtectionEquipment_getFromBuffer((EventOfProtectionEquipment) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) EventOfProtectionEquipment_getFromBuffer((EventOfProtectionEquipment) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_EP_TB_1: /* 18 */
-
-        elementSize = 7;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipment_getFromBuffer((PackedStartEventsOfProtectionEquipment) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipment_getFromBuffer((PackedStartEventsOfProtectionEquipment) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_EP_TC_1: /* 19 */
-
-        elementSize = 7;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedOutputCircuitInfo_getFromBuffer((PackedOutputCircuitInfo) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) PackedOutputCircuitInfo_getFromBuffer((PackedOutputCircuitInfo) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_PS_NA_1: /* 20 */
-
-        elementSize = 5;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedSinglePointWithSCD_getFromBuffer((PackedSinglePointWithSCD) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) PackedSinglePointWithSCD_getFromBuffer((PackedSinglePointWithSCD) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_ME_ND_1: /* 21 */
-
-        elementSize = 2;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalizedWithoutQuality_getFromBuffer((MeasuredValueNormalizedWithoutQuality) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) MeasuredValueNormalizedWithoutQuality_getFromBuffer((MeasuredValueNormalizedWithoutQuality) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_SP_TB_1: /* 30 */
-
-        elementSize = 8;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) SinglePointWithCP56Time2a_getFromBuffer((SinglePointWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) SinglePointWithCP56Time2a_getFromBuffer((SinglePointWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_DP_TB_1: /* 31 */
-
-        elementSize = 8;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) DoublePointWithCP56Time2a_getFromBuffer((DoublePointWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) DoublePointWithCP56Time2a_getFromBuffer((DoublePointWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_ST_TB_1: /* 32 */
-
-        elementSize = 9;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) StepPositionWithCP56Time2a_getFromBuffer((StepPositionWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) StepPositionWithCP56Time2a_getFromBuffer((StepPositionWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_BO_TB_1: /* 33 */
-
-        elementSize = 12;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) Bitstring32WithCP56Time2a_getFromBuffer((Bitstring32WithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+        p += stride;
+    }
+}
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) Bitstring32WithCP56Time2a_getFromBuffer((Bitstring32WithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+static void
+decodeColumnsStepPositions(const uint8_t* p, int stride, int n, CS101_ASDUColumns columns)
+{
+    int i;
 
-        break;
+    for (i = 0; i < n; i++) {
+        int value = (p[0] & 0x7f);
 
-    case M_ME_TD_1: /* 34 */
+        if (value > 63)
+            value = value - 128;
 
-        elementSize = 10;
+        if (columns->value)
+            columns->value[i] = (float) value;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP56Time2a_getFromBuffer((MeasuredValueNormalizedWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+        if (columns->intValue)
+            columns->intValue[i] = value;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) MeasuredValueNormalizedWithCP56Time2a_getFromBuffer((MeasuredValueNormalizedWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+        if (columns->quality)
+            columns->quality[i] = p[1];
 
-        break;
-
-    case M_ME_TE_1: /* 35 */
+        p += stride;
+    }
+}
 
-        elementSize = 10;
+/* 32 bit values with quality (bitstring, binary counter reading) */
+static void
+decodeColumnsUInt32(const uint8_t* p, int stride, int n, CS101_ASDUColumns columns, bool isSigned)
+{
+    int i;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueScaledWithCP56Time2a_getFromBuffer((MeasuredValueScaledWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    for (i = 0; i < n; i++) {
+        uint32_t value = p[0] + ((uint32_t) p[1] * 0x100) + ((uint32_t) p[2] * 0x10000) + ((uint32_t) p[3] * 0x1000000);
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
+        if (columns->value) {
+            if (isSigned)
+                columns->value[i] = (float) ((int32_t) value);
+            else
+                columns->value[i] = (float) value;
         }
-        else
-            retVal  = (InformationObject) MeasuredValueScaledWithCP56Time2a_getFromBuffer((MeasuredValueScaledWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
 
-    case M_ME_TF_1: /* 36 */
+        if (columns->intValue)
+            columns->intValue[i] = (int32_t) value;
 
-        elementSize = 12;
+        if (columns->quality)
+            columns->quality[i] = p[4];
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) MeasuredValueShortWithCP56Time2a_getFromBuffer((MeasuredValueShortWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) MeasuredValueShortWithCP56Time2a_getFromBuffer((MeasuredValueShortWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_IT_TB_1: /* 37 */
+        p += stride;
+    }
+}
 
-        elementSize = 12;
+/* normalized and scaled values */
+static void
+decodeColumnsScaled(const uint8_t* p, int stride, int n, CS101_ASDUColumns columns, ElementValueType conversion, bool hasQuality)
+{
+    int i;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) IntegratedTotalsWithCP56Time2a_getFromBuffer((IntegratedTotalsWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    for (i = 0; i < n; i++) {
+        int16_t value = (int16_t) (p[0] + (p[1] * 0x100));
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
+        if (columns->value) {
+            if (conversion == ELEMENT_VALUE_NORMALIZED)
+                columns->value[i] = (float) value / 32767.f;
+            else if (conversion == ELEMENT_VALUE_NORMALIZED_CENTERED)
+                columns->value[i] = ((float) value + 0.5f) / 32767.5f;
+            else
+                columns->value[i] = (float) value;
         }
-        else
-            retVal  = (InformationObject) IntegratedTotalsWithCP56Time2a_getFromBuffer((IntegratedTotalsWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    case M_EP_TD_1: /* 38 */
 
-        elementSize = 10;
+        if (columns->intValue)
+            columns->intValue[i] = value;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer((EventOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+        if (columns->quality)
+            columns->quality[i] = hasQuality ? p[2] : 0;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer((EventOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
+        p += stride;
+    }
+}
 
-    case M_EP_TE_1: /* 39 */
+static void
+decodeColumnsShorts(const uint8_t* p, int stride, int n, CS101_ASDUColumns columns)
+{
+    int i;
 
-        elementSize = 11;
+    for (i = 0; i < n; i++) {
+        float value = getShortFloat(p);
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer((PackedStartEventsOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+        if (columns->value)
+            columns->value[i] = value;
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer((PackedStartEventsOfProtectionEquipmentWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
+        if (columns->intValue)
+            columns->intValue[i] = (int32_t) value;
 
-        break;
+        if (columns->quality)
+            columns->quality[i] = p[4];
 
-    case M_EP_TF_1: /* 40 */
+        p += stride;
+    }
+}
 
-        elementSize = 11;
+static void
+decodeColumnsTimestamps(const uint8_t* p, int stride, int n, uint64_t* timestamp, int timestampOffset)
+{
+    CP56Time2aHourCache cache;
+    int i;
 
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer((PackedOutputCircuitInfoWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
+    memset(&cache, 0, sizeof(cache));
 
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
+    for (i = 0; i < n; i++) {
+        if (timestampOffset < 0)
+            timestamp[i] = 0;
         else
-            retVal  = (InformationObject) PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer((PackedOutputCircuitInfoWithCP56Time2a) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
-        break;
-
-    /* 41 - 44 reserved */
-
-    case C_SC_NA_1: /* 45 */
-
-        elementSize = self->parameters->sizeOfIOA + 1;
-
-        retVal = (InformationObject) SingleCommand_getFromBuffer((SingleCommand) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-
-    case C_DC_NA_1: /* 46 */
-
-        elementSize = self->parameters->sizeOfIOA + 1;
-
-        retVal = (InformationObject) DoubleCommand_getFromBuffer((DoubleCommand) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_RC_NA_1: /* 47 */
-
-        elementSize = self->parameters->sizeOfIOA + 1;
-
-        retVal = (InformationObject) StepCommand_getFromBuffer((StepCommand) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_SE_NA_1: /* 48 - Set-point command, normalized value */
-
-        elementSize = self->parameters->sizeOfIOA + 3;
-
-        retVal = (InformationObject) SetpointCommandNormalized_getFromBuffer((SetpointCommandNormalized) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-
-    case C_SE_NB_1: /* 49 - Set-point command, scaled value */
-
-        elementSize = self->parameters->sizeOfIOA + 3;
-
-        retVal = (InformationObject) SetpointCommandScaled_getFromBuffer((SetpointCommandScaled) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_SE_NC_1: /* 50 - Set-point command, short floating point number */
-
-        elementSize = self->parameters->sizeOfIOA + 5;
-
-        retVal = (InformationObject) SetpointCommandShort_getFromBuffer((SetpointCommandShort) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_BO_NA_1: /* 51 - Bitstring command */
-
-        elementSize = self->parameters->sizeOfIOA + 4;
-
-        retVal = (InformationObject) Bitstring32Command_getFromBuffer((Bitstring32Command) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    /* 52 - 57 reserved */
-
-    case C_SC_TA_1: /* 58 - Single command with CP56Time2a */
-
-        elementSize = self->parameters->sizeOfIOA + 8;
-
-        retVal = (InformationObject) SingleCommandWithCP56Time2a_getFromBuffer((SingleCommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_DC_TA_1: /* 59 - Double command with CP56Time2a */
-
-        elementSize = self->parameters->sizeOfIOA + 8;
-
-        retVal = (InformationObject) DoubleCommandWithCP56Time2a_getFromBuffer((DoubleCommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_RC_TA_1: /* 60 - Step command with CP56Time2a */
-
-        elementSize = self->parameters->sizeOfIOA + 8;
-
-        retVal = (InformationObject) StepCommandWithCP56Time2a_getFromBuffer((StepCommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_SE_TA_1: /* 61 - Setpoint command, normalized value with CP56Time2a */
-
-        elementSize = self->parameters->sizeOfIOA + 10;
-
-        retVal = (InformationObject) SetpointCommandNormalizedWithCP56Time2a_getFromBuffer((SetpointCommandNormalizedWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_SE_TB_1: /* 62 - Setpoint command, scaled value with CP56Time2a */
-
-        elementSize = self->parameters->sizeOfIOA + 10;
-
-        retVal = (InformationObject) SetpointCommandScaledWithCP56Time2a_getFromBuffer((SetpointCommandScaledWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_SE_TC_1: /* 63 - Setpoint command, short value with CP56Time2a */
-
-        elementSize = self->parameters->sizeOfIOA + 12;
-
-        retVal = (InformationObject) SetpointCommandShortWithCP56Time2a_getFromBuffer((SetpointCommandShortWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case C_BO_TA_1: /* 64 - Bitstring command with CP56Time2a */
-
-        elementSize = self->parameters->sizeOfIOA + 11;
-
-        retVal = (InformationObject) Bitstring32CommandWithCP56Time2a_getFromBuffer((Bitstring32CommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
-        break;
-
-    case M_EI_NA_1: /* 70 - End of Initialization */
-
-        retVal = (InformationObject) EndOfInitialization_getFromBuffer((EndOfInitialization) io, self->parameters, self->payload, self->payloadSize,  0);
+            timestamp[i] = CP56Time2a_decodeMsTimestamp(p + timestampOffset, &cache);
 
-        break;
+        p += stride;
+    }
+}
 
-    case C_IC_NA_1: /* 100 - Interrogation command */
+int
+CS101_ASDU_decodeColumns(CS101_ASDU self, CS101_ASDUColumns columns)
+{
+    ColumnValueType valueType;
+    uint8_t pointValueMask = 0x01; /* SPI or DPI bits */
 
-        retVal = (InformationObject) InterrogationCommand_getFromBuffer((InterrogationCommand) io, self->parameters, self->payload, self->payloadSize,  0);
+    /* select the column decoder - element size and time tag offset are taken from the element types */
+    switch (CS101_ASDU_getTypeID(self)) {
 
+    case M_SP_NA_1:
+    case M_SP_TB_1:
+        valueType = COLUMN_VALUE_POINT;
         break;
 
-    case C_CI_NA_1: /* 101 - Counter interrogation command */
-
-        retVal = (InformationObject) CounterInterrogationCommand_getFromBuffer((CounterInterrogationCommand) io, self->parameters, self->payload, self->payloadSize,  0);
-
+    case M_DP_NA_1:
+    case M_DP_TB_1:
+        valueType = COLUMN_VALUE_POINT;
+        pointValueMask = 0x03;
         break;
 
-    case C_RD_NA_1: /* 102 - Read command */
-
-        retVal = (InformationObject) ReadCommand_getFromBuffer((ReadCommand) io, self->parameters, self->payload, self->payloadSize,  0);
-
+    case M_ST_NA_1:
+    case M_ST_TB_1:
+        valueType = COLUMN_VALUE_STEP_POSITION;
         break;
 
-    case C_CS_NA_1: /* 103 - Clock synchronization command */
-
-        retVal = (InformationObject) ClockSynchronizationCommand_getFromBuffer((ClockSynchronizationCommand) io, self->parameters, self->payload, self->payloadSize,  0);
-
+    case M_BO_NA_1:
+    case M_BO_TB_1:
+        valueType = COLUMN_VALUE_BITSTRING;
         break;
 
-    case C_TS_NA_1: /* 104 - Test command */
-
-        retVal = (InformationObject) TestCommand_getFromBuffer((TestCommand) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case M_ME_NA_1:
+    case M_ME_TD_1:
+        valueType = COLUMN_VALUE_NORMALIZED;
         break;
 
-    case C_RP_NA_1: /* 105 - Reset process command */
-
-        retVal = (InformationObject) ResetProcessCommand_getFromBuffer((ResetProcessCommand) io, self->parameters, self->payload, self->payloadSize,  0);
-
+    case M_ME_ND_1: /* normalized value without quality */
+        valueType = COLUMN_VALUE_NORMALIZED_CENTERED;
         break;
 
-    case C_CD_NA_1: /* 106 - Delay acquisition command */
-
-        retVal = (InformationObject) DelayAcquisitionCommand_getFromBuffer((DelayAcquisitionCommand) io, self->parameters, self->payload, self->payloadSize,  0);
-
+    case M_ME_NB_1:
+    case M_ME_TE_1:
+        valueType = COLUMN_VALUE_SCALED;
         break;
 
-    case C_TS_TA_1: /* 107 - Test command with time */
-
-        retVal = (InformationObject) TestCommandWithCP56Time2a_getFromBuffer((TestCommandWithCP56Time2a) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case M_ME_NC_1:
+    case M_ME_TF_1:
+        valueType = COLUMN_VALUE_SHORT;
         break;
 
-    case P_ME_NA_1: /* 110 - Parameter of measured values, normalized value */
-
-        elementSize = self->parameters->sizeOfIOA + 3;
-
-        retVal = (InformationObject) ParameterNormalizedValue_getFromBuffer((ParameterNormalizedValue) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
-
+    case M_IT_NA_1:
+    case M_IT_TB_1:
+        valueType = COLUMN_VALUE_INTEGRATED_TOTALS;
         break;
 
-    case P_ME_NB_1: /* 111 - Parameter of measured values, scaled value */
-
-        elementSize = self->parameters->sizeOfIOA + 3;
+    default:
+        DEBUG_PRINT("type %d not supported\n", CS101_ASDU_getTypeID(self));
+        return -1;
+    }
 
-        retVal = (InformationObject) ParameterScaledValue_getFromBuffer((ParameterScaledValue) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+    const ElementType* elementType = &(elementTypes[CS101_ASDU_getTypeID(self)]);
 
-        break;
+    int elementSize = elementType->elementSize;
+    int timestampOffset = elementType->timestampOffset; /* offset of CP56Time2a in the element (-1 = no timestamp) */
 
-    case P_ME_NC_1: /* 112 - Parameter of measured values, short floating point number */
+    bool isSequence = CS101_ASDU_isSequence(self);
+    int sizeOfIOA = CS101_SIZE_OF_IOA(self->parameters);
 
-        elementSize = self->parameters->sizeOfIOA + 5;
+    /* only decode the elements that are complete in the payload */
+    int available;
 
-        retVal = (InformationObject) ParameterFloatValue_getFromBuffer((ParameterFloatValue) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+    if (isSequence)
+        available = (self->payloadSize - sizeOfIOA) / elementSize;
+    else
+        available = self->payloadSize / (sizeOfIOA + elementSize);
 
-        break;
+    int n = CS101_ASDU_getNumberOfElements(self);
 
-    case P_AC_NA_1: /* 113 - Parameter for activation */
+    if (n > available)
+        n = available;
 
-        elementSize = self->parameters->sizeOfIOA + 1;
+    if (n > columns->maxElements)
+        n = columns->maxElements;
 
-        retVal = (InformationObject) ParameterActivation_getFromBuffer((ParameterActivation) io, self->parameters, self->payload, self->payloadSize,  index * elementSize);
+    if (n <= 0)
+        return 0;
 
-        break;
+    /* for sequences the elements follow the single IOA, otherwise each element is preceded by its IOA */
+    int stride = isSequence ? elementSize : (sizeOfIOA + elementSize);
+    const uint8_t* elements = self->payload + sizeOfIOA;
 
-    case F_FR_NA_1: /* 120 - File ready */
+    if (columns->ioa)
+        decodeColumnsIOA(self, columns->ioa, n, stride, isSequence);
 
-        retVal = (InformationObject) FileReady_getFromBuffer((FileReady) io, self->parameters, self->payload, self->payloadSize, 0);
+    switch (valueType) {
 
+    case COLUMN_VALUE_POINT:
+        decodeColumnsPoints(elements, stride, n, columns, pointValueMask);
         break;
 
-    case F_SR_NA_1: /* 121 - Section ready */
-
-        retVal = (InformationObject) SectionReady_getFromBuffer((SectionReady) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case COLUMN_VALUE_STEP_POSITION:
+        decodeColumnsStepPositions(elements, stride, n, columns);
         break;
 
-    case F_SC_NA_1: /* 122 - Call/Select directory/file/section */
-
-        retVal = (InformationObject) FileCallOrSelect_getFromBuffer((FileCallOrSelect) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case COLUMN_VALUE_BITSTRING:
+        decodeColumnsUInt32(elements, stride, n, columns, false);
         break;
 
-    case F_LS_NA_1: /* 123 - Last segment/section */
-
-        retVal = (InformationObject) FileLastSegmentOrSection_getFromBuffer((FileLastSegmentOrSection) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case COLUMN_VALUE_NORMALIZED:
+        decodeColumnsScaled(elements, stride, n, columns, ELEMENT_VALUE_NORMALIZED, true);
         break;
 
-    case F_AF_NA_1: /* 124 -  ACK file/section */
-
-        retVal = (InformationObject) FileACK_getFromBuffer((FileACK) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case COLUMN_VALUE_NORMALIZED_CENTERED:
+        decodeColumnsScaled(elements, stride, n, columns, ELEMENT_VALUE_NORMALIZED_CENTERED, false);
         break;
 
-    case F_SG_NA_1: /* 125 - File segment */
-
-        retVal = (InformationObject) FileSegment_getFromBuffer((FileSegment) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case COLUMN_VALUE_SCALED:
+        decodeColumnsScaled(elements, stride, n, columns, ELEMENT_VALUE_SCALED, true);
         break;
 
-    case F_DR_TA_1: /* 126 - File directory */
-
-        elementSize = 13;
-
-        if (CS101_ASDU_isSequence(self)) {
-            retVal  = (InformationObject) FileDirectory_getFromBuffer((FileDirectory) io, self->parameters,
-                    self->payload, self->payloadSize, self->parameters->sizeOfIOA + (index * elementSize), true);
-
-            InformationObject_setObjectAddress(retVal, InformationObject_ParseObjectAddress(self->parameters, self->payload, 0) + index);
-        }
-        else
-            retVal  = (InformationObject) FileDirectory_getFromBuffer((FileDirectory) io, self->parameters,
-                    self->payload, self->payloadSize, index * (self->parameters->sizeOfIOA + elementSize), false);
-
+    case COLUMN_VALUE_SHORT:
+        decodeColumnsShorts(elements, stride, n, columns);
         break;
 
-    case F_SC_NB_1: /* 127 - QueryLog */
-
-        retVal = (InformationObject) QueryLog_getFromBuffer((QueryLog) io, self->parameters, self->payload, self->payloadSize, 0);
-
+    case COLUMN_VALUE_INTEGRATED_TOTALS:
+        decodeColumnsUInt32(elements, stride, n, columns, true);
         break;
-
-    default:
-    	DEBUG_PRINT("type %d not supported\n", CS101_ASDU_getTypeID(self));
-    	break;
     }
 
-    return retVal;
+    if (columns->timestamp)
+        decodeColumnsTimestamps(elements, stride, n, columns->timestamp, timestampOffset);
+
+    return n;
 }
 
 const char*
@@ -175,10 +175,10 @@ InformationObject_encodeBase(InformationObject self, Frame frame, CS101_AppLayer
     if (!isSequence) {
         Frame_setNextByte(frame, (uint8_t)(self->objectAddress & 0xff));
 
-        if (parameters->sizeOfIOA > 1)
+        if (CS101_SIZE_OF_IOA(parameters) > 1)
             Frame_setNextByte(frame, (uint8_t)((self->objectAddress / 0x100) & 0xff));
 
-        if (parameters->sizeOfIOA > 2)
+        if (CS101_SIZE_OF_IOA(parameters) > 2)
             Frame_setNextByte(frame, (uint8_t)((self->objectAddress / 0x10000) & 0xff));
     }
 }
@@ -189,10 +189,10 @@ InformationObject_ParseObjectAddress(CS101_AppLayerParameters parameters, const
     /* parse information object address */
     int ioa = msg [startIndex];
 
-    if (parameters->sizeOfIOA > 1)
+    if (CS101_SIZE_OF_IOA(parameters) > 1)
         ioa += (msg [startIndex + 1] * 0x100);
 
-    if (parameters->sizeOfIOA > 2)
+    if (CS101_SIZE_OF_IOA(parameters) > 2)
         ioa += (msg [startIndex + 2] * 0x10000);
 
     return ioa;
@@ -219,7 +219,7 @@ InformationObject_getMaxSizeInMemory()
 static bool
 SinglePointInformation_encode(SinglePointInformation self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -280,7 +280,7 @@ SinglePointInformation_getFromBuffer(SinglePointInformation self, CS101_AppLayer
     int minSize = startIndex + 1;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -296,7 +296,7 @@ SinglePointInformation_getFromBuffer(SinglePointInformation self, CS101_AppLayer
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse SIQ (single point information with quality) */
@@ -330,7 +330,7 @@ SinglePointInformation_getQuality(SinglePointInformation self)
 static bool
 StepPositionInformation_encode(StepPositionInformation self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 2 : (parameters->sizeOfIOA + 2);
+    int size = isSequence ? 2 : (CS101_SIZE_OF_IOA(parameters) + 2);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -431,7 +431,7 @@ StepPositionInformation_getFromBuffer(StepPositionInformation self, CS101_AppLay
     int minSize = startIndex + 2;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -447,7 +447,7 @@ StepPositionInformation_getFromBuffer(StepPositionInformation self, CS101_AppLay
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse VTI (value with transient state indication) */
@@ -467,7 +467,7 @@ StepPositionInformation_getFromBuffer(StepPositionInformation self, CS101_AppLay
 static bool
 StepPositionWithCP56Time2a_encode(StepPositionWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 9 : (parameters->sizeOfIOA + 9);
+    int size = isSequence ? 9 : (CS101_SIZE_OF_IOA(parameters) + 9);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -549,7 +549,7 @@ StepPositionWithCP56Time2a_getFromBuffer(StepPositionWithCP56Time2a self, CS101_
     int minSize = startIndex + 9;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -565,7 +565,7 @@ StepPositionWithCP56Time2a_getFromBuffer(StepPositionWithCP56Time2a self, CS101_
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse VTI (value with transient state indication) */
@@ -587,7 +587,7 @@ StepPositionWithCP56Time2a_getFromBuffer(StepPositionWithCP56Time2a self, CS101_
 static bool
 StepPositionWithCP24Time2a_encode(StepPositionWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 5 : (parameters->sizeOfIOA + 5);
+    int size = isSequence ? 5 : (CS101_SIZE_OF_IOA(parameters) + 5);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -670,7 +670,7 @@ StepPositionWithCP24Time2a_getFromBuffer(StepPositionWithCP24Time2a self, CS101_
     int minSize = startIndex + 5;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -686,7 +686,7 @@ StepPositionWithCP24Time2a_getFromBuffer(StepPositionWithCP24Time2a self, CS101_
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse VTI (value with transient state indication) */
@@ -708,7 +708,7 @@ StepPositionWithCP24Time2a_getFromBuffer(StepPositionWithCP24Time2a self, CS101_
 static bool
 DoublePointInformation_encode(DoublePointInformation self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -780,7 +780,7 @@ DoublePointInformation_getFromBuffer(DoublePointInformation self, CS101_AppLayer
     int minSize = startIndex + 1;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -796,7 +796,7 @@ DoublePointInformation_getFromBuffer(DoublePointInformation self, CS101_AppLayer
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse DIQ (double point information with quality) */
@@ -818,7 +818,7 @@ DoublePointInformation_getFromBuffer(DoublePointInformation self, CS101_AppLayer
 static bool
 DoublePointWithCP24Time2a_encode(DoublePointWithCP24Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 4 : (parameters->sizeOfIOA + 4);
+    int size = isSequence ? 4 : (CS101_SIZE_OF_IOA(parameters) + 4);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -889,7 +889,7 @@ DoublePointWithCP24Time2a_getFromBuffer(DoublePointWithCP24Time2a self, CS101_Ap
     int minSize = startIndex + 4;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -905,7 +905,7 @@ DoublePointWithCP24Time2a_getFromBuffer(DoublePointWithCP24Time2a self, CS101_Ap
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse DIQ (double point information with quality) */
@@ -929,7 +929,7 @@ DoublePointWithCP24Time2a_getFromBuffer(DoublePointWithCP24Time2a self, CS101_Ap
 static bool
 DoublePointWithCP56Time2a_encode(DoublePointWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -999,7 +999,7 @@ DoublePointWithCP56Time2a_getFromBuffer(DoublePointWithCP56Time2a self, CS101_Ap
     int minSize = startIndex + 8;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1015,7 +1015,7 @@ DoublePointWithCP56Time2a_getFromBuffer(DoublePointWithCP56Time2a self, CS101_Ap
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse DIQ (double point information with quality) */
@@ -1039,7 +1039,7 @@ DoublePointWithCP56Time2a_getFromBuffer(DoublePointWithCP56Time2a self, CS101_Ap
 static bool
 SinglePointWithCP24Time2a_encode(SinglePointWithCP24Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 4 : (parameters->sizeOfIOA + 4);
+    int size = isSequence ? 4 : (CS101_SIZE_OF_IOA(parameters) + 4);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -1110,7 +1110,7 @@ SinglePointWithCP24Time2a_getFromBuffer(SinglePointWithCP24Time2a self, CS101_Ap
     int minSize = startIndex + 4;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1126,7 +1126,7 @@ SinglePointWithCP24Time2a_getFromBuffer(SinglePointWithCP24Time2a self, CS101_Ap
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse SIQ (single point information with qualitiy) */
@@ -1150,7 +1150,7 @@ SinglePointWithCP24Time2a_getFromBuffer(SinglePointWithCP24Time2a self, CS101_Ap
 static bool
 SinglePointWithCP56Time2a_encode(SinglePointWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -1221,7 +1221,7 @@ SinglePointWithCP56Time2a_getFromBuffer(SinglePointWithCP56Time2a self, CS101_Ap
     int minSize = startIndex + 8;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1237,7 +1237,7 @@ SinglePointWithCP56Time2a_getFromBuffer(SinglePointWithCP56Time2a self, CS101_Ap
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* parse SIQ (single point information with qualitiy) */
@@ -1261,7 +1261,7 @@ SinglePointWithCP56Time2a_getFromBuffer(SinglePointWithCP56Time2a self, CS101_Ap
 static bool
 BitString32_encode(BitString32 self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 5 : (parameters->sizeOfIOA + 5);
+    int size = isSequence ? 5 : (CS101_SIZE_OF_IOA(parameters) + 5);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -1341,7 +1341,7 @@ BitString32_getFromBuffer(BitString32 self, CS101_AppLayerParameters parameters,
     int minSize = startIndex + 5;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1357,7 +1357,7 @@ BitString32_getFromBuffer(BitString32 self, CS101_AppLayerParameters parameters,
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         uint32_t value;
@@ -1382,7 +1382,7 @@ BitString32_getFromBuffer(BitString32 self, CS101_AppLayerParameters parameters,
 static bool
 Bitstring32WithCP24Time2a_encode(Bitstring32WithCP24Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -1460,7 +1460,7 @@ Bitstring32WithCP24Time2a_getFromBuffer(Bitstring32WithCP24Time2a self, CS101_Ap
     int minSize = startIndex + 8;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1476,7 +1476,7 @@ Bitstring32WithCP24Time2a_getFromBuffer(Bitstring32WithCP24Time2a self, CS101_Ap
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         uint32_t value;
@@ -1504,7 +1504,7 @@ Bitstring32WithCP24Time2a_getFromBuffer(Bitstring32WithCP24Time2a self, CS101_Ap
 static bool
 Bitstring32WithCP56Time2a_encode(Bitstring32WithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 12 : (parameters->sizeOfIOA + 12);
+    int size = isSequence ? 12 : (CS101_SIZE_OF_IOA(parameters) + 12);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -1582,7 +1582,7 @@ Bitstring32WithCP56Time2a_getFromBuffer(Bitstring32WithCP56Time2a self, CS101_Ap
     int minSize = startIndex + 12;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1598,7 +1598,7 @@ Bitstring32WithCP56Time2a_getFromBuffer(Bitstring32WithCP56Time2a self, CS101_Ap
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         uint32_t value;
@@ -1654,7 +1654,7 @@ setScaledValue(uint8_t* encodedValue, int value)
 static bool
 MeasuredValueNormalized_encode(MeasuredValueNormalized self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 3 : (parameters->sizeOfIOA + 3);
+    int size = isSequence ? 3 : (CS101_SIZE_OF_IOA(parameters) + 3);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -1741,7 +1741,7 @@ MeasuredValueNormalized_getFromBuffer(MeasuredValueNormalized self, CS101_AppLay
     int minSize = startIndex + 3;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1757,7 +1757,7 @@ MeasuredValueNormalized_getFromBuffer(MeasuredValueNormalized self, CS101_AppLay
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         self->encodedValue[0] = msg [startIndex++];
@@ -1833,7 +1833,7 @@ ParameterNormalizedValue_getFromBuffer(ParameterNormalizedValue self, CS101_AppL
 static bool
 MeasuredValueNormalizedWithoutQuality_encode(MeasuredValueNormalizedWithoutQuality self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 2 : (parameters->sizeOfIOA + 2);
+    int size = isSequence ? 2 : (CS101_SIZE_OF_IOA(parameters) + 2);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -1910,7 +1910,7 @@ MeasuredValueNormalizedWithoutQuality_getFromBuffer(MeasuredValueNormalizedWitho
     int minSize = startIndex + 2;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -1926,7 +1926,7 @@ MeasuredValueNormalizedWithoutQuality_getFromBuffer(MeasuredValueNormalizedWitho
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         self->encodedValue[0] = msg [startIndex++];
@@ -1943,7 +1943,7 @@ MeasuredValueNormalizedWithoutQuality_getFromBuffer(MeasuredValueNormalizedWitho
 static bool
 MeasuredValueNormalizedWithCP24Time2a_encode(MeasuredValueNormalizedWithCP24Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 6 : (parameters->sizeOfIOA + 6);
+    int size = isSequence ? 6 : (CS101_SIZE_OF_IOA(parameters) + 6);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -2019,7 +2019,7 @@ MeasuredValueNormalizedWithCP24Time2a_getFromBuffer(MeasuredValueNormalizedWithC
     int minSize = startIndex + 6;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2035,7 +2035,7 @@ MeasuredValueNormalizedWithCP24Time2a_getFromBuffer(MeasuredValueNormalizedWithC
         if (!isSequence) {
              InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-             startIndex += parameters->sizeOfIOA; /* skip IOA */
+             startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
          }
 
         self->encodedValue[0] = msg [startIndex++];
@@ -2058,7 +2058,7 @@ MeasuredValueNormalizedWithCP24Time2a_getFromBuffer(MeasuredValueNormalizedWithC
 static bool
 MeasuredValueNormalizedWithCP56Time2a_encode(MeasuredValueNormalizedWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 10 : (parameters->sizeOfIOA + 10);
+    int size = isSequence ? 10 : (CS101_SIZE_OF_IOA(parameters) + 10);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -2134,7 +2134,7 @@ MeasuredValueNormalizedWithCP56Time2a_getFromBuffer(MeasuredValueNormalizedWithC
     int minSize = startIndex + 10;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2150,7 +2150,7 @@ MeasuredValueNormalizedWithCP56Time2a_getFromBuffer(MeasuredValueNormalizedWithC
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         self->encodedValue[0] = msg [startIndex++];
@@ -2245,7 +2245,7 @@ MeasuredValueScaled_getFromBuffer(MeasuredValueScaled self, CS101_AppLayerParame
     int minSize = startIndex + 3;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2261,7 +2261,7 @@ MeasuredValueScaled_getFromBuffer(MeasuredValueScaled self, CS101_AppLayerParame
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         self->encodedValue[0] = msg [startIndex++];
@@ -2336,7 +2336,7 @@ ParameterScaledValue_getFromBuffer(ParameterScaledValue self, CS101_AppLayerPara
 static bool
 MeasuredValueScaledWithCP24Time2a_encode(MeasuredValueScaledWithCP24Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 6 : (parameters->sizeOfIOA + 6);
+    int size = isSequence ? 6 : (CS101_SIZE_OF_IOA(parameters) + 6);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -2409,7 +2409,7 @@ MeasuredValueScaledWithCP24Time2a_getFromBuffer(MeasuredValueScaledWithCP24Time2
     int minSize = startIndex + 6;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2425,7 +2425,7 @@ MeasuredValueScaledWithCP24Time2a_getFromBuffer(MeasuredValueScaledWithCP24Time2
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         self->encodedValue[0] = msg [startIndex++];
@@ -2448,7 +2448,7 @@ MeasuredValueScaledWithCP24Time2a_getFromBuffer(MeasuredValueScaledWithCP24Time2
 static bool
 MeasuredValueScaledWithCP56Time2a_encode(MeasuredValueScaledWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 10 : (parameters->sizeOfIOA + 10);
+    int size = isSequence ? 10 : (CS101_SIZE_OF_IOA(parameters) + 10);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -2522,7 +2522,7 @@ MeasuredValueScaledWithCP56Time2a_getFromBuffer(MeasuredValueScaledWithCP56Time2
     int minSize = startIndex + 10;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2538,7 +2538,7 @@ MeasuredValueScaledWithCP56Time2a_getFromBuffer(MeasuredValueScaledWithCP56Time2
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* scaled value */
@@ -2562,7 +2562,7 @@ MeasuredValueScaledWithCP56Time2a_getFromBuffer(MeasuredValueScaledWithCP56Time2
 static bool
 MeasuredValueShort_encode(MeasuredValueShort self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 5 : (parameters->sizeOfIOA + 5);
+    int size = isSequence ? 5 : (CS101_SIZE_OF_IOA(parameters) + 5);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -2646,7 +2646,7 @@ MeasuredValueShort_getFromBuffer(MeasuredValueShort self, CS101_AppLayerParamete
     int minSize = startIndex + 5;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2662,7 +2662,7 @@ MeasuredValueShort_getFromBuffer(MeasuredValueShort self, CS101_AppLayerParamete
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         uint8_t* valueBytes = (uint8_t*) &(self->value);
@@ -2748,7 +2748,7 @@ ParameterFloatValue_getFromBuffer(ParameterFloatValue self, CS101_AppLayerParame
 static bool
 MeasuredValueShortWithCP24Time2a_encode(MeasuredValueShortWithCP24Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -2821,7 +2821,7 @@ MeasuredValueShortWithCP24Time2a_getFromBuffer(MeasuredValueShortWithCP24Time2a
     int minSize = startIndex + 8;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2837,7 +2837,7 @@ MeasuredValueShortWithCP24Time2a_getFromBuffer(MeasuredValueShortWithCP24Time2a
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         uint8_t* valueBytes = (uint8_t*) &(self->value);
@@ -2871,7 +2871,7 @@ MeasuredValueShortWithCP24Time2a_getFromBuffer(MeasuredValueShortWithCP24Time2a
 static bool
 MeasuredValueShortWithCP56Time2a_encode(MeasuredValueShortWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 12 : (parameters->sizeOfIOA + 12);
+    int size = isSequence ? 12 : (CS101_SIZE_OF_IOA(parameters) + 12);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -2944,7 +2944,7 @@ MeasuredValueShortWithCP56Time2a_getFromBuffer(MeasuredValueShortWithCP56Time2a
     int minSize = startIndex + 12;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -2960,7 +2960,7 @@ MeasuredValueShortWithCP56Time2a_getFromBuffer(MeasuredValueShortWithCP56Time2a
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         uint8_t* valueBytes = (uint8_t*) &(self->value);
@@ -2994,7 +2994,7 @@ MeasuredValueShortWithCP56Time2a_getFromBuffer(MeasuredValueShortWithCP56Time2a
 static bool
 IntegratedTotals_encode(IntegratedTotals self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 5 : (parameters->sizeOfIOA + 5);
+    int size = isSequence ? 5 : (CS101_SIZE_OF_IOA(parameters) + 5);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3063,7 +3063,7 @@ IntegratedTotals_getFromBuffer(IntegratedTotals self, CS101_AppLayerParameters p
     int minSize = startIndex + 5;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3079,7 +3079,7 @@ IntegratedTotals_getFromBuffer(IntegratedTotals self, CS101_AppLayerParameters p
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* BCR */
@@ -3099,7 +3099,7 @@ IntegratedTotals_getFromBuffer(IntegratedTotals self, CS101_AppLayerParameters p
 static bool
 IntegratedTotalsWithCP24Time2a_encode(IntegratedTotalsWithCP24Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3171,7 +3171,7 @@ IntegratedTotalsWithCP24Time2a_getFromBuffer(IntegratedTotalsWithCP24Time2a self
     int minSize = startIndex + 8;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3187,7 +3187,7 @@ IntegratedTotalsWithCP24Time2a_getFromBuffer(IntegratedTotalsWithCP24Time2a self
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* BCR */
@@ -3211,7 +3211,7 @@ IntegratedTotalsWithCP24Time2a_getFromBuffer(IntegratedTotalsWithCP24Time2a self
 static bool
 IntegratedTotalsWithCP56Time2a_encode(IntegratedTotalsWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 12 : (parameters->sizeOfIOA + 12);
+    int size = isSequence ? 12 : (CS101_SIZE_OF_IOA(parameters) + 12);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3283,7 +3283,7 @@ IntegratedTotalsWithCP56Time2a_getFromBuffer(IntegratedTotalsWithCP56Time2a self
     int minSize = startIndex + 12;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3299,7 +3299,7 @@ IntegratedTotalsWithCP56Time2a_getFromBuffer(IntegratedTotalsWithCP56Time2a self
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* BCR */
@@ -3322,7 +3322,7 @@ IntegratedTotalsWithCP56Time2a_getFromBuffer(IntegratedTotalsWithCP56Time2a self
 static bool
 EventOfProtectionEquipment_encode(EventOfProtectionEquipment self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 6 : (parameters->sizeOfIOA + 6);
+    int size = isSequence ? 6 : (CS101_SIZE_OF_IOA(parameters) + 6);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3383,7 +3383,7 @@ EventOfProtectionEquipment_getFromBuffer(EventOfProtectionEquipment self, CS101_
     int minSize = startIndex + 6;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3399,7 +3399,7 @@ EventOfProtectionEquipment_getFromBuffer(EventOfProtectionEquipment self, CS101_
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* event */
@@ -3441,7 +3441,7 @@ EventOfProtectionEquipment_getTimestamp(EventOfProtectionEquipment self)
 static bool
 EventOfProtectionEquipmentWithCP56Time2a_encode(EventOfProtectionEquipmentWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 10 : (parameters->sizeOfIOA + 10);
+    int size = isSequence ? 10 : (CS101_SIZE_OF_IOA(parameters) + 10);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3520,7 +3520,7 @@ EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer(EventOfProtectionEquipmen
     int minSize = startIndex + 10;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3536,7 +3536,7 @@ EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer(EventOfProtectionEquipmen
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* event */
@@ -3560,7 +3560,7 @@ EventOfProtectionEquipmentWithCP56Time2a_getFromBuffer(EventOfProtectionEquipmen
 static bool
 PackedStartEventsOfProtectionEquipment_encode(PackedStartEventsOfProtectionEquipment self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 7 : (parameters->sizeOfIOA + 7);
+    int size = isSequence ? 7 : (CS101_SIZE_OF_IOA(parameters) + 7);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3648,7 +3648,7 @@ PackedStartEventsOfProtectionEquipment_getFromBuffer(PackedStartEventsOfProtecti
     int minSize = startIndex + 7;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3664,7 +3664,7 @@ PackedStartEventsOfProtectionEquipment_getFromBuffer(PackedStartEventsOfProtecti
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* event */
@@ -3691,7 +3691,7 @@ PackedStartEventsOfProtectionEquipment_getFromBuffer(PackedStartEventsOfProtecti
 static bool
 PackedStartEventsOfProtectionEquipmentWithCP56Time2a_encode(PackedStartEventsOfProtectionEquipmentWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 11 : (parameters->sizeOfIOA + 11);
+    int size = isSequence ? 11 : (CS101_SIZE_OF_IOA(parameters) + 11);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3779,7 +3779,7 @@ PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer(PackedStartEv
     int minSize = startIndex + 11;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3795,7 +3795,7 @@ PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer(PackedStartEv
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* event */
@@ -3822,7 +3822,7 @@ PackedStartEventsOfProtectionEquipmentWithCP56Time2a_getFromBuffer(PackedStartEv
 static bool
 PacketOutputCircuitInfo_encode(PackedOutputCircuitInfo self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 7 : (parameters->sizeOfIOA + 7);
+    int size = isSequence ? 7 : (CS101_SIZE_OF_IOA(parameters) + 7);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -3910,7 +3910,7 @@ PackedOutputCircuitInfo_getFromBuffer(PackedOutputCircuitInfo self, CS101_AppLay
     int minSize = startIndex + 7;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -3926,7 +3926,7 @@ PackedOutputCircuitInfo_getFromBuffer(PackedOutputCircuitInfo self, CS101_AppLay
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* OCI - output circuit information */
@@ -3953,7 +3953,7 @@ PackedOutputCircuitInfo_getFromBuffer(PackedOutputCircuitInfo self, CS101_AppLay
 static bool
 PackedOutputCircuitInfoWithCP56Time2a_encode(PackedOutputCircuitInfoWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 11 : (parameters->sizeOfIOA + 11);
+    int size = isSequence ? 11 : (CS101_SIZE_OF_IOA(parameters) + 11);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4041,7 +4041,7 @@ PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer(PackedOutputCircuitInfoWithC
     int minSize = startIndex + 11;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4057,7 +4057,7 @@ PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer(PackedOutputCircuitInfoWithC
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* OCI - output circuit information */
@@ -4085,7 +4085,7 @@ PackedOutputCircuitInfoWithCP56Time2a_getFromBuffer(PackedOutputCircuitInfoWithC
 static bool
 PackedSinglePointWithSCD_encode(PackedSinglePointWithSCD self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 5 : (parameters->sizeOfIOA + 5);
+    int size = isSequence ? 5 : (CS101_SIZE_OF_IOA(parameters) + 5);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4155,7 +4155,7 @@ PackedSinglePointWithSCD_getFromBuffer(PackedSinglePointWithSCD self, CS101_AppL
     int minSize = startIndex + 5;
 
     if (!isSequence)
-        minSize += parameters->sizeOfIOA;
+        minSize += CS101_SIZE_OF_IOA(parameters);
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4171,7 +4171,7 @@ PackedSinglePointWithSCD_getFromBuffer(PackedSinglePointWithSCD self, CS101_AppL
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         /* SCD */
@@ -4194,7 +4194,7 @@ PackedSinglePointWithSCD_getFromBuffer(PackedSinglePointWithSCD self, CS101_AppL
 static bool
 SingleCommand_encode(SingleCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4270,7 +4270,7 @@ SingleCommand_getFromBuffer(SingleCommand self, CS101_AppLayerParameters paramet
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4285,7 +4285,7 @@ SingleCommand_getFromBuffer(SingleCommand self, CS101_AppLayerParameters paramet
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* SCO */
         self->sco = msg[startIndex];
@@ -4302,7 +4302,7 @@ SingleCommand_getFromBuffer(SingleCommand self, CS101_AppLayerParameters paramet
 static bool
 SingleCommandWithCP56Time2a_encode(SingleCommandWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4368,7 +4368,7 @@ SingleCommandWithCP56Time2a_getFromBuffer(SingleCommandWithCP56Time2a self, CS10
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 8;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 8;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4383,7 +4383,7 @@ SingleCommandWithCP56Time2a_getFromBuffer(SingleCommandWithCP56Time2a self, CS10
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* SCO */
         self->sco = msg[startIndex++];
@@ -4402,7 +4402,7 @@ SingleCommandWithCP56Time2a_getFromBuffer(SingleCommandWithCP56Time2a self, CS10
 static bool
 DoubleCommand_encode(DoubleCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4478,7 +4478,7 @@ DoubleCommand_getFromBuffer(DoubleCommand self, CS101_AppLayerParameters paramet
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4493,7 +4493,7 @@ DoubleCommand_getFromBuffer(DoubleCommand self, CS101_AppLayerParameters paramet
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* SCO */
         self->dcq = msg[startIndex];
@@ -4509,7 +4509,7 @@ DoubleCommand_getFromBuffer(DoubleCommand self, CS101_AppLayerParameters paramet
 static bool
 DoubleCommandWithCP56Time2a_encode(DoubleCommandWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4587,7 +4587,7 @@ DoubleCommandWithCP56Time2a_getFromBuffer(DoubleCommandWithCP56Time2a self, CS10
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 8;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 8;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4602,7 +4602,7 @@ DoubleCommandWithCP56Time2a_getFromBuffer(DoubleCommandWithCP56Time2a self, CS10
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* DCQ */
         self->dcq = msg[startIndex++];
@@ -4627,7 +4627,7 @@ DoubleCommandWithCP56Time2a_getTimestamp(DoubleCommandWithCP56Time2a self)
 static bool
 StepCommand_encode(StepCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4705,7 +4705,7 @@ StepCommand_getFromBuffer(StepCommand self, CS101_AppLayerParameters parameters,
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4720,7 +4720,7 @@ StepCommand_getFromBuffer(StepCommand self, CS101_AppLayerParameters parameters,
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* SCO */
         self->dcq = msg[startIndex];
@@ -4736,7 +4736,7 @@ StepCommand_getFromBuffer(StepCommand self, CS101_AppLayerParameters parameters,
 static bool
 StepCommandWithCP56Time2a_encode(StepCommandWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 8 : (parameters->sizeOfIOA + 8);
+    int size = isSequence ? 8 : (CS101_SIZE_OF_IOA(parameters) + 8);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4814,7 +4814,7 @@ StepCommandWithCP56Time2a_getFromBuffer(StepCommandWithCP56Time2a self, CS101_Ap
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 8;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 8;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4829,7 +4829,7 @@ StepCommandWithCP56Time2a_getFromBuffer(StepCommandWithCP56Time2a self, CS101_Ap
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* SCO */
         self->dcq = msg[startIndex++];
@@ -4854,7 +4854,7 @@ StepCommandWithCP56Time2a_getTimestamp(StepCommandWithCP56Time2a self)
 static bool
 SetpointCommandNormalized_encode(SetpointCommandNormalized self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 3 : (parameters->sizeOfIOA + 3);
+    int size = isSequence ? 3 : (CS101_SIZE_OF_IOA(parameters) + 3);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -4935,7 +4935,7 @@ SetpointCommandNormalized_getFromBuffer(SetpointCommandNormalized self, CS101_Ap
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 3;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 3;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -4950,7 +4950,7 @@ SetpointCommandNormalized_getFromBuffer(SetpointCommandNormalized self, CS101_Ap
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->encodedValue[0] = msg[startIndex++];
         self->encodedValue[1] = msg[startIndex++];
@@ -4969,7 +4969,7 @@ SetpointCommandNormalized_getFromBuffer(SetpointCommandNormalized self, CS101_Ap
 static bool
 SetpointCommandNormalizedWithCP56Time2a_encode(SetpointCommandNormalizedWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 10 : (parameters->sizeOfIOA + 10);
+    int size = isSequence ? 10 : (CS101_SIZE_OF_IOA(parameters) + 10);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5049,7 +5049,7 @@ SetpointCommandNormalizedWithCP56Time2a_getFromBuffer(SetpointCommandNormalizedW
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 10;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 10;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5064,7 +5064,7 @@ SetpointCommandNormalizedWithCP56Time2a_getFromBuffer(SetpointCommandNormalizedW
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->encodedValue[0] = msg[startIndex++];
         self->encodedValue[1] = msg[startIndex++];
@@ -5092,7 +5092,7 @@ SetpointCommandNormalizedWithCP56Time2a_getTimestamp(SetpointCommandNormalizedWi
 static bool
 SetpointCommandScaled_encode(SetpointCommandScaled self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 3 : (parameters->sizeOfIOA + 3);
+    int size = isSequence ? 3 : (CS101_SIZE_OF_IOA(parameters) + 3);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5169,7 +5169,7 @@ SetpointCommandScaled_getFromBuffer(SetpointCommandScaled self, CS101_AppLayerPa
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 3;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 3;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5184,7 +5184,7 @@ SetpointCommandScaled_getFromBuffer(SetpointCommandScaled self, CS101_AppLayerPa
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->encodedValue[0] = msg[startIndex++];
         self->encodedValue[1] = msg[startIndex++];
@@ -5203,7 +5203,7 @@ SetpointCommandScaled_getFromBuffer(SetpointCommandScaled self, CS101_AppLayerPa
 static bool
 SetpointCommandScaledWithCP56Time2a_encode(SetpointCommandScaledWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 10 : (parameters->sizeOfIOA + 10);
+    int size = isSequence ? 10 : (CS101_SIZE_OF_IOA(parameters) + 10);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5281,7 +5281,7 @@ SetpointCommandScaledWithCP56Time2a_getFromBuffer(SetpointCommandScaledWithCP56T
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 10;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 10;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5296,7 +5296,7 @@ SetpointCommandScaledWithCP56Time2a_getFromBuffer(SetpointCommandScaledWithCP56T
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->encodedValue[0] = msg[startIndex++];
         self->encodedValue[1] = msg[startIndex++];
@@ -5324,7 +5324,7 @@ SetpointCommandScaledWithCP56Time2a_getTimestamp(SetpointCommandScaledWithCP56Ti
 static bool
 SetpointCommandShort_encode(SetpointCommandShort self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 5 : (parameters->sizeOfIOA + 5);
+    int size = isSequence ? 5 : (CS101_SIZE_OF_IOA(parameters) + 5);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5411,7 +5411,7 @@ SetpointCommandShort_getFromBuffer(SetpointCommandShort self, CS101_AppLayerPara
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 5;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 5;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5426,7 +5426,7 @@ SetpointCommandShort_getFromBuffer(SetpointCommandShort self, CS101_AppLayerPara
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         uint8_t* valueBytes = (uint8_t*) &(self->value);
 
@@ -5456,7 +5456,7 @@ SetpointCommandShort_getFromBuffer(SetpointCommandShort self, CS101_AppLayerPara
 static bool
 SetpointCommandShortWithCP56Time2a_encode(SetpointCommandShortWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 12 : (parameters->sizeOfIOA + 12);
+    int size = isSequence ? 12 : (CS101_SIZE_OF_IOA(parameters) + 12);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5534,7 +5534,7 @@ SetpointCommandShortWithCP56Time2a_getFromBuffer(SetpointCommandShortWithCP56Tim
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 12;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 12;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5549,7 +5549,7 @@ SetpointCommandShortWithCP56Time2a_getFromBuffer(SetpointCommandShortWithCP56Tim
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         uint8_t* valueBytes = (uint8_t*) &(self->value);
 
@@ -5588,7 +5588,7 @@ SetpointCommandShortWithCP56Time2a_getTimestamp(SetpointCommandShortWithCP56Time
 static bool
 Bitstring32Command_encode(Bitstring32Command self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 5 : (parameters->sizeOfIOA + 5);
+    int size = isSequence ? 5 : (CS101_SIZE_OF_IOA(parameters) + 5);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5655,7 +5655,7 @@ Bitstring32Command_getFromBuffer(Bitstring32Command self, CS101_AppLayerParamete
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 4;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 4;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5670,7 +5670,7 @@ Bitstring32Command_getFromBuffer(Bitstring32Command self, CS101_AppLayerParamete
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         uint8_t* valueBytes = (uint8_t*) &(self->value);
 
@@ -5697,7 +5697,7 @@ Bitstring32Command_getFromBuffer(Bitstring32Command self, CS101_AppLayerParamete
 static bool
 Bitstring32CommandWithCP56Time2a_encode(Bitstring32CommandWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 12 : (parameters->sizeOfIOA + 12);
+    int size = isSequence ? 12 : (CS101_SIZE_OF_IOA(parameters) + 12);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5763,7 +5763,7 @@ Bitstring32CommandWithCP56Time2a_getFromBuffer(Bitstring32CommandWithCP56Time2a
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 11;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 11;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5778,7 +5778,7 @@ Bitstring32CommandWithCP56Time2a_getFromBuffer(Bitstring32CommandWithCP56Time2a
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         uint8_t* valueBytes = (uint8_t*) &(self->value);
 
@@ -5808,7 +5808,7 @@ Bitstring32CommandWithCP56Time2a_getFromBuffer(Bitstring32CommandWithCP56Time2a
 static bool
 ReadCommand_encode(ReadCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 0 : (parameters->sizeOfIOA + 0);
+    int size = isSequence ? 0 : (CS101_SIZE_OF_IOA(parameters) + 0);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5857,7 +5857,7 @@ ReadCommand_getFromBuffer(ReadCommand self, CS101_AppLayerParameters parameters,
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 0;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 0;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5883,7 +5883,7 @@ ReadCommand_getFromBuffer(ReadCommand self, CS101_AppLayerParameters parameters,
 static bool
 ClockSynchronizationCommand_encode(ClockSynchronizationCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 7 : (parameters->sizeOfIOA + 7);
+    int size = isSequence ? 7 : (CS101_SIZE_OF_IOA(parameters) + 7);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -5940,7 +5940,7 @@ ClockSynchronizationCommand_getFromBuffer(ClockSynchronizationCommand self, CS10
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 7;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 7;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -5955,7 +5955,7 @@ ClockSynchronizationCommand_getFromBuffer(ClockSynchronizationCommand self, CS10
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* timestamp */
         CP56Time2a_getFromBuffer(&(self->timestamp), msg, msgSize, startIndex);
@@ -5971,7 +5971,7 @@ ClockSynchronizationCommand_getFromBuffer(ClockSynchronizationCommand self, CS10
 static bool
 InterrogationCommand_encode(InterrogationCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6029,7 +6029,7 @@ InterrogationCommand_getFromBuffer(InterrogationCommand self, CS101_AppLayerPara
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6044,7 +6044,7 @@ InterrogationCommand_getFromBuffer(InterrogationCommand self, CS101_AppLayerPara
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* QUI */
         self->qoi = msg[startIndex];
@@ -6060,7 +6060,7 @@ InterrogationCommand_getFromBuffer(InterrogationCommand self, CS101_AppLayerPara
 static bool
 CounterInterrogationCommand_encode(CounterInterrogationCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6118,7 +6118,7 @@ CounterInterrogationCommand_getFromBuffer(CounterInterrogationCommand self, CS10
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6133,7 +6133,7 @@ CounterInterrogationCommand_getFromBuffer(CounterInterrogationCommand self, CS10
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* QCC */
         self->qcc = msg[startIndex];
@@ -6149,7 +6149,7 @@ CounterInterrogationCommand_getFromBuffer(CounterInterrogationCommand self, CS10
 static bool
 TestCommand_encode(TestCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 2 : (parameters->sizeOfIOA + 2);
+    int size = isSequence ? 2 : (CS101_SIZE_OF_IOA(parameters) + 2);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6227,7 +6227,7 @@ TestCommand_getFromBuffer(TestCommand self, CS101_AppLayerParameters parameters,
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* test bytes */
         self->byte1 = msg[startIndex++];
@@ -6244,7 +6244,7 @@ TestCommand_getFromBuffer(TestCommand self, CS101_AppLayerParameters parameters,
 static bool
 TestCommandWithCP56Time2a_encode(TestCommandWithCP56Time2a self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 2 : (parameters->sizeOfIOA + 9);
+    int size = isSequence ? 2 : (CS101_SIZE_OF_IOA(parameters) + 9);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6327,7 +6327,7 @@ TestCommandWithCP56Time2a_getFromBuffer(TestCommandWithCP56Time2a self, CS101_Ap
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* test counter */
         self->tsc = msg[startIndex++];
@@ -6347,7 +6347,7 @@ TestCommandWithCP56Time2a_getFromBuffer(TestCommandWithCP56Time2a self, CS101_Ap
 static bool
 ResetProcessCommand_encode(ResetProcessCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6405,7 +6405,7 @@ ResetProcessCommand_getFromBuffer(ResetProcessCommand self, CS101_AppLayerParame
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6420,7 +6420,7 @@ ResetProcessCommand_getFromBuffer(ResetProcessCommand self, CS101_AppLayerParame
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* QUI */
         self->qrp = msg[startIndex];
@@ -6436,7 +6436,7 @@ ResetProcessCommand_getFromBuffer(ResetProcessCommand self, CS101_AppLayerParame
 static bool
 DelayAcquisitionCommand_encode(DelayAcquisitionCommand self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 2 : (parameters->sizeOfIOA + 2);
+    int size = isSequence ? 2 : (CS101_SIZE_OF_IOA(parameters) + 2);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6494,7 +6494,7 @@ DelayAcquisitionCommand_getFromBuffer(DelayAcquisitionCommand self, CS101_AppLay
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 2;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 2;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6509,7 +6509,7 @@ DelayAcquisitionCommand_getFromBuffer(DelayAcquisitionCommand self, CS101_AppLay
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* delay */
         CP16Time2a_getFromBuffer(&(self->delay), msg, msgSize, startIndex);
@@ -6525,7 +6525,7 @@ DelayAcquisitionCommand_getFromBuffer(DelayAcquisitionCommand self, CS101_AppLay
 static bool
 ParameterActivation_encode(ParameterActivation self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6582,7 +6582,7 @@ ParameterActivation_getFromBuffer(ParameterActivation self, CS101_AppLayerParame
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6597,7 +6597,7 @@ ParameterActivation_getFromBuffer(ParameterActivation self, CS101_AppLayerParame
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* QPA */
         self->qpa = (QualifierOfParameterActivation) msg [startIndex++];
@@ -6613,7 +6613,7 @@ ParameterActivation_getFromBuffer(ParameterActivation self, CS101_AppLayerParame
 static bool
 EndOfInitialization_encode(EndOfInitialization self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6671,7 +6671,7 @@ EndOfInitialization_getFromBuffer(EndOfInitialization self, CS101_AppLayerParame
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 1;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 1;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6686,7 +6686,7 @@ EndOfInitialization_getFromBuffer(EndOfInitialization self, CS101_AppLayerParame
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         /* COI */
         self->coi = msg[startIndex];
@@ -6702,7 +6702,7 @@ EndOfInitialization_getFromBuffer(EndOfInitialization self, CS101_AppLayerParame
 static bool
 FileReady_encode(FileReady self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6796,7 +6796,7 @@ FileReady_getFromBuffer(FileReady self, CS101_AppLayerParameters parameters,
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 6;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 6;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6811,7 +6811,7 @@ FileReady_getFromBuffer(FileReady self, CS101_AppLayerParameters parameters,
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->nof = msg[startIndex++];
         self->nof += (msg[startIndex++] * 0x100);
@@ -6834,7 +6834,7 @@ FileReady_getFromBuffer(FileReady self, CS101_AppLayerParameters parameters,
 static bool
 SectionReady_encode(SectionReady self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -6937,7 +6937,7 @@ SectionReady_getFromBuffer(SectionReady self, CS101_AppLayerParameters parameter
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 7;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 7;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -6952,7 +6952,7 @@ SectionReady_getFromBuffer(SectionReady self, CS101_AppLayerParameters parameter
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->nof = msg[startIndex++];
         self->nof += (msg[startIndex++] * 0x100);
@@ -6976,7 +6976,7 @@ SectionReady_getFromBuffer(SectionReady self, CS101_AppLayerParameters parameter
 static bool
 FileCallOrSelect_encode(FileCallOrSelect self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 1 : (parameters->sizeOfIOA + 1);
+    int size = isSequence ? 1 : (CS101_SIZE_OF_IOA(parameters) + 1);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -7053,7 +7053,7 @@ FileCallOrSelect_getFromBuffer(FileCallOrSelect self, CS101_AppLayerParameters p
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 4;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 4;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -7068,7 +7068,7 @@ FileCallOrSelect_getFromBuffer(FileCallOrSelect self, CS101_AppLayerParameters p
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->nof = msg[startIndex++];
         self->nof += (msg[startIndex++] * 0x100);
@@ -7168,7 +7168,7 @@ FileLastSegmentOrSection_getFromBuffer(FileLastSegmentOrSection self, CS101_AppL
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 5;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 5;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -7183,7 +7183,7 @@ FileLastSegmentOrSection_getFromBuffer(FileLastSegmentOrSection self, CS101_AppL
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->nof = msg[startIndex++];
         self->nof += (msg[startIndex++] * 0x100);
@@ -7277,7 +7277,7 @@ FileACK_getFromBuffer(FileACK self, CS101_AppLayerParameters parameters,
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 4;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 4;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -7292,7 +7292,7 @@ FileACK_getFromBuffer(FileACK self, CS101_AppLayerParameters parameters,
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->nof = msg[startIndex++];
         self->nof += (msg[startIndex++] * 0x100);
@@ -7389,8 +7389,8 @@ int
 FileSegment_GetMaxDataSize(CS101_AppLayerParameters parameters)
 {
     int maxSize = parameters->maxSizeOfASDU -
-        parameters->sizeOfTypeId - parameters->sizeOfVSQ - parameters->sizeOfCA - parameters->sizeOfCOT
-        - parameters->sizeOfIOA - 4;
+        parameters->sizeOfTypeId - parameters->sizeOfVSQ - CS101_SIZE_OF_CA(parameters) - CS101_SIZE_OF_COT(parameters)
+        - CS101_SIZE_OF_IOA(parameters) - 4;
 
     return maxSize;
 }
@@ -7406,16 +7406,16 @@ FileSegment_getFromBuffer(FileSegment self, CS101_AppLayerParameters parameters,
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 4;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 4;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
         return NULL;
     }
 
-    uint8_t los = msg[startIndex + 3 + parameters->sizeOfIOA];
+    uint8_t los = msg[startIndex + 3 + CS101_SIZE_OF_IOA(parameters)];
 
-    if ((msgSize - startIndex) < (parameters->sizeOfIOA) + 4 + los)
+    if ((msgSize - startIndex) < (CS101_SIZE_OF_IOA(parameters)) + 4 + los)
         return NULL;
 
     if (self == NULL)
@@ -7426,7 +7426,7 @@ FileSegment_getFromBuffer(FileSegment self, CS101_AppLayerParameters parameters,
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->nof = msg[startIndex++];
         self->nof += (msg[startIndex++] * 0x100);
@@ -7448,7 +7448,7 @@ FileSegment_getFromBuffer(FileSegment self, CS101_AppLayerParameters parameters,
 static bool
 FileDirectory_encode(FileDirectory self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 13 : (parameters->sizeOfIOA + 13);
+    int size = isSequence ? 13 : (CS101_SIZE_OF_IOA(parameters) + 13);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -7560,7 +7560,7 @@ FileDirectory_getFromBuffer(FileDirectory self, CS101_AppLayerParameters paramet
         uint8_t* msg, int msgSize, int startIndex, bool isSequence)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 13;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 13;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -7577,7 +7577,7 @@ FileDirectory_getFromBuffer(FileDirectory self, CS101_AppLayerParameters paramet
         if (!isSequence) {
             InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-            startIndex += parameters->sizeOfIOA; /* skip IOA */
+            startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
         }
 
         self->nof = msg[startIndex++];
@@ -7603,7 +7603,7 @@ FileDirectory_getFromBuffer(FileDirectory self, CS101_AppLayerParameters paramet
 static bool
 QueryLog_encode(QueryLog self, Frame frame, CS101_AppLayerParameters parameters, bool isSequence)
 {
-    int size = isSequence ? 16 : (parameters->sizeOfIOA + 16);
+    int size = isSequence ? 16 : (CS101_SIZE_OF_IOA(parameters) + 16);
 
     if (Frame_getSpaceLeft(frame) < size)
         return false;
@@ -7678,7 +7678,7 @@ QueryLog_getFromBuffer(QueryLog self, CS101_AppLayerParameters parameters,
         uint8_t* msg, int msgSize, int startIndex)
 {
     /* check message size */
-    int minSize = startIndex + parameters->sizeOfIOA + 16;
+    int minSize = startIndex + CS101_SIZE_OF_IOA(parameters) + 16;
 
     if (minSize > msgSize) {
         DEBUG_PRINT("invalid ASDU - size too small\n");
@@ -7694,7 +7694,7 @@ QueryLog_getFromBuffer(QueryLog self, CS101_AppLayerParameters parameters,
 
         InformationObject_getFromBuffer((InformationObject) self, parameters, msg, startIndex);
 
-        startIndex += parameters->sizeOfIOA; /* skip IOA */
+        startIndex += CS101_SIZE_OF_IOA(parameters); /* skip IOA */
 
         self->nof = msg[startIndex++];
         self->nof += (msg[startIndex++] * 0x100);
@@ -56,6 +56,8 @@ struct sCS101_Master
     CS101_ASDUReceivedHandler asduReceivedHandler;
     void* asduReceivedHandlerParameter;
 
+    CS101_MirrorCache mirrorCache;
+
     struct sCS101_Queue userDataQueue;
 
 #if (CONFIG_USE_THREADS == 1)
@@ -101,12 +103,15 @@ IBalancedApplicationLayer_HandleReceivedData (void* parameter, uint8_t* msg, boo
 
     CS101_Master self = (CS101_Master) parameter;
 
-    CS101_ASDU asdu = CS101_ASDU_createFromBuffer(&(self->alParameters), msg + userDataStart, userDataLength);
+    sCS101_ASDUView _asdu;
 
-    if (self->asduReceivedHandler)
-        self->asduReceivedHandler(self->asduReceivedHandlerParameter, 0, asdu);
+    CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, &(self->alParameters), msg + userDataStart, userDataLength);
 
-    CS101_ASDU_destroy(asdu);
+    if (asdu && self->mirrorCache)
+        CS101_MirrorCache_handleASDU(self->mirrorCache, asdu);
+
+    if (asdu && self->asduReceivedHandler)
+        self->asduReceivedHandler(self->asduReceivedHandlerParameter, 0, asdu);
 
     return true;
 }
@@ -139,12 +144,15 @@ IPrimaryApplicationLayer_UserData(void* parameter, int slaveAddress, uint8_t* ms
 {
     CS101_Master self = (CS101_Master) parameter;
 
-    CS101_ASDU asdu = CS101_ASDU_createFromBuffer(&(self->alParameters), msg + start, length);
+    sCS101_ASDUView _asdu;
 
-    if (self->asduReceivedHandler)
-        self->asduReceivedHandler(self->asduReceivedHandlerParameter, slaveAddress, asdu);
+    CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, &(self->alParameters), msg + start, length);
+
+    if (asdu && self->mirrorCache)
+        CS101_MirrorCache_handleASDU(self->mirrorCache, asdu);
 
-    CS101_ASDU_destroy(asdu);
+    if (asdu && self->asduReceivedHandler)
+        self->asduReceivedHandler(self->asduReceivedHandlerParameter, slaveAddress, asdu);
 
 }
 
@@ -188,6 +196,10 @@ CS101_Master_createEx(SerialPort serialPort, const LinkLayerParameters llParamet
         else
             self->alParameters = defaultAppLayerParameters;
 
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+        CS101_AppLayerParameters_applyFixedProfile(&(self->alParameters));
+#endif
+
         self->transceiver = SerialTransceiverFT12_create(serialPort,  &(self->linkLayerParameters));
 
         self->linkLayerMode = linkLayerMode;
@@ -503,6 +515,12 @@ CS101_Master_setASDUReceivedHandler(CS101_Master self, CS101_ASDUReceivedHandler
     self->asduReceivedHandlerParameter = parameter;
 }
 
+void
+CS101_Master_setMirrorCache(CS101_Master self, CS101_MirrorCache cache)
+{
+    self->mirrorCache = cache;
+}
+
 void
 CS101_Master_setLinkLayerStateChanged(CS101_Master self, IEC60870_LinkLayerStateChangedHandler handler, void* parameter)
 {
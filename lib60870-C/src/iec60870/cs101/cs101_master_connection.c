@@ -68,3 +68,12 @@ IMasterConnection_getPeerAddress(IMasterConnection self, char* addrBuf, int addr
     else
         return 0;
 }
+
+bool
+IMasterConnection_getStatistics(IMasterConnection self, CS104_ConnectionStatistics stats)
+{
+    if (self->getStatistics)
+        return self->getStatistics(self, stats);
+    else
+        return false;
+}
@@ -0,0 +1,390 @@
+/*
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_GENERAL
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
+#include <string.h>
+
+#include "iec60870_master.h"
+
+#include "hal_thread.h"
+#include "hal_time.h"
+#include "lib_memory.h"
+#include "linked_list.h"
+#include "lib60870_config.h"
+#include "lib60870_internal.h"
+#include "lib60870_atomic.h"
+
+/* maximum number of information objects in an ASDU (7 bit of the VSQ) */
+#define MAX_ELEMENTS_PER_ASDU 127
+
+/*
+ * Entries are protected by a sequence lock: the writer makes the sequence odd before it
+ * changes the value and even again afterwards. Readers retry when the sequence is odd or
+ * has changed while they copied the value.
+ *
+ * Entries are never removed. CA, IOA and the first value are written before the entry is
+ * published by setting "used", so readers can compare CA and IOA without the sequence lock.
+ */
+typedef struct {
+    uint32_t sequenceLock;
+    int used;
+    int ca;
+    int ioa;
+    sCS101_MirrorCacheValue value;
+} MirrorCacheEntry;
+
+struct sCS101_MirrorCacheSubscription {
+    int ca;
+    int firstIOA;
+    int lastIOA;
+    CS101_MirrorCacheHandler handler;
+    void* parameter;
+};
+
+struct sCS101_MirrorCache {
+    MirrorCacheEntry* entries;
+    uint32_t tableMask; /* table size - 1 (table size is a power of two) */
+
+    int maxPoints;
+    int numberOfPoints;
+
+    uint32_t sequence;
+    uint32_t droppedUpdates;
+
+    LinkedList subscriptions;
+    int numberOfSubscriptions;
+
+    /* decoder output - only used by the writer */
+    int ioa[MAX_ELEMENTS_PER_ASDU];
+    float value[MAX_ELEMENTS_PER_ASDU];
+    int32_t intValue[MAX_ELEMENTS_PER_ASDU];
+    uint8_t quality[MAX_ELEMENTS_PER_ASDU];
+    uint64_t timestamp[MAX_ELEMENTS_PER_ASDU];
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore writeLock; /* serializes writers */
+    Semaphore subscriptionLock; /* protects the subscription list and serializes the handler calls */
+#endif
+};
+
+static uint32_t
+hashPoint(int ca, int ioa)
+{
+    uint32_t hash = ((uint32_t) ioa * 2654435761u) ^ ((uint32_t) ca * 40503u);
+
+    return hash ^ (hash >> 16);
+}
+
+/* returns the entry of the data point or the free entry where the data point has to be stored */
+static MirrorCacheEntry*
+findEntry(CS101_MirrorCache self, int ca, int ioa)
+{
+    uint32_t index = hashPoint(ca, ioa) & self->tableMask;
+
+    while (true) {
+        MirrorCacheEntry* entry = &(self->entries[index]);
+
+        if (LIB60870_ATOMIC_LOAD_ACQUIRE(&(entry->used)) == 0)
+            return entry;
+
+        if ((entry->ca == ca) && (entry->ioa == ioa))
+            return entry;
+
+        index = (index + 1) & self->tableMask;
+    }
+}
+
+CS101_MirrorCache
+CS101_MirrorCache_create(int maxPoints)
+{
+    CS101_MirrorCache self = (CS101_MirrorCache) GLOBAL_CALLOC(1, sizeof(struct sCS101_MirrorCache));
+
+    if (self) {
+        uint32_t tableSize = 16;
+
+        if (maxPoints < 1)
+            maxPoints = 1;
+
+        /* keep the load factor below 0.5 so that lookups stay short */
+        while (tableSize < (uint32_t) maxPoints * 2)
+            tableSize = tableSize * 2;
+
+        self->entries = (MirrorCacheEntry*) GLOBAL_CALLOC(tableSize, sizeof(MirrorCacheEntry));
+        self->tableMask = tableSize - 1;
+        self->maxPoints = maxPoints;
+        self->subscriptions = LinkedList_create();
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        self->writeLock = Semaphore_create(1);
+        self->subscriptionLock = Semaphore_create(1);
+#endif
+
+        if ((self->entries == NULL) || (self->subscriptions == NULL)) {
+            CS101_MirrorCache_destroy(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+/* called without the write lock - the handlers get the current value of the data points */
+static void
+notifySubscribers(CS101_MirrorCache self, int ca, const int* ioas, int numberOfIOAs)
+{
+    sCS101_MirrorCacheValue value;
+    int i;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->subscriptionLock);
+#endif
+
+    for (i = 0; i < numberOfIOAs; i++) {
+        int ioa = ioas[i];
+        bool hasValue = false;
+
+        LinkedList element = LinkedList_getNext(self->subscriptions);
+
+        while (element) {
+            CS101_MirrorCacheSubscription subscription = (CS101_MirrorCacheSubscription) LinkedList_getData(element);
+
+            if (((subscription->ca == -1) || (subscription->ca == ca)) &&
+                    (ioa >= subscription->firstIOA) && (ioa <= subscription->lastIOA))
+            {
+                if (hasValue == false)
+                    hasValue = CS101_MirrorCache_getValue(self, ca, ioa, &value);
+
+                if (hasValue)
+                    subscription->handler(subscription->parameter, ca, ioa, &value);
+            }
+
+            element = LinkedList_getNext(element);
+        }
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->subscriptionLock);
+#endif
+}
+
+int
+CS101_MirrorCache_handleASDU(CS101_MirrorCache self, CS101_ASDU asdu)
+{
+    sCS101_ASDUColumns columns;
+    int changedIOAs[MAX_ELEMENTS_PER_ASDU];
+    int numberOfChanges = 0;
+    int ca = 0;
+
+    columns.maxElements = MAX_ELEMENTS_PER_ASDU;
+    columns.ioa = self->ioa;
+    columns.value = self->value;
+    columns.intValue = self->intValue;
+    columns.quality = self->quality;
+    columns.timestamp = self->timestamp;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->writeLock);
+#endif
+
+    int n = CS101_ASDU_decodeColumns(asdu, &columns);
+
+    if (n > 0) {
+        IEC60870_5_TypeID typeId = CS101_ASDU_getTypeID(asdu);
+        uint64_t updateTime = Hal_getTimeInMs();
+        bool hasSubscriptions = (LIB60870_ATOMIC_LOAD(&(self->numberOfSubscriptions)) > 0);
+        int i;
+
+        ca = CS101_ASDU_getCA(asdu);
+
+        for (i = 0; i < n; i++) {
+            MirrorCacheEntry* entry = findEntry(self, ca, self->ioa[i]);
+            bool isNew = (entry->used == 0);
+            bool changed;
+
+            if (isNew) {
+                if (self->numberOfPoints >= self->maxPoints) {
+                    LIB60870_ATOMIC_ADD(&(self->droppedUpdates), 1);
+                    continue;
+                }
+
+                entry->ca = ca;
+                entry->ioa = self->ioa[i];
+
+                changed = true;
+            }
+            else {
+                changed = (entry->value.intValue != self->intValue[i]) || (entry->value.value != self->value[i]) ||
+                        (entry->value.quality != (QualityDescriptor) self->quality[i]);
+            }
+
+            uint32_t sequenceLock = entry->sequenceLock;
+            uint32_t sequence = self->sequence + 1;
+
+            LIB60870_ATOMIC_STORE(&(entry->sequenceLock), sequenceLock + 1);
+            LIB60870_ATOMIC_FENCE_RELEASE();
+
+            entry->value.typeId = typeId;
+            entry->value.value = self->value[i];
+            entry->value.intValue = self->intValue[i];
+            entry->value.quality = (QualityDescriptor) self->quality[i];
+            entry->value.timestamp = self->timestamp[i];
+            entry->value.updateTime = updateTime;
+            entry->value.sequence = sequence;
+
+            if (changed)
+                entry->value.changeCount++;
+
+            LIB60870_ATOMIC_STORE_RELEASE(&(entry->sequenceLock), sequenceLock + 2);
+
+            if (isNew) {
+                /* publish the entry after the value is complete */
+                LIB60870_ATOMIC_STORE_RELEASE(&(entry->used), 1);
+                LIB60870_ATOMIC_STORE(&(self->numberOfPoints), self->numberOfPoints + 1);
+            }
+
+            LIB60870_ATOMIC_STORE_RELEASE(&(self->sequence), sequence);
+
+            if (changed && hasSubscriptions)
+                changedIOAs[numberOfChanges++] = self->ioa[i];
+        }
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->writeLock);
+#endif
+
+    /* other writers can update the cache while the handlers are running */
+    if (numberOfChanges > 0)
+        notifySubscribers(self, ca, changedIOAs, numberOfChanges);
+
+    return n;
+}
+
+bool
+CS101_MirrorCache_getValue(CS101_MirrorCache self, int ca, int ioa, sCS101_MirrorCacheValue* value)
+{
+    MirrorCacheEntry* entry = findEntry(self, ca, ioa);
+
+    if (LIB60870_ATOMIC_LOAD_ACQUIRE(&(entry->used)) == 0)
+        return false;
+
+    while (true) {
+        uint32_t sequenceLock = LIB60870_ATOMIC_LOAD_ACQUIRE(&(entry->sequenceLock));
+
+        /* update in progress */
+        if (sequenceLock & 1)
+            continue;
+
+        memcpy(value, &(entry->value), sizeof(sCS101_MirrorCacheValue));
+
+        LIB60870_ATOMIC_FENCE_ACQUIRE();
+
+        if (LIB60870_ATOMIC_LOAD(&(entry->sequenceLock)) == sequenceLock)
+            return true;
+    }
+}
+
+uint32_t
+CS101_MirrorCache_getSequence(CS101_MirrorCache self)
+{
+    return LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->sequence));
+}
+
+int
+CS101_MirrorCache_getNumberOfPoints(CS101_MirrorCache self)
+{
+    return LIB60870_ATOMIC_LOAD(&(self->numberOfPoints));
+}
+
+uint32_t
+CS101_MirrorCache_getDroppedUpdates(CS101_MirrorCache self)
+{
+    return LIB60870_ATOMIC_LOAD(&(self->droppedUpdates));
+}
+
+CS101_MirrorCacheSubscription
+CS101_MirrorCache_subscribe(CS101_MirrorCache self, int ca, int firstIOA, int lastIOA, CS101_MirrorCacheHandler handler, void* parameter)
+{
+    CS101_MirrorCacheSubscription subscription =
+            (CS101_MirrorCacheSubscription) GLOBAL_MALLOC(sizeof(struct sCS101_MirrorCacheSubscription));
+
+    if (subscription) {
+        subscription->ca = ca;
+        subscription->firstIOA = firstIOA;
+        subscription->lastIOA = lastIOA;
+        subscription->handler = handler;
+        subscription->parameter = parameter;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_wait(self->subscriptionLock);
+#endif
+
+        LinkedList_add(self->subscriptions, subscription);
+        LIB60870_ATOMIC_STORE(&(self->numberOfSubscriptions), self->numberOfSubscriptions + 1);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_post(self->subscriptionLock);
+#endif
+    }
+
+    return subscription;
+}
+
+void
+CS101_MirrorCache_unsubscribe(CS101_MirrorCache self, CS101_MirrorCacheSubscription subscription)
+{
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->subscriptionLock);
+#endif
+
+    bool removed = LinkedList_remove(self->subscriptions, subscription);
+
+    if (removed)
+        LIB60870_ATOMIC_STORE(&(self->numberOfSubscriptions), self->numberOfSubscriptions - 1);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->subscriptionLock);
+#endif
+
+    if (removed)
+        GLOBAL_FREEMEM(subscription);
+}
+
+void
+CS101_MirrorCache_destroy(CS101_MirrorCache self)
+{
+    if (self) {
+        if (self->subscriptions)
+            LinkedList_destroy(self->subscriptions);
+
+        if (self->entries)
+            GLOBAL_FREEMEM(self->entries);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_destroy(self->writeLock);
+        Semaphore_destroy(self->subscriptionLock);
+#endif
+
+        GLOBAL_FREEMEM(self);
+    }
+}
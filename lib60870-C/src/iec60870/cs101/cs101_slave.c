@@ -143,12 +143,12 @@ HandleReceivedData(void* parameter, uint8_t* msg, bool isBroadcast, int userData
 
     CS101_Slave self = (CS101_Slave) parameter;
 
-    CS101_ASDU asdu = CS101_ASDU_createFromBuffer(&(self->alParameters), msg + userDataStart, userDataLength);
+    sCS101_ASDUView _asdu;
+
+    CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, &(self->alParameters), msg + userDataStart, userDataLength);
 
     if (asdu) {
         handleASDU(self, asdu);
-
-        CS101_ASDU_destroy(asdu);
     }
     else {
         DEBUG_PRINT("CS101 slave: Failed to parse ASDU\n");
@@ -326,6 +326,10 @@ CS101_Slave_createEx(SerialPort serialPort, const LinkLayerParameters llParamete
             self->alParameters = defaultAppLayerParameters;
         }
 
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+        CS101_AppLayerParameters_applyFixedProfile(&(self->alParameters));
+#endif
+
         self->transceiver = SerialTransceiverFT12_create(serialPort,  &(self->linkLayerParameters));
 
         self->linkLayerMode = linkLayerMode;
@@ -356,6 +360,7 @@ CS101_Slave_createEx(SerialPort serialPort, const LinkLayerParameters llParamete
         self->iMasterConnection.getApplicationLayerParameters = getApplicationLayerParameters;
         self->iMasterConnection.close = NULL;
         self->iMasterConnection.getPeerAddress = NULL;
+        self->iMasterConnection.getStatistics = NULL;
         self->iMasterConnection.object = self;
 
         CS101_Queue_initialize(&(self->userDataClass1Queue), class1QueueSize);
@@ -0,0 +1,969 @@
+/*
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_GENERAL
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
+/* capture files can be larger than 2 GB (64 bit off_t for fseeko/ftello on 32 bit systems) */
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cs104_capture.h"
+#include "cs104_connection_internal.h"
+
+#include "hal_thread.h"
+#include "hal_time.h"
+#include "lib_memory.h"
+#include "linked_list.h"
+#include "lib60870_config.h"
+#include "lib60870_internal.h"
+#include "lib60870_atomic.h"
+
+#define CAPTURE_MAGIC "IEC104CP"
+#define CAPTURE_VERSION 1
+#define CAPTURE_HEADER_SIZE 32
+#define CAPTURE_RECORD_HEADER_SIZE 16
+#define CAPTURE_INDEX_INTERVAL 256
+#define CAPTURE_FILE_BUFFER_SIZE 65536
+
+#define CAPTURE_FLAG_SENT 0x01
+
+/* maximum size of an APDU (start byte, length byte and 253 byte APCI/ASDU) */
+#define MAX_APDU_SIZE 255
+
+static void
+encodeUInt16(uint8_t* buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t) (value & 0xff);
+    buffer[1] = (uint8_t) (value >> 8);
+}
+
+static void
+encodeUInt32(uint8_t* buffer, uint32_t value)
+{
+    int i;
+
+    for (i = 0; i < 4; i++)
+        buffer[i] = (uint8_t) (value >> (8 * i));
+}
+
+static void
+encodeUInt64(uint8_t* buffer, uint64_t value)
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+        buffer[i] = (uint8_t) (value >> (8 * i));
+}
+
+static uint16_t
+decodeUInt16(const uint8_t* buffer)
+{
+    return (uint16_t) (buffer[0] + (buffer[1] * 0x100));
+}
+
+static uint32_t
+decodeUInt32(const uint8_t* buffer)
+{
+    uint32_t value = 0;
+    int i;
+
+    for (i = 3; i >= 0; i--)
+        value = (value << 8) + buffer[i];
+
+    return value;
+}
+
+static uint64_t
+decodeUInt64(const uint8_t* buffer)
+{
+    uint64_t value = 0;
+    int i;
+
+    for (i = 7; i >= 0; i--)
+        value = (value << 8) + buffer[i];
+
+    return value;
+}
+
+static int
+getPaddedRecordSize(int msgSize)
+{
+    return (CAPTURE_RECORD_HEADER_SIZE + msgSize + 7) & ~7;
+}
+
+/********************************************
+ * CS104_CaptureWriter
+ ********************************************/
+
+typedef struct {
+    CS104_CaptureWriter writer;
+    uint32_t connectionId;
+} CapturedConnection;
+
+struct sCS104_CaptureWriter {
+    FILE* file;
+    char* fileBuffer;
+
+    uint64_t position; /* file offset of the next record */
+    uint64_t recordCount;
+
+    uint64_t* index;
+    int indexSize;
+    int indexCapacity;
+
+    LinkedList capturedConnections;
+
+    bool writeError;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore lock;
+#endif
+};
+
+static bool
+writeFileHeader(CS104_CaptureWriter self, uint64_t recordCount, uint64_t indexOffset)
+{
+    uint8_t header[CAPTURE_HEADER_SIZE];
+
+    memcpy(header, CAPTURE_MAGIC, 8);
+    encodeUInt16(header + 8, CAPTURE_VERSION);
+    encodeUInt16(header + 10, CAPTURE_HEADER_SIZE);
+    encodeUInt32(header + 12, CAPTURE_INDEX_INTERVAL);
+    encodeUInt64(header + 16, recordCount);
+    encodeUInt64(header + 24, indexOffset);
+
+    return (fwrite(header, 1, CAPTURE_HEADER_SIZE, self->file) == CAPTURE_HEADER_SIZE);
+}
+
+CS104_CaptureWriter
+CS104_CaptureWriter_create(const char* filename)
+{
+    CS104_CaptureWriter self = (CS104_CaptureWriter) GLOBAL_CALLOC(1, sizeof(struct sCS104_CaptureWriter));
+
+    if (self) {
+        self->file = fopen(filename, "wb");
+
+        if (self->file == NULL) {
+            DEBUG_PRINT("Failed to create capture file %s\n", filename);
+            GLOBAL_FREEMEM(self);
+            return NULL;
+        }
+
+        self->fileBuffer = (char*) GLOBAL_MALLOC(CAPTURE_FILE_BUFFER_SIZE);
+
+        if (self->fileBuffer)
+            setvbuf(self->file, self->fileBuffer, _IOFBF, CAPTURE_FILE_BUFFER_SIZE);
+
+        self->capturedConnections = LinkedList_create();
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        self->lock = Semaphore_create(1);
+#endif
+
+        if (writeFileHeader(self, 0, 0) == false)
+            self->writeError = true;
+
+        self->position = CAPTURE_HEADER_SIZE;
+    }
+
+    return self;
+}
+
+static bool
+addIndexEntry(CS104_CaptureWriter self, uint64_t position)
+{
+    if (self->indexSize == self->indexCapacity) {
+        int newCapacity = (self->indexCapacity == 0) ? 64 : (self->indexCapacity * 2);
+
+        uint64_t* newIndex = (uint64_t*) GLOBAL_REALLOC(self->index, newCapacity * sizeof(uint64_t));
+
+        if (newIndex == NULL)
+            return false;
+
+        self->index = newIndex;
+        self->indexCapacity = newCapacity;
+    }
+
+    self->index[self->indexSize++] = position;
+
+    return true;
+}
+
+bool
+CS104_CaptureWriter_writeRecord(CS104_CaptureWriter self, uint64_t timestamp, uint32_t connectionId, bool sent,
+        const uint8_t* msg, int msgSize)
+{
+    uint8_t record[CAPTURE_RECORD_HEADER_SIZE + MAX_APDU_SIZE + 8];
+    bool retVal = false;
+
+    if ((msgSize < 0) || (msgSize > MAX_APDU_SIZE))
+        return false;
+
+    int recordSize = getPaddedRecordSize(msgSize);
+
+    encodeUInt64(record, timestamp);
+    encodeUInt32(record + 8, connectionId);
+    record[12] = sent ? CAPTURE_FLAG_SENT : 0;
+    record[13] = 0;
+    encodeUInt16(record + 14, (uint16_t) msgSize);
+    memcpy(record + CAPTURE_RECORD_HEADER_SIZE, msg, msgSize);
+    memset(record + CAPTURE_RECORD_HEADER_SIZE + msgSize, 0, recordSize - CAPTURE_RECORD_HEADER_SIZE - msgSize);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif
+
+    if (self->writeError == false) {
+
+        if ((self->recordCount % CAPTURE_INDEX_INTERVAL) == 0) {
+            if (addIndexEntry(self, self->position) == false)
+                self->writeError = true;
+        }
+
+        if (self->writeError == false) {
+            if (fwrite(record, 1, recordSize, self->file) == (size_t) recordSize) {
+                self->position += recordSize;
+                self->recordCount++;
+                retVal = true;
+            }
+            else {
+                DEBUG_PRINT("Failed to write capture record\n");
+                self->writeError = true;
+            }
+        }
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif
+
+    return retVal;
+}
+
+static void
+connectionRawMessageHandler(void* parameter, uint8_t* msg, int msgSize, bool sent)
+{
+    CapturedConnection* capturedConnection = (CapturedConnection*) parameter;
+
+    CS104_CaptureWriter_writeRecord(capturedConnection->writer, Hal_getTimeInNs(), capturedConnection->connectionId,
+            sent, msg, msgSize);
+}
+
+void
+CS104_CaptureWriter_captureConnection(CS104_CaptureWriter self, CS104_Connection connection, uint32_t connectionId)
+{
+    CapturedConnection* capturedConnection = (CapturedConnection*) GLOBAL_MALLOC(sizeof(CapturedConnection));
+
+    if (capturedConnection) {
+        capturedConnection->writer = self;
+        capturedConnection->connectionId = connectionId;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_wait(self->lock);
+#endif
+
+        LinkedList_add(self->capturedConnections, capturedConnection);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_post(self->lock);
+#endif
+
+        CS104_Connection_setRawMessageHandler(connection, connectionRawMessageHandler, capturedConnection);
+    }
+}
+
+static void
+slaveRawMessageHandler(void* parameter, IMasterConnection connection, uint8_t* msg, int msgSize, bool sent)
+{
+    CS104_CaptureWriter self = (CS104_CaptureWriter) parameter;
+
+    struct sCS104_ConnectionStatistics stats;
+    uint32_t connectionId = 0;
+
+    if (IMasterConnection_getStatistics(connection, &stats))
+        connectionId = stats.connectionId;
+
+    CS104_CaptureWriter_writeRecord(self, Hal_getTimeInNs(), connectionId, sent, msg, msgSize);
+}
+
+void
+CS104_CaptureWriter_captureSlave(CS104_CaptureWriter self, CS104_Slave slave)
+{
+    CS104_Slave_setRawMessageHandler(slave, slaveRawMessageHandler, self);
+}
+
+void
+CS104_CaptureWriter_flush(CS104_CaptureWriter self)
+{
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif
+
+    fflush(self->file);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif
+}
+
+uint64_t
+CS104_CaptureWriter_getRecordCount(CS104_CaptureWriter self)
+{
+    uint64_t recordCount;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif
+
+    recordCount = self->recordCount;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif
+
+    return recordCount;
+}
+
+/* append the index and update the file header - the file can be read without index when this fails */
+static void
+finalizeCaptureFile(CS104_CaptureWriter self)
+{
+    uint8_t entry[8];
+    int i;
+
+    if (self->writeError)
+        return;
+
+    for (i = 0; i < self->indexSize; i++) {
+        encodeUInt64(entry, self->index[i]);
+
+        if (fwrite(entry, 1, 8, self->file) != 8)
+            return;
+    }
+
+    if (fseek(self->file, 0, SEEK_SET) == 0)
+        writeFileHeader(self, self->recordCount, self->position);
+}
+
+void
+CS104_CaptureWriter_destroy(CS104_CaptureWriter self)
+{
+    if (self) {
+        finalizeCaptureFile(self);
+
+        fclose(self->file);
+
+        if (self->fileBuffer)
+            GLOBAL_FREEMEM(self->fileBuffer);
+
+        if (self->index)
+            GLOBAL_FREEMEM(self->index);
+
+        if (self->capturedConnections)
+            LinkedList_destroy(self->capturedConnections);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_destroy(self->lock);
+#endif
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+/********************************************
+ * CS104_CaptureReader
+ ********************************************/
+
+struct sCS104_CaptureReader {
+    uint8_t* data;
+    uint64_t dataSize;
+
+    int recordCount;
+
+    uint32_t indexInterval;
+    uint64_t* index;
+    int indexSize;
+};
+
+/* scan the records to rebuild the index of a capture file that was not closed */
+static bool
+rebuildIndex(CS104_CaptureReader self, uint64_t endOfRecords)
+{
+    uint64_t position = CAPTURE_HEADER_SIZE;
+    int indexCapacity = 0;
+
+    self->recordCount = 0;
+    self->indexSize = 0;
+
+    while (position + CAPTURE_RECORD_HEADER_SIZE <= endOfRecords) {
+        int msgSize = decodeUInt16(self->data + position + 14);
+        int recordSize = getPaddedRecordSize(msgSize);
+
+        /* ignore incomplete or corrupted record at the end of the file */
+        if ((msgSize > MAX_APDU_SIZE) || (position + recordSize > endOfRecords))
+            break;
+
+        if ((self->recordCount % self->indexInterval) == 0) {
+            if (self->indexSize == indexCapacity) {
+                int newCapacity = (indexCapacity == 0) ? 64 : (indexCapacity * 2);
+
+                uint64_t* newIndex = (uint64_t*) GLOBAL_REALLOC(self->index, newCapacity * sizeof(uint64_t));
+
+                if (newIndex == NULL)
+                    return false;
+
+                self->index = newIndex;
+                indexCapacity = newCapacity;
+            }
+
+            self->index[self->indexSize++] = position;
+        }
+
+        self->recordCount++;
+        position += recordSize;
+    }
+
+    return true;
+}
+
+/*
+ * load the index of a closed capture file - the records have to be a chain of complete
+ * records in front of the index and the index entries have to point to these records
+ */
+static bool
+loadIndex(CS104_CaptureReader self, uint64_t recordCount, uint64_t indexOffset)
+{
+    uint64_t position = CAPTURE_HEADER_SIZE;
+    int i;
+
+    if ((recordCount > 0x7fffffff) || (indexOffset < CAPTURE_HEADER_SIZE) || (indexOffset > self->dataSize))
+        return false;
+
+    self->recordCount = (int) recordCount;
+    self->indexSize = (int) ((recordCount + self->indexInterval - 1) / self->indexInterval);
+
+    if (indexOffset + (uint64_t) self->indexSize * 8 > self->dataSize)
+        return false;
+
+    if (self->indexSize > 0) {
+        self->index = (uint64_t*) GLOBAL_MALLOC(self->indexSize * sizeof(uint64_t));
+
+        if (self->index == NULL)
+            return false;
+    }
+
+    for (i = 0; i < self->recordCount; i++) {
+        if (position + CAPTURE_RECORD_HEADER_SIZE > indexOffset)
+            return false;
+
+        int msgSize = decodeUInt16(self->data + position + 14);
+
+        if ((msgSize > MAX_APDU_SIZE) || (position + getPaddedRecordSize(msgSize) > indexOffset))
+            return false;
+
+        if ((i % self->indexInterval) == 0) {
+            int indexEntry = (int) (i / self->indexInterval);
+
+            self->index[indexEntry] = decodeUInt64(self->data + indexOffset + ((uint64_t) indexEntry * 8));
+
+            if (self->index[indexEntry] != position)
+                return false;
+        }
+
+        position += getPaddedRecordSize(msgSize);
+    }
+
+    return true;
+}
+
+/* size of the file in bytes (-1 on error) - ftell only returns a 32 bit long on Windows */
+static int64_t
+getFileSize(FILE* file)
+{
+    int64_t fileSize = -1;
+
+#if defined(_WIN32)
+    if (_fseeki64(file, 0, SEEK_END) == 0) {
+        fileSize = (int64_t) _ftelli64(file);
+
+        if (_fseeki64(file, 0, SEEK_SET) != 0)
+            fileSize = -1;
+    }
+#else
+    if (fseeko(file, 0, SEEK_END) == 0) {
+        fileSize = (int64_t) ftello(file);
+
+        if (fseeko(file, 0, SEEK_SET) != 0)
+            fileSize = -1;
+    }
+#endif
+
+    return fileSize;
+}
+
+static bool
+readCaptureFile(CS104_CaptureReader self, const char* filename)
+{
+    bool retVal = false;
+
+    FILE* file = fopen(filename, "rb");
+
+    if (file == NULL)
+        return false;
+
+    int64_t fileSize = getFileSize(file);
+
+    /* the file has to fit into the address space */
+    if ((fileSize >= CAPTURE_HEADER_SIZE) && ((uint64_t) fileSize <= (uint64_t) SIZE_MAX)) {
+        self->data = (uint8_t*) GLOBAL_MALLOC((size_t) fileSize);
+
+        if (self->data) {
+            if (fread(self->data, 1, (size_t) fileSize, file) == (size_t) fileSize) {
+                self->dataSize = (uint64_t) fileSize;
+                retVal = true;
+            }
+        }
+    }
+    else if (fileSize > CAPTURE_HEADER_SIZE) {
+        DEBUG_PRINT("Capture file %s is too large (%llu bytes)\n", filename, (unsigned long long) fileSize);
+    }
+
+    fclose(file);
+
+    return retVal;
+}
+
+CS104_CaptureReader
+CS104_CaptureReader_create(const char* filename)
+{
+    CS104_CaptureReader self = (CS104_CaptureReader) GLOBAL_CALLOC(1, sizeof(struct sCS104_CaptureReader));
+
+    if (self) {
+        bool valid = false;
+
+        if (readCaptureFile(self, filename)) {
+            if ((memcmp(self->data, CAPTURE_MAGIC, 8) == 0) && (decodeUInt16(self->data + 8) == CAPTURE_VERSION) &&
+                    (decodeUInt16(self->data + 10) == CAPTURE_HEADER_SIZE))
+            {
+                uint64_t recordCount = decodeUInt64(self->data + 16);
+                uint64_t indexOffset = decodeUInt64(self->data + 24);
+
+                self->indexInterval = decodeUInt32(self->data + 12);
+
+                if (self->indexInterval > 0) {
+                    if (indexOffset != 0)
+                        valid = loadIndex(self, recordCount, indexOffset);
+                    else
+                        valid = rebuildIndex(self, self->dataSize);
+                }
+            }
+        }
+
+        if (valid == false) {
+            DEBUG_PRINT("Invalid capture file %s\n", filename);
+            CS104_CaptureReader_destroy(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+int
+CS104_CaptureReader_getRecordCount(CS104_CaptureReader self)
+{
+    return self->recordCount;
+}
+
+static void
+decodeRecord(CS104_CaptureReader self, uint64_t position, sCS104_CaptureRecord* record)
+{
+    const uint8_t* buffer = self->data + position;
+
+    record->timestamp = decodeUInt64(buffer);
+    record->connectionId = decodeUInt32(buffer + 8);
+    record->sent = ((buffer[12] & CAPTURE_FLAG_SENT) != 0);
+    record->msgSize = decodeUInt16(buffer + 14);
+    record->msg = buffer + CAPTURE_RECORD_HEADER_SIZE;
+}
+
+/* the record chain is checked by loadIndex and rebuildIndex */
+static uint64_t
+getRecordPosition(CS104_CaptureReader self, int index)
+{
+    uint64_t position = self->index[index / self->indexInterval];
+    int i;
+
+    for (i = 0; i < (int) (index % self->indexInterval); i++)
+        position += getPaddedRecordSize(decodeUInt16(self->data + position + 14));
+
+    return position;
+}
+
+bool
+CS104_CaptureReader_getRecord(CS104_CaptureReader self, int index, sCS104_CaptureRecord* record)
+{
+    if ((index < 0) || (index >= self->recordCount))
+        return false;
+
+    decodeRecord(self, getRecordPosition(self, index), record);
+
+    return true;
+}
+
+int
+CS104_CaptureReader_findRecord(CS104_CaptureReader self, uint64_t timestamp)
+{
+    int first = 0;
+    int last = self->indexSize - 1;
+
+    if (self->recordCount == 0)
+        return 0;
+
+    /* find the last index entry with a timestamp before the requested time */
+    while (first < last) {
+        int middle = (first + last + 1) / 2;
+
+        if (decodeUInt64(self->data + self->index[middle]) < timestamp)
+            first = middle;
+        else
+            last = middle - 1;
+    }
+
+    int index = first * self->indexInterval;
+    uint64_t position = self->index[first];
+
+    while (index < self->recordCount) {
+        if (decodeUInt64(self->data + position) >= timestamp)
+            break;
+
+        position += getPaddedRecordSize(decodeUInt16(self->data + position + 14));
+        index++;
+    }
+
+    return index;
+}
+
+void
+CS104_CaptureReader_destroy(CS104_CaptureReader self)
+{
+    if (self) {
+        if (self->data)
+            GLOBAL_FREEMEM(self->data);
+
+        if (self->index)
+            GLOBAL_FREEMEM(self->index);
+
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+/********************************************
+ * CS104_CaptureReplay
+ ********************************************/
+
+struct sCS104_CaptureReplay {
+    CS104_CaptureReader reader;
+
+    double speed;
+
+    bool sent;
+    int64_t connectionId;
+
+    bool stopped;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore sendSignal; /* posted when the send queue of the connection is available again or the replay is stopped */
+#endif
+
+    sCS104_CaptureReplayStatistics statistics;
+};
+
+CS104_CaptureReplay
+CS104_CaptureReplay_create(CS104_CaptureReader reader)
+{
+    CS104_CaptureReplay self = (CS104_CaptureReplay) GLOBAL_CALLOC(1, sizeof(struct sCS104_CaptureReplay));
+
+    if (self) {
+        self->reader = reader;
+        self->speed = 1.0;
+        self->sent = true;
+        self->connectionId = -1;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        self->sendSignal = Semaphore_create(0);
+#endif
+    }
+
+    return self;
+}
+
+void
+CS104_CaptureReplay_setSpeed(CS104_CaptureReplay self, double speed)
+{
+    self->speed = speed;
+}
+
+void
+CS104_CaptureReplay_setFilter(CS104_CaptureReplay self, bool sent, int64_t connectionId)
+{
+    self->sent = sent;
+    self->connectionId = connectionId;
+}
+
+/* wait until the replay time of a record is reached */
+static void
+waitForReplayTime(CS104_CaptureReplay self, uint64_t replayStart, uint64_t recordOffset)
+{
+    uint64_t replayTime = replayStart + (uint64_t) ((double) recordOffset / self->speed);
+
+    while (LIB60870_ATOMIC_LOAD(&(self->stopped)) == false) {
+        uint64_t now = Hal_getTimeInNs();
+
+        if (now >= replayTime)
+            break;
+
+        uint64_t waitTimeMs = (replayTime - now) / 1000000;
+
+        Thread_sleep((waitTimeMs > 0) ? (int) ((waitTimeMs > 100) ? 100 : waitTimeMs) : 0);
+    }
+}
+
+typedef enum {
+    REPLAY_RECORD_SENT,
+    REPLAY_RECORD_SKIPPED,
+    REPLAY_STOP
+} ReplayResult;
+
+typedef ReplayResult (*ReplayFunction) (void* parameter, const sCS104_CaptureRecord* record);
+
+static int
+replayRecords(CS104_CaptureReplay self, ReplayFunction replayFunction, void* parameter)
+{
+    CS104_CaptureReader reader = self->reader;
+    sCS104_CaptureRecord record;
+    uint64_t firstTimestamp = 0;
+    bool firstRecord = true;
+    uint64_t position = 0;
+    int i;
+
+    memset(&(self->statistics), 0, sizeof(sCS104_CaptureReplayStatistics));
+    LIB60870_ATOMIC_STORE(&(self->stopped), false);
+
+    uint64_t replayStart = Hal_getTimeInNs();
+
+    if (reader->recordCount > 0)
+        position = reader->index[0];
+
+    for (i = 0; i < reader->recordCount; i++) {
+        if (LIB60870_ATOMIC_LOAD(&(self->stopped)))
+            break;
+
+        decodeRecord(reader, position, &record);
+
+        position += getPaddedRecordSize(record.msgSize);
+
+        if ((record.sent != self->sent) ||
+                ((self->connectionId != -1) && ((int64_t) record.connectionId != self->connectionId)))
+        {
+            self->statistics.skippedRecords++;
+            continue;
+        }
+
+        if (firstRecord) {
+            firstTimestamp = record.timestamp;
+            firstRecord = false;
+        }
+
+        if ((self->speed > 0) && (record.timestamp > firstTimestamp))
+            waitForReplayTime(self, replayStart, record.timestamp - firstTimestamp);
+
+        ReplayResult result = replayFunction(parameter, &record);
+
+        if (result == REPLAY_RECORD_SENT)
+            self->statistics.replayedRecords++;
+        else if (result == REPLAY_RECORD_SKIPPED)
+            self->statistics.skippedRecords++;
+        else
+            break;
+    }
+
+    self->statistics.durationNs = Hal_getTimeInNs() - replayStart;
+
+    return (int) self->statistics.replayedRecords;
+}
+
+typedef struct {
+    CS104_CaptureReplayHandler handler;
+    void* parameter;
+} HandlerReplay;
+
+static ReplayResult
+handlerReplayFunction(void* parameter, const sCS104_CaptureRecord* record)
+{
+    HandlerReplay* handlerReplay = (HandlerReplay*) parameter;
+
+    if (handlerReplay->handler(handlerReplay->parameter, record))
+        return REPLAY_RECORD_SENT;
+    else
+        return REPLAY_STOP;
+}
+
+int
+CS104_CaptureReplay_run(CS104_CaptureReplay self, CS104_CaptureReplayHandler handler, void* parameter)
+{
+    HandlerReplay handlerReplay;
+
+    handlerReplay.handler = handler;
+    handlerReplay.parameter = parameter;
+
+    return replayRecords(self, handlerReplayFunction, &handlerReplay);
+}
+
+/* I format APDU -> ASDU of the APDU */
+static CS101_ASDU
+getASDUOfRecord(CS101_ASDUView asduView, CS101_AppLayerParameters parameters, const sCS104_CaptureRecord* record)
+{
+    if ((record->msgSize < 7) || (record->msg[0] != 0x68) || ((record->msg[2] & 0x01) != 0))
+        return NULL;
+
+    return CS101_ASDU_initializeView(asduView, parameters, (uint8_t*) record->msg + 6, record->msgSize - 6);
+}
+
+static ReplayResult
+slaveReplayFunction(void* parameter, const sCS104_CaptureRecord* record)
+{
+    CS104_Slave slave = (CS104_Slave) parameter;
+    sCS101_ASDUView asduView;
+
+    CS101_ASDU asdu = getASDUOfRecord(&asduView, CS104_Slave_getAppLayerParameters(slave), record);
+
+    if (asdu == NULL)
+        return REPLAY_RECORD_SKIPPED;
+
+    CS104_Slave_enqueueASDU(slave, asdu);
+
+    return REPLAY_RECORD_SENT;
+}
+
+int
+CS104_CaptureReplay_runSlave(CS104_CaptureReplay self, CS104_Slave slave)
+{
+    return replayRecords(self, slaveReplayFunction, slave);
+}
+
+typedef struct {
+    CS104_CaptureReplay replay;
+    CS104_Connection connection;
+} ConnectionReplay;
+
+static ReplayResult
+connectionReplayFunction(void* parameter, const sCS104_CaptureRecord* record)
+{
+    ConnectionReplay* connectionReplay = (ConnectionReplay*) parameter;
+    sCS101_ASDUView asduView;
+
+    CS101_ASDU asdu = getASDUOfRecord(&asduView, CS104_Connection_getAppLayerParameters(connectionReplay->connection), record);
+
+    if (asdu == NULL)
+        return REPLAY_RECORD_SKIPPED;
+
+    /* sendASDU only fails when the send queue is full or the connection is closed */
+    while (CS104_Connection_sendASDU(connectionReplay->connection, asdu) == false) {
+
+        if (CS104_Connection_isRunning(connectionReplay->connection) == false)
+            return REPLAY_STOP;
+
+        if (LIB60870_ATOMIC_LOAD(&(connectionReplay->replay->stopped)))
+            return REPLAY_STOP;
+
+        /* wait for CS104_CONNECTION_SEND_QUEUE_AVAILABLE (also posted when the connection is closed) */
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_wait(connectionReplay->replay->sendSignal);
+#else
+        Thread_sleep(1);
+#endif
+    }
+
+    return REPLAY_RECORD_SENT;
+}
+
+int
+CS104_CaptureReplay_runConnection(CS104_CaptureReplay self, CS104_Connection connection)
+{
+    ConnectionReplay connectionReplay;
+    int replayedRecords;
+
+    connectionReplay.replay = self;
+    connectionReplay.connection = connection;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    if ((self->sendSignal == NULL) || (CS104_Connection_setEventSignal(connection, self->sendSignal) == false)) {
+        DEBUG_PRINT("Replay requires a connection with a send queue\n");
+        return 0;
+    }
+#endif
+
+    replayedRecords = replayRecords(self, connectionReplayFunction, &connectionReplay);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    CS104_Connection_setEventSignal(connection, NULL);
+#endif
+
+    return replayedRecords;
+}
+
+void
+CS104_CaptureReplay_stop(CS104_CaptureReplay self)
+{
+    LIB60870_ATOMIC_STORE(&(self->stopped), true);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    /* wake up a replay that waits for the send queue */
+    if (self->sendSignal)
+        Semaphore_post(self->sendSignal);
+#endif
+}
+
+void
+CS104_CaptureReplay_getStatistics(CS104_CaptureReplay self, sCS104_CaptureReplayStatistics* stats)
+{
+    *stats = self->statistics;
+}
+
+void
+CS104_CaptureReplay_destroy(CS104_CaptureReplay self)
+{
+    if (self) {
+#if (CONFIG_USE_SEMAPHORES == 1)
+        if (self->sendSignal)
+            Semaphore_destroy(self->sendSignal);
+#endif
+
+        GLOBAL_FREEMEM(self);
+    }
+}
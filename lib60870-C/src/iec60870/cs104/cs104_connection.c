@@ -24,6 +24,9 @@
 #define _CRT_NONSTDC_NO_DEPRECATE
 #endif
 
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_CS104_CLIENT
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
 #include "cs104_connection.h"
 
 #include <limits.h>
@@ -32,16 +35,21 @@
 #include <stdio.h>
 
 #include "cs104_frame.h"
+#include "buffer_frame.h"
 #include "hal_thread.h"
 #include "hal_socket.h"
 #include "tls_socket.h"
 #include "hal_time.h"
 #include "lib_memory.h"
+#include "linked_list.h"
 
 #include "apl_types_internal.h"
 #include "information_objects_internal.h"
 #include "lib60870_internal.h"
 #include "cs101_asdu_internal.h"
+#include "cs104_statistics.h"
+#include "cs104_connection_internal.h"
+#include "lib60870_trace.h"
 
 struct sCS104_APCIParameters defaultAPCIParameters = {
 		/* .k = */ 12,
@@ -79,6 +87,97 @@ typedef struct {
     int seqNo;
 } SentASDU;
 
+/* entry of the received ASDU queue (see CS104_Connection_setASDUQueueSize) */
+typedef struct {
+    int size;
+    uint8_t asdu[256];
+} ASDUQueueEntry;
+
+#ifndef CONFIG_CS104_MAX_OUTSTANDING_COMMANDS
+#define CONFIG_CS104_MAX_OUTSTANDING_COMMANDS 64
+#endif
+
+#define DEFAULT_COMMAND_TIMEOUT_MS 10000
+
+/* maximum size of a command ASDU and of a response that can be correlated with a command */
+#define COMMAND_MAX_ASDU_SIZE 32
+
+/* state of an outstanding command (see CS104_Connection_sendCommand) */
+typedef enum {
+    COMMAND_STATE_FREE = 0,
+    COMMAND_STATE_SELECT_PENDING = 1, /* select is waiting for a free entry in the k-buffer */
+    COMMAND_STATE_SELECT_SENT = 2,
+    COMMAND_STATE_EXECUTE_PENDING = 3, /* execute is waiting for a free entry in the k-buffer */
+    COMMAND_STATE_EXECUTE_SENT = 4,
+    COMMAND_STATE_WAITING_FOR_TERM = 5,
+    COMMAND_STATE_COMPLETED = 6 /* final event is not yet delivered */
+} CommandState;
+
+typedef struct {
+    CommandState state;
+    CS104_CommandHandle handle;
+
+    /* key to correlate the responses */
+    int typeId;
+    int ca;
+    int ioa;
+
+    bool waitForTermination;
+    int sePos; /* position of the byte with the S/E flag in the ASDU (-1 = direct command) */
+    uint64_t timeout;
+
+    CS104_CommandHandler handler;
+    void* handlerParameter;
+
+    uint8_t asdu[COMMAND_MAX_ASDU_SIZE];
+    int asduSize;
+
+    int event; /* event to be delivered (-1 = none) */
+    uint8_t response[COMMAND_MAX_ASDU_SIZE];
+    int responseSize;
+} OutstandingCommand;
+
+/* state of a connection that is handled by a CS104_ConnectionManager */
+typedef enum {
+    MANAGER_STATE_IDLE = 0,
+    MANAGER_STATE_CONNECTING = 1,
+    MANAGER_STATE_CONNECTED = 2
+} CS104_ManagerState;
+
+#ifndef CONFIG_CS104_CONNECTION_MANAGER_MAX_EVENTS
+#define CONFIG_CS104_CONNECTION_MANAGER_MAX_EVENTS 256
+#endif
+
+/* maximum number of frames read from one connection before the next connection is served */
+#define MANAGER_MAX_FRAMES_PER_EVENT 16
+
+struct sCS104_ConnectionManager {
+    SocketPoller poller;
+    LinkedList connections;
+
+    int reconnectInterval; /* in ms - 0 = no automatic reconnect */
+
+    /* connections with a running timeout - binary min-heap ordered by the time of the next timeout */
+    CS104_Connection* timers;
+    int timerCount;
+    int timerCapacity;
+
+    bool requestPending; /* connect or close request of a connection */
+
+    bool waiting; /* tick is waiting for socket events without lock - the poller must not be changed */
+    int pendingRemovals; /* connections to be removed after the wait */
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore lock; /* protects the connection list, the timers, the poller, and the manager state of the connections */
+#endif
+
+#if (CONFIG_USE_THREADS == 1)
+    Thread thread;
+    bool running;
+#endif
+};
+
+
 struct sCS104_Connection {
     char hostname[HOST_NAME_MAX + 1];
     int tcpPort;
@@ -86,6 +185,8 @@ struct sCS104_Connection {
     char* localIpAddress;
     int localTcpPort;
 
+    char* unixPath; /* not NULL when connecting to a local unix domain socket */
+
     struct sCS104_APCIParameters parameters;
     struct sCS101_AppLayerParameters alParameters;
 
@@ -122,6 +223,7 @@ struct sCS104_Connection {
     bool running;
     bool failure;
     bool close;
+    bool active; /* connection is being established or is open (see resetConnection) - protected by conStateLock */
 
     CS104_ConState conState;
 
@@ -137,11 +239,70 @@ struct sCS104_Connection {
     CS101_ASDUReceivedHandler receivedHandler;
     void* receivedHandlerParameter;
 
+    CS101_MirrorCache mirrorCache;
+
     CS104_ConnectionHandler connectionHandler;
     void* connectionHandlerParameter;
 
     IEC60870_RawMessageHandler rawMessageHandler;
     void* rawMessageHandlerParameter;
+
+    uint32_t connectionCounter; /* incremented for each connection attempt (statistics) */
+    struct sCS104_ConnectionStatistics statistics;
+
+    /* only used when the connection is handled by a CS104_ConnectionManager */
+    CS104_ConnectionManager manager;
+    CS104_ManagerState managerState;
+    bool connectRequested;
+    uint64_t managerTimeout; /* connect timeout or time of the next reconnect */
+    int managerTimerIndex; /* position in the timer heap of the manager (-1 = no timer) */
+    uint64_t managerTimerDeadline;
+    bool managerRemove; /* removal requested while the manager was waiting for socket events */
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore managerRemoved; /* signaled by the manager when the requested removal is done */
+#endif
+
+    /* single producer/single consumer queue for received ASDUs - only used when asduQueueSize > 0 */
+    int asduQueueSize; /* requested size */
+    int asduQueueCapacity;
+    ASDUQueueEntry* asduQueue;
+    uint32_t asduQueueHead; /* only written by the receiving thread */
+    uint32_t asduQueueTail; /* only written by CS104_Connection_processASDUQueue */
+    uint32_t asduQueueConnectionStart; /* value of asduQueueHead when the current connection was started */
+
+    /* batch delivery of received ASDUs (see CS104_Connection_setASDUBatchHandler) */
+    CS104_ASDUBatchHandler batchHandler;
+    void* batchHandlerParameter;
+    int maxBatchSize;
+    int maxBatchDelay; /* in ms */
+    ASDUQueueEntry* batchEntries; /* only used by the receiving thread */
+    sCS101_ASDUView* batchViews;
+    CS101_ASDU* batchASDUs;
+    int batchCount;
+    uint64_t batchStartTime;
+
+    /* ASDUs that wait for a free entry in the k-buffer (see CS104_Connection_setSendQueueSize) - protected by conStateLock */
+    int sendQueueSize; /* requested size */
+    int sendQueueCapacity;
+    ASDUQueueEntry* sendQueue;
+    int sendQueueHead;
+    int sendQueueCount;
+    bool sendQueueOverflow; /* an ASDU was rejected because the queue was full */
+    bool sendQueueAvailable; /* raise CS104_CONNECTION_SEND_QUEUE_AVAILABLE */
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore eventSignal; /* see CS104_Connection_setEventSignal */
+#endif
+
+    /* outstanding commands (see CS104_Connection_sendCommand) - protected by conStateLock */
+    OutstandingCommand* commands;
+    int maxCommands;
+    int commandCount; /* entries that are not free */
+    int commandTimeout; /* in ms */
+    CS104_CommandHandle lastCommandHandle;
+    int pendingCommandEvents;
+    int* commandSendQueue; /* indexes of the commands that wait for a free entry in the k-buffer */
+    int commandSendQueueHead;
+    int commandSendQueueCount;
 };
 
 
@@ -166,6 +327,8 @@ writeToSocket(CS104_Connection self, uint8_t* buf, int size)
     if (self->rawMessageHandler)
         self->rawMessageHandler(self->rawMessageHandlerParameter, buf, size, true);
 
+    CS104_ConnectionStatistics_frameSent(&(self->statistics), buf, size);
+
 #if (CONFIG_CS104_SUPPORT_TLS == 1)
     if (self->tlsSocket)
         return TLSSocket_write(self->tlsSocket, buf, size);
@@ -185,13 +348,59 @@ prepareSMessage(uint8_t* msg)
     msg[3] = 0x00;
 }
 
+/**
+ * \brief Get the number of the last received ASDUs that must not be confirmed to the other side
+ *
+ * After a confirmation the other side can send up to k more I messages. These have to fit into
+ * the ASDU queue. So the confirmation of the last received ASDUs is only held back when the queue
+ * has less than k free entries. The ASDUs are confirmed when CS104_Connection_processASDUQueue
+ * has made room in the queue.
+ */
+static int
+getHeldBackASDUs(CS104_Connection self)
+{
+    if (self->asduQueue == NULL)
+        return 0;
+
+    uint32_t tail = LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->asduQueueTail));
+
+    /* ignore entries of a previous connection */
+    if ((int32_t) (tail - self->asduQueueConnectionStart) < 0)
+        tail = self->asduQueueConnectionStart;
+
+    int queuedASDUs = (int) (self->asduQueueHead - tail);
+
+    int heldBackASDUs = queuedASDUs + self->parameters.k - self->asduQueueCapacity;
+
+    if (heldBackASDUs < 0)
+        heldBackASDUs = 0;
+    else if (heldBackASDUs > queuedASDUs)
+        heldBackASDUs = queuedASDUs;
+
+    return heldBackASDUs;
+}
+
+/* receive sequence number N(R) to confirm all received I messages except the held back ASDUs */
+static int
+getConfirmedReceiveCount(CS104_Connection self, int heldBackASDUs)
+{
+    return (self->receiveCount - heldBackASDUs + 32768) % 32768;
+}
+
+/* number of received I messages that can be confirmed */
+static int
+getConfirmableMessages(CS104_Connection self)
+{
+    return self->unconfirmedReceivedIMessages - getHeldBackASDUs(self);
+}
+
 static void
-sendSMessage(CS104_Connection self)
+sendSMessage(CS104_Connection self, int receiveCount)
 {
     uint8_t* msg = self->sMessage;
 
-    msg [4] = (uint8_t) ((self->receiveCount % 128) * 2);
-    msg [5] = (uint8_t) (self->receiveCount / 128);
+    msg [4] = (uint8_t) ((receiveCount % 128) * 2);
+    msg [5] = (uint8_t) (receiveCount / 128);
 
     writeToSocket(self, msg, 6);
 }
@@ -199,13 +408,20 @@ sendSMessage(CS104_Connection self)
 static int
 sendIMessage(CS104_Connection self, Frame frame)
 {
-    T104Frame_prepareToSend((T104Frame) frame, self->sendCount, self->receiveCount);
+    int heldBackASDUs = getHeldBackASDUs(self);
+    int receiveCount = getConfirmedReceiveCount(self, heldBackASDUs);
+
+    T104Frame_prepareToSend((T104Frame) frame, self->sendCount, receiveCount);
+
+    int msgSize = T104Frame_getMsgSize(frame);
 
-    writeToSocket(self, T104Frame_getBuffer(frame), T104Frame_getMsgSize(frame));
+    LIB60870_TRACE4(cs104_client_send, self->statistics.connectionId, self->sendCount, receiveCount, msgSize);
+
+    writeToSocket(self, T104Frame_getBuffer(frame), msgSize);
 
     self->sendCount = (self->sendCount + 1) % 32768;
 
-    self->unconfirmedReceivedIMessages = false;
+    self->unconfirmedReceivedIMessages = heldBackASDUs;
     self->timeoutT2Trigger = false;
 
     int sendCount = self->sendCount;
@@ -227,6 +443,8 @@ createConnection(const char* hostname, int tcpPort)
         self->localIpAddress = NULL;
         self->localTcpPort = -1;
 
+        self->unixPath = NULL;
+
         self->receivedHandler = NULL;
         self->receivedHandlerParameter = NULL;
 
@@ -251,6 +469,9 @@ createConnection(const char* hostname, int tcpPort)
 
         self->sentASDUs = NULL;
 
+        self->maxCommands = CONFIG_CS104_MAX_OUTSTANDING_COMMANDS;
+        self->commandTimeout = DEFAULT_COMMAND_TIMEOUT_MS;
+
         self->conState = STATE_IDLE;
 
         prepareSMessage(self->sMessage);
@@ -268,6 +489,26 @@ CS104_Connection_create(const char* hostname, int tcpPort)
     return createConnection(hostname, tcpPort);
 }
 
+CS104_Connection
+CS104_Connection_createUnix(const char* path)
+{
+    CS104_Connection self = createConnection(path, IEC_60870_5_104_DEFAULT_PORT);
+
+    if (self != NULL) {
+        self->unixPath = (char*) GLOBAL_MALLOC(strlen(path) + 1);
+
+        if (self->unixPath) {
+            strcpy(self->unixPath, path);
+        }
+        else {
+            CS104_Connection_destroy(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
 #if (CONFIG_CS104_SUPPORT_TLS == 1)
 CS104_Connection
 CS104_Connection_createSecure(const char* hostname, int tcpPort, TLSConfiguration tlsConfig)
@@ -280,12 +521,32 @@ CS104_Connection_createSecure(const char* hostname, int tcpPort, TLSConfiguratio
     if (self != NULL) {
         self->tlsConfig = tlsConfig;
         TLSConfiguration_setClientMode(tlsConfig);
+
+        lib60870_updateTLSDebugHandler();
     }
 
     return self;
 }
 #endif /* (CONFIG_CS104_SUPPORT_TLS == 1) */
 
+static Socket
+createSocket(CS104_Connection self)
+{
+    if (self->unixPath)
+        return UnixSocket_create();
+    else
+        return TcpSocket_create();
+}
+
+static const char*
+getRemoteAddress(CS104_Connection self)
+{
+    if (self->unixPath)
+        return self->unixPath;
+    else
+        return self->hostname;
+}
+
 static void
 resetT3Timeout(CS104_Connection self) {
     self->nextT3Timeout = Hal_getTimeInMs() + (self->parameters.t3 * 1000);
@@ -304,6 +565,7 @@ resetConnection(CS104_Connection self)
     self->running = false;
     self->failure = false;
     self->close = false;
+    self->active = true;
 
     self->receiveCount = 0;
     self->sendCount = 0;
@@ -320,11 +582,41 @@ resetConnection(CS104_Connection self)
         self->sentASDUs = (SentASDU*) GLOBAL_MALLOC(sizeof(SentASDU) * self->maxSentASDUs);
     }
 
+    if ((self->asduQueue == NULL) && (self->asduQueueSize > 0)) {
+        /* the other side can send up to k unconfirmed I messages */
+        self->asduQueueCapacity = self->asduQueueSize;
+
+        if (self->asduQueueCapacity < self->parameters.k)
+            self->asduQueueCapacity = self->parameters.k;
+
+        self->asduQueue = (ASDUQueueEntry*) GLOBAL_MALLOC(sizeof(ASDUQueueEntry) * self->asduQueueCapacity);
+    }
+
+    /* entries of a previous connection are dropped by CS104_Connection_processASDUQueue */
+    LIB60870_ATOMIC_STORE_RELEASE(&(self->asduQueueConnectionStart), self->asduQueueHead);
+
+    if ((self->sendQueue == NULL) && (self->sendQueueSize > 0)) {
+        self->sendQueueCapacity = self->sendQueueSize;
+        self->sendQueue = (ASDUQueueEntry*) GLOBAL_MALLOC(sizeof(ASDUQueueEntry) * self->sendQueueCapacity);
+    }
+
+    self->sendQueueHead = 0;
+    self->sendQueueCount = 0;
+    self->sendQueueOverflow = false;
+    self->sendQueueAvailable = false;
+
     self->outstandingTestFCConMessages = 0;
     self->uMessageTimeout = 0;
 
     self->conState = STATE_IDLE;
 
+    self->connectionCounter++;
+
+    if (self->connectionCounter == 0)
+        self->connectionCounter = 1;
+
+    CS104_ConnectionStatistics_reset(&(self->statistics), self->connectionCounter);
+
     resetT3Timeout(self);
 
 #if (CONFIG_USE_SEMAPHORES == 1)
@@ -332,6 +624,15 @@ resetConnection(CS104_Connection self)
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 }
 
+static int
+getSentBufferSize(CS104_Connection self)
+{
+    if (self->oldestSentASDU == -1)
+        return 0;
+
+    return ((self->newestSentASDU - self->oldestSentASDU + self->maxSentASDUs) % self->maxSentASDUs) + 1;
+}
+
 static bool
 checkSequenceNumber(CS104_Connection self, int seqNo)
 {
@@ -374,6 +675,8 @@ checkSequenceNumber(CS104_Connection self, int seqNo)
 
         if (self->oldestSentASDU != -1) {
 
+            uint64_t currentTime = Hal_getTimeInMs();
+
             do {
                 if (counterOverflowDetected == false) {
                     if (seqNo < self->sentASDUs [self->oldestSentASDU].seqNo)
@@ -383,6 +686,9 @@ checkSequenceNumber(CS104_Connection self, int seqNo)
                 if (seqNo == oldestValidSeqNo)
                     break;
 
+                CS104_ConnectionStatistics_addAck(&(self->statistics),
+                        self->sentASDUs[self->oldestSentASDU].sentTime, currentTime);
+
                 if (self->sentASDUs [self->oldestSentASDU].seqNo == seqNo) {
                     /* we arrived at the seq# that has been confirmed */
 
@@ -405,7 +711,10 @@ checkSequenceNumber(CS104_Connection self, int seqNo)
 
             } while (true);
 
+            CS104_ConnectionStatistics_setKWindow(&(self->statistics), getSentBufferSize(self), false);
         }
+
+        LIB60870_TRACE3(cs104_client_ack, self->statistics.connectionId, seqNo, self->statistics.kWindow);
     }
 
     return seqNoIsValid;
@@ -425,6 +734,79 @@ isSentBufferFull(CS104_Connection self)
         return false;
 }
 
+static void
+sendIMessageAndUpdateSentASDUs(CS104_Connection self, Frame frame)
+{
+    int currentIndex = 0;
+
+    if (self->oldestSentASDU == -1) {
+        self->oldestSentASDU = 0;
+        self->newestSentASDU = 0;
+
+    } else {
+        currentIndex = (self->newestSentASDU + 1) % self->maxSentASDUs;
+    }
+
+    self->sentASDUs [currentIndex].seqNo = sendIMessage (self, frame);
+    self->sentASDUs [currentIndex].sentTime = Hal_getTimeInMs();
+
+    self->newestSentASDU = currentIndex;
+
+    CS104_ConnectionStatistics_setKWindow(&(self->statistics), getSentBufferSize(self), true);
+}
+
+/**
+ * \brief Copy the ASDU of a frame to the send queue - has to be called with conStateLock
+ *
+ * \return false when the queue is full
+ */
+static bool
+enqueueASDUToSend(CS104_Connection self, Frame frame)
+{
+    if (self->sendQueueCount >= self->sendQueueCapacity) {
+        self->sendQueueOverflow = true;
+        return false;
+    }
+
+    ASDUQueueEntry* entry = &(self->sendQueue[(self->sendQueueHead + self->sendQueueCount) % self->sendQueueCapacity]);
+
+    /* the APCI is added when the ASDU is sent */
+    entry->size = T104Frame_getMsgSize(frame) - 6;
+    memcpy(entry->asdu, T104Frame_getBuffer(frame) + 6, entry->size);
+
+    self->sendQueueCount++;
+
+    return true;
+}
+
+/* send the queued ASDUs as long as the k-buffer is not full - has to be called with conStateLock */
+static void
+sendQueuedASDUs(CS104_Connection self)
+{
+    bool sent = false;
+
+    while ((self->sendQueueCount > 0) && self->running && (isSentBufferFull(self) == false)) {
+        ASDUQueueEntry* entry = &(self->sendQueue[self->sendQueueHead]);
+
+        struct sT104Frame _frame;
+        Frame frame = T104Frame_initialize(&_frame);
+
+        T104Frame_appendBytes(frame, entry->asdu, entry->size);
+
+        sendIMessageAndUpdateSentASDUs(self, frame);
+
+        self->sendQueueHead = (self->sendQueueHead + 1) % self->sendQueueCapacity;
+        self->sendQueueCount--;
+
+        sent = true;
+    }
+
+    if (sent && self->sendQueueOverflow) {
+        self->sendQueueOverflow = false;
+        self->sendQueueAvailable = true;
+    }
+}
+
 void
 CS104_Connection_close(CS104_Connection self)
 {
@@ -438,6 +820,11 @@ CS104_Connection_close(CS104_Connection self)
     Semaphore_post(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
+    if (self->manager) {
+        LIB60870_ATOMIC_STORE(&(self->manager->requestPending), true);
+        SocketPoller_wakeup(self->manager->poller);
+    }
+
 #if (CONFIG_USE_THREADS == 1)
     if (self->connectionHandlingThread)
     {
@@ -452,9 +839,29 @@ CS104_Connection_destroy(CS104_Connection self)
 {
     CS104_Connection_close(self);
 
+    if (self->manager)
+        CS104_ConnectionManager_removeConnection(self->manager, self);
+
     if (self->sentASDUs != NULL)
         GLOBAL_FREEMEM(self->sentASDUs);
 
+    if (self->asduQueue != NULL)
+        GLOBAL_FREEMEM(self->asduQueue);
+
+    if (self->sendQueue != NULL)
+        GLOBAL_FREEMEM(self->sendQueue);
+
+    if (self->batchEntries != NULL) {
+        GLOBAL_FREEMEM(self->batchEntries);
+        GLOBAL_FREEMEM(self->batchViews);
+        GLOBAL_FREEMEM(self->batchASDUs);
+    }
+
+    if (self->commands != NULL) {
+        GLOBAL_FREEMEM(self->commands);
+        GLOBAL_FREEMEM(self->commandSendQueue);
+    }
+
 #if (CONFIG_USE_SEMAPHORES == 1)
     Semaphore_destroy(self->conStateLock);
 #endif
@@ -464,6 +871,11 @@ CS104_Connection_destroy(CS104_Connection self)
         self->localIpAddress = NULL;
     }
 
+    if (self->unixPath) {
+        GLOBAL_FREEMEM(self->unixPath);
+        self->unixPath = NULL;
+    }
+
     GLOBAL_FREEMEM(self);
 }
 
@@ -477,7 +889,12 @@ CS104_Connection_setLocalAddress(CS104_Connection self, const char* localIpAddre
         }
 
         if (localIpAddress) {
-            self->localIpAddress = strdup(localIpAddress);
+            /* not strdup: the string is released with GLOBAL_FREEMEM */
+            self->localIpAddress = (char*) GLOBAL_MALLOC(strlen(localIpAddress) + 1);
+
+            if (self->localIpAddress)
+                strcpy(self->localIpAddress, localIpAddress);
+
             self->localTcpPort = localPort;
         }
     }
@@ -495,6 +912,10 @@ void
 CS104_Connection_setAppLayerParameters(CS104_Connection self, const CS101_AppLayerParameters parameters)
 {
     self->alParameters = *parameters;
+
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+    CS101_AppLayerParameters_applyFixedProfile(&(self->alParameters));
+#endif
 }
 
 CS101_AppLayerParameters
@@ -515,6 +936,14 @@ CS104_Connection_getAPCIParameters(CS104_Connection self)
     return &(self->parameters);
 }
 
+bool
+CS104_Connection_getStatistics(CS104_Connection self, CS104_ConnectionStatistics stats)
+{
+    CS104_ConnectionStatistics_getSnapshot(&(self->statistics), stats);
+
+    return (stats->connectionId != 0);
+}
+
 /**
  * \return number of bytes read, or -1 in case of an error
  */
@@ -582,6 +1011,9 @@ receiveMessage(CS104_Connection self)
 
         if (readCnt == remainingLength) {
             self->recvBufPos = 0;
+
+            LIB60870_TRACE3(cs104_client_frame_recv, self->statistics.connectionId, length + 2, buffer[2]);
+
             return length + 2;
         }
         else if (readCnt == -1) {
@@ -613,90 +1045,470 @@ checkConfirmTimeout(CS104_Connection self, uint64_t currentTime)
 static void
 confirmOutstandingMessages(CS104_Connection self)
 {
+    int heldBackASDUs = getHeldBackASDUs(self);
+
     self->lastConfirmationTime = Hal_getTimeInMs();
-    self->unconfirmedReceivedIMessages = 0;
-    self->timeoutT2Trigger = false;
-    sendSMessage(self);
+    self->unconfirmedReceivedIMessages = heldBackASDUs;
+    self->timeoutT2Trigger = (heldBackASDUs > 0);
+    sendSMessage(self, getConfirmedReceiveCount(self, heldBackASDUs));
 }
 
+/**
+ * \brief Copy a received ASDU to the ASDU batch
+ *
+ * \return false when the ASDU is invalid
+ */
 static bool
-checkMessage(CS104_Connection self, uint8_t* buffer, int msgSize)
+addASDUToBatch(CS104_Connection self, uint8_t* msg, int msgSize)
 {
-    bool retVal = true;
-
-    if ((buffer[2] & 1) == 0) /* I format frame */
-    {
-        if (self->timeoutT2Trigger == false) {
-            self->timeoutT2Trigger = true;
-            self->lastConfirmationTime = Hal_getTimeInMs(); /* start timeout T2 */
-        }
-
-        if (msgSize < 7) {
-            DEBUG_PRINT("I msg too small!\n");
-            retVal =  false;
+    if (msgSize < (2 + CS101_SIZE_OF_COT(&(self->alParameters)) + CS101_SIZE_OF_CA(&(self->alParameters))))
+        return false;
 
-            goto exit_function;
-        }
+    if (self->batchCount == 0)
+        self->batchStartTime = Hal_getTimeInMs();
 
-        int frameSendSequenceNumber = ((buffer [3] * 0x100) + (buffer [2] & 0xfe)) / 2;
-        int frameRecvSequenceNumber = ((buffer [5] * 0x100) + (buffer [4] & 0xfe)) / 2;
+    ASDUQueueEntry* entry = &(self->batchEntries[self->batchCount]);
 
-        DEBUG_PRINT("Received I frame: N(S) = %i N(R) = %i\n", frameSendSequenceNumber, frameRecvSequenceNumber);
+    memcpy(entry->asdu, msg, msgSize);
+    entry->size = msgSize;
 
-        /* check the receive sequence number N(R) - connection will be closed on an unexpected value */
-        if (frameSendSequenceNumber != self->receiveCount) {
-            DEBUG_PRINT("Sequence error: Close connection!");
+    self->batchCount++;
 
-            retVal =  false;
+    return true;
+}
 
-            goto exit_function;
-        }
+/* call the batch handler for the collected ASDUs - has to be called without holding conStateLock */
+static void
+deliverASDUBatch(CS104_Connection self)
+{
+    int i;
 
-        if (checkSequenceNumber(self, frameRecvSequenceNumber) == false) {
-            retVal =  false;
+    if (self->batchCount == 0)
+        return;
 
-            goto exit_function;
-        }
+    for (i = 0; i < self->batchCount; i++)
+        self->batchASDUs[i] = CS101_ASDU_initializeView(&(self->batchViews[i]), (CS101_AppLayerParameters)&(self->alParameters),
+                self->batchEntries[i].asdu, self->batchEntries[i].size);
 
-        self->receiveCount = (self->receiveCount + 1) % 32768;
-        self->unconfirmedReceivedIMessages++;
+    self->batchHandler(self->batchHandlerParameter, self->batchASDUs, self->batchCount);
 
-        CS101_ASDU asdu = CS101_ASDU_createFromBuffer((CS101_AppLayerParameters)&(self->alParameters), buffer + 6, msgSize - 6);
+    self->batchCount = 0;
+}
 
-        if (asdu != NULL) {
-            if (self->receivedHandler != NULL)
-                self->receivedHandler(self->receivedHandlerParameter, -1, asdu);
+/* deliver the ASDU batch when the maximum delay is reached (or no delay is configured) */
+static void
+checkASDUBatch(CS104_Connection self, uint64_t currentTime)
+{
+    if (self->batchCount > 0) {
+        if ((self->maxBatchDelay <= 0) || ((currentTime - self->batchStartTime) >= (uint64_t) self->maxBatchDelay))
+            deliverASDUBatch(self);
+    }
+}
 
-            CS101_ASDU_destroy(asdu);
-        }
-        else {
-            retVal =  false;
+/**
+ * \brief Copy a received ASDU to the ASDU queue
+ *
+ * \return false when the ASDU is invalid or the queue is full
+ */
+static bool
+enqueueASDU(CS104_Connection self, uint8_t* msg, int msgSize)
+{
+    if (msgSize < (2 + CS101_SIZE_OF_COT(&(self->alParameters)) + CS101_SIZE_OF_CA(&(self->alParameters))))
+        return false;
 
-            goto exit_function;
-        }
+    uint32_t head = self->asduQueueHead;
 
+    if ((head - LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->asduQueueTail))) >= (uint32_t) self->asduQueueCapacity) {
+        /* can only happen when the other side sends more than k unconfirmed I messages */
+        DEBUG_PRINT("ASDU queue overflow\n");
+        return false;
     }
-    else if ((buffer[2] & 0x03) == 0x03)  /* U format frame */
-    {
-        DEBUG_PRINT("Received U frame\n");
 
-        self->uMessageTimeout = 0;
+    ASDUQueueEntry* entry = &(self->asduQueue[head % self->asduQueueCapacity]);
 
-        if (buffer[2] == 0x43) { /* Check for TESTFR_ACT message */
-            DEBUG_PRINT("Send TESTFR_CON\n");
+    memcpy(entry->asdu, msg, msgSize);
+    entry->size = msgSize;
 
-            writeToSocket(self, TESTFR_CON_MSG, TESTFR_CON_MSG_SIZE);
-        }
-        else if (buffer[2] == 0x83) { /* TESTFR_CON */
-            DEBUG_PRINT("Rcvd TESTFR_CON\n");
-            self->outstandingTestFCConMessages = 0;
-        }
-        else if (buffer[2] == 0x07) { /* STARTDT_ACT */
-            DEBUG_PRINT("Send STARTDT_CON\n");
+    LIB60870_ATOMIC_STORE_RELEASE(&(self->asduQueueHead), head + 1);
 
-            writeToSocket(self, STARTDT_CON_MSG, STARTDT_CON_MSG_SIZE);
+    return true;
+}
 
-            self->conState = STATE_ACTIVE;
+/********************************************
+ * Outstanding commands
+ ********************************************/
+
+/* has to be called with conStateLock */
+static void
+setCommandEvent(CS104_Connection self, OutstandingCommand* command, CS104_CommandEvent event, bool final, uint8_t* response, int responseSize)
+{
+    /* events are delivered after each received message and timeout check -> no event is pending here */
+    if (command->event == -1)
+        self->pendingCommandEvents++;
+
+    command->event = (int) event;
+
+    if (response) {
+        memcpy(command->response, response, responseSize);
+        command->responseSize = responseSize;
+    }
+    else
+        command->responseSize = 0;
+
+    if (final)
+        command->state = COMMAND_STATE_COMPLETED;
+}
+
+/* has to be called with conStateLock */
+static void
+enqueueCommandToSend(CS104_Connection self, int index)
+{
+    int pos = (self->commandSendQueueHead + self->commandSendQueueCount) % self->maxCommands;
+
+    self->commandSendQueue[pos] = index;
+    self->commandSendQueueCount++;
+}
+
+/* send the queued commands as long as the k-buffer is not full - has to be called with conStateLock */
+static void
+sendPendingCommands(CS104_Connection self)
+{
+    while ((self->commandSendQueueCount > 0) && self->running && (isSentBufferFull(self) == false)) {
+        OutstandingCommand* command = &(self->commands[self->commandSendQueue[self->commandSendQueueHead]]);
+
+        self->commandSendQueueHead = (self->commandSendQueueHead + 1) % self->maxCommands;
+        self->commandSendQueueCount--;
+
+        if (command->state == COMMAND_STATE_SELECT_PENDING) {
+            command->asdu[command->sePos] |= 0x80;
+            command->state = COMMAND_STATE_SELECT_SENT;
+        }
+        else if (command->state == COMMAND_STATE_EXECUTE_PENDING) {
+            if (command->sePos != -1)
+                command->asdu[command->sePos] &= 0x7f;
+
+            command->state = COMMAND_STATE_EXECUTE_SENT;
+        }
+        else
+            continue;
+
+        struct sT104Frame _frame;
+        Frame frame = T104Frame_initialize(&_frame);
+
+        T104Frame_appendBytes(frame, command->asdu, command->asduSize);
+
+        sendIMessageAndUpdateSentASDUs(self, frame);
+
+        command->timeout = Hal_getTimeInMs() + self->commandTimeout;
+    }
+}
+
+/* check if a received ASDU is a response to an outstanding command - has to be called with conStateLock */
+static void
+checkCommandResponse(CS104_Connection self, uint8_t* msg, int msgSize)
+{
+    if (msgSize > COMMAND_MAX_ASDU_SIZE)
+        return;
+
+    sCS101_ASDUView _asdu;
+
+    CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, (CS101_AppLayerParameters)&(self->alParameters), msg, msgSize);
+
+    if (asdu == NULL)
+        return;
+
+    CS101_CauseOfTransmission cot = CS101_ASDU_getCOT(asdu);
+
+    bool unknown = ((cot >= CS101_COT_UNKNOWN_TYPE_ID) && (cot <= CS101_COT_UNKNOWN_IOA));
+
+    if ((cot != CS101_COT_ACTIVATION_CON) && (cot != CS101_COT_ACTIVATION_TERMINATION) && (unknown == false))
+        return;
+
+    int typeId = (int) CS101_ASDU_getTypeID(asdu);
+    int ca = CS101_ASDU_getCA(asdu);
+    int ioa = CS101_ASDU_getIOAAt(asdu, 0);
+
+    int i;
+
+    for (i = 0; i < self->maxCommands; i++) {
+        OutstandingCommand* command = &(self->commands[i]);
+
+        if ((command->state == COMMAND_STATE_FREE) || (command->typeId != typeId) || (command->ca != ca) || (command->ioa != ioa))
+            continue;
+
+        bool negative = (unknown || CS101_ASDU_isNegative(asdu));
+
+        switch (command->state) {
+
+        case COMMAND_STATE_SELECT_SENT:
+            if (negative)
+                setCommandEvent(self, command, CS104_COMMAND_NEGATIVE_CON, true, msg, msgSize);
+            else if (cot == CS101_COT_ACTIVATION_CON) {
+                /* select confirmed -> execute (sent by sendPendingCommands) */
+                command->state = COMMAND_STATE_EXECUTE_PENDING;
+                enqueueCommandToSend(self, i);
+            }
+            break;
+
+        case COMMAND_STATE_EXECUTE_SENT:
+            if (negative)
+                setCommandEvent(self, command, CS104_COMMAND_NEGATIVE_CON, true, msg, msgSize);
+            else if (cot == CS101_COT_ACTIVATION_CON) {
+                if (command->waitForTermination) {
+                    command->state = COMMAND_STATE_WAITING_FOR_TERM;
+                    command->timeout = Hal_getTimeInMs() + self->commandTimeout;
+                    setCommandEvent(self, command, CS104_COMMAND_ACT_CON, false, msg, msgSize);
+                }
+                else
+                    setCommandEvent(self, command, CS104_COMMAND_ACT_CON, true, msg, msgSize);
+            }
+            else /* ACT_TERM without ACT_CON */
+                setCommandEvent(self, command, CS104_COMMAND_ACT_TERM, true, msg, msgSize);
+            break;
+
+        case COMMAND_STATE_WAITING_FOR_TERM:
+            if (cot == CS101_COT_ACTIVATION_TERMINATION)
+                setCommandEvent(self, command, CS104_COMMAND_ACT_TERM, true, msg, msgSize);
+            else if (unknown)
+                setCommandEvent(self, command, CS104_COMMAND_NEGATIVE_CON, true, msg, msgSize);
+            break;
+
+        default:
+            /* response for a command that is not sent or already completed */
+            break;
+        }
+
+        /* only one outstanding command per type ID, CA and IOA */
+        break;
+    }
+}
+
+/* has to be called with conStateLock */
+static void
+checkCommandTimeouts(CS104_Connection self, uint64_t currentTime)
+{
+    int i;
+
+    for (i = 0; i < self->maxCommands; i++) {
+        OutstandingCommand* command = &(self->commands[i]);
+
+        if ((command->state == COMMAND_STATE_SELECT_SENT) || (command->state == COMMAND_STATE_EXECUTE_SENT) ||
+                (command->state == COMMAND_STATE_WAITING_FOR_TERM))
+        {
+            if (currentTime >= command->timeout) {
+                DEBUG_PRINT("Command timeout (type: %i CA: %i IOA: %i)\n", command->typeId, command->ca, command->ioa);
+
+                setCommandEvent(self, command, CS104_COMMAND_TIMEOUT, true, NULL, 0);
+            }
+        }
+    }
+}
+
+/* complete all outstanding commands when the connection is closed - has to be called with conStateLock */
+static void
+failOutstandingCommands(CS104_Connection self)
+{
+    int i;
+
+    for (i = 0; i < self->maxCommands; i++) {
+        OutstandingCommand* command = &(self->commands[i]);
+
+        if ((command->state != COMMAND_STATE_FREE) && (command->state != COMMAND_STATE_COMPLETED))
+            setCommandEvent(self, command, CS104_COMMAND_FAILED, true, NULL, 0);
+    }
+
+    self->commandSendQueueHead = 0;
+    self->commandSendQueueCount = 0;
+}
+
+/* call the command handlers for the pending events - has to be called without conStateLock */
+static void
+deliverCommandEvents(CS104_Connection self)
+{
+    if (LIB60870_ATOMIC_LOAD(&(self->pendingCommandEvents)) == 0)
+        return;
+
+    int i = 0;
+
+    while (true) {
+        OutstandingCommand* command = NULL;
+        CS104_CommandHandler handler = NULL;
+        void* handlerParameter = NULL;
+        CS104_CommandHandle handle = 0;
+        CS104_CommandEvent event = CS104_COMMAND_FAILED;
+        uint8_t response[COMMAND_MAX_ASDU_SIZE];
+        int responseSize = 0;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+        /* the handlers can send new commands -> copy the event and release the lock */
+        for (; (i < self->maxCommands) && (self->pendingCommandEvents > 0); i++) {
+            if (self->commands[i].event != -1) {
+                command = &(self->commands[i]);
+                break;
+            }
+        }
+
+        if (command) {
+            handler = command->handler;
+            handlerParameter = command->handlerParameter;
+            handle = command->handle;
+            event = (CS104_CommandEvent) command->event;
+            responseSize = command->responseSize;
+
+            if (responseSize > 0)
+                memcpy(response, command->response, responseSize);
+
+            command->event = -1;
+            self->pendingCommandEvents--;
+
+            if (command->state == COMMAND_STATE_COMPLETED) {
+                command->state = COMMAND_STATE_FREE;
+                self->commandCount--;
+            }
+        }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+        if (command == NULL)
+            break;
+
+        if (handler) {
+            sCS101_ASDUView _asdu;
+            CS101_ASDU asdu = NULL;
+
+            if (responseSize > 0)
+                asdu = CS101_ASDU_initializeView(&_asdu, (CS101_AppLayerParameters)&(self->alParameters), response, responseSize);
+
+            handler(handlerParameter, self, handle, event, asdu);
+        }
+    }
+}
+
+static bool
+checkMessage(CS104_Connection self, uint8_t* buffer, int msgSize)
+{
+    bool retVal = true;
+
+    /* the control field is only complete when the APDU has the minimum size */
+    if (msgSize >= 6) {
+        LIB60870_TRACE5(cs104_client_handle_message, self->statistics.connectionId, LIB60870_TRACE_FRAME_TYPE(buffer[2]),
+                msgSize, ((buffer[2] & 0xfe) / 2) + (buffer[3] * 128), ((buffer[4] & 0xfe) / 2) + (buffer[5] * 128));
+    }
+
+    if ((buffer[2] & 1) == 0) /* I format frame */
+    {
+        if (self->timeoutT2Trigger == false) {
+            self->timeoutT2Trigger = true;
+            self->lastConfirmationTime = Hal_getTimeInMs(); /* start timeout T2 */
+        }
+
+        if (msgSize < 7) {
+            DEBUG_PRINT("I msg too small!\n");
+            retVal =  false;
+
+            goto exit_function;
+        }
+
+        int frameSendSequenceNumber = ((buffer [3] * 0x100) + (buffer [2] & 0xfe)) / 2;
+        int frameRecvSequenceNumber = ((buffer [5] * 0x100) + (buffer [4] & 0xfe)) / 2;
+
+        DEBUG_PRINT("Received I frame: N(S) = %i N(R) = %i\n", frameSendSequenceNumber, frameRecvSequenceNumber);
+
+        /* check the receive sequence number N(R) - connection will be closed on an unexpected value */
+        if (frameSendSequenceNumber != self->receiveCount) {
+            DEBUG_PRINT("Sequence error: Close connection!");
+
+            retVal =  false;
+
+            goto exit_function;
+        }
+
+        if (checkSequenceNumber(self, frameRecvSequenceNumber) == false) {
+            retVal =  false;
+
+            goto exit_function;
+        }
+
+        self->receiveCount = (self->receiveCount + 1) % 32768;
+        self->unconfirmedReceivedIMessages++;
+
+        if (self->commandCount > 0)
+            checkCommandResponse(self, buffer + 6, msgSize - 6);
+
+        if (self->mirrorCache) {
+            sCS101_ASDUView _asdu;
+
+            CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, (CS101_AppLayerParameters)&(self->alParameters), buffer + 6, msgSize - 6);
+
+            if (asdu)
+                CS101_MirrorCache_handleASDU(self->mirrorCache, asdu);
+        }
+
+        if (self->asduQueue) {
+            /* the ASDU handler is called by CS104_Connection_processASDUQueue */
+            if (enqueueASDU(self, buffer + 6, msgSize - 6) == false) {
+                retVal = false;
+
+                goto exit_function;
+            }
+
+            LIB60870_TRACE4(cs104_client_handle_asdu, self->statistics.connectionId, buffer[6], buffer[8] & 0x3f, buffer[7] & 0x7f);
+        }
+        else if (self->batchHandler) {
+            /* the batch handler is called after the connection state is unlocked */
+            if (addASDUToBatch(self, buffer + 6, msgSize - 6) == false) {
+                retVal = false;
+
+                goto exit_function;
+            }
+
+            LIB60870_TRACE4(cs104_client_handle_asdu, self->statistics.connectionId, buffer[6], buffer[8] & 0x3f, buffer[7] & 0x7f);
+        }
+        else {
+            sCS101_ASDUView _asdu;
+
+            CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, (CS101_AppLayerParameters)&(self->alParameters), buffer + 6, msgSize - 6);
+
+            if (asdu != NULL) {
+                LIB60870_TRACE4(cs104_client_handle_asdu, self->statistics.connectionId, buffer[6], buffer[8] & 0x3f, buffer[7] & 0x7f);
+
+                if (self->receivedHandler != NULL)
+                    self->receivedHandler(self->receivedHandlerParameter, -1, asdu);
+            }
+            else {
+                retVal =  false;
+
+                goto exit_function;
+            }
+        }
+
+    }
+    else if ((buffer[2] & 0x03) == 0x03)  /* U format frame */
+    {
+        DEBUG_PRINT("Received U frame\n");
+
+        self->uMessageTimeout = 0;
+
+        if (buffer[2] == 0x43) { /* Check for TESTFR_ACT message */
+            DEBUG_PRINT("Send TESTFR_CON\n");
+
+            writeToSocket(self, TESTFR_CON_MSG, TESTFR_CON_MSG_SIZE);
+        }
+        else if (buffer[2] == 0x83) { /* TESTFR_CON */
+            DEBUG_PRINT("Rcvd TESTFR_CON\n");
+            self->outstandingTestFCConMessages = 0;
+        }
+        else if (buffer[2] == 0x07) { /* STARTDT_ACT */
+            DEBUG_PRINT("Send STARTDT_CON\n");
+
+            writeToSocket(self, STARTDT_CON_MSG, STARTDT_CON_MSG_SIZE);
+
+            self->conState = STATE_ACTIVE;
         }
         else if (buffer[2] == 0x0b) { /* STARTDT_CON */
             DEBUG_PRINT("Received STARTDT_CON\n");
@@ -725,6 +1537,14 @@ checkMessage(CS104_Connection self, uint8_t* buffer, int msgSize)
 
     resetT3Timeout(self);
 
+    /* confirmed I messages can allow to send queued ASDUs */
+    if (self->sendQueueCount > 0)
+        sendQueuedASDUs(self);
+
+    /* confirmed I messages or a confirmed select can allow to send queued commands */
+    if (self->commandSendQueueCount > 0)
+        sendPendingCommands(self);
+
 exit_function:
 
     return retVal;
@@ -741,11 +1561,18 @@ handleTimeouts(CS104_Connection self)
     Semaphore_wait(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
+    if (self->commandCount > 0)
+        checkCommandTimeouts(self, currentTime);
+
     if (currentTime > self->nextT3Timeout) {
 
         if (self->outstandingTestFCConMessages > 2) {
             DEBUG_PRINT("Timeout for TESTFR_CON message\n");
 
+            CS104_STATISTICS_INC(&(self->statistics), t1Timeouts);
+
+            LIB60870_TRACE2(cs104_client_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T1);
+
             /* close connection */
             retVal = false;
             goto exit_function;
@@ -753,6 +1580,10 @@ handleTimeouts(CS104_Connection self)
         else {
             DEBUG_PRINT("U message T3 timeout\n");
 
+            CS104_STATISTICS_INC(&(self->statistics), t3Timeouts);
+
+            LIB60870_TRACE2(cs104_client_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T3);
+
             writeToSocket(self, TESTFR_ACT_MSG, TESTFR_ACT_MSG_SIZE);
 
             self->uMessageTimeout = currentTime + (self->parameters.t1 * 1000);
@@ -762,9 +1593,11 @@ handleTimeouts(CS104_Connection self)
         }
     }
 
-    if (self->unconfirmedReceivedIMessages > 0) {
+    if (getConfirmableMessages(self) > 0) {
 
         if (checkConfirmTimeout(self, currentTime)) {
+            LIB60870_TRACE2(cs104_client_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T2);
+
             confirmOutstandingMessages(self);
         }
     }
@@ -772,6 +1605,10 @@ handleTimeouts(CS104_Connection self)
     if (self->uMessageTimeout != 0) {
         if (currentTime > self->uMessageTimeout) {
             DEBUG_PRINT("U message T1 timeout\n");
+
+            CS104_STATISTICS_INC(&(self->statistics), t1Timeouts);
+
+            LIB60870_TRACE2(cs104_client_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T1);
             retVal = false;
             goto exit_function;
         }
@@ -782,6 +1619,10 @@ handleTimeouts(CS104_Connection self)
         if (currentTime > self->sentASDUs[self->oldestSentASDU].sentTime) {
             if ((currentTime - self->sentASDUs[self->oldestSentASDU].sentTime) >= (uint64_t) (self->parameters.t1 * 1000)) {
                 DEBUG_PRINT("I message timeout\n");
+
+                CS104_STATISTICS_INC(&(self->statistics), t1Timeouts);
+
+                LIB60870_TRACE2(cs104_client_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T1);
                 retVal = false;
             }
         }
@@ -793,6 +1634,8 @@ exit_function:
     Semaphore_post(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
+    deliverCommandEvents(self);
+
     return retVal;
 }
 
@@ -850,261 +1693,1438 @@ isClose(CS104_Connection self)
     return isClose;
 }
 
-#if (CONFIG_USE_THREADS == 1)
-static void*
-handleConnection(void* parameter)
+static void
+setFailure(CS104_Connection self)
 {
-    CS104_Connection self = (CS104_Connection) parameter;
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-    CS104_ConnectionEvent event = CS104_CONNECTION_OPENED;
+    self->failure = true;
 
-    resetConnection(self);
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+}
 
-    self->socket = TcpSocket_create();
+static void
+raiseConnectionEvent(CS104_Connection self, CS104_ConnectionEvent event)
+{
+    LIB60870_TRACE2(cs104_client_state, self->statistics.connectionId, event);
 
-    if (self->socket) {
-        Socket_setConnectTimeout(self->socket, self->connectTimeoutInMs);
+#if (CONFIG_USE_SEMAPHORES == 1)
+    if ((event == CS104_CONNECTION_SEND_QUEUE_AVAILABLE) || (event == CS104_CONNECTION_CLOSED) ||
+            (event == CS104_CONNECTION_FAILED))
+    {
+        Semaphore_wait(self->conStateLock);
 
-        if (self->localIpAddress) {
-            Socket_bind(self->socket, self->localIpAddress, self->localTcpPort);
-        }
+        if (self->eventSignal)
+            Semaphore_post(self->eventSignal);
+
+        Semaphore_post(self->conStateLock);
+    }
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-        if (Socket_connect(self->socket, self->hostname, self->tcpPort)) {
+    if (self->connectionHandler)
+        self->connectionHandler(self->connectionHandlerParameter, self, event);
+}
+
+/**
+ * \brief Start the protocol after the TCP connection is established
+ *
+ * \return true when the connection is running, false otherwise (TLS error)
+ */
+static bool
+startConnection(CS104_Connection self)
+{
+    bool running;
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-            Semaphore_wait(self->conStateLock);
+    Semaphore_wait(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
 #if (CONFIG_CS104_SUPPORT_TLS == 1)
-            if (self->tlsConfig != NULL) {
-                self->tlsSocket = TLSSocket_create(self->socket, self->tlsConfig, false);
+    if (self->tlsConfig != NULL) {
+        self->tlsSocket = TLSSocket_create(self->socket, self->tlsConfig, false);
 
-                if (self->tlsSocket)
-                    self->running = true;
-                else
-                    self->failure = true;
-            }
-            else
-                self->running = true;
-#else
+        if (self->tlsSocket)
             self->running = true;
+        else
+            self->failure = true;
+    }
+    else
+        self->running = true;
+#else
+    self->running = true;
 #endif
 
-#if (CONFIG_USE_SEMAPHORES == 1)
-            Semaphore_post(self->conStateLock);
-#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+    running = self->running;
 
-            if (isRunning(self)) {
+    if (running)
+        self->conState = STATE_INACTIVE;
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-                Semaphore_wait(self->conStateLock);
+    Semaphore_post(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-                self->conState = STATE_INACTIVE;
+    /* Call connection handler */
+    if (running)
+        raiseConnectionEvent(self, CS104_CONNECTION_OPENED);
 
-#if (CONFIG_USE_SEMAPHORES == 1)
-                Semaphore_post(self->conStateLock);
-#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+    return running;
+}
+
+/**
+ * \brief Handle a complete message in the receive buffer
+ *
+ * \return false when the connection has to be closed
+ */
+static bool
+handleReceivedMessage(CS104_Connection self, int bytesRec)
+{
+    bool retVal = true;
+
+    if (self->rawMessageHandler)
+        self->rawMessageHandler(self->rawMessageHandlerParameter, self->recvBuffer, bytesRec, false);
+
+    CS104_ConnectionStatistics_frameReceived(&(self->statistics), self->recvBuffer, bytesRec);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    CS104_ConState oldState = self->conState;
+
+    if (checkMessage(self, self->recvBuffer, bytesRec) == false)
+    {
+        /* close connection on error */
+        retVal = false;
+
+        self->failure = true;
+    }
+
+    CS104_ConState newState = self->conState;
+
+    bool sendQueueAvailable = self->sendQueueAvailable;
+    self->sendQueueAvailable = false;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    deliverCommandEvents(self);
+
+    if (self->batchCount >= self->maxBatchSize)
+        deliverASDUBatch(self);
+
+    /* call connection handler when required */
+    if (newState != oldState)
+    {
+        if (newState == STATE_ACTIVE)
+            raiseConnectionEvent(self, CS104_CONNECTION_STARTDT_CON_RECEIVED);
+        else if (newState == STATE_INACTIVE)
+            raiseConnectionEvent(self, CS104_CONNECTION_STOPDT_CON_RECEIVED);
+    }
+
+    if (sendQueueAvailable)
+        raiseConnectionEvent(self, CS104_CONNECTION_SEND_QUEUE_AVAILABLE);
+
+    return retVal;
+}
+
+static void
+checkOutstandingConfirmations(CS104_Connection self)
+{
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if ((getConfirmableMessages(self) >= self->parameters.w) || (self->conState == STATE_WAITING_FOR_STOPDT_CON)) {
+        confirmOutstandingMessages(self);
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+}
+
+static void
+closeConnectionSocket(CS104_Connection self)
+{
+    /* deliver the remaining ASDUs before the connection is closed */
+    deliverASDUBatch(self);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    /* Confirm all unconfirmed received I-messages before closing the connection */
+    if (getConfirmableMessages(self) > 0) {
+        confirmOutstandingMessages(self);
+    }
+
+#if (CONFIG_CS104_SUPPORT_TLS == 1)
+    if (self->tlsSocket) {
+        TLSSocket_close(self->tlsSocket);
+        self->tlsSocket = NULL;
+    }
+#endif
+
+    Socket_destroy(self->socket);
+    self->socket = NULL;
+
+    self->conState = STATE_IDLE;
+
+    self->running = false;
+    self->active = false;
+
+    if (self->commandCount > 0)
+        failOutstandingCommands(self);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    deliverCommandEvents(self);
+}
+
+#if (CONFIG_USE_THREADS == 1)
+static void*
+handleConnection(void* parameter)
+{
+    CS104_Connection self = (CS104_Connection) parameter;
+
+    CS104_ConnectionEvent event = CS104_CONNECTION_OPENED;
+
+    resetConnection(self);
+
+    self->socket = createSocket(self);
+
+    if (self->socket) {
+        Socket_setConnectTimeout(self->socket, self->connectTimeoutInMs);
+
+        if (self->localIpAddress && (self->unixPath == NULL)) {
+            Socket_bind(self->socket, self->localIpAddress, self->localTcpPort);
+        }
+
+        if (Socket_connect(self->socket, getRemoteAddress(self), self->tcpPort)) {
+
+            if (startConnection(self)) {
+
+                HandleSet handleSet = Handleset_new();
+
+                bool loopRunning = true;
+
+                while (loopRunning) {
+
+                    Handleset_reset(handleSet);
+                    Handleset_addSocket(handleSet, self->socket);
+
+                    if (Handleset_waitReady(handleSet, 100)) {
+                        /* with a batch handler all available messages are read before the batch is delivered */
+                        int maxFrames = self->batchHandler ? self->maxBatchSize : 1;
+                        int bytesRec;
+
+                        do {
+                            bytesRec = receiveMessage(self);
+
+                            if (bytesRec == -1) {
+                                loopRunning = false;
+
+                                setFailure(self);
+                            }
+
+                            if (bytesRec > 0) {
+                                if (handleReceivedMessage(self, bytesRec) == false) {
+                                    loopRunning = false;
+                                    bytesRec = -1;
+                                }
+                            }
+
+                            checkOutstandingConfirmations(self);
+
+                            maxFrames--;
+
+                        } while ((bytesRec > 0) && (maxFrames > 0));
+                    }
+
+                    checkASDUBatch(self, Hal_getTimeInMs());
+
+                    if (handleTimeouts(self) == false)
+                        loopRunning = false;
+
+                    if (isClose(self))
+                        loopRunning = false;
+                }
+
+                Handleset_destroy(handleSet);
+
+                /* register CLOSED event */
+                event = CS104_CONNECTION_CLOSED;
+            }
+        }
+        else {
+            setFailure(self);
+
+            /* register CLOSED event */
+            event = CS104_CONNECTION_FAILED;
+        }
+
+        closeConnectionSocket(self);
+    }
+    else
+    {
+        DEBUG_PRINT("Failed to create socket\n");
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+        self->running = false;
+        self->active = false;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+    }
+
+    /* Call connection handler */
+    if ((event == CS104_CONNECTION_CLOSED) || (event == CS104_CONNECTION_FAILED))
+        raiseConnectionEvent(self, event);
+
+    return NULL;
+}
+#endif /* (CONFIG_USE_THREADS == 1) */
+
+void
+CS104_Connection_connectAsync(CS104_Connection self)
+{
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    self->running = false;
+    self->failure = false;
+    self->close = false;
+
+    if (self->manager)
+        self->connectRequested = true;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (self->manager) {
+        /* connection is handled by the connection manager */
+        LIB60870_ATOMIC_STORE(&(self->manager->requestPending), true);
+        SocketPoller_wakeup(self->manager->poller);
+        return;
+    }
+
+#if (CONFIG_USE_THREADS == 1)
+    if (self->connectionHandlingThread) {
+        Thread_destroy(self->connectionHandlingThread);
+        self->connectionHandlingThread = NULL;
+    }
+
+    self->connectionHandlingThread = Thread_create(handleConnection, (void*) self, false);
+
+    if (self->connectionHandlingThread)
+        Thread_start(self->connectionHandlingThread);
+#endif
+}
+
+bool
+CS104_Connection_connect(CS104_Connection self)
+{
+    CS104_Connection_connectAsync(self);
+
+    while ((isRunning(self) == false) && (isFailure(self) == false))
+        Thread_sleep(1);
+
+    return isRunning(self);
+}
+
+/********************************************
+ * CS104_ConnectionManager
+ ********************************************/
+
+CS104_ConnectionManager
+CS104_ConnectionManager_create(void)
+{
+    CS104_ConnectionManager self = (CS104_ConnectionManager) GLOBAL_CALLOC(1, sizeof(struct sCS104_ConnectionManager));
+
+    if (self) {
+        self->poller = SocketPoller_create(CONFIG_CS104_CONNECTION_MANAGER_MAX_EVENTS);
+        self->connections = LinkedList_create();
+
+        if ((self->poller == NULL) || (self->connections == NULL)) {
+            if (self->poller)
+                SocketPoller_destroy(self->poller);
+
+            if (self->connections)
+                LinkedList_destroyStatic(self->connections);
+
+            GLOBAL_FREEMEM(self);
+
+            return NULL;
+        }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        self->lock = Semaphore_create(1);
+#endif
+    }
+
+    return self;
+}
+
+void
+CS104_ConnectionManager_setReconnectInterval(CS104_ConnectionManager self, int intervalInMs)
+{
+    self->reconnectInterval = intervalInMs;
+}
+
+static void
+managerScheduleReconnect(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime)
+{
+    if (self->reconnectInterval > 0)
+        con->managerTimeout = currentTime + self->reconnectInterval;
+    else
+        con->managerTimeout = 0;
+}
+
+static void
+managerConnectFailed(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime, bool reconnect)
+{
+    if (con->socket) {
+        SocketPoller_removeSocket(self->poller, con->socket);
+        Socket_destroy(con->socket);
+        con->socket = NULL;
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(con->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    con->running = false;
+    con->failure = true;
+    con->active = false;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(con->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    con->managerState = MANAGER_STATE_IDLE;
+
+    if (reconnect)
+        managerScheduleReconnect(self, con, currentTime);
+    else
+        con->managerTimeout = 0;
+
+    raiseConnectionEvent(con, CS104_CONNECTION_FAILED);
+}
+
+static void
+managerStartConnect(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime)
+{
+    resetConnection(con);
+
+    con->socket = createSocket(con);
+
+    if (con->socket == NULL) {
+        DEBUG_PRINT("Failed to create socket\n");
+        managerConnectFailed(self, con, currentTime, true);
+        return;
+    }
+
+    if (con->localIpAddress && (con->unixPath == NULL))
+        Socket_bind(con->socket, con->localIpAddress, con->localTcpPort);
+
+    if (Socket_connectAsync(con->socket, getRemoteAddress(con), con->tcpPort) &&
+            SocketPoller_addSocket(self->poller, con->socket, SOCKET_POLLER_WRITE, con))
+    {
+        con->managerState = MANAGER_STATE_CONNECTING;
+        con->managerTimeout = currentTime + con->connectTimeoutInMs;
+    }
+    else {
+        /* socket is not registered in the poller */
+        Socket_destroy(con->socket);
+        con->socket = NULL;
+
+        managerConnectFailed(self, con, currentTime, true);
+    }
+}
+
+static void
+managerCloseConnection(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime, bool failure)
+{
+    SocketPoller_removeSocket(self->poller, con->socket);
+
+    if (failure)
+        setFailure(con);
+
+    closeConnectionSocket(con);
+
+    con->managerState = MANAGER_STATE_IDLE;
+
+    if (failure)
+        managerScheduleReconnect(self, con, currentTime);
+    else
+        con->managerTimeout = 0;
+
+    raiseConnectionEvent(con, CS104_CONNECTION_CLOSED);
+}
+
+static void
+managerHandleConnectEvent(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime)
+{
+    SocketState state = Socket_checkAsyncConnectState(con->socket);
+
+    if (state == SOCKET_STATE_CONNECTED) {
+        if (startConnection(con)) {
+            con->managerState = MANAGER_STATE_CONNECTED;
+
+            SocketPoller_modifySocket(self->poller, con->socket, SOCKET_POLLER_READ, con);
+        }
+        else {
+            /* TLS error */
+            SocketPoller_removeSocket(self->poller, con->socket);
+            closeConnectionSocket(con);
+
+            con->managerState = MANAGER_STATE_IDLE;
+            managerScheduleReconnect(self, con, currentTime);
+        }
+    }
+    else if (state == SOCKET_STATE_FAILED) {
+        managerConnectFailed(self, con, currentTime, true);
+    }
+}
+
+static void
+managerHandleReadEvent(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime)
+{
+    int i;
+
+    for (i = 0; i < MANAGER_MAX_FRAMES_PER_EVENT; i++) {
+        int bytesRec = receiveMessage(con);
+
+        if (bytesRec == 0)
+            break;
+
+        if ((bytesRec == -1) || (handleReceivedMessage(con, bytesRec) == false)) {
+            managerCloseConnection(self, con, currentTime, true);
+            return;
+        }
+
+        checkOutstandingConfirmations(con);
+    }
+
+    checkASDUBatch(con, currentTime);
+}
+
+/*
+ * The timers of the connections are kept in a binary min-heap ordered by the time
+ * of the next timeout. Has to be called with the manager lock.
+ */
+static void
+managerTimerSwap(CS104_ConnectionManager self, int i, int j)
+{
+    CS104_Connection con = self->timers[i];
+
+    self->timers[i] = self->timers[j];
+    self->timers[j] = con;
+
+    self->timers[i]->managerTimerIndex = i;
+    self->timers[j]->managerTimerIndex = j;
+}
+
+static void
+managerTimerSiftUp(CS104_ConnectionManager self, int index)
+{
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (self->timers[parent]->managerTimerDeadline <= self->timers[index]->managerTimerDeadline)
+            break;
+
+        managerTimerSwap(self, parent, index);
+
+        index = parent;
+    }
+}
+
+static void
+managerTimerSiftDown(CS104_ConnectionManager self, int index)
+{
+    while (true) {
+        int smallest = index;
+        int left = (2 * index) + 1;
+        int right = left + 1;
+
+        if ((left < self->timerCount) &&
+                (self->timers[left]->managerTimerDeadline < self->timers[smallest]->managerTimerDeadline))
+            smallest = left;
+
+        if ((right < self->timerCount) &&
+                (self->timers[right]->managerTimerDeadline < self->timers[smallest]->managerTimerDeadline))
+            smallest = right;
+
+        if (smallest == index)
+            break;
+
+        managerTimerSwap(self, index, smallest);
+
+        index = smallest;
+    }
+}
+
+static void
+managerTimerRemove(CS104_ConnectionManager self, CS104_Connection con)
+{
+    int index = con->managerTimerIndex;
+
+    if (index == -1)
+        return;
+
+    con->managerTimerIndex = -1;
+
+    self->timerCount--;
+
+    if (index != self->timerCount) {
+        self->timers[index] = self->timers[self->timerCount];
+        self->timers[index]->managerTimerIndex = index;
+
+        managerTimerSiftUp(self, index);
+        managerTimerSiftDown(self, self->timers[index]->managerTimerIndex);
+    }
+}
+
+static void
+managerTimerSet(CS104_ConnectionManager self, CS104_Connection con, uint64_t deadline)
+{
+    con->managerTimerDeadline = deadline;
+
+    if (con->managerTimerIndex == -1) {
+        /* capacity is reserved by CS104_ConnectionManager_addConnection */
+        con->managerTimerIndex = self->timerCount;
+        self->timers[self->timerCount] = con;
+        self->timerCount++;
+    }
+
+    managerTimerSiftUp(self, con->managerTimerIndex);
+    managerTimerSiftDown(self, con->managerTimerIndex);
+}
+
+/* time of the next timeout that has to be handled by the manager (0 = none) */
+static uint64_t
+managerGetNextTimeout(CS104_Connection con, uint64_t currentTime)
+{
+    if (con->managerState != MANAGER_STATE_CONNECTED)
+        return con->managerTimeout;
+
+    /* other threads start timeouts (sending ASDUs, STARTDT, commands) without notifying the
+     * manager. These timeouts don't expire before t1 or the command timeout -> check the
+     * connection at least once within this interval */
+    uint64_t interval = (uint64_t) (con->parameters.t1 * 1000);
+
+    if ((con->commandTimeout > 0) && ((uint64_t) con->commandTimeout < interval))
+        interval = (uint64_t) con->commandTimeout;
+
+    uint64_t nextTimeout = currentTime + interval;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(con->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    /* handleTimeouts checks t3 and the U message timeout with ">" */
+    if (con->nextT3Timeout + 1 < nextTimeout)
+        nextTimeout = con->nextT3Timeout + 1;
+
+    if ((con->uMessageTimeout != 0) && (con->uMessageTimeout + 1 < nextTimeout))
+        nextTimeout = con->uMessageTimeout + 1;
+
+    if (con->oldestSentASDU != -1) {
+        uint64_t t1Timeout = con->sentASDUs[con->oldestSentASDU].sentTime + (uint64_t) (con->parameters.t1 * 1000);
+
+        if (t1Timeout < nextTimeout)
+            nextTimeout = t1Timeout;
+    }
+
+    if (getConfirmableMessages(con) > 0) {
+        uint64_t t2Timeout = con->lastConfirmationTime + (uint64_t) (con->parameters.t2 * 1000);
+
+        if (t2Timeout < nextTimeout)
+            nextTimeout = t2Timeout;
+    }
+
+    if (con->commandCount > 0) {
+        int i;
+
+        for (i = 0; i < con->maxCommands; i++) {
+            OutstandingCommand* command = &(con->commands[i]);
+
+            if ((command->state == COMMAND_STATE_SELECT_SENT) || (command->state == COMMAND_STATE_EXECUTE_SENT) ||
+                    (command->state == COMMAND_STATE_WAITING_FOR_TERM))
+            {
+                if (command->timeout < nextTimeout)
+                    nextTimeout = command->timeout;
+            }
+        }
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(con->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (con->batchCount > 0) {
+        uint64_t batchTimeout = con->batchStartTime;
+
+        if (con->maxBatchDelay > 0)
+            batchTimeout += (uint64_t) con->maxBatchDelay;
+
+        if (batchTimeout < nextTimeout)
+            nextTimeout = batchTimeout;
+    }
+
+    return nextTimeout;
+}
+
+/* reschedule the timer of a connection after its state or its timeouts have changed */
+static void
+managerUpdateTimer(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime)
+{
+    uint64_t nextTimeout = managerGetNextTimeout(con, currentTime);
+
+    if (nextTimeout == 0)
+        managerTimerRemove(self, con);
+    else {
+        if (nextTimeout <= currentTime)
+            nextTimeout = currentTime + 1;
+
+        managerTimerSet(self, con, nextTimeout);
+    }
+}
+
+/* handle connect/close requests of a single connection */
+static void
+managerHandleRequest(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime)
+{
+    bool connectRequested;
+    bool close;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(con->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    connectRequested = con->connectRequested;
+    con->connectRequested = false;
+    close = con->close;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(con->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    /* CS104_Connection_connectAsync resets the close flag -> a close request is always newer */
+    if ((close == false) && connectRequested) {
+
+        if (con->managerState == MANAGER_STATE_CONNECTED)
+            managerCloseConnection(self, con, currentTime, false);
+        else if (con->managerState == MANAGER_STATE_CONNECTING) {
+            SocketPoller_removeSocket(self->poller, con->socket);
+            Socket_destroy(con->socket);
+            con->socket = NULL;
+        }
+
+        managerStartConnect(self, con, currentTime);
+    }
+    else if (close) {
+        if (con->managerState == MANAGER_STATE_CONNECTING)
+            managerConnectFailed(self, con, currentTime, false);
+        else if (con->managerState == MANAGER_STATE_CONNECTED)
+            managerCloseConnection(self, con, currentTime, false);
+        else
+            con->managerTimeout = 0;
+    }
+}
+
+/* handle the expired timer of a single connection (timeouts and reconnects) */
+static void
+managerHandleTimeout(CS104_ConnectionManager self, CS104_Connection con, uint64_t currentTime)
+{
+    switch (con->managerState) {
+
+    case MANAGER_STATE_CONNECTING:
+        if (currentTime >= con->managerTimeout) {
+            DEBUG_PRINT("Connect timeout\n");
+            managerConnectFailed(self, con, currentTime, true);
+        }
+        break;
+
+    case MANAGER_STATE_CONNECTED:
+        if (handleTimeouts(con) == false)
+            managerCloseConnection(self, con, currentTime, true);
+        else
+            checkASDUBatch(con, currentTime);
+        break;
+
+    default:
+        if ((con->managerTimeout != 0) && (currentTime >= con->managerTimeout)) {
+            con->managerTimeout = 0;
+            managerStartConnect(self, con, currentTime);
+        }
+        break;
+    }
+}
+
+static void
+managerRemoveConnection(CS104_ConnectionManager self, CS104_Connection connection)
+{
+    if (connection->managerState == MANAGER_STATE_CONNECTED)
+        managerCloseConnection(self, connection, Hal_getTimeInMs(), false);
+    else if (connection->managerState == MANAGER_STATE_CONNECTING)
+        managerConnectFailed(self, connection, Hal_getTimeInMs(), false);
+
+    managerTimerRemove(self, connection);
+
+    connection->managerTimeout = 0;
+    connection->managerRemove = false;
+
+    LIB60870_ATOMIC_STORE(&(connection->manager), NULL);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    if (connection->managerRemoved) {
+        Semaphore_post(connection->managerRemoved);
+        connection->managerRemoved = NULL;
+    }
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+}
+
+int
+CS104_ConnectionManager_tick(CS104_ConnectionManager self, int timeoutInMs)
+{
+    uint64_t currentTime = Hal_getTimeInMs();
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    /* don't wait longer than until the next timeout */
+    if (LIB60870_ATOMIC_LOAD(&(self->requestPending)))
+        timeoutInMs = 0;
+    else if (self->timerCount > 0) {
+        uint64_t nextTimeout = self->timers[0]->managerTimerDeadline;
+
+        if (nextTimeout <= currentTime)
+            timeoutInMs = 0;
+        else if ((nextTimeout - currentTime) < (uint64_t) timeoutInMs)
+            timeoutInMs = (int) (nextTimeout - currentTime);
+    }
+
+    self->waiting = true;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    int readyCount = SocketPoller_wait(self->poller, (unsigned int) timeoutInMs);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    self->waiting = false;
+
+    currentTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < readyCount; i++) {
+        CS104_Connection con = (CS104_Connection) SocketPoller_getParameter(self->poller, i);
+
+        /* connection may have been closed while handling a previous event */
+        if ((con == NULL) || (con->socket == NULL) || con->managerRemove)
+            continue;
+
+        if (con->managerState == MANAGER_STATE_CONNECTING)
+            managerHandleConnectEvent(self, con, currentTime);
+        else if (con->managerState == MANAGER_STATE_CONNECTED)
+            managerHandleReadEvent(self, con, currentTime);
+
+        managerUpdateTimer(self, con, currentTime);
+    }
+
+    if (LIB60870_ATOMIC_LOAD(&(self->requestPending))) {
+
+        LIB60870_ATOMIC_STORE(&(self->requestPending), false);
+
+        LinkedList element = LinkedList_getNext(self->connections);
+
+        while (element) {
+            CS104_Connection con = (CS104_Connection) LinkedList_getData(element);
+
+            if (con->managerRemove == false) {
+                managerHandleRequest(self, con, currentTime);
+                managerUpdateTimer(self, con, currentTime);
+            }
+
+            element = LinkedList_getNext(element);
+        }
+    }
+
+    /* only the connections with an expired timer are checked */
+    while ((self->timerCount > 0) && (self->timers[0]->managerTimerDeadline <= currentTime)) {
+        CS104_Connection con = self->timers[0];
+
+        if (con->managerRemove)
+            managerTimerRemove(self, con);
+        else {
+            managerHandleTimeout(self, con, currentTime);
+            managerUpdateTimer(self, con, currentTime);
+        }
+    }
+
+    if (self->pendingRemovals > 0) {
+        LinkedList element = LinkedList_getNext(self->connections);
+
+        while (element) {
+            CS104_Connection con = (CS104_Connection) LinkedList_getData(element);
+
+            element = LinkedList_getNext(element);
+
+            if (con->managerRemove) {
+                LinkedList_remove(self->connections, con);
+
+                managerRemoveConnection(self, con);
+            }
+        }
+
+        self->pendingRemovals = 0;
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (readyCount < 0)
+        readyCount = 0;
+
+    return readyCount;
+}
+
+bool
+CS104_ConnectionManager_addConnection(CS104_ConnectionManager self, CS104_Connection connection)
+{
+    bool retVal = false;
+
+    if (connection->manager != NULL)
+        return false;
+
+#if (CONFIG_USE_THREADS == 1)
+    /* connection must not be handled by an own thread */
+    if (connection->connectionHandlingThread != NULL) {
+        if (isRunning(connection))
+            return false;
+
+        Thread_destroy(connection->connectionHandlingThread);
+        connection->connectionHandlingThread = NULL;
+    }
+#endif
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    int connectionCount = LinkedList_size(self->connections);
+
+    /* reserve a timer for each connection */
+    if (connectionCount >= self->timerCapacity) {
+        int newCapacity = (self->timerCapacity == 0) ? 16 : (self->timerCapacity * 2);
+
+        CS104_Connection* newTimers = (CS104_Connection*) GLOBAL_REALLOC(self->timers,
+                newCapacity * sizeof(CS104_Connection));
+
+        if (newTimers) {
+            self->timers = newTimers;
+            self->timerCapacity = newCapacity;
+        }
+    }
+
+    if (connectionCount < self->timerCapacity) {
+        connection->manager = self;
+        connection->managerState = MANAGER_STATE_IDLE;
+        connection->managerTimeout = 0;
+        connection->managerTimerIndex = -1;
+        connection->managerRemove = false;
+#if (CONFIG_USE_SEMAPHORES == 1)
+        connection->managerRemoved = NULL;
+#endif
+        connection->connectRequested = false;
+
+        LinkedList_add(self->connections, connection);
+
+        retVal = true;
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    return retVal;
+}
+
+void
+CS104_ConnectionManager_removeConnection(CS104_ConnectionManager self, CS104_Connection connection)
+{
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (connection->manager == self) {
+
+        if (self->waiting) {
+            /* the poller can't be changed and the events of the current wait can refer to the
+             * connection -> the connection is removed by the manager after the wait */
+#if (CONFIG_USE_SEMAPHORES == 1)
+            Semaphore removed = NULL;
+#endif
+
+            if (connection->managerRemove == false) {
+                connection->managerRemove = true;
+                self->pendingRemovals++;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+                removed = Semaphore_create(0);
+                connection->managerRemoved = removed;
+#endif
+            }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+            Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+            SocketPoller_wakeup(self->poller);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+            if (removed) {
+                Semaphore_wait(removed);
+                Semaphore_destroy(removed);
+
+                return;
+            }
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+            /* removal already requested by another thread */
+            while (LIB60870_ATOMIC_LOAD(&(connection->manager)) == self)
+                Thread_sleep(1);
+
+            return;
+        }
+
+        LinkedList_remove(self->connections, connection);
+
+        managerRemoveConnection(self, connection);
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+}
+
+int
+CS104_ConnectionManager_getConnectionCount(CS104_ConnectionManager self)
+{
+    int count;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    count = LinkedList_size(self->connections);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    return count;
+}
+
+#if (CONFIG_USE_THREADS == 1)
+static bool
+isManagerRunning(CS104_ConnectionManager self)
+{
+    return LIB60870_ATOMIC_LOAD(&(self->running));
+}
+
+static void*
+handleConnectionManager(void* parameter)
+{
+    CS104_ConnectionManager self = (CS104_ConnectionManager) parameter;
+
+    while (isManagerRunning(self))
+        CS104_ConnectionManager_tick(self, 10);
+
+    return NULL;
+}
+#endif /* (CONFIG_USE_THREADS == 1) */
+
+void
+CS104_ConnectionManager_start(CS104_ConnectionManager self)
+{
+#if (CONFIG_USE_THREADS == 1)
+    if (self->thread == NULL) {
+        LIB60870_ATOMIC_STORE(&(self->running), true);
+
+        self->thread = Thread_create(handleConnectionManager, (void*) self, false);
+
+        if (self->thread)
+            Thread_start(self->thread);
+        else
+            LIB60870_ATOMIC_STORE(&(self->running), false);
+    }
+#else
+    UNUSED_PARAMETER(self);
+#endif
+}
+
+void
+CS104_ConnectionManager_stop(CS104_ConnectionManager self)
+{
+#if (CONFIG_USE_THREADS == 1)
+    if (self->thread) {
+        LIB60870_ATOMIC_STORE(&(self->running), false);
+
+        Thread_destroy(self->thread);
+        self->thread = NULL;
+    }
+#else
+    UNUSED_PARAMETER(self);
+#endif
+}
+
+void
+CS104_ConnectionManager_destroy(CS104_ConnectionManager self)
+{
+    CS104_ConnectionManager_stop(self);
+
+    LinkedList element = LinkedList_getNext(self->connections);
+
+    while (element) {
+        CS104_Connection con = (CS104_Connection) LinkedList_getData(element);
+
+        managerRemoveConnection(self, con);
+
+        element = LinkedList_getNext(element);
+    }
+
+    LinkedList_destroyStatic(self->connections);
+
+    if (self->timers)
+        GLOBAL_FREEMEM(self->timers);
+
+    SocketPoller_destroy(self->poller);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_destroy(self->lock);
+#endif
+
+    GLOBAL_FREEMEM(self);
+}
+
+void
+CS104_Connection_setASDUReceivedHandler(CS104_Connection self, CS101_ASDUReceivedHandler handler, void* parameter)
+{
+    self->receivedHandler = handler;
+    self->receivedHandlerParameter = parameter;
+}
+
+void
+CS104_Connection_setMirrorCache(CS104_Connection self, CS101_MirrorCache cache)
+{
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif
+
+    self->mirrorCache = cache;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif
+}
+
+bool
+CS104_Connection_setASDUQueueSize(CS104_Connection self, int size)
+{
+    bool success = false;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    /* the receiving thread can access the queue */
+    if (self->active == false) {
+
+        if (self->asduQueue) {
+            GLOBAL_FREEMEM(self->asduQueue);
+            self->asduQueue = NULL;
+        }
+
+        self->asduQueueCapacity = 0;
+        self->asduQueueHead = 0;
+        self->asduQueueTail = 0;
+        self->asduQueueConnectionStart = 0;
+
+        if (size < 0)
+            size = 0;
+
+        self->asduQueueSize = size;
+
+        success = true;
+    }
+    else
+        DEBUG_PRINT("Cannot change the ASDU queue size while the connection is active\n");
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    return success;
+}
+
+int
+CS104_Connection_processASDUQueue(CS104_Connection self, int maxASDUs)
+{
+    int processedASDUs = 0;
+
+    if (self->asduQueue == NULL)
+        return 0;
+
+    /* read before the head - the head is never behind the start of the current connection */
+    uint32_t connectionStart = LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->asduQueueConnectionStart));
+    uint32_t tail = self->asduQueueTail;
+    uint32_t head = LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->asduQueueHead));
+
+    /* drop the entries of a previous connection - these ASDUs are not confirmed */
+    if ((int32_t) (tail - connectionStart) < 0) {
+        tail = connectionStart;
+        LIB60870_ATOMIC_STORE_RELEASE(&(self->asduQueueTail), tail);
+    }
+
+    while ((tail != head) && ((maxASDUs <= 0) || (processedASDUs < maxASDUs))) {
+
+        if (self->batchHandler) {
+            /* pass the queue entries as batch without copying */
+            int batchSize = 0;
+
+            while ((tail + batchSize != head) && (batchSize < self->maxBatchSize) &&
+                    ((maxASDUs <= 0) || (processedASDUs + batchSize < maxASDUs)))
+            {
+                ASDUQueueEntry* entry = &(self->asduQueue[(tail + batchSize) % self->asduQueueCapacity]);
+
+                self->batchASDUs[batchSize] = CS101_ASDU_initializeView(&(self->batchViews[batchSize]),
+                        (CS101_AppLayerParameters)&(self->alParameters), entry->asdu, entry->size);
+
+                batchSize++;
+            }
+
+            self->batchHandler(self->batchHandlerParameter, self->batchASDUs, batchSize);
+
+            tail += batchSize;
+            processedASDUs += batchSize;
+        }
+        else {
+            ASDUQueueEntry* entry = &(self->asduQueue[tail % self->asduQueueCapacity]);
 
-                /* Call connection handler */
-                if (self->connectionHandler)
-                    self->connectionHandler(self->connectionHandlerParameter, self, CS104_CONNECTION_OPENED);
+            sCS101_ASDUView _asdu;
 
-                HandleSet handleSet = Handleset_new();
+            CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, (CS101_AppLayerParameters)&(self->alParameters), entry->asdu, entry->size);
 
-                bool loopRunning = true;
+            if ((asdu != NULL) && (self->receivedHandler != NULL))
+                self->receivedHandler(self->receivedHandlerParameter, -1, asdu);
 
-                while (loopRunning) {
+            tail++;
+            processedASDUs++;
+        }
 
-                    Handleset_reset(handleSet);
-                    Handleset_addSocket(handleSet, self->socket);
+        /* release the entries - the ASDUs can now be confirmed */
+        LIB60870_ATOMIC_STORE_RELEASE(&(self->asduQueueTail), tail);
+    }
 
-                    if (Handleset_waitReady(handleSet, 100)) {
-                        int bytesRec = receiveMessage(self);
+    if (processedASDUs > 0) {
 
-                        if (bytesRec == -1) {
-                            loopRunning = false;
+        /* send the delayed confirmation without waiting for the receiving thread */
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-                            Semaphore_wait(self->conStateLock);
+        Semaphore_wait(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-                            self->failure = true;
+        if (self->running && (getConfirmableMessages(self) >= self->parameters.w))
+            confirmOutstandingMessages(self);
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-                            Semaphore_post(self->conStateLock);
+        Semaphore_post(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
-                        }
+    }
 
-                        if (bytesRec > 0) {
+    return processedASDUs;
+}
 
-                            if (self->rawMessageHandler)
-                                self->rawMessageHandler(self->rawMessageHandlerParameter, self->recvBuffer, bytesRec, false);
+bool
+CS104_Connection_setSendQueueSize(CS104_Connection self, int size)
+{
+    bool success = false;
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-                            Semaphore_wait(self->conStateLock);
+    Semaphore_wait(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-                            CS104_ConState oldState = self->conState;
+    /* the send functions and the receiving thread can access the queue */
+    if (self->active == false) {
 
-                            if (checkMessage(self, self->recvBuffer, bytesRec) == false)
-                            {
-                                /* close connection on error */
-                                loopRunning = false;
+        if (self->sendQueue) {
+            GLOBAL_FREEMEM(self->sendQueue);
+            self->sendQueue = NULL;
+        }
 
-                                self->failure = true;
-                            }
+        self->sendQueueCapacity = 0;
+        self->sendQueueHead = 0;
+        self->sendQueueCount = 0;
+        self->sendQueueOverflow = false;
+        self->sendQueueAvailable = false;
 
-                            CS104_ConState newState = self->conState;
+        if (size < 0)
+            size = 0;
 
-#if (CONFIG_USE_SEMAPHORES == 1)
-                            Semaphore_post(self->conStateLock);
-#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+        self->sendQueueSize = size;
 
-                            /* call connection handler when required */
-                            if ((newState != oldState) && self->connectionHandler)
-                            {
-                                if (newState == STATE_ACTIVE)
-                                    self->connectionHandler(self->connectionHandlerParameter, self, CS104_CONNECTION_STARTDT_CON_RECEIVED);
-                                else if (newState == STATE_INACTIVE)
-                                    self->connectionHandler(self->connectionHandlerParameter, self, CS104_CONNECTION_STOPDT_CON_RECEIVED);
-                            }
-                        }
+        success = true;
+    }
+    else
+        DEBUG_PRINT("Cannot change the send queue size while the connection is active\n");
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-                        Semaphore_wait(self->conStateLock);
+    Semaphore_post(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-                        if ((self->unconfirmedReceivedIMessages >= self->parameters.w) || (self->conState == STATE_WAITING_FOR_STOPDT_CON)) {
-                            confirmOutstandingMessages(self);
-                        }
+    return success;
+}
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-                        Semaphore_post(self->conStateLock);
-#endif /* (CONFIG_USE_SEMAPHORES == 1) */
-                    }
+bool
+CS104_Connection_setEventSignal(CS104_Connection self, Semaphore signal)
+{
+    bool success = true;
 
-                    if (handleTimeouts(self) == false)
-                        loopRunning = false;
+    Semaphore_wait(self->conStateLock);
 
-                    if (isClose(self))
-                        loopRunning = false;
-                }
+    if ((signal != NULL) && (self->sendQueueSize == 0))
+        success = false;
+    else
+        self->eventSignal = signal;
 
-                Handleset_destroy(handleSet);
+    Semaphore_post(self->conStateLock);
 
-                /* register CLOSED event */
-                event = CS104_CONNECTION_CLOSED;
-            }
-        }
-        else {
-#if (CONFIG_USE_SEMAPHORES == 1)
-            Semaphore_wait(self->conStateLock);
+    return success;
+}
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
-            self->failure = true;
+
+bool
+CS104_Connection_isRunning(CS104_Connection self)
+{
+    bool running;
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-            Semaphore_post(self->conStateLock);
+    Semaphore_wait(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-            /* register CLOSED event */
-            event = CS104_CONNECTION_FAILED;
-        }
+    running = self->running;
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-        Semaphore_wait(self->conStateLock);
+    Semaphore_post(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-        /* Confirm all unconfirmed received I-messages before closing the connection */
-        if (self->unconfirmedReceivedIMessages > 0) {
-            confirmOutstandingMessages(self);
-        }
-
-    #if (CONFIG_CS104_SUPPORT_TLS == 1)
-        if (self->tlsSocket)
-            TLSSocket_close(self->tlsSocket);
-    #endif
-
-        Socket_destroy(self->socket);
-        self->socket = NULL;
-
-        self->conState = STATE_IDLE;
-
-        self->running = false;
+    return running;
+}
 
-#if (CONFIG_USE_SEMAPHORES == 1)
-        Semaphore_post(self->conStateLock);
-#endif /* (CONFIG_USE_SEMAPHORES == 1) */
-    }
-    else
-    {
-        DEBUG_PRINT("Failed to create socket\n");
+int
+CS104_Connection_getSendQueueCount(CS104_Connection self)
+{
+    int count;
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-        Semaphore_wait(self->conStateLock);
+    Semaphore_wait(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-        self->running = false;
+    count = self->sendQueueCount;
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-        Semaphore_post(self->conStateLock);
+    Semaphore_post(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
-    }
 
-    /* Call connection handler */
-    if ((event == CS104_CONNECTION_CLOSED) || (event == CS104_CONNECTION_FAILED)) {
-        if (self->connectionHandler)
-            self->connectionHandler(self->connectionHandlerParameter, self, event);
-    }
-
-    return NULL;
+    return count;
 }
-#endif /* (CONFIG_USE_THREADS == 1) */
 
-void
-CS104_Connection_connectAsync(CS104_Connection self)
+bool
+CS104_Connection_setASDUBatchHandler(CS104_Connection self, CS104_ASDUBatchHandler handler, void* parameter, int maxASDUs, int maxDelayInMs)
 {
+    bool success = false;
+
 #if (CONFIG_USE_SEMAPHORES == 1)
     Semaphore_wait(self->conStateLock);
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
-    self->running = false;
-    self->failure = false;
-    self->close = false;
+    /* the receiving thread and the ASDU queue processing can access the batch buffers */
+    if (self->active == false) {
 
-#if (CONFIG_USE_SEMAPHORES == 1)
-    Semaphore_post(self->conStateLock);
-#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+        if (self->batchEntries != NULL) {
+            GLOBAL_FREEMEM(self->batchEntries);
+            GLOBAL_FREEMEM(self->batchViews);
+            GLOBAL_FREEMEM(self->batchASDUs);
 
-#if (CONFIG_USE_THREADS == 1)
-    if (self->connectionHandlingThread) {
-        Thread_destroy(self->connectionHandlingThread);
-        self->connectionHandlingThread = NULL;
-    }
+            self->batchEntries = NULL;
+            self->batchViews = NULL;
+            self->batchASDUs = NULL;
+        }
 
-    self->connectionHandlingThread = Thread_create(handleConnection, (void*) self, false);
+        self->batchHandler = NULL;
+        self->batchCount = 0;
 
-    if (self->connectionHandlingThread)
-        Thread_start(self->connectionHandlingThread);
-#endif
-}
+        success = true;
 
-bool
-CS104_Connection_connect(CS104_Connection self)
-{
-    CS104_Connection_connectAsync(self);
+        if (handler) {
+            if (maxASDUs < 1)
+                maxASDUs = 1;
 
-    while ((isRunning(self) == false) && (isFailure(self) == false))
-        Thread_sleep(1);
+            self->batchEntries = (ASDUQueueEntry*) GLOBAL_MALLOC(sizeof(ASDUQueueEntry) * maxASDUs);
+            self->batchViews = (sCS101_ASDUView*) GLOBAL_MALLOC(sizeof(sCS101_ASDUView) * maxASDUs);
+            self->batchASDUs = (CS101_ASDU*) GLOBAL_MALLOC(sizeof(CS101_ASDU) * maxASDUs);
 
-    return isRunning(self);
-}
+            if (self->batchEntries && self->batchViews && self->batchASDUs) {
+                self->batchHandler = handler;
+                self->batchHandlerParameter = parameter;
+                self->maxBatchSize = maxASDUs;
+                self->maxBatchDelay = maxDelayInMs;
+            }
+            else {
+                GLOBAL_FREEMEM(self->batchEntries);
+                GLOBAL_FREEMEM(self->batchViews);
+                GLOBAL_FREEMEM(self->batchASDUs);
 
-void
-CS104_Connection_setASDUReceivedHandler(CS104_Connection self, CS101_ASDUReceivedHandler handler, void* parameter)
-{
-    self->receivedHandler = handler;
-    self->receivedHandlerParameter = parameter;
+                self->batchEntries = NULL;
+                self->batchViews = NULL;
+                self->batchASDUs = NULL;
+
+                success = false;
+            }
+        }
+    }
+    else
+        DEBUG_PRINT("Cannot change the batch handler while the connection is active\n");
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    return success;
 }
 
 void
@@ -1130,12 +3150,12 @@ encodeIdentificationField(CS104_Connection self, Frame frame, TypeID typeId,
 
     /* encode COT */
     T104Frame_setNextByte(frame, (uint8_t) cot);
-    if (self->alParameters.sizeOfCOT == 2)
+    if (CS101_SIZE_OF_COT(&(self->alParameters)) == 2)
         T104Frame_setNextByte(frame, (uint8_t) self->alParameters.originatorAddress);
 
     /* encode CA */
     T104Frame_setNextByte(frame, (uint8_t)(ca & 0xff));
-    if (self->alParameters.sizeOfCA == 2)
+    if (CS101_SIZE_OF_CA(&(self->alParameters)) == 2)
         T104Frame_setNextByte(frame, (uint8_t) ((ca & 0xff00) >> 8));
 }
 
@@ -1144,10 +3164,10 @@ encodeIOA(CS104_Connection self, Frame frame, int ioa)
 {
     T104Frame_setNextByte(frame, (uint8_t) (ioa & 0xff));
 
-    if (self->alParameters.sizeOfIOA > 1)
+    if (CS101_SIZE_OF_IOA(&(self->alParameters)) > 1)
         T104Frame_setNextByte(frame, (uint8_t) ((ioa / 0x100) & 0xff));
 
-    if (self->alParameters.sizeOfIOA > 2)
+    if (CS101_SIZE_OF_IOA(&(self->alParameters)) > 2)
         T104Frame_setNextByte(frame, (uint8_t) ((ioa / 0x10000) & 0xff));
 }
 
@@ -1160,6 +3180,10 @@ CS104_Connection_sendStartDT(CS104_Connection self)
 
     self->conState = STATE_WAITING_FOR_STARTDT_CON;
 
+    /* STARTDT_CON has to be received within t1 - armed before sending because
+     * the receiving thread clears it with the confirmation */
+    self->uMessageTimeout = Hal_getTimeInMs() + (self->parameters.t1 * 1000);
+
     writeToSocket(self, STARTDT_ACT_MSG, STARTDT_ACT_MSG_SIZE);
 
 #if (CONFIG_USE_SEMAPHORES == 1)
@@ -1185,47 +3209,29 @@ CS104_Connection_sendStopDT(CS104_Connection self)
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 }
 
-static void
-sendIMessageAndUpdateSentASDUs(CS104_Connection self, Frame frame)
-{
-    int currentIndex = 0;
-
-    if (self->oldestSentASDU == -1) {
-        self->oldestSentASDU = 0;
-        self->newestSentASDU = 0;
-
-    } else {
-        currentIndex = (self->newestSentASDU + 1) % self->maxSentASDUs;
-    }
-
-    self->sentASDUs [currentIndex].seqNo = sendIMessage (self, frame);
-    self->sentASDUs [currentIndex].sentTime = Hal_getTimeInMs();
-
-    self->newestSentASDU = currentIndex;
-}
-
 static bool
 sendASDUInternal(CS104_Connection self, Frame frame)
 {
     bool retVal = false;
 
-    if (isRunning(self)) {
-
 #if (CONFIG_USE_SEMAPHORES == 1)
-        Semaphore_wait(self->conStateLock);
+    Semaphore_wait(self->conStateLock);
 #endif
 
-        if (isSentBufferFull(self) == false) {
+    if (self->running) {
+        if (self->sendQueue && ((self->sendQueueCount > 0) || isSentBufferFull(self))) {
+            /* keep the order of the ASDUs -> queue when other ASDUs are waiting */
+            retVal = enqueueASDUToSend(self, frame);
+        }
+        else if (isSentBufferFull(self) == false) {
             sendIMessageAndUpdateSentASDUs(self, frame);
             retVal = true;
         }
+    }
 
 #if (CONFIG_USE_SEMAPHORES == 1)
-        Semaphore_post(self->conStateLock);
+    Semaphore_post(self->conStateLock);
 #endif
-    }
-
-    T104Frame_destroy(frame);
 
     return retVal;
 }
@@ -1233,7 +3239,8 @@ sendASDUInternal(CS104_Connection self, Frame frame)
 bool
 CS104_Connection_sendInterrogationCommand(CS104_Connection self, CS101_CauseOfTransmission cot, int ca, QualifierOfInterrogation qoi)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     encodeIdentificationField(self, frame, C_IC_NA_1, 1, cot, ca);
 
@@ -1248,7 +3255,8 @@ CS104_Connection_sendInterrogationCommand(CS104_Connection self, CS101_CauseOfTr
 bool
 CS104_Connection_sendCounterInterrogationCommand(CS104_Connection self, CS101_CauseOfTransmission cot, int ca, uint8_t qcc)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     encodeIdentificationField(self, frame, C_CI_NA_1, 1, cot, ca);
 
@@ -1263,7 +3271,8 @@ CS104_Connection_sendCounterInterrogationCommand(CS104_Connection self, CS101_Ca
 bool
 CS104_Connection_sendReadCommand(CS104_Connection self, int ca, int ioa)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     encodeIdentificationField(self, frame, C_RD_NA_1, 1, CS101_COT_REQUEST, ca);
 
@@ -1275,7 +3284,8 @@ CS104_Connection_sendReadCommand(CS104_Connection self, int ca, int ioa)
 bool
 CS104_Connection_sendClockSyncCommand(CS104_Connection self, int ca, CP56Time2a newTime)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     encodeIdentificationField(self, frame, C_CS_NA_1, 1, CS101_COT_ACTIVATION, ca);
 
@@ -1289,7 +3299,8 @@ CS104_Connection_sendClockSyncCommand(CS104_Connection self, int ca, CP56Time2a
 bool
 CS104_Connection_sendTestCommand(CS104_Connection self, int ca)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     encodeIdentificationField(self, frame, C_TS_NA_1, 1, CS101_COT_ACTIVATION, ca);
 
@@ -1314,7 +3325,8 @@ CS104_Connection_sendTestCommandWithTimestamp(CS104_Connection self, int ca, uin
 bool
 CS104_Connection_sendProcessCommand(CS104_Connection self, TypeID typeId, CS101_CauseOfTransmission cot, int ca, InformationObject sc)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     if (typeId == 0)
         typeId = InformationObject_getType(sc);
@@ -1329,7 +3341,8 @@ CS104_Connection_sendProcessCommand(CS104_Connection self, TypeID typeId, CS101_
 bool
 CS104_Connection_sendProcessCommandEx(CS104_Connection self, CS101_CauseOfTransmission cot, int ca, InformationObject sc)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     TypeID typeId = InformationObject_getType(sc);
 
@@ -1343,13 +3356,216 @@ CS104_Connection_sendProcessCommandEx(CS104_Connection self, CS101_CauseOfTransm
 bool
 CS104_Connection_sendASDU(CS104_Connection self, CS101_ASDU asdu)
 {
-    Frame frame = (Frame) T104Frame_create();
+    struct sT104Frame _frame;
+    Frame frame = T104Frame_initialize(&_frame);
 
     CS101_ASDU_encode(asdu, frame);
 
     return sendASDUInternal(self, frame);
 }
 
+/* position of the byte with the S/E flag (-1 when the command type has no S/E flag) */
+static int
+getSelectExecutePosition(TypeID typeId, int asduSize)
+{
+    switch (typeId) {
+    case C_SC_NA_1:
+    case C_DC_NA_1:
+    case C_RC_NA_1:
+    case C_SE_NA_1:
+    case C_SE_NB_1:
+    case C_SE_NC_1:
+        return asduSize - 1;
+
+    case C_SC_TA_1:
+    case C_DC_TA_1:
+    case C_RC_TA_1:
+    case C_SE_TA_1:
+    case C_SE_TB_1:
+    case C_SE_TC_1:
+        return asduSize - 8; /* followed by CP56Time2a */
+
+    default:
+        return -1;
+    }
+}
+
+CS104_CommandHandle
+CS104_Connection_sendCommand(CS104_Connection self, int ca, InformationObject command, CS104_CommandMode mode,
+        bool waitForTermination, CS104_CommandHandler handler, void* parameter)
+{
+    CS104_CommandHandle handle = 0;
+
+    TypeID typeId = InformationObject_getType(command);
+    int ioa = InformationObject_getObjectAddress(command);
+
+    /* encode the command ASDU - the S/E flag is set when the command is sent */
+    sCS101_StaticASDU _asdu;
+    uint8_t asduBuffer[256];
+    struct sBufferFrame _frame;
+
+    CS101_ASDU asdu = CS101_ASDU_initializeStatic(&_asdu, (CS101_AppLayerParameters) &(self->alParameters), false,
+            CS101_COT_ACTIVATION, self->alParameters.originatorAddress, ca, false, false);
+
+    if (CS101_ASDU_addInformationObject(asdu, command) == false)
+        return 0;
+
+    Frame frame = BufferFrame_initialize(&_frame, asduBuffer, 0);
+
+    CS101_ASDU_encode(asdu, frame);
+
+    int asduSize = Frame_getMsgSize(frame);
+
+    if (asduSize > COMMAND_MAX_ASDU_SIZE)
+        return 0;
+
+    int sePos = getSelectExecutePosition(typeId, asduSize);
+
+    if ((mode == CS104_COMMAND_SELECT_AND_EXECUTE) && (sePos == -1)) {
+        DEBUG_PRINT("Command type %i has no S/E flag\n", typeId);
+        return 0;
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (self->running == false)
+        goto exit_function;
+
+    if (self->commands == NULL) {
+        self->commands = (OutstandingCommand*) GLOBAL_CALLOC(self->maxCommands, sizeof(OutstandingCommand));
+        self->commandSendQueue = (int*) GLOBAL_MALLOC(sizeof(int) * self->maxCommands);
+
+        if ((self->commands == NULL) || (self->commandSendQueue == NULL)) {
+            GLOBAL_FREEMEM(self->commands);
+            GLOBAL_FREEMEM(self->commandSendQueue);
+
+            self->commands = NULL;
+            self->commandSendQueue = NULL;
+
+            goto exit_function;
+        }
+
+        self->commandSendQueueHead = 0;
+        self->commandSendQueueCount = 0;
+    }
+
+    int freeIndex = -1;
+    int i;
+
+    for (i = 0; i < self->maxCommands; i++) {
+        OutstandingCommand* outstandingCommand = &(self->commands[i]);
+
+        if (outstandingCommand->state == COMMAND_STATE_FREE) {
+            if (freeIndex == -1)
+                freeIndex = i;
+        }
+        else if ((outstandingCommand->typeId == (int) typeId) && (outstandingCommand->ca == ca) &&
+                (outstandingCommand->ioa == ioa))
+        {
+            /* the responses cannot be correlated */
+            DEBUG_PRINT("Command for type %i CA %i IOA %i is already outstanding\n", typeId, ca, ioa);
+            goto exit_function;
+        }
+    }
+
+    if (freeIndex == -1)
+        goto exit_function;
+
+    OutstandingCommand* newCommand = &(self->commands[freeIndex]);
+
+    self->lastCommandHandle++;
+
+    if (self->lastCommandHandle == 0)
+        self->lastCommandHandle = 1;
+
+    handle = self->lastCommandHandle;
+
+    newCommand->handle = handle;
+    newCommand->typeId = (int) typeId;
+    newCommand->ca = ca;
+    newCommand->ioa = ioa;
+    newCommand->waitForTermination = waitForTermination;
+    newCommand->sePos = sePos;
+    newCommand->handler = handler;
+    newCommand->handlerParameter = parameter;
+    newCommand->event = -1;
+
+    memcpy(newCommand->asdu, asduBuffer, asduSize);
+    newCommand->asduSize = asduSize;
+
+    if (mode == CS104_COMMAND_SELECT_AND_EXECUTE)
+        newCommand->state = COMMAND_STATE_SELECT_PENDING;
+    else
+        newCommand->state = COMMAND_STATE_EXECUTE_PENDING;
+
+    self->commandCount++;
+
+    enqueueCommandToSend(self, freeIndex);
+
+    sendPendingCommands(self);
+
+exit_function:
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    return handle;
+}
+
+void
+CS104_Connection_setCommandTimeout(CS104_Connection self, int timeoutInMs)
+{
+    self->commandTimeout = timeoutInMs;
+}
+
+void
+CS104_Connection_setMaxOutstandingCommands(CS104_Connection self, int maxCommands)
+{
+    if (maxCommands < 1)
+        maxCommands = 1;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (self->commandCount == 0) {
+        if (self->commands) {
+            GLOBAL_FREEMEM(self->commands);
+            GLOBAL_FREEMEM(self->commandSendQueue);
+
+            self->commands = NULL;
+            self->commandSendQueue = NULL;
+        }
+
+        self->maxCommands = maxCommands;
+    }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+}
+
+int
+CS104_Connection_getOutstandingCommands(CS104_Connection self)
+{
+    int count;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    count = self->commandCount;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->conStateLock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    return count;
+}
+
 bool
 CS104_Connection_isTransmitBufferFull(CS104_Connection self)
 {
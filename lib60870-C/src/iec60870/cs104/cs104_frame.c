@@ -28,22 +28,7 @@
 #include "lib60870_internal.h"
 #include "lib_memory.h"
 
-#ifndef CONFIG_LIB60870_STATIC_FRAMES
-#define CONFIG_LIB60870_STATIC_FRAMES 0
-#endif
-
-
-struct sT104Frame {
-    FrameVFT virtualFunctionTable;
-
-    uint8_t buffer[256];
-    int msgSize;
 
-#if (CONFIG_LIB60870_STATIC_FRAMES == 1)
-    /* TODO move to base class? */
-    uint8_t allocated;
-#endif
-};
 
 static struct sFrameVFT t104FrameVFT = {
         T104Frame_destroy,
@@ -98,6 +83,20 @@ getNextFreeFrame(void)
 #endif /* (CONFIG_LIB60870_STATIC_FRAMES == 1) */
 
 
+Frame
+T104Frame_initialize(T104Frame self)
+{
+    self->virtualFunctionTable = &t104FrameVFT;
+    self->buffer[0] = 0x68;
+    self->msgSize = 6;
+
+#if (CONFIG_LIB60870_STATIC_FRAMES == 1)
+    self->allocated = 0;
+#endif
+
+    return (Frame) self;
+}
+
 T104Frame
 T104Frame_create()
 {
@@ -0,0 +1,401 @@
+/*
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_CS104_CLIENT
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
+#include "cs104_connection.h"
+
+#include "hal_thread.h"
+#include "hal_time.h"
+#include "lib_memory.h"
+#include "lib60870_internal.h"
+#include "lib60870_atomic.h"
+
+#define DEFAULT_RECONNECT_INTERVAL_MS 1000
+
+typedef struct {
+    CS104_RedundantConnection redundantConnection;
+    CS104_Connection connection;
+    int index;
+    bool connected;
+} RedundantEndpoint;
+
+struct sCS104_RedundantConnection {
+    CS104_ConnectionManager manager;
+
+    RedundantEndpoint** endpoints;
+    int endpointCount;
+
+    int selectedEndpoint; /* endpoint where STARTDT was sent (-1 = none) - read without lock by the ASDU handler */
+    bool activeConfirmed; /* STARTDT_CON received from the selected endpoint */
+
+    bool switchoverPending;
+    uint64_t failureTime; /* time when the active connection failed (in ns) */
+    sCS104_RedundantConnectionStatistics statistics;
+
+    bool interrogationOnSwitchover;
+    int interrogationCA;
+
+    CS101_ASDUReceivedHandler asduHandler;
+    void* asduHandlerParameter;
+
+    CS104_RedundantConnectionHandler eventHandler;
+    void* eventHandlerParameter;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore lock;
+#endif
+};
+
+static void
+raiseEvent(CS104_RedundantConnection self, int endpoint, CS104_RedundantConnectionEvent event)
+{
+    if (self->eventHandler)
+        self->eventHandler(self->eventHandlerParameter, self, endpoint, event);
+}
+
+/* start the data transfer on a standby connection - has to be called with lock */
+static bool
+selectStandbyEndpoint(CS104_RedundantConnection self, int failedEndpoint)
+{
+    int i;
+
+    for (i = 1; i <= self->endpointCount; i++) {
+        /* start with the endpoint after the failed endpoint */
+        RedundantEndpoint* endpoint = self->endpoints[(failedEndpoint + i) % self->endpointCount];
+
+        if (endpoint->connected) {
+            DEBUG_PRINT("Start data transfer on endpoint %i\n", endpoint->index);
+
+            LIB60870_ATOMIC_STORE(&(self->selectedEndpoint), endpoint->index);
+            self->activeConfirmed = false;
+
+            CS104_Connection_sendStartDT(endpoint->connection);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void
+endpointConnectionHandler(void* parameter, CS104_Connection connection, CS104_ConnectionEvent event)
+{
+    RedundantEndpoint* endpoint = (RedundantEndpoint*) parameter;
+    CS104_RedundantConnection self = endpoint->redundantConnection;
+
+    bool raiseActive = false;
+    bool raiseNoActive = false;
+    bool sendInterrogation = false;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    switch (event) {
+
+    case CS104_CONNECTION_OPENED:
+        endpoint->connected = true;
+
+        if (self->selectedEndpoint == -1)
+            selectStandbyEndpoint(self, endpoint->index - 1);
+
+        break;
+
+    case CS104_CONNECTION_STARTDT_CON_RECEIVED:
+        if (self->selectedEndpoint == endpoint->index) {
+            self->activeConfirmed = true;
+
+            if (self->switchoverPending) {
+                uint64_t switchoverTime = (Hal_getTimeInNs() - self->failureTime) / 1000;
+
+                self->switchoverPending = false;
+                self->statistics.switchovers++;
+                self->statistics.lastSwitchoverTimeUs = switchoverTime;
+
+                if (switchoverTime > self->statistics.maxSwitchoverTimeUs)
+                    self->statistics.maxSwitchoverTimeUs = switchoverTime;
+            }
+
+            sendInterrogation = self->interrogationOnSwitchover;
+            raiseActive = true;
+        }
+        else {
+            /* only one connection is allowed to transfer data */
+            CS104_Connection_sendStopDT(connection);
+        }
+        break;
+
+    case CS104_CONNECTION_CLOSED:
+    case CS104_CONNECTION_FAILED:
+        endpoint->connected = false;
+
+        if (self->selectedEndpoint == endpoint->index) {
+            DEBUG_PRINT("Active endpoint %i failed\n", endpoint->index);
+
+            LIB60870_ATOMIC_STORE(&(self->selectedEndpoint), -1);
+
+            if (self->activeConfirmed) {
+                self->switchoverPending = true;
+                self->failureTime = Hal_getTimeInNs();
+            }
+
+            self->activeConfirmed = false;
+
+            if (selectStandbyEndpoint(self, endpoint->index) == false) {
+                /* switchover failed - the next activation is not a switchover */
+                if (self->switchoverPending) {
+                    self->switchoverPending = false;
+                    self->statistics.failedSwitchovers++;
+                }
+
+                raiseNoActive = true;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    int interrogationCA = self->interrogationCA;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (sendInterrogation)
+        CS104_Connection_sendInterrogationCommand(connection, CS101_COT_ACTIVATION, interrogationCA, IEC60870_QOI_STATION);
+
+    if (event == CS104_CONNECTION_OPENED)
+        raiseEvent(self, endpoint->index, CS104_REDUNDANT_ENDPOINT_CONNECTED);
+    else if ((event == CS104_CONNECTION_CLOSED) || (event == CS104_CONNECTION_FAILED))
+        raiseEvent(self, endpoint->index, CS104_REDUNDANT_ENDPOINT_DISCONNECTED);
+
+    if (raiseActive)
+        raiseEvent(self, endpoint->index, CS104_REDUNDANT_ENDPOINT_ACTIVE);
+
+    if (raiseNoActive)
+        raiseEvent(self, endpoint->index, CS104_REDUNDANT_NO_ACTIVE_ENDPOINT);
+}
+
+static bool
+endpointASDUReceivedHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    RedundantEndpoint* endpoint = (RedundantEndpoint*) parameter;
+    CS104_RedundantConnection self = endpoint->redundantConnection;
+
+    /* ignore ASDUs of standby connections */
+    if (LIB60870_ATOMIC_LOAD(&(self->selectedEndpoint)) != endpoint->index)
+        return true;
+
+    if (self->asduHandler)
+        return self->asduHandler(self->asduHandlerParameter, address, asdu);
+
+    return true;
+}
+
+CS104_RedundantConnection
+CS104_RedundantConnection_create(void)
+{
+    CS104_RedundantConnection self = (CS104_RedundantConnection) GLOBAL_CALLOC(1, sizeof(struct sCS104_RedundantConnection));
+
+    if (self) {
+        self->manager = CS104_ConnectionManager_create();
+
+        if (self->manager == NULL) {
+            GLOBAL_FREEMEM(self);
+            return NULL;
+        }
+
+        CS104_ConnectionManager_setReconnectInterval(self->manager, DEFAULT_RECONNECT_INTERVAL_MS);
+
+        self->selectedEndpoint = -1;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        self->lock = Semaphore_create(1);
+#endif
+    }
+
+    return self;
+}
+
+int
+CS104_RedundantConnection_addEndpoint(CS104_RedundantConnection self, const char* hostname, int tcpPort)
+{
+    RedundantEndpoint** endpoints = (RedundantEndpoint**) GLOBAL_REALLOC(self->endpoints,
+            sizeof(RedundantEndpoint*) * (self->endpointCount + 1));
+
+    if (endpoints == NULL)
+        return -1;
+
+    self->endpoints = endpoints;
+
+    RedundantEndpoint* endpoint = (RedundantEndpoint*) GLOBAL_CALLOC(1, sizeof(RedundantEndpoint));
+
+    if (endpoint == NULL)
+        return -1;
+
+    endpoint->connection = CS104_Connection_create(hostname, tcpPort);
+
+    if (endpoint->connection == NULL) {
+        GLOBAL_FREEMEM(endpoint);
+        return -1;
+    }
+
+    if (CS104_ConnectionManager_addConnection(self->manager, endpoint->connection) == false) {
+        CS104_Connection_destroy(endpoint->connection);
+        GLOBAL_FREEMEM(endpoint);
+        return -1;
+    }
+
+    endpoint->redundantConnection = self;
+    endpoint->index = self->endpointCount;
+
+    CS104_Connection_setConnectionHandler(endpoint->connection, endpointConnectionHandler, endpoint);
+    CS104_Connection_setASDUReceivedHandler(endpoint->connection, endpointASDUReceivedHandler, endpoint);
+
+    self->endpoints[self->endpointCount] = endpoint;
+    self->endpointCount++;
+
+    return endpoint->index;
+}
+
+CS104_Connection
+CS104_RedundantConnection_getEndpointConnection(CS104_RedundantConnection self, int endpoint)
+{
+    if ((endpoint < 0) || (endpoint >= self->endpointCount))
+        return NULL;
+
+    return self->endpoints[endpoint]->connection;
+}
+
+void
+CS104_RedundantConnection_setReconnectInterval(CS104_RedundantConnection self, int intervalInMs)
+{
+    CS104_ConnectionManager_setReconnectInterval(self->manager, intervalInMs);
+}
+
+void
+CS104_RedundantConnection_setInterrogationOnSwitchover(CS104_RedundantConnection self, bool enabled, int ca)
+{
+    self->interrogationOnSwitchover = enabled;
+    self->interrogationCA = ca;
+}
+
+void
+CS104_RedundantConnection_setASDUReceivedHandler(CS104_RedundantConnection self, CS101_ASDUReceivedHandler handler, void* parameter)
+{
+    self->asduHandler = handler;
+    self->asduHandlerParameter = parameter;
+}
+
+void
+CS104_RedundantConnection_setEventHandler(CS104_RedundantConnection self, CS104_RedundantConnectionHandler handler, void* parameter)
+{
+    self->eventHandler = handler;
+    self->eventHandlerParameter = parameter;
+}
+
+void
+CS104_RedundantConnection_start(CS104_RedundantConnection self)
+{
+    int i;
+
+    CS104_ConnectionManager_start(self->manager);
+
+    for (i = 0; i < self->endpointCount; i++)
+        CS104_Connection_connectAsync(self->endpoints[i]->connection);
+}
+
+int
+CS104_RedundantConnection_getActiveEndpoint(CS104_RedundantConnection self)
+{
+    int activeEndpoint = -1;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    if (self->activeConfirmed)
+        activeEndpoint = self->selectedEndpoint;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    return activeEndpoint;
+}
+
+CS104_Connection
+CS104_RedundantConnection_getActiveConnection(CS104_RedundantConnection self)
+{
+    int activeEndpoint = CS104_RedundantConnection_getActiveEndpoint(self);
+
+    if (activeEndpoint == -1)
+        return NULL;
+
+    return self->endpoints[activeEndpoint]->connection;
+}
+
+void
+CS104_RedundantConnection_getStatistics(CS104_RedundantConnection self, sCS104_RedundantConnectionStatistics* stats)
+{
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+    *stats = self->statistics;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->lock);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+}
+
+void
+CS104_RedundantConnection_destroy(CS104_RedundantConnection self)
+{
+    int i;
+
+    CS104_ConnectionManager_stop(self->manager);
+
+    /* no events while the connections are closed */
+    for (i = 0; i < self->endpointCount; i++)
+        CS104_Connection_setConnectionHandler(self->endpoints[i]->connection, NULL, NULL);
+
+    for (i = 0; i < self->endpointCount; i++) {
+        CS104_Connection_destroy(self->endpoints[i]->connection);
+        GLOBAL_FREEMEM(self->endpoints[i]);
+    }
+
+    CS104_ConnectionManager_destroy(self->manager);
+
+    if (self->endpoints)
+        GLOBAL_FREEMEM(self->endpoints);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_destroy(self->lock);
+#endif
+
+    GLOBAL_FREEMEM(self);
+}
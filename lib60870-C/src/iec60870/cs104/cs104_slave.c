@@ -24,6 +24,9 @@
 #define _CRT_NONSTDC_NO_DEPRECATE
 #endif
 
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_CS104_SLAVE
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -44,6 +47,8 @@
 
 #include "apl_types_internal.h"
 #include "cs101_asdu_internal.h"
+#include "cs104_statistics.h"
+#include "lib60870_trace.h"
 
 #if (CONFIG_CS104_SUPPORT_TLS == 1)
 #include "tls_socket.h"
@@ -53,6 +58,10 @@
 #error Illegal configuration: Define either CONFIG_CS104_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP or CONFIG_CS104_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP or CONFIG_CS104_SUPPORT_SERVER_MODE_MULTIPLE_REDUNDANCY_GROUPS
 #endif
 
+#ifndef CONFIG_CS104_SLAVE_LATENCY_STATISTICS
+#define CONFIG_CS104_SLAVE_LATENCY_STATISTICS 0
+#endif
+
 typedef struct sMasterConnection* MasterConnection;
 
 void
@@ -103,6 +112,9 @@ typedef enum  {
 
 struct sMessageQueueEntryInfo {
     uint64_t entryId;
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    uint64_t enqueueTime; /* in us - 0 when latency statistics are not enabled */
+#endif
     unsigned int entryState:2;
     unsigned int size:8;
 };
@@ -236,7 +248,7 @@ MessageQueue_countEntriesUntilEndOfBuffer(MessageQueue self, uint8_t* firstEntry
  * Add an ASDU to the queue. When queue is full, override oldest entry.
  */
 static void
-MessageQueue_enqueueASDU(MessageQueue self, CS101_ASDU asdu)
+MessageQueue_enqueueASDU(MessageQueue self, CS101_ASDU asdu, uint64_t enqueueTime)
 {
     int asduSize = asdu->asduHeaderLength + asdu->payloadSize;
 
@@ -316,6 +328,12 @@ MessageQueue_enqueueASDU(MessageQueue self, CS101_ASDU asdu)
     entryInfo.entryId = self->entryId++;
     entryInfo.entryState = QUEUE_ENTRY_STATE_WAITING_FOR_TRANSMISSION;
 
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    entryInfo.enqueueTime = enqueueTime;
+#else
+    UNUSED_PARAMETER(enqueueTime);
+#endif
+
     memcpy(nextMsgPtr, &entryInfo, sizeof(struct sMessageQueueEntryInfo));
 
     DEBUG_PRINT("CS104 SLAVE: ASDUs in FIFO: %i (new(size=%i/%i): %p, first: %p, last: %p lastInBuf: %p)\n", self->entryCounter, entrySize, asduSize, nextMsgPtr,
@@ -883,8 +901,12 @@ CS104_RedundancyGroup_create(const char* name)
     CS104_RedundancyGroup self = (CS104_RedundancyGroup) GLOBAL_MALLOC(sizeof(struct sCS104_RedundancyGroup));
 
     if (self) {
-        if (name)
-            self->name = strdup(name);
+        if (name) {
+            self->name = (char*) GLOBAL_MALLOC(strlen(name) + 1);
+
+            if (self->name)
+                strcpy(self->name, name);
+        }
         else
             self->name = NULL;
 
@@ -1028,7 +1050,10 @@ struct sCS104_Slave {
     int maxHighPrioQueueSize;
 
     int openConnections; /**< number of connected clients */
-    MasterConnection masterConnections[CONFIG_CS104_MAX_CLIENT_CONNECTIONS]; /**< references to all MasterConnection objects */
+    MasterConnection masterConnections[CONFIG_CS104_MAX_CLIENT_CONNECTIONS]; /**< references to all MasterConnection objects (created when needed) */
+    bool connectionSpecificQueues; /**< CS104_MODE_CONNECTION_IS_REDUNDANCY_GROUP: new connection objects need event queues */
+
+    SocketPoller socketPoller; /**< threadless mode: poller where the sockets are registered (optional) */
 
 #if (CONFIG_USE_SEMAPHORES == 1)
     Semaphore openConnectionsLock;
@@ -1040,6 +1065,12 @@ struct sCS104_Slave {
 
     int maxOpenConnections; /**< maximum accepted open client connections */
 
+    uint32_t connectionIdCounter; /**< used to assign unique IDs to client connections (statistics) */
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    bool latencyStatistics; /**< record latency histograms for new connections */
+#endif
+
     struct sCS104_APCIParameters conParameters;
 
     struct sCS101_AppLayerParameters alParameters;
@@ -1061,6 +1092,8 @@ struct sCS104_Slave {
     CS104_ServerMode serverMode;
 
     char* localAddress;
+    char* localUnixPath;
+    bool useUnixSocket; /* unix domain socket requested (also set when the path could not be stored) */
 
 #if (CONFIG_USE_THREADS == 1)
     Thread listeningThread;
@@ -1077,6 +1110,11 @@ typedef struct {
 
     uint64_t sentTime; /* required for T1 timeout */
     int seqNo;
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    uint64_t enqueueTime; /* in us - 0 if ASDU is not from low-priority queue */
+    uint64_t sentTimeUs;
+#endif
 } SentASDUSlave;
 
 struct sMasterConnection {
@@ -1135,6 +1173,12 @@ struct sMasterConnection {
 #if (CONFIG_CS104_SUPPORT_SERVER_MODE_MULTIPLE_REDUNDANCY_GROUPS == 1)
     CS104_RedundancyGroup redundancyGroup;
 #endif
+
+    struct sCS104_ConnectionStatistics statistics;
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    CS104_LatencyHistogram latencyHistograms; /* one histogram for each CS104_LatencyType - protected by sentASDUsLock */
+#endif
 };
 
 static uint8_t STARTDT_CON_MSG[] = { 0x68, 0x04, 0x0b, 0x00, 0x00, 0x00 };
@@ -1177,10 +1221,25 @@ initializeConnectionSpecificQueues(CS104_Slave self)
 {
     int i;
 
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->openConnectionsLock);
+#endif
+
+    /* connection objects that are created later get their queues when they are created */
+    self->connectionSpecificQueues = true;
+
     for (i = 0; i < CONFIG_CS104_MAX_CLIENT_CONNECTIONS; i++) {
-        self->masterConnections[i]->lowPrioQueue = MessageQueue_create(self->maxLowPrioQueueSize);
-        self->masterConnections[i]->highPrioQueue = HighPriorityASDUQueue_create(self->maxHighPrioQueueSize);
+        MasterConnection con = self->masterConnections[i];
+
+        if (con) {
+            con->lowPrioQueue = MessageQueue_create(self->maxLowPrioQueueSize);
+            con->highPrioQueue = HighPriorityASDUQueue_create(self->maxHighPrioQueueSize);
+        }
     }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->openConnectionsLock);
+#endif
 }
 
 static void
@@ -1188,17 +1247,32 @@ deleteConnectionSpecificQueues(CS104_Slave self)
 {
     int i;
 
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_wait(self->openConnectionsLock);
+#endif
+
+    self->connectionSpecificQueues = false;
+
     for (i = 0; i < CONFIG_CS104_MAX_CLIENT_CONNECTIONS; i++) {
-        if (self->masterConnections[i]->lowPrioQueue) {
-            MessageQueue_destroy(self->masterConnections[i]->lowPrioQueue);
-            self->masterConnections[i]->lowPrioQueue = NULL;
+        MasterConnection con = self->masterConnections[i];
+
+        if (con == NULL)
+            continue;
+
+        if (con->lowPrioQueue) {
+            MessageQueue_destroy(con->lowPrioQueue);
+            con->lowPrioQueue = NULL;
         }
 
-        if (self->masterConnections[i]->highPrioQueue) {
-            HighPriorityASDUQueue_destroy(self->masterConnections[i]->highPrioQueue);
-            self->masterConnections[i]->highPrioQueue = NULL;
+        if (con->highPrioQueue) {
+            HighPriorityASDUQueue_destroy(con->highPrioQueue);
+            con->highPrioQueue = NULL;
         }
     }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+    Semaphore_post(self->openConnectionsLock);
+#endif
 }
 #endif /* (CONFIG_CS104_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1) */
 
@@ -1282,14 +1356,6 @@ createSlave(int maxLowPrioQueueSize, int maxHighPrioQueueSize)
         self->maxLowPrioQueueSize = maxLowPrioQueueSize;
         self->maxHighPrioQueueSize = maxHighPrioQueueSize;
 
-        {
-            int i;
-
-            for (i = 0; i < CONFIG_CS104_MAX_CLIENT_CONNECTIONS; i++) {
-                self->masterConnections[i] = MasterConnection_create(self);
-            }
-        }
-
         self->maxOpenConnections = CONFIG_CS104_MAX_CLIENT_CONNECTIONS;
 #if (CONFIG_USE_SEMAPHORES == 1)
         self->openConnectionsLock = Semaphore_create(1);
@@ -1304,6 +1370,8 @@ createSlave(int maxLowPrioQueueSize, int maxHighPrioQueueSize)
         self->stopRunning = false;
 
         self->localAddress = NULL;
+        self->localUnixPath = NULL;
+        self->useUnixSocket = false;
         self->tcpPort = CS104_DEFAULT_PORT;
         self->openConnections = 0;
 
@@ -1315,6 +1383,10 @@ createSlave(int maxLowPrioQueueSize, int maxHighPrioQueueSize)
 
         self->plugins = NULL;
 
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+        self->latencyStatistics = false;
+#endif
+
 #if (CONFIG_CS104_SUPPORT_TLS == 1)
         self->tlsConfig = NULL;
 #endif
@@ -1350,6 +1422,8 @@ CS104_Slave_createSecure(int maxLowPrioQueueSize, int maxHighPrioQueueSize, TLSC
     if (self != NULL) {
         self->tcpPort = 19998;
         self->tlsConfig = tlsConfig;
+
+        lib60870_updateTLSDebugHandler();
     }
 
     return self;
@@ -1384,6 +1458,30 @@ CS104_Slave_setLocalAddress(CS104_Slave self, const char* ipAddress)
         strcpy(self->localAddress, ipAddress);
 }
 
+bool
+CS104_Slave_setLocalUnixPath(CS104_Slave self, const char* path)
+{
+    if (self->localUnixPath)
+        GLOBAL_FREEMEM(self->localUnixPath);
+
+    self->localUnixPath = NULL;
+
+    self->useUnixSocket = (path != NULL);
+
+    if (path) {
+        self->localUnixPath = (char*) GLOBAL_MALLOC(strlen(path) + 1);
+
+        if (self->localUnixPath == NULL) {
+            DEBUG_PRINT("CS104 SLAVE: Failed to allocate memory for the unix socket path\n");
+            return false;
+        }
+
+        strcpy(self->localUnixPath, path);
+    }
+
+    return true;
+}
+
 void
 CS104_Slave_setLocalPort(CS104_Slave self, int tcpPort)
 {
@@ -1408,6 +1506,196 @@ CS104_Slave_getOpenConnections(CS104_Slave self)
     return openConnections;
 }
 
+static void
+MasterConnection_getStatistics(MasterConnection self, CS104_ConnectionStatistics stats);
+
+int
+CS104_Slave_getStatistics(CS104_Slave self, CS104_ConnectionStatistics stats, int maxEntries)
+{
+    int count = 0;
+    int i;
+
+    for (i = 0; i < CONFIG_CS104_MAX_CLIENT_CONNECTIONS; i++) {
+
+        if (count >= maxEntries)
+            break;
+
+        MasterConnection con = LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->masterConnections[i]));
+
+        if (con) {
+            if (LIB60870_ATOMIC_LOAD(&(con->statistics.connectionId)) != 0) {
+
+                MasterConnection_getStatistics(con, &(stats[count]));
+
+                /* connection can be closed in the meantime */
+                if (stats[count].connectionId != 0)
+                    count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+void
+CS104_Slave_setLatencyStatisticsEnabled(CS104_Slave self, bool enabled)
+{
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    self->latencyStatistics = enabled;
+#else
+    UNUSED_PARAMETER(self);
+    UNUSED_PARAMETER(enabled);
+#endif
+}
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+/**
+ * Find an open connection with latency histograms. When a connection is found
+ * sentASDUsLock is locked and has to be released by the caller.
+ */
+static MasterConnection
+getConnectionWithLatencyHistograms(CS104_Slave self, uint32_t connectionId)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_CS104_MAX_CLIENT_CONNECTIONS; i++) {
+
+        MasterConnection con = LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->masterConnections[i]));
+
+        if (con && (LIB60870_ATOMIC_LOAD(&(con->statistics.connectionId)) == connectionId)) {
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+            Semaphore_wait(con->sentASDUsLock);
+#endif
+
+            if (con->latencyHistograms)
+                return con;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+            Semaphore_post(con->sentASDUsLock);
+#endif
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+#endif /* (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1) */
+
+bool
+CS104_Slave_getLatencyStatistics(CS104_Slave self, uint32_t connectionId, CS104_LatencyType type, CS104_LatencyStatistics stats)
+{
+    bool retVal = false;
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    if ((connectionId != 0) && (type >= CS104_LATENCY_QUEUEING) && (type <= CS104_LATENCY_TOTAL)) {
+
+        MasterConnection con = getConnectionWithLatencyHistograms(self, connectionId);
+
+        if (con) {
+            CS104_LatencyHistogram_getSummary(&(con->latencyHistograms[type]), stats);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+            Semaphore_post(con->sentASDUsLock);
+#endif
+            retVal = true;
+        }
+    }
+#else
+    UNUSED_PARAMETER(self);
+    UNUSED_PARAMETER(connectionId);
+    UNUSED_PARAMETER(type);
+    UNUSED_PARAMETER(stats);
+#endif
+
+    return retVal;
+}
+
+bool
+CS104_Slave_getLatencyPercentile(CS104_Slave self, uint32_t connectionId, CS104_LatencyType type, double percentile, uint64_t* value)
+{
+    bool retVal = false;
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    if ((connectionId != 0) && (type >= CS104_LATENCY_QUEUEING) && (type <= CS104_LATENCY_TOTAL)) {
+
+        MasterConnection con = getConnectionWithLatencyHistograms(self, connectionId);
+
+        if (con) {
+            *value = CS104_LatencyHistogram_getPercentile(&(con->latencyHistograms[type]), percentile);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+            Semaphore_post(con->sentASDUsLock);
+#endif
+            retVal = true;
+        }
+    }
+#else
+    UNUSED_PARAMETER(self);
+    UNUSED_PARAMETER(connectionId);
+    UNUSED_PARAMETER(type);
+    UNUSED_PARAMETER(percentile);
+    UNUSED_PARAMETER(value);
+#endif
+
+    return retVal;
+}
+
+void
+CS104_Slave_resetLatencyStatistics(CS104_Slave self, uint32_t connectionId)
+{
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    int i;
+
+    for (i = 0; i < CONFIG_CS104_MAX_CLIENT_CONNECTIONS; i++) {
+
+        MasterConnection con = LIB60870_ATOMIC_LOAD_ACQUIRE(&(self->masterConnections[i]));
+
+        if (con == NULL)
+            continue;
+
+        uint32_t conId = LIB60870_ATOMIC_LOAD(&(con->statistics.connectionId));
+
+        if ((conId == 0) || ((connectionId != 0) && (conId != connectionId)))
+            continue;
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_wait(con->sentASDUsLock);
+#endif
+
+        if (con->latencyHistograms) {
+            int j;
+
+            for (j = 0; j < 3; j++)
+                CS104_LatencyHistogram_reset(&(con->latencyHistograms[j]));
+        }
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+        Semaphore_post(con->sentASDUsLock);
+#endif
+    }
+#else
+    UNUSED_PARAMETER(self);
+    UNUSED_PARAMETER(connectionId);
+#endif
+}
+
+/* create a new connection object (has to be called with openConnectionsLock) */
+static MasterConnection
+createConnectionSpecificObjects(CS104_Slave self)
+{
+    MasterConnection con = MasterConnection_create(self);
+
+#if (CONFIG_CS104_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
+    if (con && (self->serverMode == CS104_MODE_CONNECTION_IS_REDUNDANCY_GROUP) && self->connectionSpecificQueues) {
+        con->lowPrioQueue = MessageQueue_create(self->maxLowPrioQueueSize);
+        con->highPrioQueue = HighPriorityASDUQueue_create(self->maxHighPrioQueueSize);
+    }
+#endif
+
+    return con;
+}
+
 static MasterConnection
 getFreeConnection(CS104_Slave self)
 {
@@ -1419,21 +1707,29 @@ getFreeConnection(CS104_Slave self)
     {
         MasterConnection con = self->masterConnections[i];
 
-        if (con) {
+        if (con == NULL) {
+            /* connection objects are created when they are needed for the first time */
+            con = createConnectionSpecificObjects(self);
+
+            if (con == NULL)
+                break;
+
+            LIB60870_ATOMIC_STORE_RELEASE(&(self->masterConnections[i]), con);
+        }
+
 #if (CONFIG_USE_SEMAPHORES)
-            Semaphore_wait(con->stateLock);
+        Semaphore_wait(con->stateLock);
 #endif
 
-            if (con->isUsed == false) {
-                connection = con;
-                connection->isUsed = true;
-            }
+        if (con->isUsed == false) {
+            connection = con;
+            connection->isUsed = true;
+        }
 
 #if (CONFIG_USE_SEMAPHORES)
-            Semaphore_post(con->stateLock);
+        Semaphore_post(con->stateLock);
 #endif
-        }
-        
+
         if (connection)
             break;
     }
@@ -1679,6 +1975,9 @@ receiveMessage(MasterConnection self)
 
         if (readCnt == remainingLength) {
             self->recvBufPos = 0;
+
+            LIB60870_TRACE3(cs104_slave_frame_recv, self->statistics.connectionId, length + 2, buffer[2]);
+
             return length + 2;
         }
         else if (readCnt == -1) {
@@ -1695,6 +1994,24 @@ receiveMessage(MasterConnection self)
     return 0;
 }
 
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+static uint64_t
+getTimeInUs(void)
+{
+    return Hal_getTimeInNs() / 1000;
+}
+
+static void
+recordAckLatency(MasterConnection self, SentASDUSlave* sentASDU, uint64_t ackTimeUs)
+{
+    if (ackTimeUs >= sentASDU->sentTimeUs)
+        CS104_LatencyHistogram_record(&(self->latencyHistograms[CS104_LATENCY_WIRE_TO_ACK]), ackTimeUs - sentASDU->sentTimeUs);
+
+    if ((sentASDU->enqueueTime != 0) && (ackTimeUs >= sentASDU->enqueueTime))
+        CS104_LatencyHistogram_record(&(self->latencyHistograms[CS104_LATENCY_TOTAL]), ackTimeUs - sentASDU->enqueueTime);
+}
+#endif /* (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1) */
+
 static int
 writeToSocket(MasterConnection self, uint8_t* buf, int size)
 {
@@ -1702,6 +2019,8 @@ writeToSocket(MasterConnection self, uint8_t* buf, int size)
         self->slave->rawMessageHandler(self->slave->rawMessageHandlerParameter,
                 &(self->iMasterConnection), buf, size, true);
 
+    CS104_ConnectionStatistics_frameSent(&(self->statistics), buf, size);
+
 #if (CONFIG_CS104_SUPPORT_TLS == 1)
     if (self->tlsSocket)
         return TLSSocket_write(self->tlsSocket, buf, size);
@@ -1730,6 +2049,9 @@ sendIMessage(MasterConnection self, uint8_t* buffer, int msgSize)
 
     if (writeToSocket(self, buffer, msgSize) > 0) {
         DEBUG_PRINT("CS104 SLAVE: SEND I (size = %i) N(S) = %i N(R) = %i\n", msgSize, self->sendCount, self->receiveCount);
+
+        LIB60870_TRACE4(cs104_slave_send, self->statistics.connectionId, self->sendCount, self->receiveCount, msgSize);
+
         self->sendCount = (self->sendCount + 1) % 32768;
         self->unconfirmedReceivedIMessages = 0;
         self->timeoutT2Triggered = false;
@@ -1763,6 +2085,15 @@ isSentBufferFull(MasterConnection self)
         return false;
 }
 
+static int
+getSentBufferSize(MasterConnection self)
+{
+    /* locking of k-buffer has to be done by caller! */
+    if (self->oldestSentASDU == -1)
+        return 0;
+
+    return ((self->newestSentASDU - self->oldestSentASDU + self->maxSentASDUs) % self->maxSentASDUs) + 1;
+}
 
 static void
 sendASDU(MasterConnection self, uint8_t* buffer, int msgSize, uint64_t entryId, uint8_t* queueEntry)
@@ -1782,8 +2113,31 @@ sendASDU(MasterConnection self, uint8_t* buffer, int msgSize, uint64_t entryId,
     self->sentASDUs[currentIndex].seqNo = sendIMessage(self, buffer, msgSize);
     self->sentASDUs[currentIndex].sentTime = Hal_getTimeInMs();
 
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    if (self->latencyHistograms) {
+        uint64_t sentTimeUs = getTimeInUs();
+        uint64_t enqueueTime = 0;
+
+        if (queueEntry) {
+            struct sMessageQueueEntryInfo entryInfo;
+
+            memcpy(&entryInfo, queueEntry, sizeof(struct sMessageQueueEntryInfo));
+
+            enqueueTime = entryInfo.enqueueTime;
+
+            if ((enqueueTime != 0) && (sentTimeUs >= enqueueTime))
+                CS104_LatencyHistogram_record(&(self->latencyHistograms[CS104_LATENCY_QUEUEING]), sentTimeUs - enqueueTime);
+        }
+
+        self->sentASDUs[currentIndex].enqueueTime = enqueueTime;
+        self->sentASDUs[currentIndex].sentTimeUs = sentTimeUs;
+    }
+#endif /* (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1) */
+
     self->newestSentASDU = currentIndex;
 
+    CS104_ConnectionStatistics_setKWindow(&(self->statistics), getSentBufferSize(self), true);
+
     printSendBuffer(self);
 }
 
@@ -1823,6 +2177,9 @@ sendASDUInternal(MasterConnection self, CS101_ASDU asdu)
             Semaphore_post(self->sentASDUsLock);
 #endif
             asduSent = HighPriorityASDUQueue_enqueue(self->highPrioQueue, asdu);
+
+            if (asduSent == false)
+                CS104_STATISTICS_INC(&(self->statistics), highPrioQueueRejected);
         }
 
     }
@@ -1859,6 +2216,8 @@ handleASDU(MasterConnection self, CS101_ASDU asdu)
 
     CS104_Slave slave = self->slave;
 
+    LIB60870_TRACE4(cs104_slave_handle_asdu, self->statistics.connectionId, asdu->asdu[0], asdu->asdu[2] & 0x3f, asdu->asdu[1] & 0x7f);
+
     /* call plugins */
     if (slave->plugins) {
         LinkedList pluginElem = LinkedList_getNext(slave->plugins);
@@ -2156,6 +2515,15 @@ checkSequenceNumber(MasterConnection self, int seqNo)
     if (seqNoIsValid) {
         if (self->oldestSentASDU != -1) {
 
+            uint64_t currentTime = Hal_getTimeInMs();
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+            uint64_t ackTimeUs = 0;
+
+            if (self->latencyHistograms)
+                ackTimeUs = getTimeInUs();
+#endif
+
             do {
                 int oldestAsduSeqNo = self->sentASDUs[self->oldestSentASDU].seqNo;
 
@@ -2167,6 +2535,14 @@ checkSequenceNumber(MasterConnection self, int seqNo)
                 if (seqNo == oldestValidSeqNo)
                     break;
 
+                CS104_ConnectionStatistics_addAck(&(self->statistics),
+                        self->sentASDUs[self->oldestSentASDU].sentTime, currentTime);
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+                if (self->latencyHistograms)
+                    recordAckLatency(self, &(self->sentASDUs[self->oldestSentASDU]), ackTimeUs);
+#endif
+
                 /* remove from server (low-priority) queue if required */
                 if (self->sentASDUs[self->oldestSentASDU].queueEntry != NULL) {
 
@@ -2204,7 +2580,11 @@ checkSequenceNumber(MasterConnection self, int seqNo)
                 }
 
             } while (true);
+
+            CS104_ConnectionStatistics_setKWindow(&(self->statistics), getSentBufferSize(self), false);
         }
+
+        LIB60870_TRACE3(cs104_slave_ack, self->statistics.connectionId, seqNo, self->statistics.kWindow);
     }
     else
         DEBUG_PRINT("CS104 SLAVE: Received sequence number out of range");
@@ -2358,6 +2738,8 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
 {
     uint64_t currentTime = Hal_getTimeInMs();
 
+    CS104_ConnectionStatistics_frameReceived(&(self->statistics), buffer, msgSize);
+
     if (msgSize >= 3) {
 
         if (buffer[0] != 0x68) {
@@ -2372,6 +2754,12 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
             return false;
         }
 
+        /* the control field is only complete when the APDU has the minimum size */
+        if (msgSize >= 6) {
+            LIB60870_TRACE5(cs104_slave_handle_message, self->statistics.connectionId, LIB60870_TRACE_FRAME_TYPE(buffer[2]),
+                    msgSize, ((buffer[2] & 0xfe) / 2) + (buffer[3] * 128), ((buffer[4] & 0xfe) / 2) + (buffer[5] * 128));
+        }
+
         if ((buffer[2] & 1) == 0) { /* I message */
 
             if (msgSize < 7) {
@@ -2427,13 +2815,13 @@ handleMessage(MasterConnection self, uint8_t* buffer, int msgSize)
 
             if (MasterConnection_isActive(self)) {
 
-                CS101_ASDU asdu = CS101_ASDU_createFromBuffer(&(self->slave->alParameters), buffer + 6, msgSize - 6);
+                sCS101_ASDUView _asdu;
+
+                CS101_ASDU asdu = CS101_ASDU_initializeView(&_asdu, &(self->slave->alParameters), buffer + 6, msgSize - 6);
 
                 if (asdu) {
                     bool validAsdu = handleASDU(self, asdu);
 
-                    CS101_ASDU_destroy(asdu);
-
                     if (validAsdu == false) {
                         DEBUG_PRINT("CS104 SLAVE: ASDU corrupted");
                         return false;
@@ -2549,10 +2937,14 @@ MasterConnection_deinit(MasterConnection self)
 #endif
 
         if (self->socket) {
+            if (self->slave->socketPoller)
+                SocketPoller_removeSocket(self->slave->socketPoller, self->socket);
+
             Socket_destroy(self->socket);
             self->socket = NULL;
         }
 
+        LIB60870_ATOMIC_STORE(&(self->statistics.connectionId), 0);
     }
 }
 
@@ -2563,6 +2955,11 @@ MasterConnection_destroy(MasterConnection self)
 
         GLOBAL_FREEMEM(self->sentASDUs);
 
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+        if (self->latencyHistograms)
+            GLOBAL_FREEMEM(self->latencyHistograms);
+#endif
+
 #if (CONFIG_USE_SEMAPHORES == 1)
         Semaphore_destroy(self->sentASDUsLock);
         Semaphore_destroy(self->stateLock);
@@ -2695,6 +3092,11 @@ handleTimeouts(MasterConnection self)
 
     /* check T3 timeout */
     if (checkT3Timeout(self, currentTime)) {
+
+        CS104_STATISTICS_INC(&(self->statistics), t3Timeouts);
+
+        LIB60870_TRACE2(cs104_slave_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T3);
+
         if (writeToSocket(self, TESTFR_ACT_MSG, TESTFR_ACT_MSG_SIZE) < 0) {
 
             DEBUG_PRINT("CS104 SLAVE: Failed to write TESTFR ACT message\n");
@@ -2729,6 +3131,10 @@ handleTimeouts(MasterConnection self)
         if (checkTestFRConTimeout(self, currentTime)) {
             DEBUG_PRINT("CS104 SLAVE: Timeout for TESTFR CON message\n");
 
+            CS104_STATISTICS_INC(&(self->statistics), t1Timeouts);
+
+            LIB60870_TRACE2(cs104_slave_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T1);
+
             /* close connection */
             timeoutsOk = false;
         }
@@ -2745,6 +3151,9 @@ handleTimeouts(MasterConnection self)
 
         if (currentTime > self->lastConfirmationTime) {
             if ((currentTime - self->lastConfirmationTime) >= (uint64_t) (self->slave->conParameters.t2 * 1000)) {
+
+                LIB60870_TRACE2(cs104_slave_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T2);
+
                 self->lastConfirmationTime = currentTime;
                 self->unconfirmedReceivedIMessages = 0;
                 self->timeoutT2Triggered = false;
@@ -2776,6 +3185,10 @@ handleTimeouts(MasterConnection self)
             if ((currentTime - self->sentASDUs[self->oldestSentASDU].sentTime) >= (uint64_t) (self->slave->conParameters.t1 * 1000)) {
                 timeoutsOk = false;
 
+                CS104_STATISTICS_INC(&(self->statistics), t1Timeouts);
+
+                LIB60870_TRACE2(cs104_slave_timeout, self->statistics.connectionId, LIB60870_TRACE_TIMEOUT_T1);
+
                 printSendBuffer(self);
 
                 DEBUG_PRINT("CS104 SLAVE: I message timeout for %i seqNo: %i\n", self->oldestSentASDU,
@@ -2825,6 +3238,8 @@ connectionHandlingThread(void* parameter)
 
     bool isAsduWaiting = false;
 
+    LIB60870_TRACE2(cs104_slave_state, self->statistics.connectionId, CS104_CON_EVENT_CONNECTION_OPENED);
+
     if (self->slave->connectionEventHandler) {
         self->slave->connectionEventHandler(self->slave->connectionEventHandlerParameter, &(self->iMasterConnection), CS104_CON_EVENT_CONNECTION_OPENED);
     }
@@ -2920,6 +3335,8 @@ connectionHandlingThread(void* parameter)
         }
     }
 
+    LIB60870_TRACE2(cs104_slave_state, self->statistics.connectionId, CS104_CON_EVENT_CONNECTION_CLOSED);
+
     if (self->slave->connectionEventHandler) {
         self->slave->connectionEventHandler(self->slave->connectionEventHandlerParameter, &(self->iMasterConnection), CS104_CON_EVENT_CONNECTION_CLOSED);
     }
@@ -3029,6 +3446,26 @@ _IMasterConnection_getApplicationLayerParameters(IMasterConnection self)
     return &(con->slave->alParameters);
 }
 
+static void
+MasterConnection_getStatistics(MasterConnection self, CS104_ConnectionStatistics stats)
+{
+    CS104_ConnectionStatistics_getSnapshot(&(self->statistics), stats);
+
+    /* the entry counter is changed under the queue lock - the queue is shared in single redundancy group mode */
+    if (self->lowPrioQueue)
+        stats->lowPrioQueueEntries = (uint32_t) MessageQueue_getEntryCount(self->lowPrioQueue);
+}
+
+static bool
+_IMasterConnection_getStatistics(IMasterConnection self, CS104_ConnectionStatistics stats)
+{
+    MasterConnection con = (MasterConnection) self->object;
+
+    MasterConnection_getStatistics(con, stats);
+
+    return true;
+}
+
 /********************************************
  * END IMasterConnection
  *******************************************/
@@ -3052,6 +3489,7 @@ MasterConnection_create(CS104_Slave slave)
         self->iMasterConnection.sendACT_TERM = _IMasterConnection_sendACT_TERM;
         self->iMasterConnection.close = _IMasterConnection_close;
         self->iMasterConnection.getPeerAddress = _IMasterConnection_getPeerAddress;
+        self->iMasterConnection.getStatistics = _IMasterConnection_getStatistics;
 
 #if (CONFIG_USE_THREADS == 1) 
         self->connectionThread = NULL;
@@ -3074,6 +3512,10 @@ MasterConnection_create(CS104_Slave slave)
 #endif
         self->lowPrioQueue = NULL;
         self->highPrioQueue = NULL;
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+        self->latencyHistograms = NULL;
+#endif
     }
 
     return self;
@@ -3083,6 +3525,28 @@ static bool
 MasterConnection_init(MasterConnection self, Socket skt, MessageQueue lowPrioQueue, HighPriorityASDUQueue highPrioQueue)
 {
     if (self) {
+        /* connections are only accepted by a single thread -> no locking required */
+        self->slave->connectionIdCounter++;
+
+        if (self->slave->connectionIdCounter == 0)
+            self->slave->connectionIdCounter = 1;
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+        if (self->slave->latencyStatistics) {
+            if (self->latencyHistograms == NULL)
+                self->latencyHistograms = (CS104_LatencyHistogram) GLOBAL_MALLOC(3 * sizeof(struct sCS104_LatencyHistogram));
+        }
+
+        if (self->latencyHistograms) {
+            int i;
+
+            for (i = 0; i < 3; i++)
+                CS104_LatencyHistogram_reset(&(self->latencyHistograms[i]));
+        }
+#endif /* (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1) */
+
+        CS104_ConnectionStatistics_reset(&(self->statistics), self->slave->connectionIdCounter);
+
         self->socket = skt;
         self->isActive = false;
         self->isRunning = false;
@@ -3195,6 +3659,9 @@ MasterConnection_deactivate(MasterConnection self)
 
     if (self->isUsed) {
         if (self->isActive == true) {
+
+            LIB60870_TRACE2(cs104_slave_state, self->statistics.connectionId, CS104_CON_EVENT_DEACTIVATED);
+
             if (self->slave->connectionEventHandler) {
                  self->slave->connectionEventHandler(self->slave->connectionEventHandlerParameter, &(self->iMasterConnection), CS104_CON_EVENT_DEACTIVATED);
             }
@@ -3216,6 +3683,9 @@ MasterConnection_activate(MasterConnection self)
 #endif /* (CONFIG_USE_SEMAPHORES == 1) */
 
     if (self->isActive == false) {
+
+        LIB60870_TRACE2(cs104_slave_state, self->statistics.connectionId, CS104_CON_EVENT_ACTIVATED);
+
         if (self->slave->connectionEventHandler) {
              self->slave->connectionEventHandler(self->slave->connectionEventHandlerParameter, &(self->iMasterConnection), CS104_CON_EVENT_ACTIVATED);
         }
@@ -3261,11 +3731,32 @@ MasterConnection_handleTcpConnection(MasterConnection self)
     }
 }
 
+/* send waiting ASDUs until no more ASDUs can be sent (queues empty or k window full) */
+static void
+sendAllWaitingASDUs(MasterConnection self)
+{
+    while (MasterConnection_isRunning(self)) {
+        uint64_t sentIFrames = LIB60870_ATOMIC_LOAD(&(self->statistics.sentIFrames));
+
+        if (sendWaitingASDUs(self) == false)
+            break;
+
+        /* remaining ASDUs are already sent and wait for confirmation */
+        if (LIB60870_ATOMIC_LOAD(&(self->statistics.sentIFrames)) == sentIFrames)
+            break;
+    }
+}
+
 static void
 MasterConnection_executePeriodicTasks(MasterConnection self)
 {
-    if (self->isActive)
-        sendWaitingASDUs(self);
+    if (self->isActive) {
+        /* with a socket poller the slave is not called continuously -> don't send only one event per call */
+        if (self->slave->socketPoller)
+            sendAllWaitingASDUs(self);
+        else
+            sendWaitingASDUs(self);
+    }
 
     if (handleTimeouts(self) == false)
         self->isRunning = false;
@@ -3302,6 +3793,8 @@ handleClientConnections(CS104_Slave self)
                 }
                 else {
 
+                    LIB60870_TRACE2(cs104_slave_state, con->statistics.connectionId, CS104_CON_EVENT_CONNECTION_CLOSED);
+
                     if (self->connectionEventHandler) {
                        self->connectionEventHandler(self->connectionEventHandlerParameter, &(con->iMasterConnection), CS104_CON_EVENT_CONNECTION_CLOSED);
                     }
@@ -3324,7 +3817,10 @@ handleClientConnections(CS104_Slave self)
         /* handle incoming messages when available */
         if (handleset != NULL) {
 
-            if (Handleset_waitReady(handleset, 1)) {
+            /* with a socket poller the slave is only called when a socket is ready or for periodic tasks */
+            unsigned int waitTime = (self->socketPoller != NULL) ? 0 : 1;
+
+            if (Handleset_waitReady(handleset, waitTime)) {
 
                 for (i = 0; i < CONFIG_CS104_MAX_CLIENT_CONNECTIONS; i++) {
                     MasterConnection con = self->masterConnections[i];
@@ -3535,7 +4031,7 @@ handleConnectionsThreadless(CS104_Slave self)
                     connection = getFreeConnection(self);
 
 #if (CONFIG_CS104_SUPPORT_SERVER_MODE_CONNECTION_IS_REDUNDANCY_GROUP == 1)
-                    if (self->serverMode == CS104_MODE_CONNECTION_IS_REDUNDANCY_GROUP) {
+                    if (connection && (self->serverMode == CS104_MODE_CONNECTION_IS_REDUNDANCY_GROUP)) {
                         lowPrioQueue = connection->lowPrioQueue;
                         MessageQueue_initialize(lowPrioQueue);
 
@@ -3564,6 +4060,11 @@ handleConnectionsThreadless(CS104_Slave self)
 
                     connection->isRunning = true;
 
+                    if (self->socketPoller)
+                        SocketPoller_addSocket(self->socketPoller, connection->socket, SOCKET_POLLER_READ, self);
+
+                    LIB60870_TRACE2(cs104_slave_state, connection->statistics.connectionId, CS104_CON_EVENT_CONNECTION_OPENED);
+
                     if (self->connectionEventHandler) {
                         self->connectionEventHandler(self->connectionEventHandlerParameter, &(connection->iMasterConnection), CS104_CON_EVENT_CONNECTION_OPENED);
                     }
@@ -3584,6 +4085,38 @@ handleConnectionsThreadless(CS104_Slave self)
     handleClientConnections(self);
 }
 
+static ServerSocket
+createServerSocket(CS104_Slave self)
+{
+    if (self->useUnixSocket) {
+        /* don't fall back to TCP when the path could not be stored */
+        if (self->localUnixPath == NULL)
+            return NULL;
+
+        return UnixServerSocket_create(self->localUnixPath);
+    }
+
+    if (self->localAddress)
+        return TcpServerSocket_create(self->localAddress, self->tcpPort);
+    else
+        return TcpServerSocket_create("0.0.0.0", self->tcpPort);
+}
+
+/* allow many clients to connect at the same time (the default backlog of the server socket is very small) */
+static int
+getListenBacklog(CS104_Slave self)
+{
+    int backlog = CONFIG_CS104_MAX_CLIENT_CONNECTIONS;
+
+    if ((self->maxOpenConnections > 0) && (self->maxOpenConnections < backlog))
+        backlog = self->maxOpenConnections;
+
+    if (backlog < 2)
+        backlog = 2;
+
+    return backlog;
+}
+
 #if (CONFIG_USE_THREADS == 1)
 
 static void*
@@ -3591,10 +4124,7 @@ serverThread (void* parameter)
 {
     CS104_Slave self = (CS104_Slave) parameter;
 
-    if (self->localAddress)
-        self->serverSocket = TcpServerSocket_create(self->localAddress, self->tcpPort);
-    else
-        self->serverSocket = TcpServerSocket_create("0.0.0.0", self->tcpPort);
+    self->serverSocket = createServerSocket(self);
 
     if (self->serverSocket == NULL) {
         DEBUG_PRINT("CS104 SLAVE: Cannot create server socket\n");
@@ -3611,6 +4141,7 @@ serverThread (void* parameter)
         goto exit_function;
     }
 
+    ServerSocket_setBacklog(self->serverSocket, getListenBacklog(self));
     ServerSocket_listen(self->serverSocket);
 
 #if (CONFIG_USE_SEMAPHORES == 1)
@@ -3837,7 +4368,7 @@ serverThread (void* parameter)
     }
 
     if (self->serverSocket)
-        Socket_destroy((Socket) self->serverSocket);
+        ServerSocket_destroy(self->serverSocket);
 
 #if (CONFIG_USE_SEMAPHORES == 1)
     Semaphore_wait(self->stateLock);
@@ -3859,9 +4390,18 @@ exit_function:
 void
 CS104_Slave_enqueueASDU(CS104_Slave self, CS101_ASDU asdu)
 {
+    uint64_t enqueueTime = 0;
+
+    LIB60870_TRACE3(cs104_slave_enqueue, asdu->asdu[0], asdu->asdu[2] & 0x3f, asdu->asduHeaderLength + asdu->payloadSize);
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    if (self->latencyStatistics)
+        enqueueTime = getTimeInUs();
+#endif
+
 #if (CONFIG_CS104_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1)
     if (self->serverMode == CS104_MODE_SINGLE_REDUNDANCY_GROUP)
-        MessageQueue_enqueueASDU(self->asduQueue, asdu);
+        MessageQueue_enqueueASDU(self->asduQueue, asdu, enqueueTime);
 #endif /* (CONFIG_CS104_SUPPORT_SERVER_MODE_SINGLE_REDUNDANCY_GROUP == 1) */
 
 #if (CONFIG_CS104_SUPPORT_SERVER_MODE_MULTIPLE_REDUNDANCY_GROUPS == 1)
@@ -3878,7 +4418,7 @@ CS104_Slave_enqueueASDU(CS104_Slave self, CS101_ASDU asdu)
 
             CS104_RedundancyGroup group = (CS104_RedundancyGroup) LinkedList_getData(element);
 
-            MessageQueue_enqueueASDU(group->asduQueue, asdu);
+            MessageQueue_enqueueASDU(group->asduQueue, asdu, enqueueTime);
 
             element = LinkedList_getNext(element);
         }
@@ -3904,7 +4444,7 @@ CS104_Slave_enqueueASDU(CS104_Slave self, CS101_ASDU asdu)
             MasterConnection con = self->masterConnections[i];
 
             if (con)
-                MessageQueue_enqueueASDU(con->lowPrioQueue, asdu);
+                MessageQueue_enqueueASDU(con->lowPrioQueue, asdu, enqueueTime);
 
         }
 
@@ -3959,6 +4499,11 @@ CS104_Slave_start(CS104_Slave self)
 #if ((CONFIG_USE_THREADS == 1) && (CONFIG_USE_SEMAPHORES == 1))
     if (isRunning(self) == false) {
 
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+        /* the parameters are changed by the user with CS104_Slave_getAppLayerParameters */
+        CS101_AppLayerParameters_applyFixedProfile(&(self->alParameters));
+#endif
+
 #if (CONFIG_USE_SEMAPHORES == 1)
         Semaphore_wait(self->stateLock);
 #endif
@@ -4026,6 +4571,10 @@ CS104_Slave_startThreadless(CS104_Slave self)
 {
     if (isRunning(self) == false) {
 
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+        CS101_AppLayerParameters_applyFixedProfile(&(self->alParameters));
+#endif
+
 #if (CONFIG_USE_THREADS == 1)
         self->isThreadlessMode = true;
 #endif
@@ -4045,10 +4594,7 @@ CS104_Slave_startThreadless(CS104_Slave self)
             initializeConnectionSpecificQueues(self);
 #endif
 
-        if (self->localAddress)
-            self->serverSocket = TcpServerSocket_create(self->localAddress, self->tcpPort);
-        else
-            self->serverSocket = TcpServerSocket_create("0.0.0.0", self->tcpPort);
+        self->serverSocket = createServerSocket(self);
 
         if (self->serverSocket == NULL) {
             DEBUG_PRINT("CS104 SLAVE: Cannot create server socket\n");
@@ -4066,8 +4612,12 @@ CS104_Slave_startThreadless(CS104_Slave self)
             goto exit_function;
         }
 
+        ServerSocket_setBacklog(self->serverSocket, getListenBacklog(self));
         ServerSocket_listen(self->serverSocket);
 
+        if (self->socketPoller)
+            SocketPoller_addSocket(self->socketPoller, (Socket) self->serverSocket, SOCKET_POLLER_READ, self);
+
 #if (CONFIG_USE_SEMAPHORES == 1)
         Semaphore_wait(self->stateLock);
 #endif
@@ -4089,6 +4639,9 @@ CS104_Slave_stopThreadless(CS104_Slave self)
     self->isRunning = false;
 
     if (self->serverSocket) {
+        if (self->socketPoller)
+            SocketPoller_removeSocket(self->socketPoller, (Socket) self->serverSocket);
+
         ServerSocket_destroy(self->serverSocket);
         self->serverSocket = NULL;
     }
@@ -4108,6 +4661,12 @@ CS104_Slave_tick(CS104_Slave self)
     handleConnectionsThreadless(self);
 }
 
+void
+CS104_Slave_setSocketPoller(CS104_Slave self, SocketPoller poller)
+{
+    self->socketPoller = poller;
+}
+
 
 bool
 CS104_Slave_isRunning(CS104_Slave self)
@@ -4226,6 +4785,9 @@ CS104_Slave_destroy(CS104_Slave self)
         if (self->localAddress != NULL)
             GLOBAL_FREEMEM(self->localAddress);
 
+        if (self->localUnixPath != NULL)
+            GLOBAL_FREEMEM(self->localUnixPath);
+
 #if (CONFIG_USE_SEMAPHORES == 1)
         Semaphore_destroy(self->openConnectionsLock);
         Semaphore_destroy(self->stateLock);
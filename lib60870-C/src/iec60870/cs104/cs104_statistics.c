@@ -0,0 +1,268 @@
+/*
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <string.h>
+
+#include "cs104_statistics.h"
+#include "lib60870_internal.h"
+
+/* the counters can be updated by different threads (e.g. the receiving thread and an application thread that sends ASDUs) */
+static void
+updateMaximum(uint32_t* maximum, uint32_t value)
+{
+    uint32_t current = LIB60870_ATOMIC_LOAD(maximum);
+
+    while (value > current) {
+        if (LIB60870_ATOMIC_CAS(maximum, &current, value))
+            break;
+    }
+}
+
+void
+CS104_ConnectionStatistics_reset(CS104_ConnectionStatistics self, uint32_t connectionId)
+{
+    LIB60870_ATOMIC_STORE(&(self->connectionId), 0);
+
+    LIB60870_ATOMIC_STORE(&(self->sentIFrames), 0);
+    LIB60870_ATOMIC_STORE(&(self->sentSFrames), 0);
+    LIB60870_ATOMIC_STORE(&(self->sentUFrames), 0);
+    LIB60870_ATOMIC_STORE(&(self->rcvdIFrames), 0);
+    LIB60870_ATOMIC_STORE(&(self->rcvdSFrames), 0);
+    LIB60870_ATOMIC_STORE(&(self->rcvdUFrames), 0);
+    LIB60870_ATOMIC_STORE(&(self->sentBytes), 0);
+    LIB60870_ATOMIC_STORE(&(self->rcvdBytes), 0);
+
+    LIB60870_ATOMIC_STORE(&(self->kWindow), 0);
+    LIB60870_ATOMIC_STORE(&(self->kWindowMax), 0);
+    LIB60870_ATOMIC_STORE(&(self->kWindowSum), 0);
+
+    LIB60870_ATOMIC_STORE(&(self->ackCount), 0);
+    LIB60870_ATOMIC_STORE(&(self->ackRttSum), 0);
+    LIB60870_ATOMIC_STORE(&(self->ackRttMax), 0);
+    LIB60870_ATOMIC_STORE(&(self->ackRttLast), 0);
+
+    LIB60870_ATOMIC_STORE(&(self->t1Timeouts), 0);
+    LIB60870_ATOMIC_STORE(&(self->t3Timeouts), 0);
+
+    LIB60870_ATOMIC_STORE(&(self->highPrioQueueRejected), 0);
+    LIB60870_ATOMIC_STORE(&(self->lowPrioQueueEntries), 0);
+
+    LIB60870_ATOMIC_STORE(&(self->connectionId), connectionId);
+}
+
+void
+CS104_ConnectionStatistics_frameSent(CS104_ConnectionStatistics self, const uint8_t* msg, int msgSize)
+{
+    if (msgSize < IEC60870_5_104_APCI_LENGTH)
+        return;
+
+    if ((msg[2] & 1) == 0)
+        CS104_STATISTICS_INC(self, sentIFrames);
+    else if (msg[2] == 0x01)
+        CS104_STATISTICS_INC(self, sentSFrames);
+    else
+        CS104_STATISTICS_INC(self, sentUFrames);
+
+    LIB60870_ATOMIC_ADD(&(self->sentBytes), (uint64_t) msgSize);
+}
+
+void
+CS104_ConnectionStatistics_frameReceived(CS104_ConnectionStatistics self, const uint8_t* msg, int msgSize)
+{
+    if (msgSize < IEC60870_5_104_APCI_LENGTH)
+        return;
+
+    if ((msg[2] & 1) == 0)
+        CS104_STATISTICS_INC(self, rcvdIFrames);
+    else if (msg[2] == 0x01)
+        CS104_STATISTICS_INC(self, rcvdSFrames);
+    else
+        CS104_STATISTICS_INC(self, rcvdUFrames);
+
+    LIB60870_ATOMIC_ADD(&(self->rcvdBytes), (uint64_t) msgSize);
+}
+
+void
+CS104_ConnectionStatistics_setKWindow(CS104_ConnectionStatistics self, int kWindow, bool iFrameSent)
+{
+    uint32_t value = (uint32_t) kWindow;
+
+    LIB60870_ATOMIC_STORE(&(self->kWindow), value);
+
+    updateMaximum(&(self->kWindowMax), value);
+
+    if (iFrameSent)
+        LIB60870_ATOMIC_ADD(&(self->kWindowSum), (uint64_t) value);
+}
+
+void
+CS104_ConnectionStatistics_addAck(CS104_ConnectionStatistics self, uint64_t sentTime, uint64_t ackTime)
+{
+    uint32_t rtt = 0;
+
+    /* ignore negative values caused by clock adjustments */
+    if (ackTime > sentTime) {
+        uint64_t rttInMs = ackTime - sentTime;
+
+        rtt = (rttInMs > 0xffffffffULL) ? 0xffffffffU : (uint32_t) rttInMs;
+    }
+
+    CS104_STATISTICS_INC(self, ackCount);
+    LIB60870_ATOMIC_ADD(&(self->ackRttSum), (uint64_t) rtt);
+    LIB60870_ATOMIC_STORE(&(self->ackRttLast), rtt);
+
+    updateMaximum(&(self->ackRttMax), rtt);
+}
+
+void
+CS104_ConnectionStatistics_getSnapshot(CS104_ConnectionStatistics self, CS104_ConnectionStatistics snapshot)
+{
+    snapshot->connectionId = LIB60870_ATOMIC_LOAD(&(self->connectionId));
+
+    snapshot->sentIFrames = LIB60870_ATOMIC_LOAD(&(self->sentIFrames));
+    snapshot->sentSFrames = LIB60870_ATOMIC_LOAD(&(self->sentSFrames));
+    snapshot->sentUFrames = LIB60870_ATOMIC_LOAD(&(self->sentUFrames));
+    snapshot->rcvdIFrames = LIB60870_ATOMIC_LOAD(&(self->rcvdIFrames));
+    snapshot->rcvdSFrames = LIB60870_ATOMIC_LOAD(&(self->rcvdSFrames));
+    snapshot->rcvdUFrames = LIB60870_ATOMIC_LOAD(&(self->rcvdUFrames));
+    snapshot->sentBytes = LIB60870_ATOMIC_LOAD(&(self->sentBytes));
+    snapshot->rcvdBytes = LIB60870_ATOMIC_LOAD(&(self->rcvdBytes));
+
+    snapshot->kWindow = LIB60870_ATOMIC_LOAD(&(self->kWindow));
+    snapshot->kWindowMax = LIB60870_ATOMIC_LOAD(&(self->kWindowMax));
+    snapshot->kWindowSum = LIB60870_ATOMIC_LOAD(&(self->kWindowSum));
+
+    snapshot->ackCount = LIB60870_ATOMIC_LOAD(&(self->ackCount));
+    snapshot->ackRttSum = LIB60870_ATOMIC_LOAD(&(self->ackRttSum));
+    snapshot->ackRttMax = LIB60870_ATOMIC_LOAD(&(self->ackRttMax));
+    snapshot->ackRttLast = LIB60870_ATOMIC_LOAD(&(self->ackRttLast));
+
+    snapshot->t1Timeouts = LIB60870_ATOMIC_LOAD(&(self->t1Timeouts));
+    snapshot->t3Timeouts = LIB60870_ATOMIC_LOAD(&(self->t3Timeouts));
+
+    snapshot->highPrioQueueRejected = LIB60870_ATOMIC_LOAD(&(self->highPrioQueueRejected));
+    snapshot->lowPrioQueueEntries = LIB60870_ATOMIC_LOAD(&(self->lowPrioQueueEntries));
+}
+
+void
+CS104_LatencyHistogram_reset(CS104_LatencyHistogram self)
+{
+    memset(self, 0, sizeof(struct sCS104_LatencyHistogram));
+}
+
+static int
+getBucketIndex(uint64_t value)
+{
+    if (value > 0xffffffffULL)
+        value = 0xffffffffULL;
+
+    if (value < 2 * CS104_LATENCY_HISTOGRAM_SUB_BUCKETS)
+        return (int) value;
+
+    /* position of the most significant bit */
+    int msb = 0;
+    uint64_t tmp = value;
+
+    while (tmp > 1) {
+        tmp = tmp >> 1;
+        msb++;
+    }
+
+    int shift = msb - 4;
+
+    return (shift * CS104_LATENCY_HISTOGRAM_SUB_BUCKETS) + (int) (value >> shift);
+}
+
+static uint64_t
+getHighestEquivalentValue(int bucketIndex)
+{
+    if (bucketIndex < 2 * CS104_LATENCY_HISTOGRAM_SUB_BUCKETS)
+        return (uint64_t) bucketIndex;
+
+    int shift = (bucketIndex / CS104_LATENCY_HISTOGRAM_SUB_BUCKETS) - 1;
+    uint64_t subBucket = (uint64_t) ((bucketIndex % CS104_LATENCY_HISTOGRAM_SUB_BUCKETS) + CS104_LATENCY_HISTOGRAM_SUB_BUCKETS);
+
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void
+CS104_LatencyHistogram_record(CS104_LatencyHistogram self, uint64_t value)
+{
+    self->buckets[getBucketIndex(value)]++;
+
+    if ((self->count == 0) || (value < self->min))
+        self->min = value;
+
+    if (value > self->max)
+        self->max = value;
+
+    self->count++;
+    self->sum += value;
+}
+
+uint64_t
+CS104_LatencyHistogram_getPercentile(CS104_LatencyHistogram self, double percentile)
+{
+    if (self->count == 0)
+        return 0;
+
+    if (percentile < 0.0)
+        percentile = 0.0;
+    else if (percentile > 100.0)
+        percentile = 100.0;
+
+    uint64_t countAtPercentile = (uint64_t) (((percentile / 100.0) * (double) self->count) + 0.5);
+
+    if (countAtPercentile < 1)
+        countAtPercentile = 1;
+
+    uint64_t totalCount = 0;
+    int i;
+
+    for (i = 0; i < CS104_LATENCY_HISTOGRAM_BUCKETS; i++) {
+        totalCount += self->buckets[i];
+
+        if (totalCount >= countAtPercentile) {
+            uint64_t value = getHighestEquivalentValue(i);
+
+            /* don't report values outside of the recorded range */
+            if (value > self->max)
+                value = self->max;
+
+            return value;
+        }
+    }
+
+    return self->max;
+}
+
+void
+CS104_LatencyHistogram_getSummary(CS104_LatencyHistogram self, CS104_LatencyStatistics stats)
+{
+    stats->count = self->count;
+    stats->min = self->min;
+    stats->max = self->max;
+    stats->mean = (self->count > 0) ? (self->sum / self->count) : 0;
+    stats->p50 = CS104_LatencyHistogram_getPercentile(self, 50.0);
+    stats->p90 = CS104_LatencyHistogram_getPercentile(self, 90.0);
+    stats->p99 = CS104_LatencyHistogram_getPercentile(self, 99.0);
+    stats->p999 = CS104_LatencyHistogram_getPercentile(self, 99.9);
+}
@@ -0,0 +1,680 @@
+/*
+ *  lib60870_log.c
+ *
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "iec60870_common.h"
+#include "lib60870_internal.h"
+#include "lib60870_atomic.h"
+#include "hal_time.h"
+
+#if (CONFIG_CS104_SUPPORT_TLS == 1)
+#include "tls_socket.h"
+#endif
+
+#ifndef CONFIG_DEBUG_OUTPUT_BINARY_LOG
+#define CONFIG_DEBUG_OUTPUT_BINARY_LOG 0
+#endif
+
+#ifndef CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE
+#define CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE 1024
+#endif
+
+#if (CONFIG_DEBUG_OUTPUT == 1)
+#define DEFAULT_LOG_LEVEL LIB60870_LOG_LEVEL_DEBUG
+#else
+#define DEFAULT_LOG_LEVEL LIB60870_LOG_LEVEL_NONE
+#endif
+
+uint8_t lib60870_logLevels[LIB60870_LOG_SUBSYSTEM_COUNT] = {
+    DEFAULT_LOG_LEVEL, DEFAULT_LOG_LEVEL, DEFAULT_LOG_LEVEL,
+    DEFAULT_LOG_LEVEL, DEFAULT_LOG_LEVEL, DEFAULT_LOG_LEVEL
+};
+
+#if (CONFIG_CS104_SUPPORT_TLS == 1)
+/* forwards the debug messages of the TLS layer (HAL) to the log */
+static void
+tlsDebugHandler(void* parameter, const char* message)
+{
+    UNUSED_PARAMETER(parameter);
+
+    lib60870_log_record(LIB60870_LOG_TLS, LIB60870_LOG_LEVEL_DEBUG, "%s", message);
+}
+
+void
+lib60870_updateTLSDebugHandler(void)
+{
+#if (CONFIG_DEBUG_OUTPUT == 1)
+    if (Lib60870_getLogLevel(LIB60870_LOG_TLS) >= LIB60870_LOG_LEVEL_DEBUG) {
+        TLSSocket_setDebugHandler(tlsDebugHandler, NULL);
+        return;
+    }
+#endif
+
+    TLSSocket_setDebugHandler(NULL, NULL);
+}
+#endif /* (CONFIG_CS104_SUPPORT_TLS == 1) */
+
+void
+Lib60870_setLogLevel(Lib60870LogSubsystem subsystem, Lib60870LogLevel level)
+{
+    if ((subsystem >= 0) && (subsystem < LIB60870_LOG_SUBSYSTEM_COUNT)) {
+        LIB60870_ATOMIC_STORE(&(lib60870_logLevels[subsystem]), (uint8_t) level);
+
+#if (CONFIG_CS104_SUPPORT_TLS == 1)
+        if (subsystem == LIB60870_LOG_TLS)
+            lib60870_updateTLSDebugHandler();
+#endif
+    }
+}
+
+Lib60870LogLevel
+Lib60870_getLogLevel(Lib60870LogSubsystem subsystem)
+{
+    if ((subsystem >= 0) && (subsystem < LIB60870_LOG_SUBSYSTEM_COUNT))
+        return (Lib60870LogLevel) LIB60870_ATOMIC_LOAD(&(lib60870_logLevels[subsystem]));
+    else
+        return LIB60870_LOG_LEVEL_NONE;
+}
+
+void
+Lib60870_enableDebugOutput(bool value)
+{
+    int i;
+
+    for (i = 0; i < LIB60870_LOG_SUBSYSTEM_COUNT; i++)
+        Lib60870_setLogLevel((Lib60870LogSubsystem) i, value ? LIB60870_LOG_LEVEL_DEBUG : LIB60870_LOG_LEVEL_NONE);
+}
+
+#if ((CONFIG_DEBUG_OUTPUT == 1) && (CONFIG_DEBUG_OUTPUT_BINARY_LOG == 1))
+
+/*
+ * Binary log
+ *
+ * A log record only contains the time stamp, a pointer to the format string and the
+ * raw argument values. Strings (%s) are copied into a small area of the record because
+ * they usually don't live long enough. The text is created later by Lib60870_processLog.
+ * This works because the format strings are literals that are part of the library.
+ *
+ * The records are stored in a bounded lock-free multi-producer/multi-consumer ring buffer
+ * (D. Vyukov). Each slot has a sequence number that tells if the slot can be written (sequence
+ * equals the write position) or read (sequence equals the read position + 1). To avoid an
+ * initialization step the slots store the sequence number minus the slot index. Thus a
+ * zero initialized buffer is a valid empty buffer.
+ */
+
+#define LOG_BUFFER_MASK (CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE - 1)
+
+#if ((CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE & LOG_BUFFER_MASK) != 0)
+#error "CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE has to be a power of two"
+#endif
+
+#define LOG_MAX_ARGS 8
+#define LOG_STRING_AREA_SIZE 36
+#define LOG_MAX_MESSAGE_SIZE 512
+
+/* argument types */
+#define LOG_ARG_INT 0
+#define LOG_ARG_UINT 1
+#define LOG_ARG_DOUBLE 2
+#define LOG_ARG_POINTER 3
+#define LOG_ARG_STRING 4
+
+typedef union {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void* p;
+} LogArg;
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t timestamp;
+    const char* format;
+    uint8_t subsystem;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t truncated;
+    char strings[LOG_STRING_AREA_SIZE];
+    LogArg args[LOG_MAX_ARGS];
+} LogRecord;
+
+static LogRecord logBuffer[CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE];
+
+static uint64_t writePos = 0;
+static uint64_t readPos = 0;
+static uint64_t droppedRecords = 0;
+
+typedef struct {
+    const char* spec; /* start of the conversion specification (after '%') */
+    int specLen; /* length of the specification (including conversion character) */
+    int lengthModifier; /* 0 = none, 'h', 'H' (hh), 'l', 'L' (ll), 'z', 'j', 't', 'D' (long double) */
+    char conversion;
+    bool widthArg;
+    bool precisionArg;
+} FormatSpec;
+
+/* parse a conversion specification. Returns pointer to the character following the specification */
+static const char*
+parseFormatSpec(const char* format, FormatSpec* spec)
+{
+    const char* pos = format;
+
+    spec->spec = format;
+    spec->lengthModifier = 0;
+    spec->widthArg = false;
+    spec->precisionArg = false;
+
+    while ((*pos == '-') || (*pos == '+') || (*pos == ' ') || (*pos == '#') || (*pos == '0'))
+        pos++;
+
+    if (*pos == '*') {
+        spec->widthArg = true;
+        pos++;
+    }
+    else {
+        while ((*pos >= '0') && (*pos <= '9'))
+            pos++;
+    }
+
+    if (*pos == '.') {
+        pos++;
+
+        if (*pos == '*') {
+            spec->precisionArg = true;
+            pos++;
+        }
+        else {
+            while ((*pos >= '0') && (*pos <= '9'))
+                pos++;
+        }
+    }
+
+    switch (*pos) {
+    case 'h':
+        pos++;
+        if (*pos == 'h') {
+            spec->lengthModifier = 'H';
+            pos++;
+        }
+        else
+            spec->lengthModifier = 'h';
+        break;
+
+    case 'l':
+        pos++;
+        if (*pos == 'l') {
+            spec->lengthModifier = 'L';
+            pos++;
+        }
+        else
+            spec->lengthModifier = 'l';
+        break;
+
+    case 'L':
+        spec->lengthModifier = 'D';
+        pos++;
+        break;
+
+    case 'z':
+    case 'j':
+    case 't':
+        spec->lengthModifier = *pos;
+        pos++;
+        break;
+
+    default:
+        break;
+    }
+
+    spec->conversion = *pos;
+
+    if (*pos != 0)
+        pos++;
+
+    spec->specLen = (int) (pos - format);
+
+    return pos;
+}
+
+static int
+getArgType(FormatSpec* spec)
+{
+    switch (spec->conversion) {
+    case 'd':
+    case 'i':
+        return LOG_ARG_INT;
+
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'c':
+        return LOG_ARG_UINT;
+
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        return LOG_ARG_DOUBLE;
+
+    case 'p':
+        return LOG_ARG_POINTER;
+
+    case 's':
+        return LOG_ARG_STRING;
+
+    default:
+        return -1;
+    }
+}
+
+static void
+captureArguments(LogRecord* record, const char* format, va_list ap)
+{
+    int stringPos = 0;
+    const char* pos = format;
+
+    record->argCount = 0;
+    record->truncated = 0;
+
+    while (*pos) {
+        FormatSpec spec;
+        int argType;
+
+        if (*pos != '%') {
+            pos++;
+            continue;
+        }
+
+        pos++;
+
+        if (*pos == '%') {
+            pos++;
+            continue;
+        }
+
+        pos = parseFormatSpec(pos, &spec);
+
+        argType = getArgType(&spec);
+
+        if ((argType == -1) || (record->argCount + (spec.widthArg ? 1 : 0) + (spec.precisionArg ? 1 : 0) >= LOG_MAX_ARGS)) {
+            /* unsupported conversion or too many arguments -> the rest of the format string is not decoded */
+            record->truncated = 1;
+            break;
+        }
+
+        if (spec.widthArg)
+            record->args[record->argCount++].i = va_arg(ap, int);
+
+        if (spec.precisionArg)
+            record->args[record->argCount++].i = va_arg(ap, int);
+
+        switch (argType) {
+        case LOG_ARG_INT:
+            if (spec.lengthModifier == 'l')
+                record->args[record->argCount].i = va_arg(ap, long);
+            else if (spec.lengthModifier == 'L')
+                record->args[record->argCount].i = va_arg(ap, long long);
+            else if ((spec.lengthModifier == 'z') || (spec.lengthModifier == 't'))
+                record->args[record->argCount].i = va_arg(ap, ptrdiff_t);
+            else if (spec.lengthModifier == 'j')
+                record->args[record->argCount].i = va_arg(ap, long long);
+            else
+                record->args[record->argCount].i = va_arg(ap, int);
+            break;
+
+        case LOG_ARG_UINT:
+            if (spec.lengthModifier == 'l')
+                record->args[record->argCount].u = va_arg(ap, unsigned long);
+            else if (spec.lengthModifier == 'L')
+                record->args[record->argCount].u = va_arg(ap, unsigned long long);
+            else if ((spec.lengthModifier == 'z') || (spec.lengthModifier == 't'))
+                record->args[record->argCount].u = va_arg(ap, size_t);
+            else if (spec.lengthModifier == 'j')
+                record->args[record->argCount].u = va_arg(ap, unsigned long long);
+            else
+                record->args[record->argCount].u = va_arg(ap, unsigned int);
+            break;
+
+        case LOG_ARG_DOUBLE:
+            if (spec.lengthModifier == 'D')
+                record->args[record->argCount].d = (double) va_arg(ap, long double);
+            else
+                record->args[record->argCount].d = va_arg(ap, double);
+            break;
+
+        case LOG_ARG_POINTER:
+            record->args[record->argCount].p = va_arg(ap, void*);
+            break;
+
+        case LOG_ARG_STRING:
+            {
+                const char* str = va_arg(ap, const char*);
+
+                if (str == NULL)
+                    str = "(null)";
+
+                /* the argument is the offset of the copied string in the string area */
+                record->args[record->argCount].u = (unsigned long long) stringPos;
+
+                while ((*str) && (stringPos < LOG_STRING_AREA_SIZE - 1))
+                    record->strings[stringPos++] = *str++;
+
+                if (stringPos < LOG_STRING_AREA_SIZE)
+                    record->strings[stringPos++] = 0;
+                else
+                    record->strings[LOG_STRING_AREA_SIZE - 1] = 0;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        record->argCount++;
+    }
+}
+
+void
+lib60870_log_record(int subsystem, int level, const char *format, ...)
+{
+    uint64_t pos = LIB60870_ATOMIC_LOAD(&writePos);
+    LogRecord* record;
+    va_list ap;
+
+    for (;;) {
+        int64_t diff;
+
+        record = &(logBuffer[pos & LOG_BUFFER_MASK]);
+
+        diff = (int64_t) (LIB60870_ATOMIC_LOAD_ACQUIRE(&(record->sequence)) + (pos & LOG_BUFFER_MASK)) - (int64_t) pos;
+
+        if (diff == 0) {
+            if (LIB60870_ATOMIC_CAS(&writePos, &pos, pos + 1))
+                break;
+        }
+        else if (diff < 0) {
+            /* buffer is full */
+            LIB60870_ATOMIC_ADD(&droppedRecords, 1);
+            return;
+        }
+        else
+            pos = LIB60870_ATOMIC_LOAD(&writePos);
+    }
+
+    record->timestamp = Hal_getTimeInNs();
+    record->format = format;
+    record->subsystem = (uint8_t) subsystem;
+    record->level = (uint8_t) level;
+
+    va_start(ap, format);
+    captureArguments(record, format, ap);
+    va_end(ap);
+
+    LIB60870_ATOMIC_STORE_RELEASE(&(record->sequence), (pos + 1) - (pos & LOG_BUFFER_MASK));
+}
+
+/* format a single conversion specification with the captured argument */
+static int
+formatArgument(char* buf, int bufSize, FormatSpec* spec, LogRecord* record, int* argIdx)
+{
+    char specBuf[32];
+    int specPos = 0;
+    int i;
+    int width = 0;
+    int precision = 0;
+    int argType = getArgType(spec);
+    LogArg* arg;
+
+    if (spec->widthArg)
+        width = (int) record->args[(*argIdx)++].i;
+
+    if (spec->precisionArg)
+        precision = (int) record->args[(*argIdx)++].i;
+
+    arg = &(record->args[(*argIdx)++]);
+
+    /* copy flags, width and precision. Then add the length modifier matching the stored type */
+    specBuf[specPos++] = '%';
+
+    for (i = 0; i < spec->specLen - 1; i++) {
+        char c = spec->spec[i];
+
+        if ((c == 'h') || (c == 'l') || (c == 'L') || (c == 'z') || (c == 'j') || (c == 't'))
+            break;
+
+        if (specPos < (int) sizeof(specBuf) - 4)
+            specBuf[specPos++] = c;
+    }
+
+    if ((argType == LOG_ARG_INT) || ((argType == LOG_ARG_UINT) && (spec->conversion != 'c'))) {
+        specBuf[specPos++] = 'l';
+        specBuf[specPos++] = 'l';
+    }
+
+    specBuf[specPos++] = spec->conversion;
+    specBuf[specPos] = 0;
+
+    switch (argType) {
+    case LOG_ARG_INT:
+        if (spec->widthArg && spec->precisionArg)
+            return snprintf(buf, bufSize, specBuf, width, precision, arg->i);
+        else if (spec->widthArg)
+            return snprintf(buf, bufSize, specBuf, width, arg->i);
+        else if (spec->precisionArg)
+            return snprintf(buf, bufSize, specBuf, precision, arg->i);
+        else
+            return snprintf(buf, bufSize, specBuf, arg->i);
+
+    case LOG_ARG_UINT:
+        if (spec->conversion == 'c') {
+            if (spec->widthArg)
+                return snprintf(buf, bufSize, specBuf, width, (int) arg->u);
+            else
+                return snprintf(buf, bufSize, specBuf, (int) arg->u);
+        }
+        else if (spec->widthArg && spec->precisionArg)
+            return snprintf(buf, bufSize, specBuf, width, precision, arg->u);
+        else if (spec->widthArg)
+            return snprintf(buf, bufSize, specBuf, width, arg->u);
+        else if (spec->precisionArg)
+            return snprintf(buf, bufSize, specBuf, precision, arg->u);
+        else
+            return snprintf(buf, bufSize, specBuf, arg->u);
+
+    case LOG_ARG_DOUBLE:
+        if (spec->widthArg && spec->precisionArg)
+            return snprintf(buf, bufSize, specBuf, width, precision, arg->d);
+        else if (spec->widthArg)
+            return snprintf(buf, bufSize, specBuf, width, arg->d);
+        else if (spec->precisionArg)
+            return snprintf(buf, bufSize, specBuf, precision, arg->d);
+        else
+            return snprintf(buf, bufSize, specBuf, arg->d);
+
+    case LOG_ARG_POINTER:
+        if (spec->widthArg)
+            return snprintf(buf, bufSize, specBuf, width, arg->p);
+        else
+            return snprintf(buf, bufSize, specBuf, arg->p);
+
+    case LOG_ARG_STRING:
+        {
+            const char* str = record->strings + (arg->u < LOG_STRING_AREA_SIZE ? arg->u : LOG_STRING_AREA_SIZE - 1);
+
+            if (spec->widthArg && spec->precisionArg)
+                return snprintf(buf, bufSize, specBuf, width, precision, str);
+            else if (spec->widthArg)
+                return snprintf(buf, bufSize, specBuf, width, str);
+            else if (spec->precisionArg)
+                return snprintf(buf, bufSize, specBuf, precision, str);
+            else
+                return snprintf(buf, bufSize, specBuf, str);
+        }
+
+    default:
+        return 0;
+    }
+}
+
+static void
+decodeRecord(LogRecord* record, char* buf, int bufSize)
+{
+    const char* pos = record->format;
+    int bufPos = 0;
+    int argIdx = 0;
+
+    while ((*pos) && (bufPos < bufSize - 1)) {
+        FormatSpec spec;
+        int len;
+
+        if (*pos != '%') {
+            buf[bufPos++] = *pos++;
+            continue;
+        }
+
+        if (pos[1] == '%') {
+            buf[bufPos++] = '%';
+            pos += 2;
+            continue;
+        }
+
+        parseFormatSpec(pos + 1, &spec);
+
+        if ((getArgType(&spec) == -1) ||
+                (argIdx + (spec.widthArg ? 1 : 0) + (spec.precisionArg ? 1 : 0) >= record->argCount))
+        {
+            /* not captured (truncated record) -> copy the remaining format string */
+            while ((*pos) && (bufPos < bufSize - 1))
+                buf[bufPos++] = *pos++;
+
+            break;
+        }
+
+        pos += 1 + spec.specLen;
+
+        len = formatArgument(buf + bufPos, bufSize - bufPos, &spec, record, &argIdx);
+
+        if (len > 0) {
+            bufPos += len;
+
+            if (bufPos > bufSize - 1)
+                bufPos = bufSize - 1;
+        }
+    }
+
+    buf[bufPos] = 0;
+}
+
+int
+Lib60870_processLog(Lib60870_LogHandler handler, void* parameter)
+{
+    int processed = 0;
+    char message[LOG_MAX_MESSAGE_SIZE];
+
+    for (;;) {
+        uint64_t pos = LIB60870_ATOMIC_LOAD(&readPos);
+        LogRecord* record;
+        int64_t diff;
+
+        record = &(logBuffer[pos & LOG_BUFFER_MASK]);
+
+        diff = (int64_t) (LIB60870_ATOMIC_LOAD_ACQUIRE(&(record->sequence)) + (pos & LOG_BUFFER_MASK)) - (int64_t) (pos + 1);
+
+        if (diff == 0) {
+            if (LIB60870_ATOMIC_CAS(&readPos, &pos, pos + 1)) {
+                decodeRecord(record, message, sizeof(message));
+
+                if (handler)
+                    handler(parameter, record->timestamp, (Lib60870LogSubsystem) record->subsystem,
+                            (Lib60870LogLevel) record->level, message);
+                else
+                    printf("DEBUG_LIB60870: %s", message);
+
+                /* release the slot for the next round of the writers */
+                LIB60870_ATOMIC_STORE_RELEASE(&(record->sequence), (pos + CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE) - (pos & LOG_BUFFER_MASK));
+
+                processed++;
+            }
+        }
+        else if (diff < 0) {
+            /* buffer is empty */
+            break;
+        }
+    }
+
+    return processed;
+}
+
+uint64_t
+Lib60870_getDroppedLogRecords(void)
+{
+    return LIB60870_ATOMIC_LOAD(&droppedRecords);
+}
+
+#else /* ((CONFIG_DEBUG_OUTPUT == 1) && (CONFIG_DEBUG_OUTPUT_BINARY_LOG == 1)) */
+
+void
+lib60870_log_record(int subsystem, int level, const char *format, ...)
+{
+#if (CONFIG_DEBUG_OUTPUT == 1)
+    va_list ap;
+
+    UNUSED_PARAMETER(subsystem);
+    UNUSED_PARAMETER(level);
+
+    printf("DEBUG_LIB60870: ");
+    va_start(ap, format);
+    vprintf(format, ap);
+    va_end(ap);
+#else
+    UNUSED_PARAMETER(subsystem);
+    UNUSED_PARAMETER(level);
+    UNUSED_PARAMETER(format);
+#endif
+}
+
+int
+Lib60870_processLog(Lib60870_LogHandler handler, void* parameter)
+{
+    UNUSED_PARAMETER(handler);
+    UNUSED_PARAMETER(parameter);
+
+    return 0;
+}
+
+uint64_t
+Lib60870_getDroppedLogRecords(void)
+{
+    return 0;
+}
+
+#endif /* ((CONFIG_DEBUG_OUTPUT == 1) && (CONFIG_DEBUG_OUTPUT_BINARY_LOG == 1)) */
@@ -21,6 +21,9 @@
  *  See COPYING file for the complete license text.
  */
 
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_LINK_LAYER
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
 #include <stdbool.h>
 #include <string.h>
 #include "lib_memory.h"
@@ -21,6 +21,9 @@
  *  See COPYING file for the complete license text.
  */
 
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_LINK_LAYER
+#define MEMORY_ACCOUNTING_TAG LIB60870_LOG_SUBSYSTEM
+
 #include "hal_serial.h"
 #include "serial_transceiver_ft_1_2.h"
 #include "lib_memory.h"
@@ -28,6 +31,9 @@
 #include <stdbool.h>
 #include "lib60870_internal.h"
 
+/* receive ring buffer (has to be a power of two and larger than the maximum frame size of 261 bytes) */
+#define FT12_RX_BUFFER_SIZE 512
+
 struct sSerialTransceiverFT12 {
     int messageTimeout;
     int characterTimeout;
@@ -35,6 +41,11 @@ struct sSerialTransceiverFT12 {
     SerialPort serialPort;
     IEC60870_RawMessageHandler rawMessageHandler;
     void* rawMessageHandlerParameter;
+
+    /* received bytes that are not yet handled */
+    uint8_t rxBuffer[FT12_RX_BUFFER_SIZE];
+    int rxStart;
+    int rxCount;
 };
 
 SerialTransceiverFT12
@@ -48,6 +59,8 @@ SerialTransceiverFT12_create(SerialPort serialPort, LinkLayerParameters linkLaye
         self->linkLayerParameters = linkLayerParameters;
         self->serialPort = serialPort;
         self->rawMessageHandler = NULL;
+        self->rxStart = 0;
+        self->rxCount = 0;
     }
 
     return self;
@@ -89,100 +102,126 @@ SerialTransceiverFT12_sendMessage(SerialTransceiverFT12 self, uint8_t* msg, int
     SerialPort_write(self->serialPort, msg, 0, msgSize);
 }
 
+/*
+ * Read the bytes that are available from the serial port into the receive buffer.
+ * Waits up to timeout ms for the first byte.
+ *
+ * \return number of read bytes, 0 in case of a timeout, -1 in case of an error
+ */
 static int
-readBytesWithTimeout(SerialTransceiverFT12 self, uint8_t* buffer, int startIndex, int count)
+fillReceiveBuffer(SerialTransceiverFT12 self, int timeout)
 {
-    int readByte;
-    int readBytes = 0;
+    int writePos = (self->rxStart + self->rxCount) & (FT12_RX_BUFFER_SIZE - 1);
 
-    while ((readByte = SerialPort_readByte(self->serialPort)) != -1) {
-        buffer[startIndex++] = (uint8_t) readByte;
+    /* only read into the contiguous free space to require a single read call */
+    int maxSize = FT12_RX_BUFFER_SIZE - self->rxCount;
 
-        readBytes++;
+    if (maxSize > FT12_RX_BUFFER_SIZE - writePos)
+        maxSize = FT12_RX_BUFFER_SIZE - writePos;
 
-        if (readBytes >= count)
-            break;
-    }
+    if (maxSize == 0)
+        return 0;
+
+    SerialPort_setTimeout(self->serialPort, timeout);
+
+    int readBytes = SerialPort_read(self->serialPort, self->rxBuffer + writePos, maxSize);
+
+    if (readBytes > 0)
+        self->rxCount += readBytes;
 
     return readBytes;
 }
 
-void
-SerialTransceiverFT12_readNextMessage(SerialTransceiverFT12 self, uint8_t* buffer,
-        SerialTXMessageHandler messageHandler, void* parameter)
+static uint8_t
+getReceivedByte(SerialTransceiverFT12 self, int index)
 {
-    SerialPort_setTimeout(self->serialPort, self->messageTimeout);
+    return self->rxBuffer[(self->rxStart + index) & (FT12_RX_BUFFER_SIZE - 1)];
+}
 
-    int read = SerialPort_readByte(self->serialPort);
+static void
+removeReceivedBytes(SerialTransceiverFT12 self, uint8_t* buffer, int count)
+{
+    int i;
 
-    if (read != -1) {
+    for (i = 0; i < count; i++)
+        buffer[i] = getReceivedByte(self, i);
 
-        if (read == 0x68) {
+    self->rxStart = (self->rxStart + count) & (FT12_RX_BUFFER_SIZE - 1);
+    self->rxCount -= count;
+}
 
-            SerialPort_setTimeout(self->serialPort, self->characterTimeout);
+static void
+discardReceivedBytes(SerialTransceiverFT12 self)
+{
+    self->rxStart = 0;
+    self->rxCount = 0;
+}
 
-            int msgSize = SerialPort_readByte(self->serialPort);
+/*
+ * Wait until the receive buffer contains the requested number of bytes. The character
+ * timeout is applied to each read call, so it limits the time between two received bytes.
+ */
+static bool
+receiveBytes(SerialTransceiverFT12 self, int count)
+{
+    while (self->rxCount < count) {
+        if (fillReceiveBuffer(self, self->characterTimeout) <= 0)
+            return false;
+    }
 
-            if (msgSize == -1)
-                goto sync_error;
+    return true;
+}
 
-            buffer[0] = (uint8_t) 0x68;
-            buffer[1] = (uint8_t) msgSize;
+void
+SerialTransceiverFT12_readNextMessage(SerialTransceiverFT12 self, uint8_t* buffer,
+        SerialTXMessageHandler messageHandler, void* parameter)
+{
+    /* only wait for a new message when no received bytes are left */
+    if (self->rxCount == 0) {
+        if (fillReceiveBuffer(self, self->messageTimeout) <= 0)
+            return;
+    }
 
-            msgSize += 4;
+    uint8_t startByte = getReceivedByte(self, 0);
 
-            int readBytes = readBytesWithTimeout(self, buffer, 2, msgSize);
+    int msgSize;
 
-            if (readBytes == msgSize) {
-                msgSize += 2;
+    if (startByte == 0x68) {
 
-                if (self->rawMessageHandler)
-                    self->rawMessageHandler(self->rawMessageHandlerParameter, buffer, msgSize, false);
+        if (receiveBytes(self, 2) == false)
+            goto sync_error;
 
-                messageHandler(parameter, buffer, msgSize);
-            }
-            else {
-                DEBUG_PRINT("RECV: Timeout reading variable length frame size = %i (expected = %i)\n", readBytes, msgSize);
-            }
+        msgSize = getReceivedByte(self, 1) + 6;
 
+        if (receiveBytes(self, msgSize) == false) {
+            DEBUG_PRINT("RECV: Timeout reading variable length frame size = %i (expected = %i)\n", self->rxCount - 2, msgSize - 2);
+            discardReceivedBytes(self);
+            return;
         }
-        else if (read == 0x10) {
-
-            SerialPort_setTimeout(self->serialPort, self->characterTimeout);
-
-            buffer[0] = 0x10;
-
-            int msgSize = 3 + self->linkLayerParameters->addressLength;
-
-            int readBytes = readBytesWithTimeout(self, buffer, 1, msgSize);
-
-            if (readBytes == msgSize) {
-                msgSize += 1;
-
-                if (self->rawMessageHandler)
-                    self->rawMessageHandler(self->rawMessageHandlerParameter, buffer, msgSize, false);
+    }
+    else if (startByte == 0x10) {
 
-                messageHandler(parameter, buffer, msgSize);
-            }
-            else {
-                DEBUG_PRINT("RECV: Timeout reading fixed length frame size = %i (expected = %i)\n", readBytes, msgSize);
-            }
+        msgSize = 4 + self->linkLayerParameters->addressLength;
 
+        if (receiveBytes(self, msgSize) == false) {
+            DEBUG_PRINT("RECV: Timeout reading fixed length frame size = %i (expected = %i)\n", self->rxCount - 1, msgSize - 1);
+            discardReceivedBytes(self);
+            return;
         }
-        else if (read == 0xe5) {
-            int msgSize = 1;
-            buffer[0] = (uint8_t) read;
+    }
+    else if (startByte == 0xe5) {
+        msgSize = 1;
+    }
+    else {
+        goto sync_error;
+    }
 
-            if (self->rawMessageHandler)
-                self->rawMessageHandler(self->rawMessageHandlerParameter, buffer, msgSize, false);
+    removeReceivedBytes(self, buffer, msgSize);
 
-            messageHandler(parameter, buffer, msgSize);
-        }
-        else {
-            goto sync_error;
-        }
+    if (self->rawMessageHandler)
+        self->rawMessageHandler(self->rawMessageHandlerParameter, buffer, msgSize, false);
 
-    }
+    messageHandler(parameter, buffer, msgSize);
 
     return;
 
@@ -190,6 +229,8 @@ sync_error:
 
     DEBUG_PRINT("RECV: SYNC ERROR\n");
 
+    discardReceivedBytes(self);
+
     SerialPort_discardInBuffer(self->serialPort);
 
     return;
@@ -301,6 +301,16 @@ CS101_Master_sendASDU(CS101_Master self, CS101_ASDU asdu);
 void
 CS101_Master_setASDUReceivedHandler(CS101_Master self, CS101_ASDUReceivedHandler handler, void* parameter);
 
+/**
+ * \brief Attach a mirror cache that is updated with all received monitoring ASDUs
+ *
+ * The cache is updated before the ASDU is passed to the ASDU received handler.
+ *
+ * \param cache the mirror cache or NULL to detach the cache
+ */
+void
+CS101_Master_setMirrorCache(CS101_Master self, CS101_MirrorCache cache);
+
 /**
  * \brief Set a callback handler for link layer state changes
  */
@@ -0,0 +1,305 @@
+/*
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_API_CS104_CAPTURE_H_
+#define SRC_INC_API_CS104_CAPTURE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cs104_slave.h"
+#include "cs104_connection.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file cs104_capture.h
+ * \brief Capture and replay of CS 104 APDU streams
+ */
+
+/**
+ * @defgroup CS104_CAPTURE Capture and replay of APDU streams
+ *
+ * The capture file is a binary log of the raw APDUs of one or more connections. All
+ * values are stored in little endian byte order and all records start at 8 byte aligned
+ * offsets, so the file can also be mapped into memory and read in place.
+ *
+ * File header (32 byte):
+ *
+ *     0  magic "IEC104CP"
+ *     8  uint16 version (1)
+ *    10  uint16 size of the file header (32)
+ *    12  uint32 index interval (number of records per index entry)
+ *    16  uint64 number of records (0 when the file was not closed)
+ *    24  uint64 file offset of the index (0 when the file was not closed)
+ *
+ * Record (16 byte header followed by the APDU, padded to a multiple of 8 byte):
+ *
+ *     0  uint64 time of capture (ns since epoch)
+ *     8  uint32 connection ID
+ *    12  uint8  flags (bit 0: APDU was sent)
+ *    13  uint8  reserved
+ *    14  uint16 size of the APDU
+ *
+ * The index contains the file offsets (uint64) of every index interval-th record
+ * (record 0, record N, record 2N, ...).
+ *
+ * @{
+ */
+
+typedef struct sCS104_CaptureWriter* CS104_CaptureWriter;
+
+typedef struct sCS104_CaptureReader* CS104_CaptureReader;
+
+typedef struct sCS104_CaptureReplay* CS104_CaptureReplay;
+
+/**
+ * \brief A record of a capture file
+ */
+typedef struct {
+    uint64_t timestamp; /**< time of capture (ns since epoch) */
+    uint32_t connectionId; /**< connection ID */
+    bool sent; /**< true when the APDU was sent, false when it was received */
+    const uint8_t* msg; /**< the APDU (only valid as long as the reader exists) */
+    int msgSize; /**< size of the APDU */
+} sCS104_CaptureRecord;
+
+/**
+ * \brief Create a new capture file
+ *
+ * \param filename name of the capture file (an existing file is overwritten)
+ *
+ * \return the new capture writer, or NULL when the file cannot be created
+ */
+CS104_CaptureWriter
+CS104_CaptureWriter_create(const char* filename);
+
+/**
+ * \brief Append an APDU to the capture file
+ *
+ * The function can be called by multiple threads.
+ *
+ * \param timestamp time of capture (ns since epoch)
+ * \param connectionId ID of the connection (user defined)
+ * \param sent true when the APDU was sent, false when it was received
+ * \param msg the APDU
+ * \param msgSize size of the APDU
+ *
+ * \return true when the record was written, false otherwise
+ */
+bool
+CS104_CaptureWriter_writeRecord(CS104_CaptureWriter self, uint64_t timestamp, uint32_t connectionId, bool sent,
+        const uint8_t* msg, int msgSize);
+
+/**
+ * \brief Capture all APDUs of a client connection
+ *
+ * NOTE: Replaces the raw message handler of the connection (\ref CS104_Connection_setRawMessageHandler).
+ * The writer has to exist as long as the connection exists.
+ *
+ * \param connection the client connection
+ * \param connectionId the ID that is stored with the records of the connection
+ */
+void
+CS104_CaptureWriter_captureConnection(CS104_CaptureWriter self, CS104_Connection connection, uint32_t connectionId);
+
+/**
+ * \brief Capture all APDUs of all connections of a slave
+ *
+ * The connection IDs of the statistics (\ref IMasterConnection_getStatistics) are stored with the records.
+ *
+ * NOTE: Replaces the raw message handler of the slave (\ref CS104_Slave_setRawMessageHandler).
+ * The writer has to exist as long as the slave is running.
+ */
+void
+CS104_CaptureWriter_captureSlave(CS104_CaptureWriter self, CS104_Slave slave);
+
+/**
+ * \brief Write the buffered records to the capture file
+ */
+void
+CS104_CaptureWriter_flush(CS104_CaptureWriter self);
+
+/**
+ * \brief Get the number of records written so far
+ */
+uint64_t
+CS104_CaptureWriter_getRecordCount(CS104_CaptureWriter self);
+
+/**
+ * \brief Write the index, close the capture file and release all resources of the writer
+ */
+void
+CS104_CaptureWriter_destroy(CS104_CaptureWriter self);
+
+/**
+ * \brief Open a capture file for reading
+ *
+ * The file is loaded into memory. When the file was not closed properly the index is
+ * rebuilt from the records.
+ *
+ * \param filename name of the capture file
+ *
+ * \return the new capture reader, or NULL when the file cannot be read or has an invalid format
+ */
+CS104_CaptureReader
+CS104_CaptureReader_create(const char* filename);
+
+/**
+ * \brief Get the number of records of the capture file
+ */
+int
+CS104_CaptureReader_getRecordCount(CS104_CaptureReader self);
+
+/**
+ * \brief Get a record of the capture file
+ *
+ * \param index index of the record (starting with 0)
+ * \param record the structure where the record is stored
+ *
+ * \return true when the record exists, false otherwise
+ */
+bool
+CS104_CaptureReader_getRecord(CS104_CaptureReader self, int index, sCS104_CaptureRecord* record);
+
+/**
+ * \brief Find the first record that was captured at or after the given time
+ *
+ * \param timestamp time (ns since epoch)
+ *
+ * \return index of the record, or the number of records when there is no such record
+ */
+int
+CS104_CaptureReader_findRecord(CS104_CaptureReader self, uint64_t timestamp);
+
+/**
+ * \brief Release all resources of the reader
+ */
+void
+CS104_CaptureReader_destroy(CS104_CaptureReader self);
+
+/**
+ * \brief Callback handler for replayed records
+ *
+ * \param parameter user provided parameter
+ * \param record the replayed record
+ *
+ * \return true to continue the replay, false to stop the replay
+ */
+typedef bool (*CS104_CaptureReplayHandler) (void* parameter, const sCS104_CaptureRecord* record);
+
+/**
+ * \brief Statistics of a replay
+ */
+typedef struct {
+    uint64_t replayedRecords; /**< number of records that were passed to the handler/sent */
+    uint64_t skippedRecords; /**< number of records that didn't match the filter or contained no ASDU */
+    uint64_t durationNs; /**< duration of the replay */
+} sCS104_CaptureReplayStatistics;
+
+/**
+ * \brief Create a replay for the records of a capture file
+ *
+ * \param reader the capture reader. Has to exist as long as the replay exists.
+ */
+CS104_CaptureReplay
+CS104_CaptureReplay_create(CS104_CaptureReader reader);
+
+/**
+ * \brief Set the replay speed
+ *
+ * \param speed 1.0 to replay with the original timing, N to replay N times faster,
+ *        0 to replay as fast as possible (default is 1.0)
+ */
+void
+CS104_CaptureReplay_setSpeed(CS104_CaptureReplay self, double speed);
+
+/**
+ * \brief Select the records that are replayed
+ *
+ * \param sent true to replay the sent APDUs, false to replay the received APDUs (default is true)
+ * \param connectionId connection ID of the replayed records or -1 for all connections (default is -1)
+ */
+void
+CS104_CaptureReplay_setFilter(CS104_CaptureReplay self, bool sent, int64_t connectionId);
+
+/**
+ * \brief Replay the selected records with a user provided handler
+ *
+ * The function blocks until all records are replayed or the replay is stopped.
+ *
+ * \return number of replayed records
+ */
+int
+CS104_CaptureReplay_run(CS104_CaptureReplay self, CS104_CaptureReplayHandler handler, void* parameter);
+
+/**
+ * \brief Replay the ASDUs of the selected records by a slave
+ *
+ * The ASDUs of the I format APDUs are put into the event queue of the slave (\ref CS104_Slave_enqueueASDU).
+ * S and U format APDUs are skipped. When the replay is faster than the clients can receive the
+ * ASDUs the oldest ASDUs in the event queue are overwritten.
+ *
+ * \return number of replayed ASDUs
+ */
+int
+CS104_CaptureReplay_runSlave(CS104_CaptureReplay self, CS104_Slave slave);
+
+/**
+ * \brief Replay the ASDUs of the selected records by a client connection
+ *
+ * The ASDUs of the I format APDUs are sent with \ref CS104_Connection_sendASDU. The connection
+ * has to use a send queue (see \ref CS104_Connection_setSendQueueSize). When the send queue is
+ * full the replay waits for the CS104_CONNECTION_SEND_QUEUE_AVAILABLE event. The replay stops
+ * when the connection is closed.
+ *
+ * \return number of replayed ASDUs (0 when the connection doesn't use a send queue)
+ */
+int
+CS104_CaptureReplay_runConnection(CS104_CaptureReplay self, CS104_Connection connection);
+
+/**
+ * \brief Stop a running replay (can be called by another thread or by the replay handler)
+ */
+void
+CS104_CaptureReplay_stop(CS104_CaptureReplay self);
+
+/**
+ * \brief Get the statistics of the last replay
+ */
+void
+CS104_CaptureReplay_getStatistics(CS104_CaptureReplay self, sCS104_CaptureReplayStatistics* stats);
+
+/**
+ * \brief Release all resources of the replay
+ */
+void
+CS104_CaptureReplay_destroy(CS104_CaptureReplay self);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_INC_API_CS104_CAPTURE_H_ */
@@ -62,6 +62,22 @@ typedef struct sCS104_Connection* CS104_Connection;
 CS104_Connection
 CS104_Connection_create(const char* hostname, int tcpPort);
 
+/**
+ * \brief Create a new connection object for a server on the same host (uses a unix domain socket)
+ *
+ * The server has to listen on the same path (see \ref CS104_Slave_setLocalUnixPath).
+ * The protocol is unchanged, only the transport differs. A local address set with
+ * \ref CS104_Connection_setLocalAddress is ignored.
+ *
+ * NOTE: only supported on Linux. On other platforms connecting always fails.
+ *
+ * \param path file system path of the server socket
+ *
+ * \return the new connection object
+ */
+CS104_Connection
+CS104_Connection_createUnix(const char* path);
+
 /**
  * \brief Create a new secure connection object (uses TLS)
  *
@@ -106,6 +122,20 @@ CS104_Connection_setAPCIParameters(CS104_Connection self, const CS104_APCIParame
 CS104_APCIParameters
 CS104_Connection_getAPCIParameters(CS104_Connection self);
 
+/**
+ * \brief Get the runtime statistics of the current (or last) connection
+ *
+ * The statistics are reset when a new connection is established. The function
+ * doesn't block the connection handling and can be called from any thread.
+ *
+ * \param self CS104_Connection instance
+ * \param stats structure where to store the statistics values
+ *
+ * \return true when statistics are available, false when the connection was never established
+ */
+bool
+CS104_Connection_getStatistics(CS104_Connection self, CS104_ConnectionStatistics stats);
+
 /**
  * \brief Set the CS101 application layer parameters
  *
@@ -169,6 +199,9 @@ CS104_Connection_connect(CS104_Connection self);
  *
  * After issuing this command the client (master) will receive spontaneous
  * (unsolicited) messages from the server (slave).
+ *
+ * When the server doesn't confirm the command (STARTDT_CON) within t1 the
+ * connection is closed.
  */
 void
 CS104_Connection_sendStartDT(CS104_Connection self);
@@ -184,7 +217,8 @@ CS104_Connection_sendStopDT(CS104_Connection self);
  *
  * The transmit buffer is full when the slave/server didn't confirm the last k sent messages.
  * In this case the next message can only be sent after the next confirmation (by I or S messages)
- * that frees part of the sent messages buffer.
+ * that frees part of the sent messages buffer. When a send queue is used (see \ref CS104_Connection_setSendQueueSize)
+ * the next message is queued instead.
  */
 bool
 CS104_Connection_isTransmitBufferFull(CS104_Connection self);
@@ -301,6 +335,89 @@ CS104_Connection_sendProcessCommandEx(CS104_Connection self, CS101_CauseOfTransm
 bool
 CS104_Connection_sendASDU(CS104_Connection self, CS101_ASDU asdu);
 
+/**
+ * \brief Handle of a command that was sent with \ref CS104_Connection_sendCommand (0 = invalid handle)
+ */
+typedef uint32_t CS104_CommandHandle;
+
+typedef enum {
+    CS104_COMMAND_DIRECT = 0, /**< send the command with S/E = execute */
+    CS104_COMMAND_SELECT_AND_EXECUTE = 1 /**< send select, then execute after the positive confirmation of the select */
+} CS104_CommandMode;
+
+typedef enum {
+    CS104_COMMAND_ACT_CON = 0, /**< positive confirmation of the execute command (final when not waiting for ACT_TERM) */
+    CS104_COMMAND_ACT_TERM = 1, /**< activation termination (final) */
+    CS104_COMMAND_NEGATIVE_CON = 2, /**< negative confirmation of the select or execute command (final) */
+    CS104_COMMAND_TIMEOUT = 3, /**< no response within the command timeout (final) */
+    CS104_COMMAND_FAILED = 4 /**< connection closed before the command was completed (final) */
+} CS104_CommandEvent;
+
+/**
+ * \brief Callback handler for the progress of a command
+ *
+ * The handler is called by the thread that handles the connection while the connection state is
+ * not locked. Commands can be sent from within the handler. After a final event the handle is invalid.
+ *
+ * \param parameter user provided parameter
+ * \param connection the connection object
+ * \param handle the handle of the command
+ * \param event the command event
+ * \param asdu the received response (NULL for CS104_COMMAND_TIMEOUT and CS104_COMMAND_FAILED). Only valid during the callback.
+ */
+typedef void (*CS104_CommandHandler) (void* parameter, CS104_Connection connection, CS104_CommandHandle handle,
+        CS104_CommandEvent event, CS101_ASDU asdu);
+
+/**
+ * \brief Send a process command and get notified when the command is confirmed or terminated
+ *
+ * The responses are correlated with the command by type ID, CA and IOA. Many commands can be outstanding
+ * at the same time, but only one command for the same type ID, CA and IOA. In the mode
+ * CS104_COMMAND_SELECT_AND_EXECUTE the execute command is sent by the library when the select is
+ * confirmed. Commands that do not fit into the k-window are queued and sent when the other side
+ * confirms the sent messages.
+ *
+ * Received responses are also passed to the ASDU received handler.
+ *
+ * \param ca the common address of the information object
+ * \param command the command information object (e.g. SingleCommand or SetpointCommandShort). The S/E flag
+ *        is set by the library.
+ * \param mode direct execute or select before operate (only for command types with S/E flag)
+ * \param waitForTermination wait for the ACT_TERM after the positive ACT_CON of the execute command
+ * \param handler callback handler that is called for the events of the command
+ * \param parameter user provided parameter that is passed to the callback handler
+ *
+ * \return the handle of the command or 0 when the command cannot be sent (not connected, too many outstanding
+ *         commands, command for the same type ID, CA and IOA is outstanding or invalid command)
+ */
+CS104_CommandHandle
+CS104_Connection_sendCommand(CS104_Connection self, int ca, InformationObject command, CS104_CommandMode mode,
+        bool waitForTermination, CS104_CommandHandler handler, void* parameter);
+
+/**
+ * \brief Set the time to wait for each response of a command sent with \ref CS104_Connection_sendCommand
+ *
+ * \param timeoutInMs timeout in ms (default is 10000 ms)
+ */
+void
+CS104_Connection_setCommandTimeout(CS104_Connection self, int timeoutInMs);
+
+/**
+ * \brief Set the maximum number of outstanding commands sent with \ref CS104_Connection_sendCommand
+ *
+ * NOTE: Only has an effect when no command is outstanding.
+ *
+ * \param maxCommands maximum number of outstanding commands (default is CONFIG_CS104_MAX_OUTSTANDING_COMMANDS)
+ */
+void
+CS104_Connection_setMaxOutstandingCommands(CS104_Connection self, int maxCommands);
+
+/**
+ * \brief Get the number of outstanding commands (commands without final event)
+ */
+int
+CS104_Connection_getOutstandingCommands(CS104_Connection self);
+
 /**
  * \brief Register a callback handler for received ASDUs
  *
@@ -310,12 +427,137 @@ CS104_Connection_sendASDU(CS104_Connection self, CS101_ASDU asdu);
 void
 CS104_Connection_setASDUReceivedHandler(CS104_Connection self, CS101_ASDUReceivedHandler handler, void* parameter);
 
+/**
+ * \brief Attach a mirror cache that is updated with all received monitoring ASDUs
+ *
+ * The cache is updated by the receiving thread before the ASDU is passed to the ASDU received handler
+ * (or the ASDU queue/batch handler). One cache can be shared by multiple connections.
+ *
+ * \param cache the mirror cache or NULL to detach the cache
+ */
+void
+CS104_Connection_setMirrorCache(CS104_Connection self, CS101_MirrorCache cache);
+
+/**
+ * \brief Pass received ASDUs to a queue instead of calling the ASDU received handler directly
+ *
+ * By default the ASDU received handler is called by the thread that receives the messages while the
+ * internal connection state is locked. A slow handler then delays the confirmation of received messages
+ * and blocks other threads that send ASDUs with the same connection.
+ *
+ * When the queue is enabled the receiving thread only copies the received ASDUs into a bounded
+ * single producer/single consumer queue. The application has to call \ref CS104_Connection_processASDUQueue
+ * from a thread of its choice to call the ASDU received handler for the queued ASDUs.
+ *
+ * Received I messages are confirmed as usual (S message after w messages or t2, or N(R) of a sent I message)
+ * as long as the queue has room for k more ASDUs (the other side can send up to k unconfirmed I messages).
+ * When the consumer is too slow and the queue has less than k free entries the confirmation of the last
+ * received ASDUs is held back. Then the k-window of the other side fills up and the other side stops sending.
+ * The held back ASDUs are confirmed when they have been handled by \ref CS104_Connection_processASDUQueue.
+ * This has to happen within the timeout t1 of the other side, otherwise the other side will close the
+ * connection.
+ *
+ * The queue size is at least k. With a size of k the confirmation of every queued ASDU waits for the
+ * consumer and the queue never holds more than k ASDUs. A size of several times k allows
+ * the consumer to lag behind without slowing down the other side. The other side is expected to use the
+ * same parameter k.
+ *
+ * ASDUs of a previous connection that are still queued when a new connection is established are dropped
+ * because they have not been confirmed to the other side.
+ *
+ * NOTE: Has to be called before the connection is established or after it is closed, and not concurrently
+ * with \ref CS104_Connection_processASDUQueue.
+ *
+ * \param size maximum number of queued ASDUs (0 = queue disabled, ASDU received handler is called directly)
+ *
+ * \return true on success, false when the connection is being established or is open
+ */
+bool
+CS104_Connection_setASDUQueueSize(CS104_Connection self, int size);
+
+/**
+ * \brief Call the ASDU received handler for the ASDUs in the ASDU queue
+ *
+ * The queue only supports a single consumer. This function must not be called by different threads
+ * at the same time. ASDUs that have been received before the connection was closed are still delivered.
+ *
+ * \param maxASDUs maximum number of ASDUs to handle (0 = all queued ASDUs)
+ *
+ * \return number of handled ASDUs (0 when the queue is empty or not enabled)
+ */
+int
+CS104_Connection_processASDUQueue(CS104_Connection self, int maxASDUs);
+
+/**
+ * \brief Queue ASDUs that are sent while the k-buffer is full
+ *
+ * Without the send queue the send functions (e.g. \ref CS104_Connection_sendProcessCommandEx or
+ * \ref CS104_Connection_sendASDU) return false when k ASDUs are not yet confirmed by the other side.
+ * With the send queue these ASDUs are copied into the queue and are sent as soon as the other side
+ * confirms the sent messages. The send functions only return false when the queue is full. Then the
+ * connection handler is called with the event CS104_CONNECTION_SEND_QUEUE_AVAILABLE when the first
+ * queued ASDU has been sent. Queued ASDUs are dropped when the connection is closed.
+ *
+ * NOTE: Has to be called before the connection is established or after it is closed.
+ *
+ * \param size maximum number of queued ASDUs (0 = queue disabled)
+ *
+ * \return true on success, false when the connection is being established or is open
+ */
+bool
+CS104_Connection_setSendQueueSize(CS104_Connection self, int size);
+
+/**
+ * \brief Get the number of ASDUs in the send queue (see \ref CS104_Connection_setSendQueueSize)
+ */
+int
+CS104_Connection_getSendQueueCount(CS104_Connection self);
+
+/**
+ * \brief Callback handler for a batch of received ASDUs
+ *
+ * \param parameter user provided parameter
+ * \param asdus array of the received ASDUs. The ASDUs are only valid during the callback.
+ * \param numberOfASDUs number of ASDUs in the array
+ */
+typedef void (*CS104_ASDUBatchHandler) (void* parameter, CS101_ASDU* asdus, int numberOfASDUs);
+
+/**
+ * \brief Register a callback handler that receives the ASDUs in batches
+ *
+ * The ASDUs of all messages that are available in one read cycle are collected and passed to the
+ * handler with a single call. With a maximum delay the ASDUs of subsequent read cycles are added
+ * to the batch until the batch is full or the delay of the first ASDU in the batch is reached. Remaining
+ * ASDUs are delivered before the connection is closed.
+ *
+ * In contrast to the ASDU received handler the batch handler is not called while the internal connection
+ * state is locked. The received messages are confirmed independently of the batch delivery.
+ *
+ * When an ASDU queue is used (see \ref CS104_Connection_setASDUQueueSize) the batches are delivered by
+ * \ref CS104_Connection_processASDUQueue. Then the maximum delay is not used.
+ *
+ * When a batch handler is set the ASDU received handler is not called.
+ *
+ * NOTE: Has to be called before the connection is established or after it is closed.
+ *
+ * \param handler user provided callback handler function (NULL to remove the batch handler)
+ * \param parameter user provided parameter that is passed to the callback handler
+ * \param maxASDUs maximum number of ASDUs in one batch
+ * \param maxDelayInMs maximum time in ms an ASDU is held back to fill the batch (0 = deliver after each read cycle)
+ *
+ * \return true on success, false when the connection is being established or is open, or when the
+ *         batch buffers cannot be allocated
+ */
+bool
+CS104_Connection_setASDUBatchHandler(CS104_Connection self, CS104_ASDUBatchHandler handler, void* parameter, int maxASDUs, int maxDelayInMs);
+
 typedef enum {
     CS104_CONNECTION_OPENED = 0,
     CS104_CONNECTION_CLOSED = 1,
     CS104_CONNECTION_STARTDT_CON_RECEIVED = 2,
     CS104_CONNECTION_STOPDT_CON_RECEIVED = 3,
-    CS104_CONNECTION_FAILED = 4
+    CS104_CONNECTION_FAILED = 4,
+    CS104_CONNECTION_SEND_QUEUE_AVAILABLE = 5 /**< the send queue was full and ASDUs can be sent again (see \ref CS104_Connection_setSendQueueSize) */
 } CS104_ConnectionEvent;
 
 /**
@@ -351,16 +593,273 @@ CS104_Connection_setRawMessageHandler(CS104_Connection self, IEC60870_RawMessage
 
 /**
  * \brief Close the connection
+ *
+ * NOTE: When the connection is handled by a \ref CS104_ConnectionManager the connection
+ * is closed asynchronously by the manager.
  */
 void
 CS104_Connection_close(CS104_Connection self);
 
 /**
  * \brief Close the connection and free all related resources
+ *
+ * When the connection is handled by a \ref CS104_ConnectionManager it is removed from the manager.
  */
 void
 CS104_Connection_destroy(CS104_Connection self);
 
+/**
+ * @defgroup CS104_CONNECTION_MANAGER Handle many client connections with a single thread
+ *
+ * By default each connection uses its own thread. A connection manager handles the connects,
+ * the received messages, the timeouts (t0, t1, t2, t3) and the reconnects of all its
+ * connections in a single thread (or in the thread that calls \ref CS104_ConnectionManager_tick).
+ * On Linux the sockets are monitored with epoll. This way a front-end can communicate with
+ * thousands of outstations. For multi-core systems the connections can be distributed over
+ * a small number of managers. The timeouts of the connections are kept in a queue ordered by
+ * their expiry time, so the manager only checks the connections with an expired timeout.
+ *
+ * The handlers of the connections are called by the thread of the manager while the manager is
+ * locked. They must not block. The handlers can use the functions of the connections (e.g. send
+ * ASDUs or commands, \ref CS104_Connection_sendStartDT, \ref CS104_Connection_close, or
+ * \ref CS104_Connection_connectAsync), also for other connections of the same manager, except
+ * CS104_Connection_connect and CS104_Connection_destroy. They must not call any function of the
+ * manager (add/remove connections, get the connection count, tick, stop, destroy).
+ *
+ * @{
+ */
+
+typedef struct sCS104_ConnectionManager* CS104_ConnectionManager;
+
+/**
+ * \brief Create a new connection manager
+ *
+ * \return the new connection manager instance, or NULL in case of an error
+ */
+CS104_ConnectionManager
+CS104_ConnectionManager_create(void);
+
+/**
+ * \brief Set the interval for automatic reconnects
+ *
+ * When the interval is greater than 0 the manager reconnects a connection after the interval
+ * when the connect failed or the connection has been closed because of an error or timeout.
+ * Connections that are closed by \ref CS104_Connection_close are not reconnected.
+ *
+ * \param intervalInMs reconnect interval in milliseconds (0 = no automatic reconnect - default)
+ */
+void
+CS104_ConnectionManager_setReconnectInterval(CS104_ConnectionManager self, int intervalInMs);
+
+/**
+ * \brief Add a connection to the manager
+ *
+ * The connection must not be connected. After the connection is added it can be connected with
+ * \ref CS104_Connection_connectAsync (or \ref CS104_Connection_connect when the manager is running).
+ * The connection remains owned by the application and has to be destroyed with \ref CS104_Connection_destroy.
+ *
+ * \return true when the connection has been added, false otherwise (e.g. connection is already running or out of memory)
+ */
+bool
+CS104_ConnectionManager_addConnection(CS104_ConnectionManager self, CS104_Connection connection);
+
+/**
+ * \brief Remove a connection from the manager (the connection is closed when it is connected)
+ *
+ * When the manager thread is waiting for socket events the wait is interrupted and the connection is
+ * removed by the manager thread. The function blocks until the connection is removed.
+ */
+void
+CS104_ConnectionManager_removeConnection(CS104_ConnectionManager self, CS104_Connection connection);
+
+/**
+ * \brief Get the number of connections handled by the manager
+ */
+int
+CS104_ConnectionManager_getConnectionCount(CS104_ConnectionManager self);
+
+/**
+ * \brief Start a background thread that handles all connections of the manager
+ */
+void
+CS104_ConnectionManager_start(CS104_ConnectionManager self);
+
+/**
+ * \brief Stop the background thread of the manager
+ */
+void
+CS104_ConnectionManager_stop(CS104_ConnectionManager self);
+
+/**
+ * \brief Handle the connections of the manager (for non-threaded mode)
+ *
+ * Waits until a socket is ready, the next timeout of a connection expires, or the timeout
+ * expired and handles all pending events, connect/close requests, and timeouts. The manager
+ * is not locked while waiting. Has to be called periodically when the manager is not started
+ * with \ref CS104_ConnectionManager_start.
+ *
+ * \param timeoutInMs maximum time to wait for socket events
+ *
+ * \return number of sockets that have been ready
+ */
+int
+CS104_ConnectionManager_tick(CS104_ConnectionManager self, int timeoutInMs);
+
+/**
+ * \brief Stop the manager, close all connections and release the resources of the manager
+ *
+ * NOTE: The connections are not destroyed.
+ */
+void
+CS104_ConnectionManager_destroy(CS104_ConnectionManager self);
+
+/*! @} */
+
+/**
+ * @defgroup CS104_REDUNDANT_CONNECTION Redundant connections to a controlled station
+ *
+ * A redundant connection connects to all endpoints (the redundant server addresses of a controlled
+ * station) at the same time. Only one connection is active (data transfer started with STARTDT). The other
+ * connections are kept open as standby connections and are tested with TESTFR frames (after t3 without
+ * messages). When the active connection fails (t1 timeout, socket error, or connection closed by the
+ * other side) the data transfer is started on a standby connection without waiting for a TCP connect.
+ * When the standby connection doesn't confirm the STARTDT within t1 it is closed and the next standby
+ * connection is tried. Failed connections are reconnected automatically and become standby connections.
+ *
+ * The connections are handled by an internal \ref CS104_ConnectionManager. The handlers are called by
+ * the thread of the manager.
+ *
+ * @{
+ */
+
+typedef struct sCS104_RedundantConnection* CS104_RedundantConnection;
+
+typedef enum {
+    CS104_REDUNDANT_ENDPOINT_CONNECTED = 0, /**< connection to the endpoint established (standby) */
+    CS104_REDUNDANT_ENDPOINT_DISCONNECTED = 1, /**< connection to the endpoint closed or connect failed */
+    CS104_REDUNDANT_ENDPOINT_ACTIVE = 2, /**< data transfer started on the endpoint (STARTDT_CON received) */
+    CS104_REDUNDANT_NO_ACTIVE_ENDPOINT = 3 /**< active connection failed and no standby connection is available */
+} CS104_RedundantConnectionEvent;
+
+/**
+ * \brief Handler for events of a redundant connection
+ *
+ * \param parameter user provided parameter
+ * \param connection the redundant connection
+ * \param endpoint index of the endpoint (see \ref CS104_RedundantConnection_addEndpoint)
+ * \param event the event
+ */
+typedef void (*CS104_RedundantConnectionHandler) (void* parameter, CS104_RedundantConnection connection, int endpoint,
+        CS104_RedundantConnectionEvent event);
+
+/**
+ * \brief Switchover statistics of a redundant connection
+ */
+typedef struct {
+    uint32_t switchovers; /**< number of switchovers after the failure of the active connection */
+    uint32_t failedSwitchovers; /**< number of switchovers that failed because no standby endpoint confirmed STARTDT */
+    uint64_t lastSwitchoverTimeUs; /**< time from the failure of the active connection to the STARTDT_CON of the new active connection (in us) */
+    uint64_t maxSwitchoverTimeUs; /**< maximum switchover time (in us) */
+} sCS104_RedundantConnectionStatistics;
+
+/**
+ * \brief Create a new redundant connection
+ *
+ * \return the new redundant connection instance, or NULL in case of an error
+ */
+CS104_RedundantConnection
+CS104_RedundantConnection_create(void);
+
+/**
+ * \brief Add a server endpoint
+ *
+ * NOTE: Has to be called before \ref CS104_RedundantConnection_start.
+ *
+ * \param hostname host name or IP address of the server
+ * \param tcpPort TCP port of the server (-1 for the default port)
+ *
+ * \return index of the endpoint, or -1 in case of an error
+ */
+int
+CS104_RedundantConnection_addEndpoint(CS104_RedundantConnection self, const char* hostname, int tcpPort);
+
+/**
+ * \brief Get the connection object of an endpoint
+ *
+ * Can be used to set the parameters of the connection (e.g. \ref CS104_Connection_setAPCIParameters)
+ * before the redundant connection is started. The connection handler and the ASDU received handler
+ * of the connection are used by the redundant connection and must not be changed.
+ *
+ * \return the connection object, or NULL when the index is invalid
+ */
+CS104_Connection
+CS104_RedundantConnection_getEndpointConnection(CS104_RedundantConnection self, int endpoint);
+
+/**
+ * \brief Set the interval to reconnect failed endpoints
+ *
+ * \param intervalInMs reconnect interval in ms (default is 1000 ms)
+ */
+void
+CS104_RedundantConnection_setReconnectInterval(CS104_RedundantConnection self, int intervalInMs);
+
+/**
+ * \brief Send a station interrogation command after the data transfer is started on a new active connection
+ *
+ * \param enabled true to send the interrogation command after a switchover (and after the first activation)
+ * \param ca common address for the interrogation command
+ */
+void
+CS104_RedundantConnection_setInterrogationOnSwitchover(CS104_RedundantConnection self, bool enabled, int ca);
+
+/**
+ * \brief Set the handler for the ASDUs received by the active connection
+ */
+void
+CS104_RedundantConnection_setASDUReceivedHandler(CS104_RedundantConnection self, CS101_ASDUReceivedHandler handler, void* parameter);
+
+/**
+ * \brief Set the handler for the events of the redundant connection
+ */
+void
+CS104_RedundantConnection_setEventHandler(CS104_RedundantConnection self, CS104_RedundantConnectionHandler handler, void* parameter);
+
+/**
+ * \brief Connect to all endpoints and start the data transfer on the first connected endpoint
+ */
+void
+CS104_RedundantConnection_start(CS104_RedundantConnection self);
+
+/**
+ * \brief Get the index of the active endpoint
+ *
+ * \return index of the active endpoint or -1 when no data transfer is started
+ */
+int
+CS104_RedundantConnection_getActiveEndpoint(CS104_RedundantConnection self);
+
+/**
+ * \brief Get the connection object of the active endpoint (to send commands)
+ *
+ * \return the active connection or NULL when no data transfer is started
+ */
+CS104_Connection
+CS104_RedundantConnection_getActiveConnection(CS104_RedundantConnection self);
+
+/**
+ * \brief Get the switchover statistics
+ */
+void
+CS104_RedundantConnection_getStatistics(CS104_RedundantConnection self, sCS104_RedundantConnectionStatistics* stats);
+
+/**
+ * \brief Close all connections and release all resources
+ */
+void
+CS104_RedundantConnection_destroy(CS104_RedundantConnection self);
+
+/*! @} */
+
 /*! @} */
 
 /*! @} */
@@ -30,6 +30,12 @@
 extern "C" {
 #endif
 
+/* socket poller of the socket HAL (hal_socket.h) */
+#ifndef HAL_SOCKET_POLLER_DEFINED
+#define HAL_SOCKET_POLLER_DEFINED
+typedef struct sSocketPoller* SocketPoller;
+#endif
+
 /**
  * \file cs104_slave.h
  * \brief CS 104 slave side definitions
@@ -63,6 +69,33 @@ typedef enum
 
 typedef struct sCS104_RedundancyGroup* CS104_RedundancyGroup;
 
+/**
+ * \brief Latency values that are recorded for ASDUs sent by the slave
+ */
+typedef enum {
+    CS104_LATENCY_QUEUEING = 0,    /**< time from CS104_Slave_enqueueASDU until transmission (only ASDUs from the event queue) */
+    CS104_LATENCY_WIRE_TO_ACK = 1, /**< time from transmission until confirmation by the client (all I frames) */
+    CS104_LATENCY_TOTAL = 2        /**< time from CS104_Slave_enqueueASDU until confirmation by the client (only ASDUs from the event queue) */
+} CS104_LatencyType;
+
+/**
+ * \brief Summary of a latency histogram. All values are in microseconds.
+ *
+ * Percentile values have the precision of the histogram buckets (about 6%).
+ */
+typedef struct sCS104_LatencyStatistics* CS104_LatencyStatistics;
+
+struct sCS104_LatencyStatistics {
+    uint64_t count; /* number of recorded values */
+    uint64_t min;
+    uint64_t max;
+    uint64_t mean;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+};
+
 /**
  * \brief Connection request handler is called when a client tries to connect to the server.
  *
@@ -142,6 +175,26 @@ CS104_Slave_addPlugin(CS104_Slave self, CS101_SlavePlugin plugin);
 void
 CS104_Slave_setLocalAddress(CS104_Slave self, const char* ipAddress);
 
+/**
+ * \brief Listen on a local unix domain socket instead of a TCP port
+ *
+ * Intended for a master (e.g. a gateway or SCADA front-end) running on the same host.
+ * When set, the local address and TCP port are ignored and the connection request
+ * handler is called with the peer address "unix". A stale socket file at the given
+ * path is removed when the server is started and the file is removed again when the
+ * server is stopped.
+ *
+ * NOTE: only supported on Linux. On other platforms the server fails to start.
+ *
+ * \param self the slave instance
+ * \param path file system path of the socket, or NULL to use TCP again
+ *
+ * \return true on success, false when the path cannot be stored (then the server fails to start until
+ *         the path is set again)
+ */
+bool
+CS104_Slave_setLocalUnixPath(CS104_Slave self, const char* path);
+
 /**
  * \brief Set the local TCP port to bind the server
  *
@@ -159,6 +212,77 @@ CS104_Slave_setLocalPort(CS104_Slave self, int tcpPort);
 int
 CS104_Slave_getOpenConnections(CS104_Slave self);
 
+/**
+ * \brief Get the runtime statistics of all open client connections
+ *
+ * The statistics are read without locking and without blocking the connection handling (only the
+ * event queue depth is read with the short lock of the queue). The function can be called from any
+ * thread (e.g. a monitoring thread).
+ *
+ * NOTE: In the CS104_MODE_SINGLE_REDUNDANCY_GROUP mode all connections share the event queue of the
+ * slave. Then lowPrioQueueEntries is the depth of this shared queue and is the same for all connections.
+ *
+ * \param self the slave instance
+ * \param stats array where to store the statistics of the connections
+ * \param maxEntries the number of elements in the stats array
+ *
+ * \return number of connections stored in the stats array
+ */
+int
+CS104_Slave_getStatistics(CS104_Slave self, CS104_ConnectionStatistics stats, int maxEntries);
+
+/**
+ * \brief Enable or disable recording of latency histograms for client connections
+ *
+ * When enabled the slave records for each client connection histograms of the queueing delay
+ * (\ref CS104_Slave_enqueueASDU until transmission), the time until the transmitted I frame
+ * is confirmed by the client, and the total latency (\ref CS104_Slave_enqueueASDU until confirmation).
+ *
+ * NOTE: Has to be called before the slave is started. Requires the library to be compiled
+ * with CONFIG_CS104_SLAVE_LATENCY_STATISTICS.
+ *
+ * \param self the slave instance
+ * \param enabled true to record latency histograms, false otherwise (default)
+ */
+void
+CS104_Slave_setLatencyStatisticsEnabled(CS104_Slave self, bool enabled);
+
+/**
+ * \brief Get a summary (count, min, max, mean and percentiles) of a latency histogram of a client connection
+ *
+ * \param self the slave instance
+ * \param connectionId the ID of the connection (see \ref CS104_Slave_getStatistics)
+ * \param type the latency histogram to evaluate
+ * \param stats structure where to store the summary (values in microseconds)
+ *
+ * \return true on success, false when the connection doesn't exist or has no latency histograms
+ */
+bool
+CS104_Slave_getLatencyStatistics(CS104_Slave self, uint32_t connectionId, CS104_LatencyType type, CS104_LatencyStatistics stats);
+
+/**
+ * \brief Get an arbitrary percentile of a latency histogram of a client connection
+ *
+ * \param self the slave instance
+ * \param connectionId the ID of the connection (see \ref CS104_Slave_getStatistics)
+ * \param type the latency histogram to evaluate
+ * \param percentile the percentile (0.0 - 100.0)
+ * \param[out] value the latency in microseconds
+ *
+ * \return true on success, false when the connection doesn't exist or has no latency histograms
+ */
+bool
+CS104_Slave_getLatencyPercentile(CS104_Slave self, uint32_t connectionId, CS104_LatencyType type, double percentile, uint64_t* value);
+
+/**
+ * \brief Reset the latency histograms (e.g. at the start of a new reporting interval)
+ *
+ * \param self the slave instance
+ * \param connectionId the ID of the connection or 0 to reset the histograms of all connections
+ */
+void
+CS104_Slave_resetLatencyStatistics(CS104_Slave self, uint32_t connectionId);
+
 /**
  * \brief set the maximum number of open client connections allowed
  *
@@ -305,6 +429,25 @@ CS104_Slave_stopThreadless(CS104_Slave self);
 void
 CS104_Slave_tick(CS104_Slave self);
 
+/**
+ * \brief Register the sockets of the slave in a socket poller (non-threaded mode only)
+ *
+ * This allows a single thread to handle a large number of slaves. The server socket and the sockets
+ * of the client connections are added to the poller with the slave instance as parameter. The
+ * application waits with \ref SocketPoller_wait and calls \ref CS104_Slave_tick for the slaves with
+ * ready sockets. CS104_Slave_tick also has to be called for all slaves periodically (e.g. every
+ * 100 ms) to handle the protocol timeouts, and after events have been added with \ref CS104_Slave_enqueueASDU.
+ *
+ * With a socket poller CS104_Slave_tick doesn't wait for incoming messages.
+ *
+ * NOTE: Has to be called before \ref CS104_Slave_startThreadless. The poller has to exist until the slave
+ * is stopped.
+ *
+ * \param poller the socket poller or NULL
+ */
+void
+CS104_Slave_setSocketPoller(CS104_Slave self, SocketPoller poller);
+
 /*
  * \brief Gets the number of ASDU in the low-priority queue
  *
@@ -227,6 +227,19 @@ typedef struct {
 
 typedef sCS101_StaticASDU* CS101_StaticASDU;
 
+/**
+ * \brief Storage for a read-only ASDU that refers to an existing message buffer (see \ref CS101_ASDU_initializeView)
+ */
+typedef struct {
+    CS101_AppLayerParameters parameters;
+    uint8_t* asdu;
+    int asduHeaderLength;
+    uint8_t* payload;
+    int payloadSize;
+} sCS101_ASDUView;
+
+typedef sCS101_ASDUView* CS101_ASDUView;
+
 typedef struct sCP16Time2a* CP16Time2a;
 
 struct sCP16Time2a {
@@ -280,6 +293,46 @@ struct sCS104_APCIParameters {
     int t3;
 };
 
+/**
+ * \brief Runtime statistics of a CS104 connection
+ *
+ * The counters are updated by the protocol stack with relaxed atomic operations. Updates can
+ * happen in the connection handling (receiving) thread and in the application thread that
+ * sends an ASDU. The counters can be read at any time (e.g. by a monitoring thread) without
+ * a lock and without blocking the connection. The values of a snapshot are not necessarily
+ * consistent with each other.
+ * All times are in milliseconds.
+ */
+typedef struct sCS104_ConnectionStatistics* CS104_ConnectionStatistics;
+
+struct sCS104_ConnectionStatistics {
+    uint32_t connectionId;          /* unique ID of the connection (0 when connection slot is not used) */
+
+    uint64_t sentIFrames;           /* number of sent I frames */
+    uint64_t sentSFrames;           /* number of sent S frames */
+    uint64_t sentUFrames;           /* number of sent U frames */
+    uint64_t rcvdIFrames;           /* number of received I frames */
+    uint64_t rcvdSFrames;           /* number of received S frames */
+    uint64_t rcvdUFrames;           /* number of received U frames */
+    uint64_t sentBytes;             /* number of sent bytes (APCI + ASDU) */
+    uint64_t rcvdBytes;             /* number of received bytes (APCI + ASDU) */
+
+    uint32_t kWindow;               /* number of sent but not yet confirmed I frames */
+    uint32_t kWindowMax;            /* maximum number of sent but not yet confirmed I frames */
+    uint64_t kWindowSum;            /* sum of the k-window occupancy sampled at each sent I frame (average = kWindowSum / sentIFrames) */
+
+    uint64_t ackCount;              /* number of I frames confirmed by the counterpart */
+    uint64_t ackRttSum;             /* sum of the times between sending an I frame and receiving the confirmation */
+    uint32_t ackRttMax;             /* maximum time between sending an I frame and receiving the confirmation */
+    uint32_t ackRttLast;            /* time between sending the last confirmed I frame and receiving the confirmation */
+
+    uint32_t t1Timeouts;            /* number of t1 timeouts (I frame or TESTFR confirmation not received in time) */
+    uint32_t t3Timeouts;            /* number of t3 timeouts (TESTFR ACT sent because the connection was idle) */
+
+    uint32_t highPrioQueueRejected; /* number of ASDUs that could not be stored in the high priority queue (only slave) */
+    uint32_t lowPrioQueueEntries;   /* current number of ASDUs in the low priority (event) queue (only slave - shared queue of all connections in single redundancy group mode) */
+};
+
 #include "cs101_information_objects.h"
 
 typedef enum {                                              // iec104协议中传输原因cot为2字节
@@ -329,8 +382,86 @@ typedef enum {                                              // iec104协议中
 
 const char* CS101_CauseOfTransmission_toString(CS101_CauseOfTransmission self);
 
+/**
+ * \brief Enable or disable the debug output of all subsystems
+ *
+ * NOTE: the debug output is only available when the library is compiled with CONFIG_DEBUG_OUTPUT = 1.
+ * Enabling the debug output sets the log level of all subsystems to LIB60870_LOG_LEVEL_DEBUG, disabling
+ * sets it to LIB60870_LOG_LEVEL_NONE.
+ */
 void Lib60870_enableDebugOutput(bool value);
 
+/**
+ * \brief Subsystems of the library with separate log levels
+ */
+typedef enum {
+    LIB60870_LOG_GENERAL = 0,
+    LIB60870_LOG_CS104_SLAVE = 1,
+    LIB60870_LOG_CS104_CLIENT = 2,
+    LIB60870_LOG_LINK_LAYER = 3,
+    LIB60870_LOG_FILE_SERVICE = 4,
+    LIB60870_LOG_TLS = 5
+} Lib60870LogSubsystem;
+
+#define LIB60870_LOG_SUBSYSTEM_COUNT 6
+
+/**
+ * \brief Log levels (a message is logged when its level is less or equal the level of the subsystem)
+ */
+typedef enum {
+    LIB60870_LOG_LEVEL_NONE = 0,
+    LIB60870_LOG_LEVEL_ERROR = 1,
+    LIB60870_LOG_LEVEL_WARNING = 2,
+    LIB60870_LOG_LEVEL_INFO = 3,
+    LIB60870_LOG_LEVEL_DEBUG = 4
+} Lib60870LogLevel;
+
+/**
+ * \brief Set the log level of a subsystem at runtime
+ *
+ * \param subsystem the subsystem
+ * \param level the highest level that is logged (LIB60870_LOG_LEVEL_NONE to disable logging)
+ */
+void Lib60870_setLogLevel(Lib60870LogSubsystem subsystem, Lib60870LogLevel level);
+
+/**
+ * \brief Get the current log level of a subsystem
+ */
+Lib60870LogLevel Lib60870_getLogLevel(Lib60870LogSubsystem subsystem);
+
+/**
+ * \brief Handler that is called by \ref Lib60870_processLog for each decoded log record
+ *
+ * \param parameter user provided parameter
+ * \param timestampInNs time when the record was created (nanoseconds since epoch)
+ * \param subsystem the subsystem that created the record
+ * \param level the level of the record
+ * \param message the formatted message (only valid during the callback)
+ */
+typedef void (*Lib60870_LogHandler)(void* parameter, uint64_t timestampInNs, Lib60870LogSubsystem subsystem,
+                                    Lib60870LogLevel level, const char* message);
+
+/**
+ * \brief Decode the records of the binary log buffer
+ *
+ * The library has to be compiled with CONFIG_DEBUG_OUTPUT = 1 and CONFIG_DEBUG_OUTPUT_BINARY_LOG = 1. Then
+ * the log messages are stored in a lock-free ring buffer by the threads of the library and are only
+ * formatted when this function is called (e.g. periodically by a background thread of the application).
+ *
+ * When the buffer is full new records are dropped (see \ref Lib60870_getDroppedLogRecords).
+ *
+ * \param handler the handler that is called for each record (when NULL the messages are printed to stdout)
+ * \param parameter user provided parameter that is passed to the handler
+ *
+ * \return number of processed records
+ */
+int Lib60870_processLog(Lib60870_LogHandler handler, void* parameter);
+
+/**
+ * \brief Get the number of log records that have been dropped because the log buffer was full
+ */
+uint64_t Lib60870_getDroppedLogRecords(void);
+
 Lib60870VersionInfo Lib60870_getLibraryVersionInfo(void);
 
 /**
@@ -455,6 +586,128 @@ InformationObject CS101_ASDU_getElement(CS101_ASDU self, int index);
  */
 InformationObject CS101_ASDU_getElementEx(CS101_ASDU self, InformationObject io, int index);
 
+/**
+ * \brief Caller provided arrays for \ref CS101_ASDU_decodeColumns
+ *
+ * All arrays are optional (NULL = column is not decoded). Each provided array needs space for
+ * maxElements entries.
+ */
+typedef struct {
+    int maxElements;    /**< size of the provided arrays */
+    int* ioa;           /**< information object addresses */
+    float* value;       /**< value as float (single/double point and step position state, bitstring, normalized value as -1.0 .. 1.0, scaled value, short floating point value, counter value) */
+    int32_t* intValue;  /**< value as integer (float values are truncated, normalized values are the raw scaled value) */
+    uint8_t* quality;   /**< quality descriptor (for integrated totals the sequence number/CY/CA/IV byte) */
+    uint64_t* timestamp; /**< CP56Time2a timestamp as ms since epoch (0 for types without CP56Time2a timestamp) */
+} sCS101_ASDUColumns;
+
+typedef sCS101_ASDUColumns* CS101_ASDUColumns;
+
+/**
+ * \brief Decode all information objects of a monitoring ASDU into arrays (one array per field)
+ *
+ * In contrast to \ref CS101_ASDU_getElementEx the information objects are decoded in a single pass without
+ * creating InformationObject instances.
+ *
+ * Supported types: M_SP_NA_1, M_SP_TB_1, M_DP_NA_1, M_DP_TB_1, M_ST_NA_1, M_ST_TB_1, M_BO_NA_1, M_BO_TB_1,
+ * M_ME_NA_1, M_ME_TD_1, M_ME_NB_1, M_ME_TE_1, M_ME_NC_1, M_ME_TF_1, M_ME_ND_1, M_IT_NA_1, M_IT_TB_1
+ *
+ * \param columns the arrays where the decoded values are stored
+ *
+ * \return number of decoded information objects (at most columns->maxElements), or -1 when the type is not supported
+ */
+int
+CS101_ASDU_decodeColumns(CS101_ASDU self, CS101_ASDUColumns columns);
+
+/**
+ * \brief Get the information object address (IOA) of an information object without decoding the information object
+ *
+ * \param index the index of the information object (starting with 0)
+ *
+ * \return the IOA, or -1 when the index is out of range or the type is not supported
+ */
+int
+CS101_ASDU_getIOAAt(CS101_ASDU self, int index);
+
+/**
+ * \brief Get the analog value of an information object directly from the ASDU payload
+ *
+ * Supported types: M_ME_NA_1, M_ME_TA_1, M_ME_TD_1, M_ME_ND_1 (normalized value as -1.0 .. 1.0),
+ * M_ME_NB_1, M_ME_TB_1, M_ME_TE_1 (scaled value), M_ME_NC_1, M_ME_TC_1, M_ME_TF_1 (short floating point value)
+ * and the corresponding set point commands and parameter types. Normalized values are converted
+ * the same way as by the getValue functions of the information object types.
+ *
+ * \param index the index of the information object (starting with 0)
+ *
+ * \return the value, or 0 when the index is out of range or the type has no analog value
+ */
+float
+CS101_ASDU_getFloatAt(CS101_ASDU self, int index);
+
+/**
+ * \brief Get the quality descriptor of an information object directly from the ASDU payload
+ *
+ * For single and double point information the quality bits of the SIQ/DIQ are returned.
+ *
+ * \param index the index of the information object (starting with 0)
+ *
+ * \return the quality descriptor (IEC60870_QUALITY_GOOD for types without quality descriptor), or
+ *         IEC60870_QUALITY_INVALID when the index is out of range or the type is not supported
+ */
+QualityDescriptor
+CS101_ASDU_getQualityAt(CS101_ASDU self, int index);
+
+/**
+ * \brief Get the CP56Time2a time tag of an information object directly from the ASDU payload
+ *
+ * \param index the index of the information object (starting with 0)
+ *
+ * \return the time tag as ms since epoch, or 0 when the index is out of range or the type has no CP56Time2a time tag
+ */
+uint64_t
+CS101_ASDU_getCP56TimeMsAt(CS101_ASDU self, int index);
+
+/**
+ * \brief Iterator to read the information objects of an ASDU in order
+ *
+ * The iterator decodes the information objects into an internal information object instance that is reused
+ * for all information objects. One iterator can be used for many ASDUs (but not at the same time).
+ */
+typedef struct sCS101_ASDUIterator* CS101_ASDUIterator;
+
+/**
+ * \brief Create a new ASDU iterator
+ *
+ * \return the new iterator instance
+ */
+CS101_ASDUIterator
+CS101_ASDUIterator_create(void);
+
+/**
+ * \brief Start the iteration over the information objects of an ASDU
+ *
+ * \param asdu the ASDU. Has to remain valid during the iteration.
+ */
+void
+CS101_ASDUIterator_start(CS101_ASDUIterator self, CS101_ASDU asdu);
+
+/**
+ * \brief Get the next information object of the ASDU
+ *
+ * NOTE: The returned information object is owned by the iterator and is only valid until the next call
+ * of this function. Do not call \ref InformationObject_destroy for it!
+ *
+ * \return the next information object, or NULL when there are no more information objects (or the ASDU is invalid)
+ */
+InformationObject
+CS101_ASDUIterator_next(CS101_ASDUIterator self);
+
+/**
+ * \brief Release all resources of the iterator
+ */
+void
+CS101_ASDUIterator_destroy(CS101_ASDUIterator self);
+
 /**
  * \brief Create a new ASDU. The type ID will be derived from the first InformationObject that will be added
  *
@@ -490,6 +743,24 @@ CS101_ASDU_create(CS101_AppLayerParameters parameters, bool isSequence, CS101_Ca
 CS101_ASDU
 CS101_ASDU_initializeStatic(CS101_StaticASDU self, CS101_AppLayerParameters parameters, bool isSequence, CS101_CauseOfTransmission cot, int oa, int ca, bool isTest, bool isNegative);
 
+/**
+ * \brief Initialize a read-only ASDU for a received message without allocating memory
+ *
+ * The ASDU refers to the provided message buffer. The message buffer is not copied and has to
+ * remain valid as long as the ASDU is used.
+ *
+ * NOTE: Do not call \ref CS101_ASDU_destroy for the returned instance and do not try to append information objects!
+ *
+ * \param self pointer to the storage for the ASDU (e.g. a local variable)
+ * \param parameters the application layer parameters used to decode the ASDU
+ * \param msg the buffer containing the ASDU (starting with the type ID)
+ * \param msgLength size of the ASDU in bytes
+ *
+ * \return the ASDU instance, or NULL when the message is too small for the ASDU header
+ */
+CS101_ASDU
+CS101_ASDU_initializeView(CS101_ASDUView self, CS101_AppLayerParameters parameters, uint8_t* msg, int msgLength);
+
 /**
  * \brief Create a new ASDU that is an exact copy of the ASDU
  * 
@@ -550,6 +821,69 @@ void CS101_ASDU_destroy(CS101_ASDU self);
  */
 bool CS101_ASDU_addInformationObject(CS101_ASDU self, InformationObject io);
 
+/**
+ * \brief Add single point information objects (M_SP_NA_1) to the ASDU
+ *
+ * The information objects are encoded directly into the ASDU payload without creating
+ * InformationObject instances. Only as many information objects are added as fit into the ASDU.
+ * For sequence ASDUs the IOAs have to be subsequent. The function stops at the first IOA that
+ * doesn't continue the sequence.
+ *
+ * \param self ASDU object instance (empty or with type M_SP_NA_1)
+ * \param ioas the information object addresses
+ * \param values the values
+ * \param qds the quality descriptors (NULL for IEC60870_QUALITY_GOOD)
+ * \param n number of information objects
+ *
+ * \return number of added information objects
+ */
+int
+CS101_ASDU_addSinglePoints(CS101_ASDU self, const int* ioas, const bool* values, const QualityDescriptor* qds, int n);
+
+/**
+ * \brief Add double point information objects (M_DP_NA_1) to the ASDU
+ *
+ * See \ref CS101_ASDU_addSinglePoints for details.
+ *
+ * \return number of added information objects
+ */
+int
+CS101_ASDU_addDoublePoints(CS101_ASDU self, const int* ioas, const DoublePointValue* values, const QualityDescriptor* qds, int n);
+
+/**
+ * \brief Add normalized measured values (M_ME_NA_1) to the ASDU
+ *
+ * See \ref CS101_ASDU_addSinglePoints for details.
+ *
+ * \param values the values in the range -1.0 .. 1.0
+ *
+ * \return number of added information objects
+ */
+int
+CS101_ASDU_addMeasuredValueNormalizeds(CS101_ASDU self, const int* ioas, const float* values, const QualityDescriptor* qds, int n);
+
+/**
+ * \brief Add scaled measured values (M_ME_NB_1) to the ASDU
+ *
+ * See \ref CS101_ASDU_addSinglePoints for details.
+ *
+ * \param values the values in the range -32768 .. 32767
+ *
+ * \return number of added information objects
+ */
+int
+CS101_ASDU_addMeasuredValueScaleds(CS101_ASDU self, const int* ioas, const int* values, const QualityDescriptor* qds, int n);
+
+/**
+ * \brief Add short floating point measured values (M_ME_NC_1) to the ASDU
+ *
+ * See \ref CS101_ASDU_addSinglePoints for details.
+ *
+ * \return number of added information objects
+ */
+int
+CS101_ASDU_addMeasuredValueShorts(CS101_ASDU self, const int* ioas, const float* values, const QualityDescriptor* qds, int n);
+
 /**
  * \brief remove all information elements from the ASDU object
  *
@@ -597,6 +931,26 @@ int CP24Time2a_getMinute(const CP24Time2a self);
  */
 void CP24Time2a_setMinute(CP24Time2a self, int value);
 
+/**
+ * \brief Set the minute, second and millisecond part of the time value from a UTC ms timestamp
+ *
+ * NOTE: The flags (invalid, substituted) are not changed.
+ */
+void CP24Time2a_setFromMsTimestamp(CP24Time2a self, uint64_t timestamp);
+
+/**
+ * \brief Convert the time value to a ms timestamp
+ *
+ * As the time value only contains minutes, seconds and milliseconds the hour is taken from
+ * a reference time (e.g. the time of reception). When the result would be after the
+ * reference time the time value is considered to be in the previous hour.
+ *
+ * \param referenceTime reference time as UTC ms timestamp
+ *
+ * \return the UTC ms timestamp
+ */
+uint64_t CP24Time2a_toMsTimestamp(const CP24Time2a self, uint64_t referenceTime);
+
 /**
  * \brief Check if the invalid flag of the time value is set
  */
@@ -664,6 +1018,28 @@ void CP56Time2a_setFromMsTimestamp(CP56Time2a self, uint64_t timestamp);
  */
 uint64_t CP56Time2a_toMsTimestamp(const CP56Time2a self);
 
+/**
+ * \brief Encode an array of UTC ms timestamps as 7 byte time values
+ *
+ * Consecutive timestamps in the same hour share the calendar calculation.
+ *
+ * \param encodedValues buffer for the encoded time values (7 bytes per timestamp)
+ * \param timestamps the UTC ms timestamps
+ * \param count number of timestamps
+ */
+void CP56Time2a_setFromMsTimestamps(uint8_t* encodedValues, const uint64_t* timestamps, int count);
+
+/**
+ * \brief Convert an array of encoded 7 byte time values to UTC ms timestamps
+ *
+ * Consecutive time values in the same hour share the calendar calculation.
+ *
+ * \param encodedValues the encoded time values (7 bytes per time value)
+ * \param timestamps buffer for the UTC ms timestamps
+ * \param count number of time values
+ */
+void CP56Time2a_toMsTimestamps(const uint8_t* encodedValues, uint64_t* timestamps, int count);
+
 /**
  * \brief Get the ms part of a time value
  */
@@ -52,6 +52,144 @@ extern "C" {
  */
 typedef bool (*CS101_ASDUReceivedHandler) (void* parameter, int address, CS101_ASDU asdu);
 
+/**
+ * @defgroup MIRROR_CACHE Latest value mirror cache
+ *
+ * The mirror cache stores the latest value, quality and timestamp of each monitored data point
+ * (identified by CA and IOA). It is updated by the thread that receives the ASDUs (see
+ * \ref CS104_Connection_setMirrorCache and \ref CS101_Master_setMirrorCache) and can be read by any number of
+ * other threads. Readers don't take a lock and never block the receiving thread.
+ *
+ * Supported types: M_SP_NA_1, M_SP_TB_1, M_DP_NA_1, M_DP_TB_1, M_ST_NA_1, M_ST_TB_1, M_BO_NA_1, M_BO_TB_1,
+ * M_ME_NA_1, M_ME_TD_1, M_ME_NB_1, M_ME_TE_1, M_ME_NC_1, M_ME_TF_1, M_ME_ND_1, M_IT_NA_1, M_IT_TB_1
+ *
+ * @{
+ */
+
+typedef struct sCS101_MirrorCache* CS101_MirrorCache;
+
+/**
+ * \brief Latest value of a data point in the mirror cache
+ */
+typedef struct {
+    IEC60870_5_TypeID typeId; /**< type ID of the last update */
+    float value; /**< value as float (see \ref sCS101_ASDUColumns) */
+    int32_t intValue; /**< value as integer (see \ref sCS101_ASDUColumns) */
+    QualityDescriptor quality; /**< quality descriptor (for integrated totals the sequence number/CY/CA/IV byte) */
+    uint64_t timestamp; /**< CP56Time2a timestamp as ms since epoch (0 for types without CP56Time2a timestamp) */
+    uint64_t updateTime; /**< local time of the last update (ms since epoch) */
+    uint32_t sequence; /**< value of the cache update counter (\ref CS101_MirrorCache_getSequence) at the last update */
+    uint32_t changeCount; /**< number of updates that changed the value or the quality */
+} sCS101_MirrorCacheValue;
+
+/**
+ * \brief Handler that is called when the value or the quality of a subscribed data point changes
+ *
+ * The handler is called by the thread that updates the cache after the update is complete. The cache is not
+ * locked for other writers while the handler is running, but the handlers of one cache are not called
+ * concurrently. The handler can read the cache. It must not call \ref CS101_MirrorCache_subscribe,
+ * \ref CS101_MirrorCache_unsubscribe or \ref CS101_MirrorCache_handleASDU of the same cache.
+ *
+ * \param parameter user provided parameter
+ * \param ca common address of the data point
+ * \param ioa information object address of the data point
+ * \param value the current value of the data point (only valid in the context of the callback)
+ */
+typedef void (*CS101_MirrorCacheHandler) (void* parameter, int ca, int ioa, const sCS101_MirrorCacheValue* value);
+
+typedef struct sCS101_MirrorCacheSubscription* CS101_MirrorCacheSubscription;
+
+/**
+ * \brief Create a new mirror cache
+ *
+ * \param maxPoints maximum number of data points. Updates for additional data points are ignored.
+ *
+ * \return the new mirror cache instance
+ */
+CS101_MirrorCache
+CS101_MirrorCache_create(int maxPoints);
+
+/**
+ * \brief Update the cache with the information objects of a monitoring ASDU
+ *
+ * NOTE: Is called by the connection when the cache is attached to a connection. Updates are serialized by
+ * an internal lock.
+ *
+ * \return number of updated data points, or -1 when the type of the ASDU is not supported
+ */
+int
+CS101_MirrorCache_handleASDU(CS101_MirrorCache self, CS101_ASDU asdu);
+
+/**
+ * \brief Get the latest value of a data point
+ *
+ * Can be called by any thread without blocking the thread that updates the cache.
+ *
+ * \param ca common address of the data point
+ * \param ioa information object address of the data point
+ * \param value the structure where the value is stored
+ *
+ * \return true when the data point is in the cache, false otherwise
+ */
+bool
+CS101_MirrorCache_getValue(CS101_MirrorCache self, int ca, int ioa, sCS101_MirrorCacheValue* value);
+
+/**
+ * \brief Get the update counter of the cache
+ *
+ * The counter is incremented for each updated data point. It can be used to check if anything has changed
+ * since the last time the cache was read.
+ */
+uint32_t
+CS101_MirrorCache_getSequence(CS101_MirrorCache self);
+
+/**
+ * \brief Get the number of data points in the cache
+ */
+int
+CS101_MirrorCache_getNumberOfPoints(CS101_MirrorCache self);
+
+/**
+ * \brief Get the number of updates that were ignored because the cache was full
+ */
+uint32_t
+CS101_MirrorCache_getDroppedUpdates(CS101_MirrorCache self);
+
+/**
+ * \brief Subscribe for changes of a range of data points
+ *
+ * The handler is called when a data point in the range is added to the cache or when the value or the quality
+ * of the data point changes.
+ *
+ * \param ca common address of the data points (-1 for all common addresses)
+ * \param firstIOA first information object address of the range
+ * \param lastIOA last information object address of the range
+ * \param handler the callback handler
+ * \param parameter user provided parameter that is passed to the callback handler
+ *
+ * \return the subscription (to be used with \ref CS101_MirrorCache_unsubscribe)
+ */
+CS101_MirrorCacheSubscription
+CS101_MirrorCache_subscribe(CS101_MirrorCache self, int ca, int firstIOA, int lastIOA, CS101_MirrorCacheHandler handler, void* parameter);
+
+/**
+ * \brief Remove a subscription
+ *
+ * When the function returns the handler of the subscription is not running and will not be called again.
+ */
+void
+CS101_MirrorCache_unsubscribe(CS101_MirrorCache self, CS101_MirrorCacheSubscription subscription);
+
+/**
+ * \brief Release all resources of the cache
+ *
+ * NOTE: The cache has to be removed from connections before it is destroyed.
+ */
+void
+CS101_MirrorCache_destroy(CS101_MirrorCache self);
+
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -70,6 +70,7 @@ struct sIMasterConnection {
     void (*close) (IMasterConnection self);
     int (*getPeerAddress) (IMasterConnection self, char* addrBuf, int addrBufSize);
     CS101_AppLayerParameters (*getApplicationLayerParameters) (IMasterConnection self);
+    bool (*getStatistics) (IMasterConnection self, CS104_ConnectionStatistics stats);
     void* object;
 };
 
@@ -152,6 +153,18 @@ IMasterConnection_close(IMasterConnection self);
 CS101_AppLayerParameters
 IMasterConnection_getApplicationLayerParameters(IMasterConnection self);
 
+/**
+ * \brief Get the runtime statistics of the master connection (only for CS 104)
+ *
+ * The function doesn't block the connection and can be called from any thread.
+ *
+ * \param stats structure where to store the statistics values
+ *
+ * \return true when the statistics have been stored, false if function not supported
+ */
+bool
+IMasterConnection_getStatistics(IMasterConnection self, CS104_ConnectionStatistics stats);
+
 /**
  * @}
  */
@@ -58,6 +58,26 @@ CP56Time2a_getFromBuffer (CP56Time2a self, const uint8_t* msg, int msgSize, int
 uint8_t*
 CP56Time2a_getEncodedValue(CP56Time2a self);
 
+/**
+ * Cache for the conversion between ms timestamps and CP56Time2a values. Stores the
+ * hour, day, month and year part of the last converted hour. Conversions for time values
+ * in the same hour only have to handle the minute and millisecond parts.
+ */
+typedef struct {
+    bool valid;
+    uint32_t hourIndex; /* hours since 1970-01-01 00:00 UTC (only for encoding) */
+    uint32_t encodedHour; /* bytes 3 to 6 of the CP56Time2a (hour, day of month, month, year) */
+    uint64_t hourStart; /* ms timestamp of the start of the hour */
+} CP56Time2aHourCache;
+
+/* encode a ms timestamp as 7 byte CP56Time2a value (cache is optional) */
+void
+CP56Time2a_encodeMsTimestamp(uint8_t* encodedValue, uint64_t timestamp, CP56Time2aHourCache* cache);
+
+/* convert a 7 byte CP56Time2a value to a ms timestamp (cache is optional) */
+uint64_t
+CP56Time2a_decodeMsTimestamp(const uint8_t* encodedValue, CP56Time2aHourCache* cache);
+
 #ifdef __cplusplus
 }
 #endif
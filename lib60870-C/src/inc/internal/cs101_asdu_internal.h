@@ -52,6 +52,19 @@ extern "C" {
 CS101_ASDU
 CS101_ASDU_createFromBuffer(CS101_AppLayerParameters parameters, uint8_t* msg, int msgLength);
 
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+/**
+ * \brief Set the field sizes of the parameters to the fixed profile (COT = 2, CA = 2, IOA = 3)
+ *
+ * The codec of the fixed profile build ignores the field sizes of the parameters. Other sizes
+ * are replaced and a warning is logged.
+ *
+ * \return true when the parameters already used the fixed profile, false otherwise
+ */
+bool
+CS101_AppLayerParameters_applyFixedProfile(CS101_AppLayerParameters parameters);
+#endif /* (CONFIG_CS101_FIXED_AL_PROFILE == 1) */
+
 #ifdef __cplusplus
 }
 #endif
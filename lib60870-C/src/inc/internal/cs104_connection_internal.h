@@ -0,0 +1,63 @@
+/*
+ *  cs104_connection_internal.h
+ *
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_INTERNAL_CS104_CONNECTION_INTERNAL_H_
+#define SRC_INC_INTERNAL_CS104_CONNECTION_INTERNAL_H_
+
+#include <stdbool.h>
+
+#include "cs104_connection.h"
+#include "hal_thread.h"
+#include "lib60870_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Check if the connection is established and not yet closed
+ */
+bool
+CS104_Connection_isRunning(CS104_Connection self);
+
+#if (CONFIG_USE_SEMAPHORES == 1)
+/**
+ * \brief Set a semaphore that is posted with the events CS104_CONNECTION_SEND_QUEUE_AVAILABLE,
+ * CS104_CONNECTION_CLOSED and CS104_CONNECTION_FAILED
+ *
+ * Used by library components (e.g. the capture replay) that have to wait for these events
+ * without replacing the connection handler of the application.
+ *
+ * \param signal the semaphore, or NULL to remove it
+ *
+ * \return false when the connection doesn't use a send queue (see \ref CS104_Connection_setSendQueueSize)
+ */
+bool
+CS104_Connection_setEventSignal(CS104_Connection self, Semaphore signal);
+#endif /* (CONFIG_USE_SEMAPHORES == 1) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_INC_INTERNAL_CS104_CONNECTION_INTERNAL_H_ */
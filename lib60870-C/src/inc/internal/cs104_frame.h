@@ -25,9 +25,34 @@
 #include <stdint.h>
 
 #include "frame.h"
+#include "lib60870_config.h"
+
+#ifndef CONFIG_LIB60870_STATIC_FRAMES
+#define CONFIG_LIB60870_STATIC_FRAMES 0
+#endif
+
+struct sT104Frame {
+    FrameVFT virtualFunctionTable;
+
+    uint8_t buffer[256];
+    int msgSize;
+
+#if (CONFIG_LIB60870_STATIC_FRAMES == 1)
+    /* TODO move to base class? */
+    uint8_t allocated;
+#endif
+};
 
 typedef struct sT104Frame* T104Frame;
 
+/**
+ * \brief Initialize a frame that is allocated by the caller (e.g. on the stack)
+ *
+ * A frame initialized with this function must not be released with T104Frame_destroy.
+ */
+Frame
+T104Frame_initialize(T104Frame self);
+
 T104Frame
 T104Frame_create(void);
 
@@ -0,0 +1,117 @@
+/*
+ *  cs104_statistics.h
+ *
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_INTERNAL_CS104_STATISTICS_H_
+#define SRC_INC_INTERNAL_CS104_STATISTICS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "iec60870_common.h"
+#include "cs104_slave.h"
+#include "lib60870_atomic.h"
+
+/*
+ * Update functions for the CS104 connection statistics.
+ *
+ * The functions are called by the connection handling code. For the client this is the
+ * receiving thread and also the application thread that calls a send function (with
+ * conStateLock). For the slave it is the connection handling thread and the threads that
+ * send ASDUs to the connection (with stateLock). All updates use atomic operations, so
+ * no additional lock is required. A snapshot can be taken at any time from another thread
+ * with CS104_ConnectionStatistics_getSnapshot.
+ */
+
+void
+CS104_ConnectionStatistics_reset(CS104_ConnectionStatistics self, uint32_t connectionId);
+
+void
+CS104_ConnectionStatistics_frameSent(CS104_ConnectionStatistics self, const uint8_t* msg, int msgSize);
+
+void
+CS104_ConnectionStatistics_frameReceived(CS104_ConnectionStatistics self, const uint8_t* msg, int msgSize);
+
+/**
+ * \brief Update the k-window occupancy
+ *
+ * \param kWindow current number of sent but unconfirmed I frames
+ * \param iFrameSent true when called after an I frame has been sent (adds a sample to kWindowSum)
+ */
+void
+CS104_ConnectionStatistics_setKWindow(CS104_ConnectionStatistics self, int kWindow, bool iFrameSent);
+
+/**
+ * \brief Count a confirmed I frame and update the acknowledgement RTT values
+ *
+ * \param sentTime time when the I frame was sent
+ * \param ackTime time when the confirmation was received
+ */
+void
+CS104_ConnectionStatistics_addAck(CS104_ConnectionStatistics self, uint64_t sentTime, uint64_t ackTime);
+
+void
+CS104_ConnectionStatistics_getSnapshot(CS104_ConnectionStatistics self, CS104_ConnectionStatistics snapshot);
+
+#define CS104_STATISTICS_INC(self, counter) LIB60870_ATOMIC_ADD(&((self)->counter), 1)
+
+/*
+ * Latency histogram with logarithmic buckets (similar to HDR histograms).
+ *
+ * Values (in microseconds) below 32 are recorded exactly. Larger values are recorded
+ * with 16 sub-buckets per power of two (relative error < 6.25%). Values above 2^32 - 1
+ * are recorded in the last bucket.
+ */
+
+#define CS104_LATENCY_HISTOGRAM_SUB_BUCKETS 16
+#define CS104_LATENCY_HISTOGRAM_BUCKETS (28 * CS104_LATENCY_HISTOGRAM_SUB_BUCKETS + 16)
+
+typedef struct sCS104_LatencyHistogram* CS104_LatencyHistogram;
+
+struct sCS104_LatencyHistogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint32_t buckets[CS104_LATENCY_HISTOGRAM_BUCKETS];
+};
+
+void
+CS104_LatencyHistogram_reset(CS104_LatencyHistogram self);
+
+void
+CS104_LatencyHistogram_record(CS104_LatencyHistogram self, uint64_t value);
+
+/**
+ * \brief Get the value at the given percentile
+ *
+ * \param percentile value between 0.0 and 100.0
+ *
+ * \return highest value that is equivalent to the bucket containing the percentile (0 when histogram is empty)
+ */
+uint64_t
+CS104_LatencyHistogram_getPercentile(CS104_LatencyHistogram self, double percentile);
+
+void
+CS104_LatencyHistogram_getSummary(CS104_LatencyHistogram self, CS104_LatencyStatistics stats);
+
+#endif /* SRC_INC_INTERNAL_CS104_STATISTICS_H_ */
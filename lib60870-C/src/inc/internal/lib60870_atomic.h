@@ -0,0 +1,65 @@
+/*
+ *  lib60870_atomic.h
+ *
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_INTERNAL_LIB60870_ATOMIC_H_
+#define SRC_INC_INTERNAL_LIB60870_ATOMIC_H_
+
+/*
+ * Minimal set of atomic operations used for counters and flags that are
+ * read by other threads without taking a lock.
+ *
+ * When the compiler has no support for atomic builtins plain memory
+ * accesses are used. Then the values are still usable for monitoring
+ * purposes but updates from different threads can get lost. The acquire/release
+ * and CAS variants are then only safe when used by a single thread.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+
+#define LIB60870_ATOMIC_ADD(ptr, value) ((void) __atomic_fetch_add((ptr), (value), __ATOMIC_RELAXED))
+#define LIB60870_ATOMIC_SUB(ptr, value) ((void) __atomic_fetch_sub((ptr), (value), __ATOMIC_RELAXED))
+#define LIB60870_ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define LIB60870_ATOMIC_STORE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELAXED)
+#define LIB60870_ATOMIC_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define LIB60870_ATOMIC_STORE_RELEASE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define LIB60870_ATOMIC_CAS(ptr, expectedPtr, desired) \
+    __atomic_compare_exchange_n((ptr), (expectedPtr), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#define LIB60870_ATOMIC_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define LIB60870_ATOMIC_FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+
+#else
+
+#define LIB60870_ATOMIC_ADD(ptr, value) ((void) (*(ptr) += (value)))
+#define LIB60870_ATOMIC_SUB(ptr, value) ((void) (*(ptr) -= (value)))
+#define LIB60870_ATOMIC_LOAD(ptr) (*(ptr))
+#define LIB60870_ATOMIC_STORE(ptr, value) ((void) (*(ptr) = (value)))
+#define LIB60870_ATOMIC_LOAD_ACQUIRE(ptr) (*(ptr))
+#define LIB60870_ATOMIC_STORE_RELEASE(ptr, value) ((void) (*(ptr) = (value)))
+#define LIB60870_ATOMIC_CAS(ptr, expectedPtr, desired) \
+    ((*(ptr) == *(expectedPtr)) ? ((*(ptr) = (desired)), 1) : ((*(expectedPtr) = *(ptr)), 0))
+#define LIB60870_ATOMIC_FENCE_ACQUIRE() ((void) 0)
+#define LIB60870_ATOMIC_FENCE_RELEASE() ((void) 0)
+
+#endif
+
+#endif /* SRC_INC_INTERNAL_LIB60870_ATOMIC_H_ */
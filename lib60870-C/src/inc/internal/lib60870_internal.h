@@ -22,15 +22,55 @@
 #ifndef SRC_INC_INTERNAL_LIB60870_INTERNAL_H_
 #define SRC_INC_INTERNAL_LIB60870_INTERNAL_H_
 
+#include <stdint.h>
+
 #include "lib60870_config.h"
+#include "iec60870_common.h"
+
+/*
+ * Source files can select the subsystem used for the log level of their debug
+ * messages by defining LIB60870_LOG_SUBSYSTEM before including this file.
+ */
+#ifndef LIB60870_LOG_SUBSYSTEM
+#define LIB60870_LOG_SUBSYSTEM LIB60870_LOG_GENERAL
+#endif
 
+extern uint8_t lib60870_logLevels[LIB60870_LOG_SUBSYSTEM_COUNT];
+
+void
+lib60870_log_record(int subsystem, int level, const char *format, ...);
+
+#if (CONFIG_CS104_SUPPORT_TLS == 1)
+/* installs or removes the debug handler of the TLS layer (HAL) according to the log level of LIB60870_LOG_TLS */
 void
-lib60870_debug_print(const char *format, ...);
+lib60870_updateTLSDebugHandler(void);
+#endif
 
 #if (CONFIG_DEBUG_OUTPUT == 1)
-#define DEBUG_PRINT(...)  do{ lib60870_debug_print(__VA_ARGS__ ); } while( false )
+#define LIB60870_LOG(level, ...) do{ if (lib60870_logLevels[LIB60870_LOG_SUBSYSTEM] >= (level)) \
+        lib60870_log_record(LIB60870_LOG_SUBSYSTEM, (level), __VA_ARGS__ ); } while( false )
+#else
+#define LIB60870_LOG(level, ...) do{ } while ( false )
+#endif
+
+#define DEBUG_PRINT(...) LIB60870_LOG(LIB60870_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#ifndef CONFIG_CS101_FIXED_AL_PROFILE
+#define CONFIG_CS101_FIXED_AL_PROFILE 0
+#endif
+
+/*
+ * Sizes of the variable length fields of the application layer. With the fixed profile
+ * the sizes are constants and the codec doesn't depend on the application layer parameters.
+ */
+#if (CONFIG_CS101_FIXED_AL_PROFILE == 1)
+#define CS101_SIZE_OF_COT(parameters) 2
+#define CS101_SIZE_OF_CA(parameters) 2
+#define CS101_SIZE_OF_IOA(parameters) 3
 #else
-#define DEBUG_PRINT(...) do{ } while ( false )
+#define CS101_SIZE_OF_COT(parameters) ((parameters)->sizeOfCOT)
+#define CS101_SIZE_OF_CA(parameters) ((parameters)->sizeOfCA)
+#define CS101_SIZE_OF_IOA(parameters) ((parameters)->sizeOfIOA)
 #endif
 
 #define IEC60870_5_104_MAX_ASDU_LENGTH 249
@@ -0,0 +1,91 @@
+/*
+ *  lib60870_trace.h
+ *
+ *  Copyright 2023 Michael Zillgith
+ *
+ *  This file is part of lib60870-C
+ *
+ *  lib60870-C is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  lib60870-C is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with lib60870-C.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SRC_INC_INTERNAL_LIB60870_TRACE_H_
+#define SRC_INC_INTERNAL_LIB60870_TRACE_H_
+
+/*
+ * Static tracepoints (USDT probes) for perf, bpftrace, systemtap, ...
+ *
+ * The probes are only compiled in when CONFIG_LIB60870_TRACEPOINTS is set to 1
+ * (CMake option WITH_TRACEPOINTS). Then each probe is a single NOP instruction. The
+ * locations of the probe arguments are stored in an ELF note, so the arguments should be
+ * values that are available anyway (no function calls). When CONFIG_LIB60870_TRACEPOINTS
+ * is not set the probes are removed completely by the preprocessor.
+ *
+ * All probes are defined for the provider "lib60870". Example:
+ *
+ *   bpftrace -e 'usdt:./liblib60870.so:lib60870:cs104_slave_ack { printf("%d %d\n", arg0, arg1); }'
+ *
+ * Available probes (arguments in brackets):
+ *
+ * CS104 slave:
+ *   cs104_slave_frame_recv     (connectionId, size, control field 1)
+ *   cs104_slave_handle_message (connectionId, frame type (0 = I, 1 = S, 3 = U), size, N(S)/control field, N(R))
+ *   cs104_slave_handle_asdu    (connectionId, type ID, COT, number of elements)
+ *   cs104_slave_enqueue        (type ID, COT, ASDU size)
+ *   cs104_slave_send           (connectionId, N(S), N(R), size)
+ *   cs104_slave_ack            (connectionId, N(R), k-window after ack)
+ *   cs104_slave_timeout        (connectionId, timeout (1 = t1, 2 = t2, 3 = t3))
+ *   cs104_slave_state          (connectionId, CS104_PeerConnectionEvent)
+ *
+ * CS104 client (CS104_Connection):
+ *   cs104_client_frame_recv     (connectionId, size, control field 1)
+ *   cs104_client_handle_message (connectionId, frame type (0 = I, 1 = S, 3 = U), size, N(S)/control field, N(R))
+ *   cs104_client_handle_asdu    (connectionId, type ID, COT, number of elements)
+ *   cs104_client_send           (connectionId, N(S), N(R), size)
+ *   cs104_client_ack            (connectionId, N(R), k-window after ack)
+ *   cs104_client_timeout        (connectionId, timeout (1 = t1, 2 = t2, 3 = t3))
+ *   cs104_client_state          (connectionId, CS104_ConnectionEvent)
+ */
+
+#define LIB60870_TRACE_TIMEOUT_T1 1
+#define LIB60870_TRACE_TIMEOUT_T2 2
+#define LIB60870_TRACE_TIMEOUT_T3 3
+
+/* frame type as used by the handle_message probes */
+#define LIB60870_TRACE_FRAME_TYPE(ctrl1) ((((ctrl1) & 1) == 0) ? 0 : ((ctrl1) & 3))
+
+#ifndef CONFIG_LIB60870_TRACEPOINTS
+#define CONFIG_LIB60870_TRACEPOINTS 0
+#endif
+
+#if (CONFIG_LIB60870_TRACEPOINTS == 1)
+
+#include <sys/sdt.h>
+
+#define LIB60870_TRACE2(name, a1, a2) DTRACE_PROBE2(lib60870, name, a1, a2)
+#define LIB60870_TRACE3(name, a1, a2, a3) DTRACE_PROBE3(lib60870, name, a1, a2, a3)
+#define LIB60870_TRACE4(name, a1, a2, a3, a4) DTRACE_PROBE4(lib60870, name, a1, a2, a3, a4)
+#define LIB60870_TRACE5(name, a1, a2, a3, a4, a5) DTRACE_PROBE5(lib60870, name, a1, a2, a3, a4, a5)
+
+#else
+
+#define LIB60870_TRACE2(name, a1, a2) do {} while (0)
+#define LIB60870_TRACE3(name, a1, a2, a3) do {} while (0)
+#define LIB60870_TRACE4(name, a1, a2, a3, a4) do {} while (0)
+#define LIB60870_TRACE5(name, a1, a2, a3, a4, a5) do {} while (0)
+
+#endif /* (CONFIG_LIB60870_TRACEPOINTS == 1) */
+
+#endif /* SRC_INC_INTERNAL_LIB60870_TRACE_H_ */
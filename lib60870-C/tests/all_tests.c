@@ -2,12 +2,25 @@
 #include "iec60870_common.h"
 #include "cs104_slave.h"
 #include "cs104_connection.h"
+#include "cs104_capture.h"
 #include "hal_time.h"
 #include "hal_thread.h"
+#include "hal_socket.h"
 #include "buffer_frame.h"
+#include "lib60870_config.h"
+#include "lib60870_internal.h"
+#include "lib_memory.h"
+#include "cs104_statistics.h"
+#include "serial_transceiver_ft_1_2.h"
 #include <string.h>
 #include <stdlib.h>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
 #ifndef CONFIG_CS104_SUPPORT_TLS
 #define CONFIG_CS104_SUPPORT_TLS 0
 #endif
@@ -241,6 +254,79 @@ test_CP56Time2aConversionFunctions(void)
     TEST_ASSERT_EQUAL_UINT64(currentTime, convertedTime);
 }
 
+void
+test_CP56Time2aBatchConversion(void)
+{
+    struct sCP56Time2a timeval;
+
+    /* leap day */
+    CP56Time2a_setFromMsTimestamp(&timeval, (uint64_t) 951827696789);
+
+    TEST_ASSERT_EQUAL_INT(0, CP56Time2a_getYear(&timeval));
+    TEST_ASSERT_EQUAL_INT(2, CP56Time2a_getMonth(&timeval));
+    TEST_ASSERT_EQUAL_INT(29, CP56Time2a_getDayOfMonth(&timeval));
+    TEST_ASSERT_EQUAL_INT(0, CP56Time2a_getDayOfWeek(&timeval));
+    TEST_ASSERT_EQUAL_INT(12, CP56Time2a_getHour(&timeval));
+    TEST_ASSERT_EQUAL_INT(34, CP56Time2a_getMinute(&timeval));
+    TEST_ASSERT_EQUAL_INT(56, CP56Time2a_getSecond(&timeval));
+    TEST_ASSERT_EQUAL_INT(789, CP56Time2a_getMillisecond(&timeval));
+    TEST_ASSERT_FALSE(CP56Time2a_isInvalid(&timeval));
+    TEST_ASSERT_FALSE(CP56Time2a_isSummerTime(&timeval));
+
+    /* end of year */
+    CP56Time2a_setFromMsTimestamp(&timeval, (uint64_t) 1735689599999);
+
+    TEST_ASSERT_EQUAL_INT(24, CP56Time2a_getYear(&timeval));
+    TEST_ASSERT_EQUAL_INT(12, CP56Time2a_getMonth(&timeval));
+    TEST_ASSERT_EQUAL_INT(31, CP56Time2a_getDayOfMonth(&timeval));
+    TEST_ASSERT_EQUAL_INT(23, CP56Time2a_getHour(&timeval));
+    TEST_ASSERT_EQUAL_INT(59, CP56Time2a_getMinute(&timeval));
+    TEST_ASSERT_EQUAL_INT(59, CP56Time2a_getSecond(&timeval));
+    TEST_ASSERT_EQUAL_INT(999, CP56Time2a_getMillisecond(&timeval));
+
+    /* batch conversion across hour, day, month and year boundaries */
+    uint64_t timestamps[200];
+    uint64_t converted[200];
+    uint8_t encoded[200 * 7];
+    int i;
+
+    for (i = 0; i < 200; i++)
+        timestamps[i] = (uint64_t) 1735689599999 - (uint64_t) 5000000 + ((uint64_t) i * 60013);
+
+    timestamps[100] = (uint64_t) 951827696789;
+    timestamps[101] = (uint64_t) 1677628800000;
+
+    CP56Time2a_setFromMsTimestamps(encoded, timestamps, 200);
+
+    for (i = 0; i < 200; i++) {
+        CP56Time2a_setFromMsTimestamp(&timeval, timestamps[i]);
+        TEST_ASSERT_EQUAL_MEMORY(timeval.encodedValue, encoded + (i * 7), 7);
+    }
+
+    CP56Time2a_toMsTimestamps(encoded, converted, 200);
+
+    for (i = 0; i < 200; i++)
+        TEST_ASSERT_EQUAL_UINT64(timestamps[i], converted[i]);
+
+    /* CP24Time2a */
+    struct sCP24Time2a cp24;
+
+    memset(&cp24, 0, sizeof(cp24));
+    CP24Time2a_setInvalid(&cp24, true);
+
+    CP24Time2a_setFromMsTimestamp(&cp24, (uint64_t) 951827696789);
+
+    TEST_ASSERT_EQUAL_INT(34, CP24Time2a_getMinute(&cp24));
+    TEST_ASSERT_EQUAL_INT(56, CP24Time2a_getSecond(&cp24));
+    TEST_ASSERT_EQUAL_INT(789, CP24Time2a_getMillisecond(&cp24));
+    TEST_ASSERT_TRUE(CP24Time2a_isInvalid(&cp24));
+
+    TEST_ASSERT_EQUAL_UINT64((uint64_t) 951827696789, CP24Time2a_toMsTimestamp(&cp24, (uint64_t) 951827696789 + 1000));
+
+    /* reference time is in the next hour */
+    TEST_ASSERT_EQUAL_UINT64((uint64_t) 951827696789, CP24Time2a_toMsTimestamp(&cp24, (uint64_t) 951827696789 + 1800000));
+}
+
 void
 test_StepPositionInformation(void)
 {
@@ -1138,6 +1224,9 @@ test_CS104SlaveEventQueue1_asduReceivedHandler (void* parameter, int address, CS
 
 struct sTestMessageQueueEntryInfo {
 	uint64_t entryTimestamp;
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+	uint64_t enqueueTime;
+#endif
 	unsigned int entryState : 2;
 	unsigned int size : 8;
 };
@@ -5313,287 +5402,3255 @@ test_CS104_Connection_async_timeout(void)
 }
 
 void
-test_CS101_ASDU_addObjectOfWrongType(void)
+test_CS104_Connection_statistics(void)
 {
-    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_PERIODIC, 0, 1, false, false);
-
-    InformationObject io1 = (InformationObject) SinglePointInformation_create(NULL, 101, true, IEC60870_QUALITY_GOOD);
-
-    bool added = CS101_ASDU_addInformationObject(asdu, io1);
-
-    TEST_ASSERT_TRUE(added);
-
-    InformationObject_destroy(io1);
-
-    InformationObject io2 = (InformationObject) DoublePointInformation_create(NULL, 102, IEC60870_DOUBLE_POINT_OFF, IEC60870_QUALITY_GOOD);
-
-    added = CS101_ASDU_addInformationObject(asdu, io2);
-
-    TEST_ASSERT_FALSE(added);
-
-    InformationObject_destroy(io2);
+    CS104_Slave slave = CS104_Slave_create(100, 100);
 
-    CS101_ASDU_destroy(asdu);
-}
+    TEST_ASSERT_NOT_NULL(slave);
 
-void
-test_CS101_ASDU_addUntilOverflow(void)
-{
-    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_PERIODIC, 0, 1, false, false);
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
 
-    int i = 0;
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
 
-    for (i = 0; i < 60; i++) {
-        InformationObject io = (InformationObject) SinglePointInformation_create(NULL, 100 + i, true, IEC60870_QUALITY_GOOD);
+    TEST_ASSERT_NOT_NULL(con);
 
-        bool added = CS101_ASDU_addInformationObject(asdu, io);
+    struct sCS104_ConnectionStatistics conStats;
 
-        TEST_ASSERT_TRUE(added);
+    /* no statistics before the first connection */
+    TEST_ASSERT_FALSE(CS104_Connection_getStatistics(con, &conStats));
 
-        InformationObject_destroy(io);
+    bool result = CS104_Connection_connect(con);
 
-        TEST_ASSERT_EQUAL_INT(i + 1, CS101_ASDU_getNumberOfElements(asdu));
-    }
+    TEST_ASSERT_TRUE(result);
 
-    InformationObject io = (InformationObject) SinglePointInformation_create(NULL, 100 + i, true, IEC60870_QUALITY_GOOD);
+    CS104_Connection_sendStartDT(con);
 
-    bool added = CS101_ASDU_addInformationObject(asdu, io);
+    Thread_sleep(500);
 
-    TEST_ASSERT_FALSE(added);
+    result = CS104_Connection_sendInterrogationCommand(con, CS101_COT_ACTIVATION, 1, IEC60870_QOI_STATION);
 
-    InformationObject_destroy(io);
+    TEST_ASSERT_TRUE(result);
 
-    CS101_ASDU_destroy(asdu);
-}
+    Thread_sleep(500);
 
-void
-test_CS101_ASDU_clone(void)
-{
-    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_PERIODIC, 0, 1, false, false);
+    TEST_ASSERT_TRUE(CS104_Connection_getStatistics(con, &conStats));
 
-    int i = 0;
+    TEST_ASSERT_NOT_EQUAL(0, conStats.connectionId);
+    TEST_ASSERT_EQUAL_UINT64(1, conStats.sentIFrames);
+    TEST_ASSERT_EQUAL_UINT64(1, conStats.sentUFrames);
+    TEST_ASSERT_EQUAL_UINT64(1, conStats.rcvdUFrames);
+    TEST_ASSERT_TRUE(conStats.rcvdIFrames >= 1);
+    TEST_ASSERT_EQUAL_UINT64(1, conStats.ackCount);
+    TEST_ASSERT_EQUAL_UINT32(0, conStats.kWindow);
+    TEST_ASSERT_EQUAL_UINT32(1, conStats.kWindowMax);
+    TEST_ASSERT_EQUAL_UINT32(0, conStats.t1Timeouts);
+    TEST_ASSERT_EQUAL_UINT64(6 + 16, conStats.sentBytes); /* STARTDT ACT + C_IC_NA_1 */
 
-    for (i = 0; i < 60; i++) {
-        InformationObject io = (InformationObject) SinglePointInformation_create(NULL, 100 + i, true, IEC60870_QUALITY_GOOD);
+    struct sCS104_ConnectionStatistics slaveStats[2];
 
-        bool added = CS101_ASDU_addInformationObject(asdu, io);
+    int count = CS104_Slave_getStatistics(slave, slaveStats, 2);
 
-        TEST_ASSERT_TRUE(added);
+    TEST_ASSERT_EQUAL_INT(1, count);
+    TEST_ASSERT_NOT_EQUAL(0, slaveStats[0].connectionId);
+    TEST_ASSERT_EQUAL_UINT64(1, slaveStats[0].rcvdIFrames);
+    TEST_ASSERT_EQUAL_UINT64(1, slaveStats[0].rcvdUFrames);
+    TEST_ASSERT_EQUAL_UINT64(conStats.rcvdIFrames, slaveStats[0].sentIFrames);
+    TEST_ASSERT_EQUAL_UINT64(conStats.sentBytes, slaveStats[0].rcvdBytes);
+    TEST_ASSERT_EQUAL_UINT64(conStats.rcvdBytes, slaveStats[0].sentBytes);
 
-        InformationObject_destroy(io);
+    CS104_Connection_destroy(con);
 
-        TEST_ASSERT_EQUAL_INT(i + 1, CS101_ASDU_getNumberOfElements(asdu));
-    }
+    Thread_sleep(500);
 
-    CS101_ASDU clonedAsdu = CS101_ASDU_clone(asdu, NULL);
+    count = CS104_Slave_getStatistics(slave, slaveStats, 2);
 
-    TEST_ASSERT_NOT_NULL(clonedAsdu);
-    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getCA(asdu), CS101_ASDU_getCA(clonedAsdu));
-    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getOA(asdu), CS101_ASDU_getOA(clonedAsdu));
-    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getCOT(asdu), CS101_ASDU_getCOT(clonedAsdu));
-    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getTypeID(asdu), CS101_ASDU_getTypeID(clonedAsdu));
-    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getNumberOfElements(asdu), CS101_ASDU_getNumberOfElements(clonedAsdu));
-    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getPayloadSize(asdu), CS101_ASDU_getPayloadSize(clonedAsdu));
-    TEST_ASSERT_EQUAL_INT(0, memcmp(CS101_ASDU_getPayload(asdu), CS101_ASDU_getPayload(clonedAsdu), CS101_ASDU_getPayloadSize(clonedAsdu)));
+    TEST_ASSERT_EQUAL_INT(0, count);
 
-    CS101_ASDU_destroy(asdu);
-    CS101_ASDU_destroy(clonedAsdu);
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
 }
 
-#if (CONFIG_CS104_SUPPORT_TLS == 1)
-
-struct secEventInfo {
-    int eventHandlerCalled;
-    int eventCodes[100];
+struct sConnectionManagerTestInfo {
+    int opened;
+    int closed;
+    int failed;
+    int startDtCon;
+    int asduCount;
 };
 
 static void
-securityEventHandler(void* parameter, TLSEventLevel eventLevel, int eventCode, const char* msg, TLSConnection con)
+connectionManagerTestConnectionHandler(void* parameter, CS104_Connection connection, CS104_ConnectionEvent event)
 {
-    struct secEventInfo* eventInfo = (struct secEventInfo*)parameter;
-
-    char peerAddrBuf[60];
-    char* peerAddr = NULL;
-    const char* tlsVersion = "unknown";
+    struct sConnectionManagerTestInfo* info = (struct sConnectionManagerTestInfo*) parameter;
+
+    if (event == CS104_CONNECTION_OPENED)
+        info->opened++;
+    else if (event == CS104_CONNECTION_CLOSED)
+        info->closed++;
+    else if (event == CS104_CONNECTION_FAILED)
+        info->failed++;
+    else if (event == CS104_CONNECTION_STARTDT_CON_RECEIVED)
+        info->startDtCon++;
+}
 
-    if (con) {
-        peerAddr = TLSConnection_getPeerAddress(con, peerAddrBuf);
-        tlsVersion = TLSConfigVersion_toString(TLSConnection_getTLSVersion(con));
-    }
+static bool
+connectionManagerTestASDUHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    struct sConnectionManagerTestInfo* info = (struct sConnectionManagerTestInfo*) parameter;
 
-    printf("[SECURITY EVENT] %s (t: %i, c: %i, version: %s remote-ip: %s)\n", msg, eventLevel, eventCode, tlsVersion, peerAddr);
+    if (CS101_ASDU_getTypeID(asdu) == M_ME_NB_1)
+        info->asduCount++;
 
-    if (eventInfo) {
-        eventInfo->eventCodes[eventInfo->eventHandlerCalled] = eventCode;
-        eventInfo->eventHandlerCalled++;
-    }
+    return true;
 }
 
+#define CONNECTION_MANAGER_TEST_CONNECTIONS 3
+
 void
-test_CS104_MasterSlave_TLSConnectSuccess(void)
+test_CS104_ConnectionManager(void)
 {
-    bool res = false;
-
-    TLSConfiguration tlsConfig1 = TLSConfiguration_create();
+    struct sConnectionManagerTestInfo info[CONNECTION_MANAGER_TEST_CONNECTIONS];
+    CS104_Connection cons[CONNECTION_MANAGER_TEST_CONNECTIONS];
+    int i;
 
-    TLSConfiguration_setEventHandler(tlsConfig1, securityEventHandler, NULL);
+    memset(info, 0, sizeof(info));
 
-    TLSConfiguration_setChainValidation(tlsConfig1, true);
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    TEST_ASSERT_NOT_NULL(slave);
 
-    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig1, "server_CA1_1.key", NULL);
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig1, "server_CA1_1.pem");
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_addCACertificateFromFile(tlsConfig1, "root_CA1.pem");
-    TEST_ASSERT_TRUE(res);
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_setServerMode(slave, CS104_MODE_CONNECTION_IS_REDUNDANCY_GROUP);
+    CS104_Slave_start(slave);
 
-    TLSConfiguration tlsConfig2 = TLSConfiguration_create();
+    CS104_ConnectionManager manager = CS104_ConnectionManager_create();
+    TEST_ASSERT_NOT_NULL(manager);
 
-    TLSConfiguration_setChainValidation(tlsConfig2, true);
-    TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig2, true);
+    CS104_ConnectionManager_setReconnectInterval(manager, 200);
 
-    /* use valid certificate */
-    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig2, "client_CA1_3.key", NULL);
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig2, "client_CA1_3.pem");
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_addCACertificateFromFile(tlsConfig2, "root_CA1.pem");
-    TEST_ASSERT_TRUE(res);
+    for (i = 0; i < CONNECTION_MANAGER_TEST_CONNECTIONS; i++) {
+        cons[i] = CS104_Connection_create("127.0.0.1", 20004);
+        TEST_ASSERT_NOT_NULL(cons[i]);
 
-    res = TLSConfiguration_addAllowedCertificateFromFile(tlsConfig2, "server_CA1_1.pem");
-    TEST_ASSERT_TRUE(res);
+        CS104_Connection_setConnectionHandler(cons[i], connectionManagerTestConnectionHandler, &(info[i]));
+        CS104_Connection_setASDUReceivedHandler(cons[i], connectionManagerTestASDUHandler, &(info[i]));
 
-    CS104_Slave slave = CS104_Slave_createSecure(100, 100, tlsConfig1);
+        TEST_ASSERT_TRUE(CS104_ConnectionManager_addConnection(manager, cons[i]));
+    }
 
-    TEST_ASSERT_NOT_NULL(slave);
+    /* connection cannot be added twice */
+    TEST_ASSERT_FALSE(CS104_ConnectionManager_addConnection(manager, cons[0]));
+    TEST_ASSERT_EQUAL_INT(CONNECTION_MANAGER_TEST_CONNECTIONS, CS104_ConnectionManager_getConnectionCount(manager));
 
-    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_ConnectionManager_start(manager);
 
-    CS104_Slave_start(slave);
+    /* blocking connect is also supported when the manager thread is running */
+    TEST_ASSERT_TRUE(CS104_Connection_connect(cons[0]));
 
-    CS104_Connection con = CS104_Connection_createSecure("127.0.0.1", 20004, tlsConfig2);
+    for (i = 1; i < CONNECTION_MANAGER_TEST_CONNECTIONS; i++)
+        CS104_Connection_connectAsync(cons[i]);
 
-    TEST_ASSERT_NOT_NULL(con);
+    Thread_sleep(500);
 
-    bool result = CS104_Connection_connect(con);
+    for (i = 0; i < CONNECTION_MANAGER_TEST_CONNECTIONS; i++) {
+        TEST_ASSERT_EQUAL_INT(1, info[i].opened);
+        CS104_Connection_sendStartDT(cons[i]);
+    }
 
-    TEST_ASSERT_TRUE(result);
+    Thread_sleep(500);
 
-    CS104_Slave_destroy(slave);
+    for (i = 0; i < CONNECTION_MANAGER_TEST_CONNECTIONS; i++)
+        TEST_ASSERT_EQUAL_INT(1, info[i].startDtCon);
 
-    CS104_Connection_destroy(con);
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slave);
 
-    TLSConfiguration_destroy(tlsConfig1);
-    TLSConfiguration_destroy(tlsConfig2);
-}
+    for (i = 0; i < 10; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
 
-void
-test_CS104_MasterSlave_TLSConnectSuccessWithoutSeparateCACert(void)
-{
-    bool res = false;
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100 + i, i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
 
-    TLSConfiguration tlsConfig1 = TLSConfiguration_create();
+        CS104_Slave_enqueueASDU(slave, asdu);
 
-    TLSConfiguration_setEventHandler(tlsConfig1, securityEventHandler, NULL);
+        CS101_ASDU_destroy(asdu);
+    }
 
-    TLSConfiguration_setChainValidation(tlsConfig1, true);
+    Thread_sleep(1000);
 
-    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig1, "server_CA1_1.key", NULL);
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig1, "server_CA1_1_chain.pem");
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_addCACertificateFromFile(tlsConfig1, "server_CA1_1_chain.pem");
-    TEST_ASSERT_TRUE(res);
+    for (i = 0; i < CONNECTION_MANAGER_TEST_CONNECTIONS; i++)
+        TEST_ASSERT_EQUAL_INT(10, info[i].asduCount);
 
-    TLSConfiguration tlsConfig2 = TLSConfiguration_create();
+    /* closed connections are not reconnected */
+    CS104_Connection_close(cons[1]);
 
-    TLSConfiguration_setChainValidation(tlsConfig2, true);
-    TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig2, true);
+    Thread_sleep(500);
 
-    /* use expired certificate */
-    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig2, "client_CA1_3.key", NULL);
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig2, "client_CA1_3.pem");
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_addCACertificateFromFile(tlsConfig2, "root_CA1.pem");
-    TEST_ASSERT_TRUE(res);
+    TEST_ASSERT_EQUAL_INT(1, info[1].closed);
+    TEST_ASSERT_EQUAL_INT(1, info[1].opened);
 
-    res = TLSConfiguration_addAllowedCertificateFromFile(tlsConfig2, "server_CA1_1_chain.pem");
-    TEST_ASSERT_TRUE(res);
+    /* connections that are lost are reconnected */
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
 
-    CS104_Slave slave = CS104_Slave_createSecure(100, 100, tlsConfig1);
+    Thread_sleep(500);
 
-    TEST_ASSERT_NOT_NULL(slave);
+    TEST_ASSERT_EQUAL_INT(1, info[0].closed);
+    TEST_ASSERT_EQUAL_INT(1, info[2].closed);
 
+    slave = CS104_Slave_create(100, 100);
     CS104_Slave_setLocalPort(slave, 20004);
-
+    CS104_Slave_setServerMode(slave, CS104_MODE_CONNECTION_IS_REDUNDANCY_GROUP);
     CS104_Slave_start(slave);
 
-    CS104_Connection con = CS104_Connection_createSecure("127.0.0.1", 20004, tlsConfig2);
+    Thread_sleep(1000);
 
-    TEST_ASSERT_NOT_NULL(con);
+    TEST_ASSERT_EQUAL_INT(2, info[0].opened);
+    TEST_ASSERT_EQUAL_INT(2, info[2].opened);
+    TEST_ASSERT_EQUAL_INT(1, info[1].opened);
 
-    bool result = CS104_Connection_connect(con);
+    /* removing a connection closes it */
+    CS104_ConnectionManager_removeConnection(manager, cons[0]);
+    TEST_ASSERT_EQUAL_INT(2, info[0].closed);
+    TEST_ASSERT_EQUAL_INT(CONNECTION_MANAGER_TEST_CONNECTIONS - 1, CS104_ConnectionManager_getConnectionCount(manager));
 
-    TEST_ASSERT_TRUE(result);
+    for (i = 0; i < CONNECTION_MANAGER_TEST_CONNECTIONS; i++)
+        CS104_Connection_destroy(cons[i]);
 
-    CS104_Slave_destroy(slave);
+    TEST_ASSERT_EQUAL_INT(2, info[2].closed);
+    TEST_ASSERT_EQUAL_INT(0, CS104_ConnectionManager_getConnectionCount(manager));
 
-    CS104_Connection_destroy(con);
+    CS104_ConnectionManager_destroy(manager);
 
-    TLSConfiguration_destroy(tlsConfig1);
-    TLSConfiguration_destroy(tlsConfig2);
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
 }
 
 void
-test_CS104_MasterSlave_TLSConnectFails(void)
+test_CS104_ConnectionManager_timeouts(void)
 {
-    struct secEventInfo eventInfo;
-    memset(&eventInfo, 0, sizeof(struct secEventInfo));
+    struct sConnectionManagerTestInfo info[2];
+    struct sCS104_ConnectionStatistics stats;
 
-    bool res = false;
+    memset(info, 0, sizeof(info));
 
-    TLSConfiguration tlsConfig1 = TLSConfiguration_create();
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
 
-    TLSConfiguration_setEventHandler(tlsConfig1, securityEventHandler, &eventInfo);
+    /* server that accepts TCP connections (listen backlog) but never answers */
+    ServerSocket silentServer = TcpServerSocket_create("127.0.0.1", 20006);
+    TEST_ASSERT_NOT_NULL(silentServer);
+    ServerSocket_listen(silentServer);
 
-    TLSConfiguration_setChainValidation(tlsConfig1, true);
+    CS104_ConnectionManager manager = CS104_ConnectionManager_create();
+    TEST_ASSERT_NOT_NULL(manager);
 
-    TLSConfiguration tlsConfig2 = TLSConfiguration_create();
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    CS104_Connection silentCon = CS104_Connection_create("127.0.0.1", 20006);
 
-    TLSConfiguration_setChainValidation(tlsConfig2, true);
-    TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig2, true);
+    struct sCS104_APCIParameters apciParameters = *(CS104_Connection_getAPCIParameters(con));
+    apciParameters.t3 = 1;
+    CS104_Connection_setAPCIParameters(con, &apciParameters);
 
-    /* use valid certificate */
-    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig2, "client_CA1_3.key", NULL);
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig2, "client_CA1_3.pem");
-    TEST_ASSERT_TRUE(res);
-    res = TLSConfiguration_addCACertificateFromFile(tlsConfig2, "root_CA1.pem");
-    TEST_ASSERT_TRUE(res);
+    apciParameters = *(CS104_Connection_getAPCIParameters(silentCon));
+    apciParameters.t1 = 1;
+    CS104_Connection_setAPCIParameters(silentCon, &apciParameters);
 
-    res = TLSConfiguration_addAllowedCertificateFromFile(tlsConfig2, "server_CA1_1.pem");
-    TEST_ASSERT_TRUE(res);
+    CS104_Connection_setConnectionHandler(con, connectionManagerTestConnectionHandler, &(info[0]));
+    CS104_Connection_setConnectionHandler(silentCon, connectionManagerTestConnectionHandler, &(info[1]));
 
-    CS104_Slave slave = CS104_Slave_createSecure(100, 100, tlsConfig1);
+    TEST_ASSERT_TRUE(CS104_ConnectionManager_addConnection(manager, con));
+    TEST_ASSERT_TRUE(CS104_ConnectionManager_addConnection(manager, silentCon));
 
-    TEST_ASSERT_NOT_NULL(slave);
+    CS104_ConnectionManager_start(manager);
 
-    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Connection_connectAsync(con);
+    CS104_Connection_connectAsync(silentCon);
 
-    CS104_Slave_start(slave);
+    Thread_sleep(300);
 
-    CS104_Connection con = CS104_Connection_createSecure("127.0.0.1", 20004, tlsConfig2);
+    TEST_ASSERT_EQUAL_INT(1, info[0].opened);
+    TEST_ASSERT_EQUAL_INT(1, info[1].opened);
 
-    TEST_ASSERT_NOT_NULL(con);
+    uint64_t startTime = Hal_getTimeInMs();
 
-    bool result = CS104_Connection_connect(con);
+    CS104_Connection_sendStartDT(con);
+    CS104_Connection_sendStartDT(silentCon);
 
-    TEST_ASSERT_FALSE(result);
+    /* STARTDT_CON not received within t1 -> connection is closed */
+    while ((info[1].closed == 0) && ((Hal_getTimeInMs() - startTime) < 3000))
+        Thread_sleep(10);
 
-    CS104_Slave_destroy(slave);
+    uint64_t closeTime = Hal_getTimeInMs() - startTime;
 
-    CS104_Connection_destroy(con);
+    TEST_ASSERT_EQUAL_INT(1, info[1].closed);
+    TEST_ASSERT_TRUE(closeTime >= 900);
+    TEST_ASSERT_TRUE(closeTime < 2000);
+
+    CS104_Connection_getStatistics(silentCon, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.t1Timeouts);
+
+    /* idle connection is tested with TESTFR after t3 and stays open */
+    Thread_sleep(2500);
+
+    TEST_ASSERT_EQUAL_INT(1, info[0].startDtCon);
+    TEST_ASSERT_EQUAL_INT(0, info[0].closed);
+
+    CS104_Connection_getStatistics(con, &stats);
+    TEST_ASSERT_TRUE(stats.t3Timeouts >= 1);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.t1Timeouts);
+
+    CS104_Connection_destroy(con);
+    CS104_Connection_destroy(silentCon);
+
+    TEST_ASSERT_EQUAL_INT(0, CS104_ConnectionManager_getConnectionCount(manager));
+
+    CS104_ConnectionManager_destroy(manager);
+
+    ServerSocket_destroy(silentServer);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+
+static void*
+connectionManagerTestTickThread(void* parameter)
+{
+    CS104_ConnectionManager manager = (CS104_ConnectionManager) parameter;
+
+    /* single tick with a long timeout (non-threaded mode) */
+    CS104_ConnectionManager_tick(manager, 5000);
+
+    return NULL;
+}
+
+void
+test_CS104_ConnectionManager_wakeup(void)
+{
+    struct sConnectionManagerTestInfo info;
+
+    memset(&info, 0, sizeof(info));
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
+
+    CS104_ConnectionManager manager = CS104_ConnectionManager_create();
+    TEST_ASSERT_NOT_NULL(manager);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    CS104_Connection_setConnectionHandler(con, connectionManagerTestConnectionHandler, &info);
+
+    TEST_ASSERT_TRUE(CS104_ConnectionManager_addConnection(manager, con));
+
+    /* connect request interrupts the wait of the tick */
+    Thread tickThread = Thread_create(connectionManagerTestTickThread, manager, false);
+    Thread_start(tickThread);
+
+    Thread_sleep(100);
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    CS104_Connection_connectAsync(con);
+
+    Thread_destroy(tickThread);
+
+    TEST_ASSERT_TRUE((Hal_getTimeInMs() - startTime) < 1000);
+
+    while ((info.opened == 0) && ((Hal_getTimeInMs() - startTime) < 2000))
+        CS104_ConnectionManager_tick(manager, 10);
+
+    TEST_ASSERT_EQUAL_INT(1, info.opened);
+
+    /* removal interrupts the wait and doesn't wait for the end of the tick */
+    tickThread = Thread_create(connectionManagerTestTickThread, manager, false);
+    Thread_start(tickThread);
+
+    Thread_sleep(100);
+
+    startTime = Hal_getTimeInMs();
+
+    CS104_Connection_destroy(con);
+
+    TEST_ASSERT_TRUE((Hal_getTimeInMs() - startTime) < 1000);
+    TEST_ASSERT_EQUAL_INT(1, info.closed);
+    TEST_ASSERT_EQUAL_INT(0, CS104_ConnectionManager_getConnectionCount(manager));
+
+    Thread_destroy(tickThread);
+
+    CS104_ConnectionManager_destroy(manager);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+
+void
+test_CS101_ASDU_decodeColumns(void)
+{
+    uint8_t buffer[256];
+    struct sBufferFrame bf;
+    sCS101_ASDUView _view;
+
+    int ioa[10];
+    float value[10];
+    int32_t intValue[10];
+    uint8_t quality[10];
+    uint64_t timestamp[10];
+
+    sCS101_ASDUColumns columns;
+
+    columns.maxElements = 10;
+    columns.ioa = ioa;
+    columns.value = value;
+    columns.intValue = intValue;
+    columns.quality = quality;
+    columns.timestamp = timestamp;
+
+    /* M_ME_TF_1 - not a sequence */
+    Frame f = BufferFrame_initialize(&bf, buffer, 0);
+
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    struct sCP56Time2a cpTime;
+    uint64_t time = 1700000000123;
+
+    CP56Time2a_createFromMsTimestamp(&cpTime, time);
+
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        InformationObject io = (InformationObject) MeasuredValueShortWithCP56Time2a_create(NULL, 1000 + (i * 10), 1.5f * i,
+                (i == 1) ? IEC60870_QUALITY_INVALID : IEC60870_QUALITY_GOOD, &cpTime);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+    }
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    CS101_ASDU view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    TEST_ASSERT_EQUAL_INT(3, CS101_ASDU_decodeColumns(view, &columns));
+
+    for (i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT(1000 + (i * 10), ioa[i]);
+        TEST_ASSERT_EQUAL_FLOAT(1.5f * i, value[i]);
+        TEST_ASSERT_EQUAL_UINT64(time, timestamp[i]);
+    }
+
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_GOOD, quality[0]);
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_INVALID, quality[1]);
+
+    /* M_ME_NB_1 - sequence */
+    f = BufferFrame_initialize(&bf, buffer, 0);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, true, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    for (i = 0; i < 5; i++) {
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 2000 + i, -100 * i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+    }
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    TEST_ASSERT_TRUE(CS101_ASDU_isSequence(view));
+    TEST_ASSERT_EQUAL_INT(5, CS101_ASDU_decodeColumns(view, &columns));
+
+    for (i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_INT(2000 + i, ioa[i]);
+        TEST_ASSERT_EQUAL_INT(-100 * i, intValue[i]);
+        TEST_ASSERT_EQUAL_FLOAT(-100.f * i, value[i]);
+        TEST_ASSERT_EQUAL_UINT64(0, timestamp[i]);
+    }
+
+    /* only maxElements are decoded, missing arrays are skipped */
+    columns.maxElements = 2;
+    columns.value = NULL;
+    columns.timestamp = NULL;
+
+    TEST_ASSERT_EQUAL_INT(2, CS101_ASDU_decodeColumns(view, &columns));
+
+    /* M_DP_NA_1 */
+    f = BufferFrame_initialize(&bf, buffer, 0);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    InformationObject io = (InformationObject) DoublePointInformation_create(NULL, 300, IEC60870_DOUBLE_POINT_ON, IEC60870_QUALITY_BLOCKED);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    TEST_ASSERT_EQUAL_INT(1, CS101_ASDU_decodeColumns(view, &columns));
+    TEST_ASSERT_EQUAL_INT(300, ioa[0]);
+    TEST_ASSERT_EQUAL_INT(IEC60870_DOUBLE_POINT_ON, intValue[0]);
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_BLOCKED, quality[0]);
+
+    /* commands are not supported */
+    f = BufferFrame_initialize(&bf, buffer, 0);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_ACTIVATION, 0, 1, false, false);
+
+    io = (InformationObject) SingleCommand_create(NULL, 5000, true, false, 0);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    TEST_ASSERT_EQUAL_INT(-1, CS101_ASDU_decodeColumns(view, &columns));
+}
+
+void
+test_CS101_ASDU_getValueAt(void)
+{
+    uint8_t buffer[256];
+    struct sBufferFrame bf;
+    sCS101_ASDUView _view;
+    int i;
+
+    struct sCP56Time2a cpTime;
+    uint64_t time = 1700000000123;
+
+    CP56Time2a_createFromMsTimestamp(&cpTime, time);
+
+    /* M_ME_TF_1 - not a sequence */
+    Frame f = BufferFrame_initialize(&bf, buffer, 0);
+
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    for (i = 0; i < 3; i++) {
+        InformationObject io = (InformationObject) MeasuredValueShortWithCP56Time2a_create(NULL, 1000 + (i * 10), -2.25f * i,
+                (i == 1) ? IEC60870_QUALITY_INVALID : IEC60870_QUALITY_GOOD, &cpTime);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+    }
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    CS101_ASDU view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    for (i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT(1000 + (i * 10), CS101_ASDU_getIOAAt(view, i));
+        TEST_ASSERT_EQUAL_FLOAT(-2.25f * i, CS101_ASDU_getFloatAt(view, i));
+        TEST_ASSERT_EQUAL_UINT64(time, CS101_ASDU_getCP56TimeMsAt(view, i));
+    }
+
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_GOOD, CS101_ASDU_getQualityAt(view, 0));
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_INVALID, CS101_ASDU_getQualityAt(view, 1));
+
+    /* index out of range */
+    TEST_ASSERT_EQUAL_INT(-1, CS101_ASDU_getIOAAt(view, 3));
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_INVALID, CS101_ASDU_getQualityAt(view, 3));
+    TEST_ASSERT_EQUAL_UINT64(0, CS101_ASDU_getCP56TimeMsAt(view, -1));
+
+    /* truncated payload */
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f) - 1);
+
+    TEST_ASSERT_EQUAL_INT(1010, CS101_ASDU_getIOAAt(view, 1));
+    TEST_ASSERT_EQUAL_INT(-1, CS101_ASDU_getIOAAt(view, 2));
+
+    /* M_ME_NA_1 - sequence */
+    f = BufferFrame_initialize(&bf, buffer, 0);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, true, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    for (i = 0; i < 4; i++) {
+        InformationObject io = (InformationObject) MeasuredValueNormalized_create(NULL, 2000 + i, 0.25f * i, IEC60870_QUALITY_OVERFLOW);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+    }
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    TEST_ASSERT_TRUE(CS101_ASDU_isSequence(view));
+
+    for (i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(2000 + i, CS101_ASDU_getIOAAt(view, i));
+        TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.25f * i, CS101_ASDU_getFloatAt(view, i));
+        TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_OVERFLOW, CS101_ASDU_getQualityAt(view, i));
+        TEST_ASSERT_EQUAL_UINT64(0, CS101_ASDU_getCP56TimeMsAt(view, i));
+    }
+
+    /* M_SP_TB_1 - quality bits of SIQ */
+    f = BufferFrame_initialize(&bf, buffer, 0);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    InformationObject io = (InformationObject) SinglePointWithCP56Time2a_create(NULL, 300, true, IEC60870_QUALITY_NON_TOPICAL, &cpTime);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    TEST_ASSERT_EQUAL_INT(300, CS101_ASDU_getIOAAt(view, 0));
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_NON_TOPICAL, CS101_ASDU_getQualityAt(view, 0));
+    TEST_ASSERT_EQUAL_UINT64(time, CS101_ASDU_getCP56TimeMsAt(view, 0));
+    TEST_ASSERT_EQUAL_FLOAT(0.f, CS101_ASDU_getFloatAt(view, 0));
+}
+
+/* compares CS101_ASDU_getFloatAt and CS101_ASDU_decodeColumns with the getValue function of the information object type */
+static void
+checkNormalizedFloatAt(InformationObject io)
+{
+    uint8_t buffer[256];
+    struct sBufferFrame bf;
+    sCS101_ASDUView _view;
+    float expected;
+
+    Frame f = BufferFrame_initialize(&bf, buffer, 0);
+
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+    TEST_ASSERT_TRUE(CS101_ASDU_addInformationObject(asdu, io));
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    CS101_ASDU view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    InformationObject element = CS101_ASDU_getElement(view, 0);
+    TEST_ASSERT_NOT_NULL(element);
+
+    switch (CS101_ASDU_getTypeID(view)) {
+
+    case M_ME_NA_1:
+    case M_ME_TA_1:
+    case M_ME_TD_1:
+        expected = MeasuredValueNormalized_getValue((MeasuredValueNormalized) element);
+        break;
+
+    case M_ME_ND_1:
+        expected = MeasuredValueNormalizedWithoutQuality_getValue((MeasuredValueNormalizedWithoutQuality) element);
+        break;
+
+    case C_SE_NA_1:
+        expected = SetpointCommandNormalized_getValue((SetpointCommandNormalized) element);
+        break;
+
+    case C_SE_TA_1:
+        expected = SetpointCommandNormalizedWithCP56Time2a_getValue((SetpointCommandNormalizedWithCP56Time2a) element);
+        break;
+
+    case P_ME_NA_1:
+        expected = ParameterNormalizedValue_getValue((ParameterNormalizedValue) element);
+        break;
+
+    default:
+        TEST_FAIL_MESSAGE("unexpected type ID");
+        return;
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT(expected, CS101_ASDU_getFloatAt(view, 0));
+
+    if ((CS101_ASDU_getTypeID(view) == M_ME_NA_1) || (CS101_ASDU_getTypeID(view) == M_ME_TD_1) ||
+            (CS101_ASDU_getTypeID(view) == M_ME_ND_1))
+    {
+        float value = 0.f;
+        sCS101_ASDUColumns columns;
+
+        memset(&columns, 0, sizeof(columns));
+        columns.maxElements = 1;
+        columns.value = &value;
+
+        TEST_ASSERT_EQUAL_INT(1, CS101_ASDU_decodeColumns(view, &columns));
+        TEST_ASSERT_EQUAL_FLOAT(expected, value);
+    }
+
+    InformationObject_destroy(element);
+    InformationObject_destroy(io);
+}
+
+void
+test_CS101_ASDU_normalizedValueConversion(void)
+{
+    const float values[] = { -1.0f, -0.5f, 0.f, 0.33f, 1.0f };
+    int i;
+
+    struct sCP24Time2a cp24Time;
+    struct sCP56Time2a cp56Time;
+
+    memset(&cp24Time, 0, sizeof(cp24Time));
+    CP56Time2a_createFromMsTimestamp(&cp56Time, 1700000000123);
+
+    for (i = 0; i < (int) (sizeof(values) / sizeof(values[0])); i++) {
+        float value = values[i];
+
+        checkNormalizedFloatAt((InformationObject) MeasuredValueNormalized_create(NULL, 100, value, IEC60870_QUALITY_GOOD));
+        checkNormalizedFloatAt((InformationObject) MeasuredValueNormalizedWithCP24Time2a_create(NULL, 100, value, IEC60870_QUALITY_GOOD, &cp24Time));
+        checkNormalizedFloatAt((InformationObject) MeasuredValueNormalizedWithCP56Time2a_create(NULL, 100, value, IEC60870_QUALITY_GOOD, &cp56Time));
+        checkNormalizedFloatAt((InformationObject) MeasuredValueNormalizedWithoutQuality_create(NULL, 100, value));
+        checkNormalizedFloatAt((InformationObject) SetpointCommandNormalized_create(NULL, 100, value, false, 0));
+        checkNormalizedFloatAt((InformationObject) SetpointCommandNormalizedWithCP56Time2a_create(NULL, 100, value, false, 0, &cp56Time));
+        checkNormalizedFloatAt((InformationObject) ParameterNormalizedValue_create(NULL, 100, value, 0));
+    }
+}
+
+void
+test_CS101_ASDU_bulkEncoding(void)
+{
+    int ioas[130];
+    float values[130];
+    QualityDescriptor qds[130];
+    int i;
+
+    for (i = 0; i < 130; i++) {
+        ioas[i] = 100 + i;
+        values[i] = 0.5f * i;
+        qds[i] = (i % 2) ? IEC60870_QUALITY_INVALID : IEC60870_QUALITY_GOOD;
+    }
+
+    /* encoding has to be identical to CS101_ASDU_addInformationObject */
+    CS101_ASDU reference = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    for (i = 0; i < 4; i++) {
+        InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, ioas[i], values[i], qds[i]);
+        CS101_ASDU_addInformationObject(reference, io);
+        InformationObject_destroy(io);
+    }
+
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    TEST_ASSERT_EQUAL_INT(1, CS101_ASDU_addMeasuredValueShorts(asdu, ioas, values, qds, 1));
+    TEST_ASSERT_EQUAL_INT(3, CS101_ASDU_addMeasuredValueShorts(asdu, ioas + 1, values + 1, qds + 1, 3));
+
+    TEST_ASSERT_EQUAL_INT(M_ME_NC_1, CS101_ASDU_getTypeID(asdu));
+    TEST_ASSERT_EQUAL_INT(4, CS101_ASDU_getNumberOfElements(asdu));
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getPayloadSize(reference), CS101_ASDU_getPayloadSize(asdu));
+    TEST_ASSERT_EQUAL_MEMORY(CS101_ASDU_getPayload(reference), CS101_ASDU_getPayload(asdu), CS101_ASDU_getPayloadSize(asdu));
+
+    /* other type cannot be added */
+    TEST_ASSERT_EQUAL_INT(0, CS101_ASDU_addMeasuredValueNormalizeds(asdu, ioas, values, qds, 1));
+
+    CS101_ASDU_destroy(asdu);
+    CS101_ASDU_destroy(reference);
+
+    /* sequence of scaled values */
+    int scaledValues[5] = { -32768, -1, 0, 1, 32767 };
+
+    reference = CS101_ASDU_create(&defaultAppLayerParameters, true, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    for (i = 0; i < 5; i++) {
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, ioas[i], scaledValues[i], qds[i]);
+        CS101_ASDU_addInformationObject(reference, io);
+        InformationObject_destroy(io);
+    }
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, true, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    TEST_ASSERT_EQUAL_INT(2, CS101_ASDU_addMeasuredValueScaleds(asdu, ioas, scaledValues, qds, 2));
+    TEST_ASSERT_EQUAL_INT(3, CS101_ASDU_addMeasuredValueScaleds(asdu, ioas + 2, scaledValues + 2, qds + 2, 3));
+
+    TEST_ASSERT_EQUAL_INT(5, CS101_ASDU_getNumberOfElements(asdu));
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getPayloadSize(reference), CS101_ASDU_getPayloadSize(asdu));
+    TEST_ASSERT_EQUAL_MEMORY(CS101_ASDU_getPayload(reference), CS101_ASDU_getPayload(asdu), CS101_ASDU_getPayloadSize(asdu));
+
+    /* IOA doesn't continue the sequence */
+    TEST_ASSERT_EQUAL_INT(0, CS101_ASDU_addMeasuredValueScaleds(asdu, ioas + 6, scaledValues, NULL, 1));
+
+    CS101_ASDU_destroy(asdu);
+    CS101_ASDU_destroy(reference);
+
+    /* only as many information objects as fit into the ASDU are added */
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    int expected = (defaultAppLayerParameters.maxSizeOfASDU - 6) / (defaultAppLayerParameters.sizeOfIOA + 5);
+
+    TEST_ASSERT_EQUAL_INT(expected, CS101_ASDU_addMeasuredValueShorts(asdu, ioas, values, NULL, 130));
+    TEST_ASSERT_EQUAL_INT(0, CS101_ASDU_addMeasuredValueShorts(asdu, ioas, values, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(expected, CS101_ASDU_getNumberOfElements(asdu));
+
+    CS101_ASDU_destroy(asdu);
+
+    /* single and double points - at most 127 elements */
+    bool spValues[130];
+    DoublePointValue dpValues[130];
+
+    for (i = 0; i < 130; i++) {
+        spValues[i] = (i % 3) == 0;
+        dpValues[i] = (DoublePointValue) (i % 4);
+    }
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, true, CS101_COT_INTERROGATED_BY_STATION, 0, 1, false, false);
+
+    TEST_ASSERT_EQUAL_INT(127, CS101_ASDU_addSinglePoints(asdu, ioas, spValues, qds, 130));
+    TEST_ASSERT_EQUAL_INT(127, CS101_ASDU_getNumberOfElements(asdu));
+
+    for (i = 0; i < 127; i++) {
+        SinglePointInformation spi = (SinglePointInformation) CS101_ASDU_getElement(asdu, i);
+
+        TEST_ASSERT_NOT_NULL(spi);
+        TEST_ASSERT_EQUAL_INT(ioas[i], InformationObject_getObjectAddress((InformationObject) spi));
+        TEST_ASSERT_EQUAL(spValues[i], SinglePointInformation_getValue(spi));
+        TEST_ASSERT_EQUAL_INT(qds[i], SinglePointInformation_getQuality(spi));
+
+        SinglePointInformation_destroy(spi);
+    }
+
+    CS101_ASDU_destroy(asdu);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_INTERROGATED_BY_STATION, 0, 1, false, false);
+
+    TEST_ASSERT_EQUAL_INT(10, CS101_ASDU_addDoublePoints(asdu, ioas, dpValues, NULL, 10));
+
+    for (i = 0; i < 10; i++) {
+        DoublePointInformation dpi = (DoublePointInformation) CS101_ASDU_getElement(asdu, i);
+
+        TEST_ASSERT_NOT_NULL(dpi);
+        TEST_ASSERT_EQUAL_INT(ioas[i], InformationObject_getObjectAddress((InformationObject) dpi));
+        TEST_ASSERT_EQUAL_INT(dpValues[i], DoublePointInformation_getValue(dpi));
+        TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_GOOD, DoublePointInformation_getQuality(dpi));
+
+        DoublePointInformation_destroy(dpi);
+    }
+
+    CS101_ASDU_destroy(asdu);
+
+    /* normalized values are limited to -1.0 .. 1.0 */
+    float normalizedValues[3] = { -2.0f, 0.5f, 2.0f };
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    TEST_ASSERT_EQUAL_INT(3, CS101_ASDU_addMeasuredValueNormalizeds(asdu, ioas, normalizedValues, qds, 3));
+
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, -1.0f, CS101_ASDU_getFloatAt(asdu, 0));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.5f, CS101_ASDU_getFloatAt(asdu, 1));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, CS101_ASDU_getFloatAt(asdu, 2));
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_INVALID, CS101_ASDU_getQualityAt(asdu, 1));
+
+    CS101_ASDU_destroy(asdu);
+}
+
+void
+test_CS101_ASDUIterator(void)
+{
+    uint8_t buffer[256];
+    struct sBufferFrame bf;
+    sCS101_ASDUView _view;
+    int i;
+
+    CS101_ASDUIterator iterator = CS101_ASDUIterator_create();
+    TEST_ASSERT_NOT_NULL(iterator);
+
+    /* sequence of information objects */
+    Frame f = BufferFrame_initialize(&bf, buffer, 0);
+
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, true, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    for (i = 0; i < 10; i++) {
+        InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, 300 + i, 0.5f * i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+    }
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    CS101_ASDU view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    CS101_ASDUIterator_start(iterator, view);
+
+    InformationObject io;
+
+    i = 0;
+
+    while ((io = CS101_ASDUIterator_next(iterator)) != NULL) {
+        TEST_ASSERT_EQUAL_INT(M_ME_NC_1, InformationObject_getType(io));
+        TEST_ASSERT_EQUAL_INT(300 + i, InformationObject_getObjectAddress(io));
+        TEST_ASSERT_EQUAL_FLOAT(0.5f * i, MeasuredValueShort_getValue((MeasuredValueShort) io));
+        i++;
+    }
+
+    TEST_ASSERT_EQUAL_INT(10, i);
+
+    /* not a sequence - same results as CS101_ASDU_getElement */
+    f = BufferFrame_initialize(&bf, buffer, 0);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    for (i = 0; i < 5; i++) {
+        io = (InformationObject) DoublePointInformation_create(NULL, 1000 - i, (DoublePointValue) (i % 4), IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+    }
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    CS101_ASDUIterator_start(iterator, view);
+
+    for (i = 0; i < 5; i++) {
+        io = CS101_ASDUIterator_next(iterator);
+        TEST_ASSERT_NOT_NULL(io);
+
+        DoublePointInformation dpi = (DoublePointInformation) CS101_ASDU_getElement(view, i);
+
+        TEST_ASSERT_EQUAL_INT(InformationObject_getObjectAddress((InformationObject) dpi), InformationObject_getObjectAddress(io));
+        TEST_ASSERT_EQUAL_INT(DoublePointInformation_getValue(dpi), DoublePointInformation_getValue((DoublePointInformation) io));
+
+        DoublePointInformation_destroy(dpi);
+    }
+
+    TEST_ASSERT_NULL(CS101_ASDUIterator_next(iterator));
+
+    /* number of elements larger than the payload -> iteration stops at the end of the payload */
+    CS101_ASDU_setNumberOfElements(view, 7);
+    CS101_ASDUIterator_start(iterator, view);
+
+    for (i = 0; i < 5; i++)
+        TEST_ASSERT_NOT_NULL(CS101_ASDUIterator_next(iterator));
+
+    TEST_ASSERT_NULL(CS101_ASDUIterator_next(iterator));
+
+    /* ASDU with a single information object */
+    f = BufferFrame_initialize(&bf, buffer, 0);
+
+    asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_ACTIVATION, 0, 1, false, false);
+
+    io = (InformationObject) InterrogationCommand_create(NULL, 0, IEC60870_QOI_STATION);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    CS101_ASDU_encode(asdu, f);
+    CS101_ASDU_destroy(asdu);
+
+    view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    CS101_ASDUIterator_start(iterator, view);
+
+    io = CS101_ASDUIterator_next(iterator);
+    TEST_ASSERT_NOT_NULL(io);
+    TEST_ASSERT_EQUAL_INT(C_IC_NA_1, InformationObject_getType(io));
+    TEST_ASSERT_EQUAL_INT(IEC60870_QOI_STATION, InterrogationCommand_getQOI((InterrogationCommand) io));
+    TEST_ASSERT_NULL(CS101_ASDUIterator_next(iterator));
+
+    CS101_ASDUIterator_destroy(iterator);
+}
+
+void
+test_CS101_ASDU_initializeView(void)
+{
+    uint8_t buffer[256];
+
+    struct sBufferFrame bf;
+
+    Frame f = BufferFrame_initialize(&bf, buffer, 0);
+
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1234, false, false);
+
+    InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 4000, -1000, IEC60870_QUALITY_INVALID);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    CS101_ASDU_encode(asdu, f);
+
+    CS101_ASDU_destroy(asdu);
+
+    sCS101_ASDUView _view;
+
+    CS101_ASDU view = CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, Frame_getMsgSize(f));
+
+    TEST_ASSERT_NOT_NULL(view);
+    TEST_ASSERT_EQUAL_PTR(&_view, view);
+    TEST_ASSERT_EQUAL_INT(M_ME_NB_1, CS101_ASDU_getTypeID(view));
+    TEST_ASSERT_EQUAL_INT(CS101_COT_SPONTANEOUS, CS101_ASDU_getCOT(view));
+    TEST_ASSERT_EQUAL_INT(1234, CS101_ASDU_getCA(view));
+    TEST_ASSERT_EQUAL_INT(1, CS101_ASDU_getNumberOfElements(view));
+
+    MeasuredValueScaled mvs = (MeasuredValueScaled) CS101_ASDU_getElement(view, 0);
+
+    TEST_ASSERT_NOT_NULL(mvs);
+    TEST_ASSERT_EQUAL_INT(4000, InformationObject_getObjectAddress((InformationObject) mvs));
+    TEST_ASSERT_EQUAL_INT(-1000, MeasuredValueScaled_getValue(mvs));
+
+    MeasuredValueScaled_destroy(mvs);
+
+    /* message too small for the ASDU header */
+    TEST_ASSERT_NULL(CS101_ASDU_initializeView(&_view, &defaultAppLayerParameters, buffer, 5));
+}
+
+static bool
+asduQueueTestASDUHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    (void) address;
+
+    if (CS101_ASDU_getTypeID(asdu) == M_ME_NB_1)
+        (*((int*) parameter))++;
+
+    return true;
+}
+
+void
+test_CS104_Connection_asduQueue(void)
+{
+    int asduCount = 0;
+    struct sCS104_ConnectionStatistics stats;
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    TEST_ASSERT_NOT_NULL(con);
+
+    CS104_Connection_setASDUReceivedHandler(con, asduQueueTestASDUHandler, &asduCount);
+
+    /* queue size is increased to k (12) */
+    TEST_ASSERT_TRUE(CS104_Connection_setASDUQueueSize(con, 4));
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    /* queue cannot be replaced while the connection is open */
+    TEST_ASSERT_FALSE(CS104_Connection_setASDUQueueSize(con, 20));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(500);
+
+    int i;
+
+    for (i = 0; i < 20; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(CS104_Slave_getAppLayerParameters(slave), false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100 + i, i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, asdu);
+
+        CS101_ASDU_destroy(asdu);
+    }
+
+    Thread_sleep(500);
+
+    /* handler is not called by the receiving thread and queued ASDUs are not confirmed -> slave stops after k messages */
+    CS104_Connection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_INT(0, asduCount);
+    TEST_ASSERT_EQUAL_INT(12, (int) stats.rcvdIFrames);
+    TEST_ASSERT_EQUAL_INT(0, (int) stats.sentSFrames);
+
+    /* less than w handled ASDUs -> no confirmation */
+    TEST_ASSERT_EQUAL_INT(5, CS104_Connection_processASDUQueue(con, 5));
+    TEST_ASSERT_EQUAL_INT(5, asduCount);
+
+    CS104_Connection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_INT(0, (int) stats.sentSFrames);
+
+    TEST_ASSERT_EQUAL_INT(7, CS104_Connection_processASDUQueue(con, 0));
+    TEST_ASSERT_EQUAL_INT(12, asduCount);
+
+    Thread_sleep(500);
+
+    CS104_Connection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_INT(1, (int) stats.sentSFrames);
+    TEST_ASSERT_EQUAL_INT(20, (int) stats.rcvdIFrames);
+
+    TEST_ASSERT_EQUAL_INT(8, CS104_Connection_processASDUQueue(con, 0));
+    TEST_ASSERT_EQUAL_INT(20, asduCount);
+    TEST_ASSERT_EQUAL_INT(0, CS104_Connection_processASDUQueue(con, 0));
+
+    /* ASDUs that are still queued when the connection is closed are not confirmed */
+    for (i = 0; i < 3; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(CS104_Slave_getAppLayerParameters(slave), false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 200 + i, i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, asdu);
+
+        CS101_ASDU_destroy(asdu);
+    }
+
+    Thread_sleep(500);
+
+    CS104_Connection_close(con);
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(500);
+
+    /* the entries of the closed connection are dropped - the slave sends the unconfirmed ASDUs again */
+    TEST_ASSERT_EQUAL_INT(3, CS104_Connection_processASDUQueue(con, 0));
+    TEST_ASSERT_EQUAL_INT(23, asduCount);
+
+    CS104_Connection_close(con);
+
+    TEST_ASSERT_TRUE(CS104_Connection_setASDUQueueSize(con, 0));
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+
+static void
+asduQueueTestEnqueue(CS104_Slave slave, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(CS104_Slave_getAppLayerParameters(slave), false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100 + i, i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, asdu);
+
+        CS101_ASDU_destroy(asdu);
+    }
+}
+
+void
+test_CS104_Connection_asduQueueLarge(void)
+{
+    int asduCount = 0;
+    struct sCS104_ConnectionStatistics stats;
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    TEST_ASSERT_NOT_NULL(con);
+
+    CS104_Connection_setASDUReceivedHandler(con, asduQueueTestASDUHandler, &asduCount);
+
+    /* k = 12 -> confirmations are held back when less than 12 entries are free */
+    TEST_ASSERT_TRUE(CS104_Connection_setASDUQueueSize(con, 30));
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(500);
+
+    asduQueueTestEnqueue(slave, 20);
+
+    Thread_sleep(500);
+
+    /* queue has enough room -> ASDUs are confirmed without waiting for the consumer */
+    CS104_Connection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_INT(0, asduCount);
+    TEST_ASSERT_EQUAL_INT(20, (int) stats.rcvdIFrames);
+    TEST_ASSERT_EQUAL_INT(2, (int) stats.sentSFrames);
+
+    asduQueueTestEnqueue(slave, 20);
+
+    Thread_sleep(500);
+
+    /* less than k free entries -> confirmations are held back and the slave stops when its k-window is full */
+    CS104_Connection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_INT(0, asduCount);
+    TEST_ASSERT_EQUAL_INT(28, (int) stats.rcvdIFrames);
+    TEST_ASSERT_EQUAL_INT(2, (int) stats.sentSFrames);
+
+    TEST_ASSERT_EQUAL_INT(28, CS104_Connection_processASDUQueue(con, 0));
+
+    Thread_sleep(500);
+
+    TEST_ASSERT_EQUAL_INT(12, CS104_Connection_processASDUQueue(con, 0));
+    TEST_ASSERT_EQUAL_INT(40, asduCount);
+
+    CS104_Connection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_INT(40, (int) stats.rcvdIFrames);
+    TEST_ASSERT_EQUAL_INT(0, (int) stats.t1Timeouts);
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+
+struct sCommandTestInfo {
+    int selects;
+    int executes;
+    int actCon;
+    int actTerm;
+    int negativeCon;
+    int timeouts;
+    int failed;
+    int otherEvents;
+};
+
+static bool
+commandTestSlaveASDUHandler(void* parameter, IMasterConnection connection, CS101_ASDU asdu)
+{
+    struct sCommandTestInfo* info = (struct sCommandTestInfo*) parameter;
+
+    if (CS101_ASDU_getTypeID(asdu) != C_SC_NA_1)
+        return false;
+
+    SingleCommand sc = (SingleCommand) CS101_ASDU_getElement(asdu, 0);
+
+    int ioa = InformationObject_getObjectAddress((InformationObject) sc);
+    bool select = SingleCommand_isSelect(sc);
+
+    SingleCommand_destroy(sc);
+
+    /* no response -> timeout */
+    if (ioa == 2000)
+        return true;
+
+    if (select)
+        info->selects++;
+    else
+        info->executes++;
+
+    if (ioa == 1000) {
+        IMasterConnection_sendACT_CON(connection, asdu, true);
+    }
+    else {
+        IMasterConnection_sendACT_CON(connection, asdu, false);
+
+        if (select == false)
+            IMasterConnection_sendACT_TERM(connection, asdu);
+    }
+
+    return true;
+}
+
+static void
+commandTestCommandHandler(void* parameter, CS104_Connection connection, CS104_CommandHandle handle,
+        CS104_CommandEvent event, CS101_ASDU asdu)
+{
+    struct sCommandTestInfo* info = (struct sCommandTestInfo*) parameter;
+
+    (void) connection;
+    (void) handle;
+
+    switch (event) {
+    case CS104_COMMAND_ACT_CON:
+        if (asdu && (CS101_ASDU_getCOT(asdu) == CS101_COT_ACTIVATION_CON))
+            info->actCon++;
+        else
+            info->otherEvents++;
+        break;
+    case CS104_COMMAND_ACT_TERM:
+        if (asdu && (CS101_ASDU_getCOT(asdu) == CS101_COT_ACTIVATION_TERMINATION))
+            info->actTerm++;
+        else
+            info->otherEvents++;
+        break;
+    case CS104_COMMAND_NEGATIVE_CON:
+        info->negativeCon++;
+        break;
+    case CS104_COMMAND_TIMEOUT:
+        info->timeouts++;
+        break;
+    case CS104_COMMAND_FAILED:
+        info->failed++;
+        break;
+    default:
+        info->otherEvents++;
+        break;
+    }
+}
+
+static CS104_CommandHandle
+sendSingleCommand(CS104_Connection con, int ioa, CS104_CommandMode mode, bool waitForTermination, struct sCommandTestInfo* info)
+{
+    SingleCommand sc = SingleCommand_create(NULL, ioa, true, false, 0);
+
+    CS104_CommandHandle handle = CS104_Connection_sendCommand(con, 1, (InformationObject) sc, mode, waitForTermination,
+            commandTestCommandHandler, info);
+
+    SingleCommand_destroy(sc);
+
+    return handle;
+}
+
+void
+test_CS104_Connection_sendCommand(void)
+{
+    struct sCommandTestInfo slaveInfo;
+    struct sCommandTestInfo info;
+
+    memset(&slaveInfo, 0, sizeof(slaveInfo));
+    memset(&info, 0, sizeof(info));
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_setASDUHandler(slave, commandTestSlaveASDUHandler, &slaveInfo);
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    TEST_ASSERT_NOT_NULL(con);
+
+    CS104_Connection_setCommandTimeout(con, 500);
+    CS104_Connection_setMaxOutstandingCommands(con, 100);
+
+    /* not connected */
+    TEST_ASSERT_EQUAL_UINT(0, sendSingleCommand(con, 100, CS104_COMMAND_DIRECT, false, &info));
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    /* more commands than fit into the k-window (12) */
+    int i;
+
+    for (i = 0; i < 50; i++)
+        TEST_ASSERT_NOT_EQUAL(0, sendSingleCommand(con, 100 + i, CS104_COMMAND_SELECT_AND_EXECUTE, true, &info));
+
+    /* same type ID, CA and IOA as an outstanding command */
+    TEST_ASSERT_EQUAL_UINT(0, sendSingleCommand(con, 100, CS104_COMMAND_DIRECT, false, &info));
+
+    /* negative confirmation of the select */
+    TEST_ASSERT_NOT_EQUAL(0, sendSingleCommand(con, 1000, CS104_COMMAND_SELECT_AND_EXECUTE, true, &info));
+
+    /* no response */
+    TEST_ASSERT_NOT_EQUAL(0, sendSingleCommand(con, 2000, CS104_COMMAND_DIRECT, false, &info));
+
+    /* direct execute without waiting for ACT_TERM */
+    TEST_ASSERT_NOT_EQUAL(0, sendSingleCommand(con, 3000, CS104_COMMAND_DIRECT, false, &info));
+
+    /* bitstring command has no S/E flag */
+    Bitstring32Command bsc = Bitstring32Command_create(NULL, 4000, 0x12345678);
+    TEST_ASSERT_EQUAL_UINT(0, CS104_Connection_sendCommand(con, 1, (InformationObject) bsc, CS104_COMMAND_SELECT_AND_EXECUTE, false, commandTestCommandHandler, &info));
+    Bitstring32Command_destroy(bsc);
+
+    int waitTime = 0;
+
+    while ((CS104_Connection_getOutstandingCommands(con) > 0) && (waitTime < 3000)) {
+        Thread_sleep(10);
+        waitTime += 10;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, CS104_Connection_getOutstandingCommands(con));
+
+    TEST_ASSERT_EQUAL_INT(51, slaveInfo.selects);
+    TEST_ASSERT_EQUAL_INT(51, slaveInfo.executes);
+
+    TEST_ASSERT_EQUAL_INT(51, info.actCon);
+    TEST_ASSERT_EQUAL_INT(50, info.actTerm);
+    TEST_ASSERT_EQUAL_INT(1, info.negativeCon);
+    TEST_ASSERT_EQUAL_INT(1, info.timeouts);
+    TEST_ASSERT_EQUAL_INT(0, info.failed);
+    TEST_ASSERT_EQUAL_INT(0, info.otherEvents);
+
+    /* outstanding command is completed when the connection is closed */
+    TEST_ASSERT_NOT_EQUAL(0, sendSingleCommand(con, 2000, CS104_COMMAND_DIRECT, false, &info));
+
+    CS104_Connection_close(con);
+
+    TEST_ASSERT_EQUAL_INT(1, info.failed);
+    TEST_ASSERT_EQUAL_INT(0, CS104_Connection_getOutstandingCommands(con));
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+
+static bool
+sendQueueTestSlaveASDUHandler(void* parameter, IMasterConnection connection, CS101_ASDU asdu)
+{
+    (void) connection;
+
+    if (CS101_ASDU_getTypeID(asdu) == C_SC_NA_1)
+        (*((int*) parameter))++;
+
+    return true;
+}
+
+static void
+sendQueueTestConnectionHandler(void* parameter, CS104_Connection connection, CS104_ConnectionEvent event)
+{
+    (void) connection;
+
+    if (event == CS104_CONNECTION_SEND_QUEUE_AVAILABLE)
+        (*((int*) parameter))++;
+}
+
+void
+test_CS104_Connection_sendQueue(void)
+{
+    int receivedCommands = 0;
+    int availableEvents = 0;
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    TEST_ASSERT_NOT_NULL(slave);
+
+    /* slave confirms the received I messages only after t2 */
+    CS104_APCIParameters slaveParameters = CS104_Slave_getConnectionParameters(slave);
+    slaveParameters->w = 100;
+    slaveParameters->t2 = 1;
+
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_setASDUHandler(slave, sendQueueTestSlaveASDUHandler, &receivedCommands);
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    TEST_ASSERT_NOT_NULL(con);
+
+    CS104_Connection_setConnectionHandler(con, sendQueueTestConnectionHandler, &availableEvents);
+    TEST_ASSERT_TRUE(CS104_Connection_setSendQueueSize(con, 10));
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    /* queue cannot be replaced while the connection is open */
+    TEST_ASSERT_FALSE(CS104_Connection_setSendQueueSize(con, 20));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    int i;
+
+    /* k (12) ASDUs are sent, 10 ASDUs are queued */
+    for (i = 0; i < 22; i++) {
+        SingleCommand sc = SingleCommand_create(NULL, 100 + i, true, false, 0);
+
+        TEST_ASSERT_TRUE(CS104_Connection_sendProcessCommandEx(con, CS101_COT_ACTIVATION, 1, (InformationObject) sc));
+
+        SingleCommand_destroy(sc);
+    }
+
+    TEST_ASSERT_TRUE(CS104_Connection_isTransmitBufferFull(con));
+    TEST_ASSERT_EQUAL_INT(10, CS104_Connection_getSendQueueCount(con));
+
+    /* queue is full */
+    SingleCommand sc = SingleCommand_create(NULL, 200, true, false, 0);
+    TEST_ASSERT_FALSE(CS104_Connection_sendProcessCommandEx(con, CS101_COT_ACTIVATION, 1, (InformationObject) sc));
+    SingleCommand_destroy(sc);
+
+    TEST_ASSERT_EQUAL_INT(0, availableEvents);
+
+    /* confirmation of the slave -> queued ASDUs are sent */
+    int waitTime = 0;
+
+    while ((receivedCommands < 22) && (waitTime < 5000)) {
+        Thread_sleep(10);
+        waitTime += 10;
+    }
+
+    TEST_ASSERT_EQUAL_INT(22, receivedCommands);
+    TEST_ASSERT_EQUAL_INT(0, CS104_Connection_getSendQueueCount(con));
+    TEST_ASSERT_EQUAL_INT(1, availableEvents);
+
+    CS104_Connection_close(con);
+
+    TEST_ASSERT_TRUE(CS104_Connection_setSendQueueSize(con, 0));
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+
+static bool
+redundantConnectionTestInterrogationHandler(void* parameter, IMasterConnection connection, CS101_ASDU asdu, uint8_t qoi)
+{
+    (void) qoi;
+
+    (*((int*) parameter))++;
+
+    IMasterConnection_sendACT_CON(connection, asdu, false);
+
+    return true;
+}
+
+static void
+redundantConnectionTestEventHandler(void* parameter, CS104_RedundantConnection connection, int endpoint,
+        CS104_RedundantConnectionEvent event)
+{
+    (void) connection;
+    (void) endpoint;
+
+    if (event == CS104_REDUNDANT_ENDPOINT_ACTIVE)
+        (*((int*) parameter))++;
+}
+
+static void
+waitForActiveEndpoint(CS104_RedundantConnection con, int endpoint)
+{
+    int waitTime = 0;
+
+    while ((CS104_RedundantConnection_getActiveEndpoint(con) != endpoint) && (waitTime < 3000)) {
+        Thread_sleep(10);
+        waitTime += 10;
+    }
+}
+
+void
+test_CS104_RedundantConnection_switchover(void)
+{
+    int interrogations1 = 0;
+    int interrogations2 = 0;
+    int activeEvents = 0;
+    sCS104_RedundantConnectionStatistics stats;
+
+    CS104_Slave slave1 = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave1, 20004);
+    CS104_Slave_setInterrogationHandler(slave1, redundantConnectionTestInterrogationHandler, &interrogations1);
+    CS104_Slave_start(slave1);
+
+    CS104_Slave slave2 = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave2, 20005);
+    CS104_Slave_setInterrogationHandler(slave2, redundantConnectionTestInterrogationHandler, &interrogations2);
+    CS104_Slave_start(slave2);
+
+    CS104_RedundantConnection con = CS104_RedundantConnection_create();
+    TEST_ASSERT_NOT_NULL(con);
+
+    TEST_ASSERT_EQUAL_INT(0, CS104_RedundantConnection_addEndpoint(con, "127.0.0.1", 20004));
+    TEST_ASSERT_EQUAL_INT(1, CS104_RedundantConnection_addEndpoint(con, "127.0.0.1", 20005));
+
+    CS104_RedundantConnection_setInterrogationOnSwitchover(con, true, 1);
+    CS104_RedundantConnection_setEventHandler(con, redundantConnectionTestEventHandler, &activeEvents);
+
+    TEST_ASSERT_NULL(CS104_RedundantConnection_getActiveConnection(con));
+
+    CS104_RedundantConnection_start(con);
+
+    /* wait until both connections are established */
+    Thread_sleep(500);
+
+    int activeEndpoint = CS104_RedundantConnection_getActiveEndpoint(con);
+
+    TEST_ASSERT_TRUE((activeEndpoint == 0) || (activeEndpoint == 1));
+    TEST_ASSERT_EQUAL_PTR(CS104_RedundantConnection_getEndpointConnection(con, activeEndpoint), CS104_RedundantConnection_getActiveConnection(con));
+    TEST_ASSERT_EQUAL_INT(1, activeEvents);
+    TEST_ASSERT_EQUAL_INT(1, interrogations1 + interrogations2);
+
+    CS104_RedundantConnection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.switchovers);
+
+    /* failure of the active server -> standby connection becomes active */
+    if (activeEndpoint == 0)
+        CS104_Slave_stop(slave1);
+    else
+        CS104_Slave_stop(slave2);
+
+    waitForActiveEndpoint(con, 1 - activeEndpoint);
+
+    TEST_ASSERT_EQUAL_INT(1 - activeEndpoint, CS104_RedundantConnection_getActiveEndpoint(con));
+
+    Thread_sleep(100);
+
+    TEST_ASSERT_EQUAL_INT(2, activeEvents);
+    TEST_ASSERT_EQUAL_INT(1, interrogations1);
+    TEST_ASSERT_EQUAL_INT(1, interrogations2);
+
+    CS104_RedundantConnection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.switchovers);
+    TEST_ASSERT_TRUE(stats.lastSwitchoverTimeUs < 1000000);
+    TEST_ASSERT_EQUAL_UINT64(stats.lastSwitchoverTimeUs, stats.maxSwitchoverTimeUs);
+
+    CS104_RedundantConnection_destroy(con);
+
+    CS104_Slave_stop(slave1);
+    CS104_Slave_destroy(slave1);
+    CS104_Slave_stop(slave2);
+    CS104_Slave_destroy(slave2);
+}
+
+void
+test_CS104_RedundantConnection_startDTTimeout(void)
+{
+    int interrogations = 0;
+    int activeEvents = 0;
+    sCS104_RedundantConnectionStatistics stats;
+
+    /* server that accepts TCP connections (listen backlog) but never answers STARTDT */
+    ServerSocket silentServer = TcpServerSocket_create("127.0.0.1", 20006);
+    TEST_ASSERT_NOT_NULL(silentServer);
+    ServerSocket_listen(silentServer);
+
+    CS104_RedundantConnection con = CS104_RedundantConnection_create();
+    TEST_ASSERT_NOT_NULL(con);
+
+    TEST_ASSERT_EQUAL_INT(0, CS104_RedundantConnection_addEndpoint(con, "127.0.0.1", 20006));
+    TEST_ASSERT_EQUAL_INT(1, CS104_RedundantConnection_addEndpoint(con, "127.0.0.1", 20007));
+
+    CS104_Connection silentConnection = CS104_RedundantConnection_getEndpointConnection(con, 0);
+
+    struct sCS104_APCIParameters apciParameters = *(CS104_Connection_getAPCIParameters(silentConnection));
+    apciParameters.t1 = 1;
+    CS104_Connection_setAPCIParameters(silentConnection, &apciParameters);
+
+    CS104_RedundantConnection_setReconnectInterval(con, 100);
+    CS104_RedundantConnection_setEventHandler(con, redundantConnectionTestEventHandler, &activeEvents);
+
+    CS104_RedundantConnection_start(con);
+
+    /* only the silent endpoint is reachable -> STARTDT is sent there but not confirmed */
+    Thread_sleep(300);
+
+    TEST_ASSERT_EQUAL_INT(-1, CS104_RedundantConnection_getActiveEndpoint(con));
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave, 20007);
+    CS104_Slave_setInterrogationHandler(slave, redundantConnectionTestInterrogationHandler, &interrogations);
+    CS104_Slave_start(slave);
+
+    /* t1 timeout of STARTDT -> the next endpoint becomes active */
+    waitForActiveEndpoint(con, 1);
+
+    TEST_ASSERT_EQUAL_INT(1, CS104_RedundantConnection_getActiveEndpoint(con));
+    TEST_ASSERT_EQUAL_INT(1, activeEvents);
+
+    CS104_RedundantConnection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.switchovers);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.failedSwitchovers);
+
+    /* wait until the silent endpoint is reconnected as standby */
+    Thread_sleep(500);
+
+    /* switchover to the silent endpoint fails with t1 timeout and no other standby is available */
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    int waitTime = 0;
+
+    do {
+        Thread_sleep(10);
+        waitTime += 10;
+        CS104_RedundantConnection_getStatistics(con, &stats);
+    } while ((stats.failedSwitchovers == 0) && (waitTime < 3000));
+
+    TEST_ASSERT_EQUAL_UINT32(1, stats.failedSwitchovers);
+    TEST_ASSERT_EQUAL_INT(-1, CS104_RedundantConnection_getActiveEndpoint(con));
+
+    /* the next activation is no switchover */
+    slave = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave, 20007);
+    CS104_Slave_start(slave);
+
+    waitForActiveEndpoint(con, 1);
+
+    TEST_ASSERT_EQUAL_INT(1, CS104_RedundantConnection_getActiveEndpoint(con));
+
+    CS104_RedundantConnection_getStatistics(con, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.switchovers);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.failedSwitchovers);
+
+    CS104_RedundantConnection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    ServerSocket_destroy(silentServer);
+}
+
+static void
+mirrorCacheTestHandler(void* parameter, int ca, int ioa, const sCS101_MirrorCacheValue* value)
+{
+    (void) ca;
+    (void) value;
+
+    int* changes = (int*) parameter;
+
+    changes[ioa - 100]++;
+}
+
+static void
+mirrorCacheTestAddScaledValue(CS101_MirrorCache cache, CS101_AppLayerParameters alParams, int ca, int ioa, int value,
+        QualityDescriptor quality)
+{
+    CS101_ASDU asdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, ca, false, false);
+
+    InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, ioa, value, quality);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    TEST_ASSERT_EQUAL_INT(1, CS101_MirrorCache_handleASDU(cache, asdu));
+
+    CS101_ASDU_destroy(asdu);
+}
+
+void
+test_CS101_MirrorCache(void)
+{
+    struct sCS101_AppLayerParameters alParams = {1, 1, 2, 0, 2, 3, 249};
+    sCS101_MirrorCacheValue value;
+    int changes[4] = {0, 0, 0, 0};
+
+    CS101_MirrorCache cache = CS101_MirrorCache_create(4);
+    TEST_ASSERT_NOT_NULL(cache);
+
+    TEST_ASSERT_FALSE(CS101_MirrorCache_getValue(cache, 1, 100, &value));
+
+    CS101_MirrorCacheSubscription subscription = CS101_MirrorCache_subscribe(cache, 1, 100, 101, mirrorCacheTestHandler, changes);
+    TEST_ASSERT_NOT_NULL(subscription);
+
+    /* sequence of single points with time tag */
+    CS101_ASDU asdu = CS101_ASDU_create(&alParams, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+    struct sCP56Time2a timestamp;
+    CP56Time2a_createFromMsTimestamp(&timestamp, 1700000000000ULL);
+
+    InformationObject io = (InformationObject) SinglePointWithCP56Time2a_create(NULL, 100, true, IEC60870_QUALITY_GOOD, &timestamp);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    io = (InformationObject) SinglePointWithCP56Time2a_create(NULL, 101, false, IEC60870_QUALITY_INVALID, &timestamp);
+    CS101_ASDU_addInformationObject(asdu, io);
+    InformationObject_destroy(io);
+
+    TEST_ASSERT_EQUAL_INT(2, CS101_MirrorCache_handleASDU(cache, asdu));
+    CS101_ASDU_destroy(asdu);
+
+    TEST_ASSERT_EQUAL_INT(2, CS101_MirrorCache_getNumberOfPoints(cache));
+    TEST_ASSERT_EQUAL_UINT32(2, CS101_MirrorCache_getSequence(cache));
+
+    TEST_ASSERT_TRUE(CS101_MirrorCache_getValue(cache, 1, 100, &value));
+    TEST_ASSERT_EQUAL_INT(M_SP_TB_1, value.typeId);
+    TEST_ASSERT_EQUAL_INT(1, value.intValue);
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_GOOD, value.quality);
+    TEST_ASSERT_EQUAL_UINT64(1700000000000ULL, value.timestamp);
+    TEST_ASSERT_EQUAL_UINT32(1, value.sequence);
+    TEST_ASSERT_EQUAL_UINT32(1, value.changeCount);
+
+    TEST_ASSERT_TRUE(CS101_MirrorCache_getValue(cache, 1, 101, &value));
+    TEST_ASSERT_EQUAL_INT(0, value.intValue);
+    TEST_ASSERT_EQUAL_INT(IEC60870_QUALITY_INVALID, value.quality);
+
+    /* same IOA with other CA is another data point */
+    TEST_ASSERT_FALSE(CS101_MirrorCache_getValue(cache, 2, 100, &value));
+
+    TEST_ASSERT_EQUAL_INT(1, changes[0]);
+    TEST_ASSERT_EQUAL_INT(1, changes[1]);
+
+    /* update without change -> no notification */
+    mirrorCacheTestAddScaledValue(cache, &alParams, 1, 102, 1000, IEC60870_QUALITY_GOOD);
+    mirrorCacheTestAddScaledValue(cache, &alParams, 1, 102, 1000, IEC60870_QUALITY_GOOD);
+    mirrorCacheTestAddScaledValue(cache, &alParams, 1, 102, -5, IEC60870_QUALITY_GOOD);
+
+    TEST_ASSERT_TRUE(CS101_MirrorCache_getValue(cache, 1, 102, &value));
+    TEST_ASSERT_EQUAL_INT(M_ME_NB_1, value.typeId);
+    TEST_ASSERT_EQUAL_INT(-5, value.intValue);
+    TEST_ASSERT_EQUAL_FLOAT(-5.f, value.value);
+    TEST_ASSERT_EQUAL_UINT64(0, value.timestamp);
+    TEST_ASSERT_EQUAL_UINT32(5, value.sequence);
+    TEST_ASSERT_EQUAL_UINT32(2, value.changeCount);
+
+    /* IOA 102 is not in the subscribed range */
+    TEST_ASSERT_EQUAL_INT(0, changes[2]);
+
+    mirrorCacheTestAddScaledValue(cache, &alParams, 1, 101, 0, IEC60870_QUALITY_GOOD);
+    mirrorCacheTestAddScaledValue(cache, &alParams, 1, 101, 0, IEC60870_QUALITY_GOOD);
+    TEST_ASSERT_EQUAL_INT(2, changes[1]);
+
+    CS101_MirrorCache_unsubscribe(cache, subscription);
+
+    mirrorCacheTestAddScaledValue(cache, &alParams, 1, 101, 1, IEC60870_QUALITY_GOOD);
+    TEST_ASSERT_EQUAL_INT(2, changes[1]);
+
+    /* cache is full (4 points) */
+    mirrorCacheTestAddScaledValue(cache, &alParams, 2, 100, 1, IEC60870_QUALITY_GOOD);
+
+    CS101_ASDU fullAsdu = CS101_ASDU_create(&alParams, false, CS101_COT_SPONTANEOUS, 0, 2, false, false);
+    io = (InformationObject) MeasuredValueScaled_create(NULL, 101, 1, IEC60870_QUALITY_GOOD);
+    CS101_ASDU_addInformationObject(fullAsdu, io);
+    InformationObject_destroy(io);
+
+    CS101_MirrorCache_handleASDU(cache, fullAsdu);
+    CS101_ASDU_destroy(fullAsdu);
+
+    TEST_ASSERT_EQUAL_INT(4, CS101_MirrorCache_getNumberOfPoints(cache));
+    TEST_ASSERT_EQUAL_UINT32(1, CS101_MirrorCache_getDroppedUpdates(cache));
+    TEST_ASSERT_FALSE(CS101_MirrorCache_getValue(cache, 2, 101, &value));
+    TEST_ASSERT_TRUE(CS101_MirrorCache_getValue(cache, 2, 100, &value));
+
+    /* commands are not stored */
+    CS101_ASDU commandAsdu = CS101_ASDU_create(&alParams, false, CS101_COT_ACTIVATION, 0, 1, false, false);
+    io = (InformationObject) SingleCommand_create(NULL, 100, false, false, 0);
+    CS101_ASDU_addInformationObject(commandAsdu, io);
+    InformationObject_destroy(io);
+
+    TEST_ASSERT_EQUAL_INT(-1, CS101_MirrorCache_handleASDU(cache, commandAsdu));
+    CS101_ASDU_destroy(commandAsdu);
+
+    CS101_MirrorCache_destroy(cache);
+}
+
+void
+test_CS104_Connection_mirrorCache(void)
+{
+    sCS101_MirrorCacheValue value;
+
+    CS104_Slave slave = CS104_Slave_create(10, 10);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
+
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slave);
+
+    CS101_MirrorCache cache = CS101_MirrorCache_create(100);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    CS104_Connection_setMirrorCache(con, cache);
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    int i;
+
+    for (i = 0; i < 10; i++) {
+        CS101_ASDU newAsdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, 200 + (i % 2), (float) i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(newAsdu, io);
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, newAsdu);
+
+        CS101_ASDU_destroy(newAsdu);
+    }
+
+    int waitTime = 0;
+
+    while ((CS101_MirrorCache_getSequence(cache) < 10) && (waitTime < 2000)) {
+        Thread_sleep(10);
+        waitTime += 10;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(10, CS101_MirrorCache_getSequence(cache));
+    TEST_ASSERT_EQUAL_INT(2, CS101_MirrorCache_getNumberOfPoints(cache));
+
+    TEST_ASSERT_TRUE(CS101_MirrorCache_getValue(cache, 1, 200, &value));
+    TEST_ASSERT_EQUAL_FLOAT(8.f, value.value);
+    TEST_ASSERT_EQUAL_UINT32(5, value.changeCount);
+
+    TEST_ASSERT_TRUE(CS101_MirrorCache_getValue(cache, 1, 201, &value));
+    TEST_ASSERT_EQUAL_FLOAT(9.f, value.value);
+    TEST_ASSERT_EQUAL_UINT32(10, value.sequence);
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    CS101_MirrorCache_destroy(cache);
+}
+
+static bool
+captureTestASDUHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    (void) address;
+
+    if (CS101_ASDU_getTypeID(asdu) == M_ME_NB_1)
+        (*((int*) parameter))++;
+
+    return true;
+}
+
+static bool
+captureTestReplayHandler(void* parameter, const sCS104_CaptureRecord* record)
+{
+    (void) record;
+
+    (*((int*) parameter))++;
+
+    return true;
+}
+
+static bool
+captureTestSlaveASDUHandler(void* parameter, IMasterConnection connection, CS101_ASDU asdu)
+{
+    (void) connection;
+
+    if (CS101_ASDU_getTypeID(asdu) == M_ME_NB_1)
+        (*((int*) parameter))++;
+
+    return true;
+}
+
+static void
+captureTestWaitForASDUs(int* receivedASDUs, int count)
+{
+    int waitTime = 0;
+
+    while ((*receivedASDUs < count) && (waitTime < 3000)) {
+        Thread_sleep(10);
+        waitTime += 10;
+    }
+}
+
+void
+test_CS104_CaptureAndReplay(void)
+{
+    const char* filename = "test_capture.cap";
+    int receivedASDUs = 0;
+    int i;
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
+
+    CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slave);
+
+    /* capture the messages of a client connection */
+    CS104_CaptureWriter writer = CS104_CaptureWriter_create(filename);
+    TEST_ASSERT_NOT_NULL(writer);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    CS104_Connection_setASDUReceivedHandler(con, captureTestASDUHandler, &receivedASDUs);
+    CS104_CaptureWriter_captureConnection(writer, con, 7);
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    for (i = 0; i < 20; i++) {
+        CS101_ASDU newAsdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 110, i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(newAsdu, io);
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, newAsdu);
+
+        CS101_ASDU_destroy(newAsdu);
+    }
+
+    captureTestWaitForASDUs(&receivedASDUs, 20);
+    TEST_ASSERT_EQUAL_INT(20, receivedASDUs);
+
+    CS104_Connection_destroy(con);
+
+    uint64_t recordCount = CS104_CaptureWriter_getRecordCount(writer);
+    TEST_ASSERT_TRUE(recordCount > 20);
+
+    CS104_CaptureWriter_destroy(writer);
+
+    /* read the capture file */
+    CS104_CaptureReader reader = CS104_CaptureReader_create(filename);
+    TEST_ASSERT_NOT_NULL(reader);
+
+    TEST_ASSERT_EQUAL_INT((int) recordCount, CS104_CaptureReader_getRecordCount(reader));
+
+    sCS104_CaptureRecord record;
+
+    /* STARTDT ACT */
+    TEST_ASSERT_TRUE(CS104_CaptureReader_getRecord(reader, 0, &record));
+    TEST_ASSERT_TRUE(record.sent);
+    TEST_ASSERT_EQUAL_UINT32(7, record.connectionId);
+    TEST_ASSERT_EQUAL_INT(6, record.msgSize);
+    TEST_ASSERT_EQUAL_UINT8(0x07, record.msg[2]);
+
+    TEST_ASSERT_FALSE(CS104_CaptureReader_getRecord(reader, (int) recordCount, &record));
+
+    TEST_ASSERT_TRUE(CS104_CaptureReader_getRecord(reader, (int) recordCount - 1, &record));
+    TEST_ASSERT_EQUAL_INT((int) recordCount - 1, CS104_CaptureReader_findRecord(reader, record.timestamp));
+    TEST_ASSERT_EQUAL_INT(0, CS104_CaptureReader_findRecord(reader, 0));
+    TEST_ASSERT_EQUAL_INT((int) recordCount, CS104_CaptureReader_findRecord(reader, record.timestamp + 1));
+
+    CS104_CaptureReplay replay = CS104_CaptureReplay_create(reader);
+    TEST_ASSERT_NOT_NULL(replay);
+
+    /* all messages sent by the client (STARTDT, S format APDUs) */
+    int sentMessages = 0;
+
+    CS104_CaptureReplay_setSpeed(replay, 0);
+    TEST_ASSERT_TRUE(CS104_CaptureReplay_run(replay, captureTestReplayHandler, &sentMessages) > 0);
+
+    sCS104_CaptureReplayStatistics stats;
+    CS104_CaptureReplay_getStatistics(replay, &stats);
+    TEST_ASSERT_EQUAL_UINT64(recordCount, stats.replayedRecords + stats.skippedRecords);
+
+    /* replay the received ASDUs by the slave to a new client */
+    receivedASDUs = 0;
+
+    con = CS104_Connection_create("127.0.0.1", 20004);
+    CS104_Connection_setASDUReceivedHandler(con, captureTestASDUHandler, &receivedASDUs);
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    CS104_CaptureReplay_setFilter(replay, false, 7);
+    CS104_CaptureReplay_setSpeed(replay, 10.0);
+
+    /* STARTDT CON is skipped */
+    TEST_ASSERT_EQUAL_INT(20, CS104_CaptureReplay_runSlave(replay, slave));
+
+    captureTestWaitForASDUs(&receivedASDUs, 20);
+    TEST_ASSERT_EQUAL_INT(20, receivedASDUs);
+
+    CS104_CaptureReplay_getStatistics(replay, &stats);
+    TEST_ASSERT_EQUAL_UINT64(20, stats.replayedRecords);
+
+    /* no records of other connections */
+    CS104_CaptureReplay_setFilter(replay, false, 8);
+    TEST_ASSERT_EQUAL_INT(0, CS104_CaptureReplay_runSlave(replay, slave));
+
+    CS104_Connection_destroy(con);
+
+    /* replay the ASDUs by a client connection - the small send queue is full most of the time */
+    int slaveASDUs = 0;
+
+    CS104_Slave_setASDUHandler(slave, captureTestSlaveASDUHandler, &slaveASDUs);
+
+    con = CS104_Connection_create("127.0.0.1", 20004);
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    CS104_CaptureReplay_setFilter(replay, false, 7);
+    CS104_CaptureReplay_setSpeed(replay, 0);
+
+    /* a send queue is required */
+    TEST_ASSERT_EQUAL_INT(0, CS104_CaptureReplay_runConnection(replay, con));
+
+    CS104_Connection_destroy(con);
+
+    con = CS104_Connection_create("127.0.0.1", 20004);
+    CS104_Connection_getAPCIParameters(con)->k = 2;
+    TEST_ASSERT_TRUE(CS104_Connection_setSendQueueSize(con, 1));
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    TEST_ASSERT_EQUAL_INT(20, CS104_CaptureReplay_runConnection(replay, con));
+
+    captureTestWaitForASDUs(&slaveASDUs, 20);
+    TEST_ASSERT_EQUAL_INT(20, slaveASDUs);
+
+    CS104_CaptureReplay_destroy(replay);
+    CS104_CaptureReader_destroy(reader);
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    remove(filename);
+}
+
+static void
+captureTestWriteFile(const char* filename, const uint8_t* data, long size)
+{
+    FILE* file = fopen(filename, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    TEST_ASSERT_EQUAL_INT((int) size, (int) fwrite(data, 1, size, file));
+
+    fclose(file);
+}
+
+void
+test_CS104_CaptureReader_corruptFile(void)
+{
+    const char* filename = "test_capture_corrupt.cap";
+    uint8_t msg[6] = { 0x68, 0x04, 0x01, 0x00, 0x00, 0x00 };
+    int i;
+
+    /* more records than the index interval (256) */
+    CS104_CaptureWriter writer = CS104_CaptureWriter_create(filename);
+    TEST_ASSERT_NOT_NULL(writer);
+
+    for (i = 0; i < 300; i++)
+        TEST_ASSERT_TRUE(CS104_CaptureWriter_writeRecord(writer, 1000 + i, 1, false, msg, sizeof(msg)));
+
+    CS104_CaptureWriter_destroy(writer);
+
+    FILE* file = fopen(filename, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = (uint8_t*) malloc(fileSize);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL_INT((int) fileSize, (int) fread(data, 1, fileSize, file));
+
+    fclose(file);
+
+    CS104_CaptureReader reader = CS104_CaptureReader_create(filename);
+    TEST_ASSERT_NOT_NULL(reader);
+    TEST_ASSERT_EQUAL_INT(300, CS104_CaptureReader_getRecordCount(reader));
+    CS104_CaptureReader_destroy(reader);
+
+    /* truncated index */
+    captureTestWriteFile(filename, data, fileSize - 8);
+    TEST_ASSERT_NULL(CS104_CaptureReader_create(filename));
+
+    /* truncated records */
+    captureTestWriteFile(filename, data, 32 + 100);
+    TEST_ASSERT_NULL(CS104_CaptureReader_create(filename));
+
+    /* message size of the second record (header 32 byte, first record 24 byte) is too large */
+    data[56 + 14] = 0xff;
+    data[56 + 15] = 0xff;
+
+    captureTestWriteFile(filename, data, fileSize);
+    TEST_ASSERT_NULL(CS104_CaptureReader_create(filename));
+
+    /* without index (file was not closed) only the records before the corrupted record are used */
+    memset(data + 24, 0, 8);
+
+    captureTestWriteFile(filename, data, fileSize);
+
+    reader = CS104_CaptureReader_create(filename);
+    TEST_ASSERT_NOT_NULL(reader);
+    TEST_ASSERT_EQUAL_INT(1, CS104_CaptureReader_getRecordCount(reader));
+    CS104_CaptureReader_destroy(reader);
+
+    free(data);
+
+    remove(filename);
+}
+
+static bool
+socketPollerTestASDUHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    (void) address;
+
+    if (CS101_ASDU_getTypeID(asdu) == M_ME_NB_1)
+        (*((int*) parameter))++;
+
+    return true;
+}
+
+/* wait for ready sockets and handle the slaves with ready sockets */
+static void
+socketPollerTestRun(SocketPoller poller, int durationMs)
+{
+    uint64_t endTime = Hal_getTimeInMs() + durationMs;
+
+    while (Hal_getTimeInMs() < endTime) {
+        int readyCount = SocketPoller_wait(poller, 10);
+        int i;
+
+        for (i = 0; i < readyCount; i++)
+            CS104_Slave_tick((CS104_Slave) SocketPoller_getParameter(poller, i));
+    }
+}
+
+void
+test_CS104_Slave_socketPoller(void)
+{
+    struct sCS104_ConnectionStatistics stats;
+    int receivedASDUs[2] = {0, 0};
+    CS104_Slave slaves[2];
+    CS104_Connection connections[2];
+    int i, j;
+
+    SocketPoller poller = SocketPoller_create(16);
+    TEST_ASSERT_NOT_NULL(poller);
+
+    for (i = 0; i < 2; i++) {
+        slaves[i] = CS104_Slave_create(10, 10);
+
+        CS104_Slave_setLocalPort(slaves[i], 20004 + i);
+        CS104_Slave_setMaxOpenConnections(slaves[i], 1);
+        CS104_Slave_setSocketPoller(slaves[i], poller);
+
+        CS104_Slave_startThreadless(slaves[i]);
+        TEST_ASSERT_TRUE(CS104_Slave_isRunning(slaves[i]));
+    }
+
+    for (i = 0; i < 2; i++) {
+        connections[i] = CS104_Connection_create("127.0.0.1", 20004 + i);
+        CS104_Connection_setASDUReceivedHandler(connections[i], socketPollerTestASDUHandler, &(receivedASDUs[i]));
+
+        TEST_ASSERT_TRUE(CS104_Connection_connect(connections[i]));
+
+        CS104_Connection_sendStartDT(connections[i]);
+    }
+
+    /* accept the connections and handle STARTDT */
+    socketPollerTestRun(poller, 300);
+
+    for (i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_INT(1, CS104_Slave_getOpenConnections(slaves[i]));
+
+        CS101_AppLayerParameters alParams = CS104_Slave_getAppLayerParameters(slaves[i]);
+
+        for (j = 0; j < 5 + i; j++) {
+            CS101_ASDU newAsdu = CS101_ASDU_create(alParams, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+            InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100, j, IEC60870_QUALITY_GOOD);
+            CS101_ASDU_addInformationObject(newAsdu, io);
+            InformationObject_destroy(io);
+
+            CS104_Slave_enqueueASDU(slaves[i], newAsdu);
+
+            CS101_ASDU_destroy(newAsdu);
+        }
+
+        /* events are sent by the tick function */
+        CS104_Slave_tick(slaves[i]);
+    }
+
+    /* handle the confirmations of the client */
+    socketPollerTestRun(poller, 200);
+
+    TEST_ASSERT_EQUAL_INT(5, receivedASDUs[0]);
+    TEST_ASSERT_EQUAL_INT(6, receivedASDUs[1]);
+
+    for (i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_INT(1, CS104_Slave_getStatistics(slaves[i], &stats, 1));
+        TEST_ASSERT_EQUAL_UINT64(5 + i, stats.sentIFrames);
+    }
+
+    for (i = 0; i < 2; i++) {
+        CS104_Connection_destroy(connections[i]);
+
+        CS104_Slave_stopThreadless(slaves[i]);
+        CS104_Slave_destroy(slaves[i]);
+    }
+
+    SocketPoller_destroy(poller);
+}
+
+struct sBatchHandlerTestInfo {
+    int asduCount;
+    int batchCount;
+    int maxBatchSize;
+    int nextValue;
+    bool orderError;
+};
+
+static void
+batchHandlerTestHandler(void* parameter, CS101_ASDU* asdus, int numberOfASDUs)
+{
+    struct sBatchHandlerTestInfo* info = (struct sBatchHandlerTestInfo*) parameter;
+    int i;
+
+    info->batchCount++;
+
+    if (numberOfASDUs > info->maxBatchSize)
+        info->maxBatchSize = numberOfASDUs;
+
+    for (i = 0; i < numberOfASDUs; i++) {
+        if (CS101_ASDU_getTypeID(asdus[i]) == M_ME_NB_1) {
+            MeasuredValueScaled mvs = (MeasuredValueScaled) CS101_ASDU_getElement(asdus[i], 0);
+
+            if (MeasuredValueScaled_getValue(mvs) != info->nextValue)
+                info->orderError = true;
+
+            info->nextValue++;
+            info->asduCount++;
+
+            MeasuredValueScaled_destroy(mvs);
+        }
+    }
+}
+
+static void
+batchHandlerTestSendASDUs(CS104_Slave slave, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(CS104_Slave_getAppLayerParameters(slave), false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100, i, IEC60870_QUALITY_GOOD);
+        CS101_ASDU_addInformationObject(asdu, io);
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, asdu);
+
+        CS101_ASDU_destroy(asdu);
+    }
+}
+
+void
+test_CS104_Connection_batchHandler(void)
+{
+    struct sBatchHandlerTestInfo info;
+
+    memset(&info, 0, sizeof(info));
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_start(slave);
+
+    /* batches are delivered after each read cycle */
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+    TEST_ASSERT_NOT_NULL(con);
+
+    TEST_ASSERT_TRUE(CS104_Connection_setASDUBatchHandler(con, batchHandlerTestHandler, &info, 8, 0));
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    /* the batch buffers cannot be changed while the connection is open */
+    TEST_ASSERT_FALSE(CS104_Connection_setASDUBatchHandler(con, batchHandlerTestHandler, &info, 2, 0));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(500);
+
+    batchHandlerTestSendASDUs(slave, 30);
+
+    Thread_sleep(1000);
+
+    TEST_ASSERT_EQUAL_INT(30, info.asduCount);
+    TEST_ASSERT_FALSE(info.orderError);
+    TEST_ASSERT_TRUE(info.maxBatchSize <= 8);
+    TEST_ASSERT_TRUE(info.batchCount >= 4);
+
+    CS104_Connection_destroy(con);
+
+    /* with a long delay the ASDUs are held back until the connection is closed */
+    memset(&info, 0, sizeof(info));
+
+    con = CS104_Connection_create("127.0.0.1", 20004);
+    TEST_ASSERT_NOT_NULL(con);
+
+    TEST_ASSERT_TRUE(CS104_Connection_setASDUBatchHandler(con, batchHandlerTestHandler, &info, 100, 60000));
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(500);
+
+    batchHandlerTestSendASDUs(slave, 30);
+
+    Thread_sleep(1000);
+
+    TEST_ASSERT_EQUAL_INT(0, info.asduCount);
+
+    CS104_Connection_close(con);
+
+    TEST_ASSERT_EQUAL_INT(30, info.asduCount);
+    TEST_ASSERT_EQUAL_INT(1, info.batchCount);
+    TEST_ASSERT_FALSE(info.orderError);
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+
+struct sUnixSocketTestInfo {
+    int asduCount;
+    char peerAddress[32];
+};
+
+static bool
+unixSocketTestConnectionRequestHandler(void* parameter, const char* ipAddress)
+{
+    struct sUnixSocketTestInfo* info = (struct sUnixSocketTestInfo*) parameter;
+
+    strncpy(info->peerAddress, ipAddress, sizeof(info->peerAddress) - 1);
+
+    return true;
+}
+
+static bool
+unixSocketTestASDUHandler(void* parameter, int address, CS101_ASDU asdu)
+{
+    struct sUnixSocketTestInfo* info = (struct sUnixSocketTestInfo*) parameter;
+
+    if (CS101_ASDU_getTypeID(asdu) == M_ME_NB_1)
+        info->asduCount++;
+
+    return true;
+}
+
+static void*
+unixSocketTestFailingMalloc(void* parameter, size_t size)
+{
+    (void) parameter;
+    (void) size;
+
+    return NULL;
+}
+
+static void*
+unixSocketTestRealloc(void* parameter, void* ptr, size_t size)
+{
+    (void) parameter;
+
+    return realloc(ptr, size);
+}
+
+static void
+unixSocketTestFree(void* parameter, void* ptr)
+{
+    (void) parameter;
+
+    free(ptr);
+}
+
+void
+test_CS104_UnixSocketConnection(void)
+{
+#if defined(__linux__)
+    const char* path = "/tmp/lib60870_test_unix_socket";
+
+    struct sUnixSocketTestInfo info;
+    memset(&info, 0, sizeof(info));
+
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+
+    TEST_ASSERT_NOT_NULL(slave);
+
+    TEST_ASSERT_TRUE(CS104_Slave_setLocalUnixPath(slave, path));
+    CS104_Slave_setConnectionRequestHandler(slave, unixSocketTestConnectionRequestHandler, &info);
+    CS104_Slave_start(slave);
+
+    TEST_ASSERT_TRUE(CS104_Slave_isRunning(slave));
+
+    /* a TCP client cannot reach the server */
+    CS104_Connection tcpCon = CS104_Connection_create("127.0.0.1", 20004);
+    CS104_Connection_setConnectTimeout(tcpCon, 200);
+    TEST_ASSERT_FALSE(CS104_Connection_connect(tcpCon));
+    CS104_Connection_destroy(tcpCon);
+
+    CS104_Connection con = CS104_Connection_createUnix(path);
+
+    TEST_ASSERT_NOT_NULL(con);
+
+    CS104_Connection_setASDUReceivedHandler(con, unixSocketTestASDUHandler, &info);
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(200);
+
+    TEST_ASSERT_EQUAL_STRING("unix", info.peerAddress);
+    TEST_ASSERT_EQUAL_INT(1, CS104_Slave_getOpenConnections(slave));
+
+    batchHandlerTestSendASDUs(slave, 10);
+
+    Thread_sleep(500);
+
+    TEST_ASSERT_EQUAL_INT(10, info.asduCount);
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    /* the path can be used again by a new server */
+    slave = CS104_Slave_create(100, 100);
+
+    TEST_ASSERT_TRUE(CS104_Slave_setLocalUnixPath(slave, path));
+    CS104_Slave_start(slave);
+
+    TEST_ASSERT_TRUE(CS104_Slave_isRunning(slave));
+
+    con = CS104_Connection_createUnix(path);
+
+    TEST_ASSERT_TRUE(CS104_Connection_connect(con));
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+
+    /* when the path cannot be stored the server doesn't fall back to TCP */
+    sMemoryAllocator failingAllocator;
+
+    failingAllocator.mallocFunction = unixSocketTestFailingMalloc;
+    failingAllocator.reallocFunction = unixSocketTestRealloc;
+    failingAllocator.freeFunction = unixSocketTestFree;
+    failingAllocator.parameter = NULL;
+
+    slave = CS104_Slave_create(100, 100);
+    CS104_Slave_setLocalPort(slave, 20004);
+
+    Memory_installAllocator(&failingAllocator);
+    TEST_ASSERT_FALSE(CS104_Slave_setLocalUnixPath(slave, path));
+    Memory_installAllocator(NULL);
+
+    CS104_Slave_start(slave);
+
+    TEST_ASSERT_FALSE(CS104_Slave_isRunning(slave));
+
+    CS104_Slave_destroy(slave);
+#endif /* defined(__linux__) */
+}
+
+#if defined(__linux__)
+struct sFT12TestInfo {
+    int count;
+    int msgSize[4];
+    uint8_t msg[4][261];
+};
+
+static void
+ft12TestMessageHandler(void* parameter, uint8_t* msg, int msgSize)
+{
+    struct sFT12TestInfo* info = (struct sFT12TestInfo*) parameter;
+
+    if (info->count < 4) {
+        info->msgSize[info->count] = msgSize;
+        memcpy(info->msg[info->count], msg, msgSize);
+    }
+
+    info->count++;
+}
+
+static int ft12TestPtyMaster;
+
+static void*
+ft12TestDelayedWrite(void* parameter)
+{
+    uint8_t* part = (uint8_t*) parameter;
+
+    Thread_sleep(50);
+
+    TEST_ASSERT_EQUAL_INT(5, write(ft12TestPtyMaster, part, 5));
+
+    return NULL;
+}
+#endif /* defined(__linux__) */
+
+void
+test_SerialTransceiverFT12_bufferedReceive(void)
+{
+#if defined(__linux__)
+    uint8_t fixedFrame[] = { 0x10, 0x49, 0x01, 0x4a, 0x16 };
+    uint8_t variableFrame[] = { 0x68, 0x03, 0x03, 0x68, 0x08, 0x01, 0x64, 0x6d, 0x16 };
+    uint8_t singleCharAck[] = { 0xe5 };
+
+    /* use a pseudo terminal as serial interface */
+    int unlock = 0;
+    int ptyNumber;
+    char ptyName[32];
+
+    ft12TestPtyMaster = open("/dev/ptmx", O_RDWR | O_NOCTTY);
+
+    TEST_ASSERT_TRUE(ft12TestPtyMaster != -1);
+    TEST_ASSERT_EQUAL_INT(0, ioctl(ft12TestPtyMaster, TIOCSPTLCK, &unlock));
+    TEST_ASSERT_EQUAL_INT(0, ioctl(ft12TestPtyMaster, TIOCGPTN, &ptyNumber));
+
+    snprintf(ptyName, sizeof(ptyName), "/dev/pts/%i", ptyNumber);
+
+    SerialPort port = SerialPort_create(ptyName, 9600, 8, 'E', 1);
+
+    TEST_ASSERT_TRUE(SerialPort_open(port));
+
+    struct sLinkLayerParameters linkLayerParameters;
+    memset(&linkLayerParameters, 0, sizeof(linkLayerParameters));
+    linkLayerParameters.addressLength = 1;
+
+    SerialTransceiverFT12 transceiver = SerialTransceiverFT12_create(port, &linkLayerParameters);
+    SerialTransceiverFT12_setTimeouts(transceiver, 50, 100);
+
+    struct sFT12TestInfo info;
+    memset(&info, 0, sizeof(info));
+
+    uint8_t buffer[261];
+
+    /* three frames received at once are returned one by one */
+    uint8_t frames[sizeof(fixedFrame) + sizeof(variableFrame) + sizeof(singleCharAck)];
+
+    memcpy(frames, fixedFrame, sizeof(fixedFrame));
+    memcpy(frames + sizeof(fixedFrame), variableFrame, sizeof(variableFrame));
+    memcpy(frames + sizeof(fixedFrame) + sizeof(variableFrame), singleCharAck, sizeof(singleCharAck));
+
+    TEST_ASSERT_EQUAL_INT(sizeof(frames), write(ft12TestPtyMaster, frames, sizeof(frames)));
+
+    SerialTransceiverFT12_readNextMessage(transceiver, buffer, ft12TestMessageHandler, &info);
+    SerialTransceiverFT12_readNextMessage(transceiver, buffer, ft12TestMessageHandler, &info);
+    SerialTransceiverFT12_readNextMessage(transceiver, buffer, ft12TestMessageHandler, &info);
+
+    TEST_ASSERT_EQUAL_INT(3, info.count);
+    TEST_ASSERT_EQUAL_INT(sizeof(fixedFrame), info.msgSize[0]);
+    TEST_ASSERT_EQUAL_MEMORY(fixedFrame, info.msg[0], sizeof(fixedFrame));
+    TEST_ASSERT_EQUAL_INT(sizeof(variableFrame), info.msgSize[1]);
+    TEST_ASSERT_EQUAL_MEMORY(variableFrame, info.msg[1], sizeof(variableFrame));
+    TEST_ASSERT_EQUAL_INT(1, info.msgSize[2]);
+    TEST_ASSERT_EQUAL_UINT8(0xe5, info.msg[2][0]);
+
+    /* no message -> message timeout */
+    SerialTransceiverFT12_readNextMessage(transceiver, buffer, ft12TestMessageHandler, &info);
+
+    TEST_ASSERT_EQUAL_INT(3, info.count);
+
+    /* the second part of the frame is received within the character timeout */
+    memset(&info, 0, sizeof(info));
+
+    TEST_ASSERT_EQUAL_INT(4, write(ft12TestPtyMaster, variableFrame, 4));
+
+    Thread writer = Thread_create(ft12TestDelayedWrite, variableFrame + 4, false);
+    Thread_start(writer);
+
+    SerialTransceiverFT12_readNextMessage(transceiver, buffer, ft12TestMessageHandler, &info);
+
+    Thread_destroy(writer);
+
+    TEST_ASSERT_EQUAL_INT(1, info.count);
+    TEST_ASSERT_EQUAL_MEMORY(variableFrame, info.msg[0], sizeof(variableFrame));
+
+    /* incomplete frame is discarded after the character timeout */
+    memset(&info, 0, sizeof(info));
+
+    TEST_ASSERT_EQUAL_INT(3, write(ft12TestPtyMaster, fixedFrame, 3));
+
+    SerialTransceiverFT12_readNextMessage(transceiver, buffer, ft12TestMessageHandler, &info);
+
+    TEST_ASSERT_EQUAL_INT(0, info.count);
+
+    TEST_ASSERT_EQUAL_INT(1, write(ft12TestPtyMaster, singleCharAck, 1));
+
+    SerialTransceiverFT12_readNextMessage(transceiver, buffer, ft12TestMessageHandler, &info);
+
+    TEST_ASSERT_EQUAL_INT(1, info.count);
+    TEST_ASSERT_EQUAL_UINT8(0xe5, info.msg[0][0]);
+
+    SerialTransceiverFT12_destroy(transceiver);
+
+    SerialPort_close(port);
+    SerialPort_destroy(port);
+
+    close(ft12TestPtyMaster);
+#endif /* defined(__linux__) */
+}
+
+/* the histogram is also compiled without CONFIG_CS104_SLAVE_LATENCY_STATISTICS */
+void
+test_CS104_LatencyHistogram(void)
+{
+    struct sCS104_LatencyHistogram histogram;
+    struct sCS104_LatencyStatistics stats;
+    uint64_t value;
+
+    CS104_LatencyHistogram_reset(&histogram);
+
+    TEST_ASSERT_EQUAL_UINT64(0, CS104_LatencyHistogram_getPercentile(&histogram, 50.0));
+
+    CS104_LatencyHistogram_getSummary(&histogram, &stats);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.count);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.mean);
+
+    for (value = 1; value <= 100; value++)
+        CS104_LatencyHistogram_record(&histogram, value);
+
+    CS104_LatencyHistogram_getSummary(&histogram, &stats);
+    TEST_ASSERT_EQUAL_UINT64(100, stats.count);
+    TEST_ASSERT_EQUAL_UINT64(1, stats.min);
+    TEST_ASSERT_EQUAL_UINT64(100, stats.max);
+    TEST_ASSERT_EQUAL_UINT64(50, stats.mean);
+
+    /* values below 32 are recorded exactly */
+    TEST_ASSERT_EQUAL_UINT64(10, CS104_LatencyHistogram_getPercentile(&histogram, 10.0));
+    TEST_ASSERT_EQUAL_UINT64(1, CS104_LatencyHistogram_getPercentile(&histogram, -5.0));
+
+    /* 50 is in the bucket 50..51 */
+    TEST_ASSERT_EQUAL_UINT64(51, stats.p50);
+
+    /* 99 is in the bucket 96..99 */
+    TEST_ASSERT_EQUAL_UINT64(99, stats.p99);
+
+    /* bucket of 100 is 100..103 -> limited to the maximum */
+    TEST_ASSERT_EQUAL_UINT64(100, CS104_LatencyHistogram_getPercentile(&histogram, 150.0));
+
+    /* values above 2^32 - 1 are recorded in the last bucket */
+    CS104_LatencyHistogram_record(&histogram, 1ULL << 40);
+
+    CS104_LatencyHistogram_getSummary(&histogram, &stats);
+    TEST_ASSERT_EQUAL_UINT64(1ULL << 40, stats.max);
+    TEST_ASSERT_EQUAL_UINT64(0xffffffffULL, CS104_LatencyHistogram_getPercentile(&histogram, 100.0));
+    TEST_ASSERT_EQUAL_UINT32(1, histogram.buckets[CS104_LATENCY_HISTOGRAM_BUCKETS - 1]);
+
+    CS104_LatencyHistogram_reset(&histogram);
+    TEST_ASSERT_EQUAL_UINT64(0, histogram.count);
+}
+
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+void
+test_CS104_Slave_latencyStatistics(void)
+{
+    CS104_Slave slave = CS104_Slave_create(100, 100);
+
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+    CS104_Slave_setLatencyStatisticsEnabled(slave, true);
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_create("127.0.0.1", 20004);
+
+    TEST_ASSERT_NOT_NULL(con);
+
+    /* confirm each received I frame immediately */
+    CS104_Connection_getAPCIParameters(con)->w = 1;
+
+    bool result = CS104_Connection_connect(con);
+
+    TEST_ASSERT_TRUE(result);
+
+    CS104_Connection_sendStartDT(con);
+
+    Thread_sleep(500);
+
+    int i;
+
+    for (i = 0; i < 10; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(CS104_Slave_getAppLayerParameters(slave), false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueScaled_create(NULL, 100 + i, i, IEC60870_QUALITY_GOOD);
+
+        CS101_ASDU_addInformationObject(asdu, io);
+
+        InformationObject_destroy(io);
+
+        CS104_Slave_enqueueASDU(slave, asdu);
+
+        CS101_ASDU_destroy(asdu);
+    }
+
+    Thread_sleep(1000);
+
+    struct sCS104_ConnectionStatistics conStats;
+
+    TEST_ASSERT_EQUAL_INT(1, CS104_Slave_getStatistics(slave, &conStats, 1));
+
+    struct sCS104_LatencyStatistics latency;
+
+    TEST_ASSERT_TRUE(CS104_Slave_getLatencyStatistics(slave, conStats.connectionId, CS104_LATENCY_QUEUEING, &latency));
+    TEST_ASSERT_EQUAL_UINT64(10, latency.count);
+
+    TEST_ASSERT_TRUE(CS104_Slave_getLatencyStatistics(slave, conStats.connectionId, CS104_LATENCY_WIRE_TO_ACK, &latency));
+    TEST_ASSERT_EQUAL_UINT64(10, latency.count);
+
+    TEST_ASSERT_TRUE(CS104_Slave_getLatencyStatistics(slave, conStats.connectionId, CS104_LATENCY_TOTAL, &latency));
+    TEST_ASSERT_EQUAL_UINT64(10, latency.count);
+    TEST_ASSERT_TRUE(latency.min <= latency.p50);
+    TEST_ASSERT_TRUE(latency.p50 <= latency.p99);
+    TEST_ASSERT_TRUE(latency.p99 <= latency.max);
+    TEST_ASSERT_TRUE(latency.max < 1000000);
+
+    uint64_t p100 = 0;
+
+    TEST_ASSERT_TRUE(CS104_Slave_getLatencyPercentile(slave, conStats.connectionId, CS104_LATENCY_TOTAL, 100.0, &p100));
+    TEST_ASSERT_EQUAL_UINT64(latency.max, p100);
+
+    CS104_Slave_resetLatencyStatistics(slave, 0);
+
+    TEST_ASSERT_TRUE(CS104_Slave_getLatencyStatistics(slave, conStats.connectionId, CS104_LATENCY_TOTAL, &latency));
+    TEST_ASSERT_EQUAL_UINT64(0, latency.count);
+
+    /* unknown connection */
+    TEST_ASSERT_FALSE(CS104_Slave_getLatencyStatistics(slave, conStats.connectionId + 1, CS104_LATENCY_TOTAL, &latency));
+
+    CS104_Connection_destroy(con);
+
+    CS104_Slave_stop(slave);
+    CS104_Slave_destroy(slave);
+}
+#endif /* (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1) */
+
+void
+test_Lib60870_logLevels(void)
+{
+    Lib60870LogLevel oldLevel = Lib60870_getLogLevel(LIB60870_LOG_CS104_SLAVE);
+
+    Lib60870_setLogLevel(LIB60870_LOG_CS104_SLAVE, LIB60870_LOG_LEVEL_WARNING);
+    TEST_ASSERT_EQUAL_INT(LIB60870_LOG_LEVEL_WARNING, Lib60870_getLogLevel(LIB60870_LOG_CS104_SLAVE));
+
+    Lib60870_enableDebugOutput(false);
+    TEST_ASSERT_EQUAL_INT(LIB60870_LOG_LEVEL_NONE, Lib60870_getLogLevel(LIB60870_LOG_CS104_SLAVE));
+    TEST_ASSERT_EQUAL_INT(LIB60870_LOG_LEVEL_NONE, Lib60870_getLogLevel(LIB60870_LOG_TLS));
+
+    Lib60870_enableDebugOutput(true);
+    TEST_ASSERT_EQUAL_INT(LIB60870_LOG_LEVEL_DEBUG, Lib60870_getLogLevel(LIB60870_LOG_LINK_LAYER));
+
+    /* invalid subsystem */
+    TEST_ASSERT_EQUAL_INT(LIB60870_LOG_LEVEL_NONE, Lib60870_getLogLevel((Lib60870LogSubsystem) LIB60870_LOG_SUBSYSTEM_COUNT));
+
+    Lib60870_setLogLevel(LIB60870_LOG_CS104_SLAVE, oldLevel);
+}
+
+#if ((CONFIG_DEBUG_OUTPUT == 1) && (CONFIG_DEBUG_OUTPUT_BINARY_LOG == 1))
+
+struct sLogHandlerInfo {
+    int count;
+    Lib60870LogSubsystem subsystem;
+    Lib60870LogLevel level;
+    uint64_t timestamp;
+    char message[256];
+};
+
+static void
+logHandler(void* parameter, uint64_t timestampInNs, Lib60870LogSubsystem subsystem, Lib60870LogLevel level, const char* message)
+{
+    struct sLogHandlerInfo* info = (struct sLogHandlerInfo*) parameter;
+
+    info->count++;
+    info->subsystem = subsystem;
+    info->level = level;
+    info->timestamp = timestampInNs;
+    strncpy(info->message, message, sizeof(info->message) - 1);
+    info->message[sizeof(info->message) - 1] = 0;
+}
+
+void
+test_Lib60870_binaryLog(void)
+{
+    struct sLogHandlerInfo info;
+    uint64_t startTime = Hal_getTimeInNs();
+    char text[20];
+    int i;
+
+    memset(&info, 0, sizeof(info));
+
+    /* remove records of previous tests */
+    Lib60870_processLog(logHandler, &info);
+
+    memset(&info, 0, sizeof(info));
+
+    strcpy(text, "text");
+
+    lib60870_log_record(LIB60870_LOG_CS104_CLIENT, LIB60870_LOG_LEVEL_WARNING,
+            "i=%i u=%u s=%s f=%.2f x=%02x c=%c l=%li ll=%lld %%\n", -5, 7u, text, 1.5, 10, 'A', -123456L, 1234567890123LL);
+
+    /* the string argument has to be copied into the record */
+    strcpy(text, "XXXX");
+
+    TEST_ASSERT_EQUAL_INT(1, Lib60870_processLog(logHandler, &info));
+    TEST_ASSERT_EQUAL_INT(1, info.count);
+    TEST_ASSERT_EQUAL_INT(LIB60870_LOG_CS104_CLIENT, info.subsystem);
+    TEST_ASSERT_EQUAL_INT(LIB60870_LOG_LEVEL_WARNING, info.level);
+    TEST_ASSERT_TRUE(info.timestamp >= startTime);
+    TEST_ASSERT_EQUAL_STRING("i=-5 u=7 s=text f=1.50 x=0a c=A l=-123456 ll=1234567890123 %\n", info.message);
+
+    lib60870_log_record(LIB60870_LOG_GENERAL, LIB60870_LOG_LEVEL_DEBUG, "w=%*d p=%.*s\n", 4, 12, 2, "abc");
+    TEST_ASSERT_EQUAL_INT(1, Lib60870_processLog(logHandler, &info));
+    TEST_ASSERT_EQUAL_STRING("w=  12 p=ab\n", info.message);
+
+    /* buffer is empty */
+    TEST_ASSERT_EQUAL_INT(0, Lib60870_processLog(logHandler, &info));
+
+    /* level filter of the DEBUG_PRINT macro */
+    Lib60870_setLogLevel(LIB60870_LOG_GENERAL, LIB60870_LOG_LEVEL_INFO);
+    DEBUG_PRINT("not recorded\n");
+    TEST_ASSERT_EQUAL_INT(0, Lib60870_processLog(logHandler, &info));
+
+    Lib60870_setLogLevel(LIB60870_LOG_GENERAL, LIB60870_LOG_LEVEL_DEBUG);
+    DEBUG_PRINT("recorded %i\n", 1);
+    TEST_ASSERT_EQUAL_INT(1, Lib60870_processLog(logHandler, &info));
+    TEST_ASSERT_EQUAL_STRING("recorded 1\n", info.message);
+
+    /* records are dropped when the buffer is full */
+    uint64_t droppedBefore = Lib60870_getDroppedLogRecords();
+
+    for (i = 0; i < CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE + 10; i++)
+        lib60870_log_record(LIB60870_LOG_GENERAL, LIB60870_LOG_LEVEL_DEBUG, "record %i\n", i);
+
+    TEST_ASSERT_EQUAL_UINT64(droppedBefore + 10, Lib60870_getDroppedLogRecords());
+
+    info.count = 0;
+    TEST_ASSERT_EQUAL_INT(CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE, Lib60870_processLog(logHandler, &info));
+    TEST_ASSERT_EQUAL_INT(CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE, info.count);
+
+    snprintf(text, sizeof(text), "record %i\n", CONFIG_DEBUG_OUTPUT_BINARY_LOG_SIZE - 1);
+    TEST_ASSERT_EQUAL_STRING(text, info.message);
+}
+#endif /* ((CONFIG_DEBUG_OUTPUT == 1) && (CONFIG_DEBUG_OUTPUT_BINARY_LOG == 1)) */
+
+void
+test_CS101_ASDU_addObjectOfWrongType(void)
+{
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    InformationObject io1 = (InformationObject) SinglePointInformation_create(NULL, 101, true, IEC60870_QUALITY_GOOD);
+
+    bool added = CS101_ASDU_addInformationObject(asdu, io1);
+
+    TEST_ASSERT_TRUE(added);
+
+    InformationObject_destroy(io1);
+
+    InformationObject io2 = (InformationObject) DoublePointInformation_create(NULL, 102, IEC60870_DOUBLE_POINT_OFF, IEC60870_QUALITY_GOOD);
+
+    added = CS101_ASDU_addInformationObject(asdu, io2);
+
+    TEST_ASSERT_FALSE(added);
+
+    InformationObject_destroy(io2);
+
+    CS101_ASDU_destroy(asdu);
+}
+
+void
+test_CS101_ASDU_addUntilOverflow(void)
+{
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    int i = 0;
+
+    for (i = 0; i < 60; i++) {
+        InformationObject io = (InformationObject) SinglePointInformation_create(NULL, 100 + i, true, IEC60870_QUALITY_GOOD);
+
+        bool added = CS101_ASDU_addInformationObject(asdu, io);
+
+        TEST_ASSERT_TRUE(added);
+
+        InformationObject_destroy(io);
+
+        TEST_ASSERT_EQUAL_INT(i + 1, CS101_ASDU_getNumberOfElements(asdu));
+    }
+
+    InformationObject io = (InformationObject) SinglePointInformation_create(NULL, 100 + i, true, IEC60870_QUALITY_GOOD);
+
+    bool added = CS101_ASDU_addInformationObject(asdu, io);
+
+    TEST_ASSERT_FALSE(added);
+
+    InformationObject_destroy(io);
+
+    CS101_ASDU_destroy(asdu);
+}
+
+void
+test_CS101_ASDU_clone(void)
+{
+    CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_PERIODIC, 0, 1, false, false);
+
+    int i = 0;
+
+    for (i = 0; i < 60; i++) {
+        InformationObject io = (InformationObject) SinglePointInformation_create(NULL, 100 + i, true, IEC60870_QUALITY_GOOD);
+
+        bool added = CS101_ASDU_addInformationObject(asdu, io);
+
+        TEST_ASSERT_TRUE(added);
+
+        InformationObject_destroy(io);
+
+        TEST_ASSERT_EQUAL_INT(i + 1, CS101_ASDU_getNumberOfElements(asdu));
+    }
+
+    CS101_ASDU clonedAsdu = CS101_ASDU_clone(asdu, NULL);
+
+    TEST_ASSERT_NOT_NULL(clonedAsdu);
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getCA(asdu), CS101_ASDU_getCA(clonedAsdu));
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getOA(asdu), CS101_ASDU_getOA(clonedAsdu));
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getCOT(asdu), CS101_ASDU_getCOT(clonedAsdu));
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getTypeID(asdu), CS101_ASDU_getTypeID(clonedAsdu));
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getNumberOfElements(asdu), CS101_ASDU_getNumberOfElements(clonedAsdu));
+    TEST_ASSERT_EQUAL_INT(CS101_ASDU_getPayloadSize(asdu), CS101_ASDU_getPayloadSize(clonedAsdu));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(CS101_ASDU_getPayload(asdu), CS101_ASDU_getPayload(clonedAsdu), CS101_ASDU_getPayloadSize(clonedAsdu)));
+
+    CS101_ASDU_destroy(asdu);
+    CS101_ASDU_destroy(clonedAsdu);
+}
+
+static void
+createAndDestroyASDUs(int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        CS101_ASDU asdu = CS101_ASDU_create(&defaultAppLayerParameters, false, CS101_COT_SPONTANEOUS, 0, 1, false, false);
+
+        InformationObject io = (InformationObject) MeasuredValueShort_create(NULL, 100 + i, 1.5f, IEC60870_QUALITY_GOOD);
+
+        CS101_ASDU_addInformationObject(asdu, io);
+
+        InformationObject_destroy(io);
+
+        CS101_ASDU clonedAsdu = CS101_ASDU_clone(asdu, NULL);
+
+        CS101_ASDU_destroy(asdu);
+        CS101_ASDU_destroy(clonedAsdu);
+    }
+}
+
+void
+test_MemoryPool(void)
+{
+    sMemoryPoolStatistics stats;
+    sMemoryAllocator poolAllocator;
+
+    MemoryPool pool = MemoryPool_create(16);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    MemoryPool_getAllocator(pool, &poolAllocator);
+
+    Memory_installAllocator(&poolAllocator);
+
+    createAndDestroyASDUs(10);
+
+    MemoryPool_getStatistics(pool, &stats);
+
+    TEST_ASSERT_EQUAL_UINT(0, stats.blocksInUse);
+    TEST_ASSERT_TRUE(stats.poolAllocations > 0);
+
+    size_t blocksAllocated = stats.blocksAllocated;
+
+    /* released blocks are reused */
+    createAndDestroyASDUs(1000);
+
+    MemoryPool_getStatistics(pool, &stats);
+
+    TEST_ASSERT_EQUAL_UINT(0, stats.blocksInUse);
+    TEST_ASSERT_EQUAL_UINT(blocksAllocated, stats.blocksAllocated);
+
+    /* realloc and large blocks */
+    uint8_t* buffer = (uint8_t*) GLOBAL_MALLOC(20);
+    TEST_ASSERT_NOT_NULL(buffer);
+    memset(buffer, 0xaa, 20);
+
+    buffer = (uint8_t*) GLOBAL_REALLOC(buffer, 2000);
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_EQUAL_UINT8(0xaa, buffer[19]);
+
+    MemoryPool_getStatistics(pool, &stats);
+    TEST_ASSERT_EQUAL_UINT(1, stats.largeAllocations);
+
+    GLOBAL_FREEMEM(buffer);
+
+    Memory_installAllocator(NULL);
+
+    MemoryPool_destroy(pool);
+}
+
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+void
+test_MemoryAccounting(void)
+{
+    sMemoryStatistics before;
+    sMemoryStatistics after;
+
+    TEST_ASSERT_TRUE(Memory_getStatistics(LIB60870_LOG_GENERAL, &before));
+    TEST_ASSERT_FALSE(Memory_getStatistics(MEMORY_ACCOUNTING_MAX_TAGS, &before));
+
+    createAndDestroyASDUs(10);
+
+    TEST_ASSERT_TRUE(Memory_getStatistics(LIB60870_LOG_GENERAL, &after));
+
+    TEST_ASSERT_TRUE(after.allocations >= before.allocations + 30);
+    TEST_ASSERT_EQUAL_UINT(after.allocations - before.allocations, after.frees - before.frees);
+    TEST_ASSERT_EQUAL_UINT(before.bytesInUse, after.bytesInUse);
+    TEST_ASSERT_TRUE(after.peakBytesInUse > 0);
+}
+#endif /* (CONFIG_MEMORY_ACCOUNTING == 1) */
+
+#if (CONFIG_CS104_SUPPORT_TLS == 1)
+
+struct secEventInfo {
+    int eventHandlerCalled;
+    int eventCodes[100];
+};
+
+static void
+securityEventHandler(void* parameter, TLSEventLevel eventLevel, int eventCode, const char* msg, TLSConnection con)
+{
+    struct secEventInfo* eventInfo = (struct secEventInfo*)parameter;
+
+    char peerAddrBuf[60];
+    char* peerAddr = NULL;
+    const char* tlsVersion = "unknown";
+
+    if (con) {
+        peerAddr = TLSConnection_getPeerAddress(con, peerAddrBuf);
+        tlsVersion = TLSConfigVersion_toString(TLSConnection_getTLSVersion(con));
+    }
+
+    printf("[SECURITY EVENT] %s (t: %i, c: %i, version: %s remote-ip: %s)\n", msg, eventLevel, eventCode, tlsVersion, peerAddr);
+
+    if (eventInfo) {
+        eventInfo->eventCodes[eventInfo->eventHandlerCalled] = eventCode;
+        eventInfo->eventHandlerCalled++;
+    }
+}
+
+void
+test_CS104_MasterSlave_TLSConnectSuccess(void)
+{
+    bool res = false;
+
+    TLSConfiguration tlsConfig1 = TLSConfiguration_create();
+
+    TLSConfiguration_setEventHandler(tlsConfig1, securityEventHandler, NULL);
+
+    TLSConfiguration_setChainValidation(tlsConfig1, true);
+
+    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig1, "server_CA1_1.key", NULL);
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig1, "server_CA1_1.pem");
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_addCACertificateFromFile(tlsConfig1, "root_CA1.pem");
+    TEST_ASSERT_TRUE(res);
+
+    TLSConfiguration tlsConfig2 = TLSConfiguration_create();
+
+    TLSConfiguration_setChainValidation(tlsConfig2, true);
+    TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig2, true);
+
+    /* use valid certificate */
+    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig2, "client_CA1_3.key", NULL);
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig2, "client_CA1_3.pem");
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_addCACertificateFromFile(tlsConfig2, "root_CA1.pem");
+    TEST_ASSERT_TRUE(res);
+
+    res = TLSConfiguration_addAllowedCertificateFromFile(tlsConfig2, "server_CA1_1.pem");
+    TEST_ASSERT_TRUE(res);
+
+    CS104_Slave slave = CS104_Slave_createSecure(100, 100, tlsConfig1);
+
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_createSecure("127.0.0.1", 20004, tlsConfig2);
+
+    TEST_ASSERT_NOT_NULL(con);
+
+    bool result = CS104_Connection_connect(con);
+
+    TEST_ASSERT_TRUE(result);
+
+    CS104_Slave_destroy(slave);
+
+    CS104_Connection_destroy(con);
+
+    TLSConfiguration_destroy(tlsConfig1);
+    TLSConfiguration_destroy(tlsConfig2);
+}
+
+void
+test_CS104_MasterSlave_TLSConnectSuccessWithoutSeparateCACert(void)
+{
+    bool res = false;
+
+    TLSConfiguration tlsConfig1 = TLSConfiguration_create();
+
+    TLSConfiguration_setEventHandler(tlsConfig1, securityEventHandler, NULL);
+
+    TLSConfiguration_setChainValidation(tlsConfig1, true);
+
+    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig1, "server_CA1_1.key", NULL);
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig1, "server_CA1_1_chain.pem");
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_addCACertificateFromFile(tlsConfig1, "server_CA1_1_chain.pem");
+    TEST_ASSERT_TRUE(res);
+
+    TLSConfiguration tlsConfig2 = TLSConfiguration_create();
+
+    TLSConfiguration_setChainValidation(tlsConfig2, true);
+    TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig2, true);
+
+    /* use expired certificate */
+    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig2, "client_CA1_3.key", NULL);
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig2, "client_CA1_3.pem");
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_addCACertificateFromFile(tlsConfig2, "root_CA1.pem");
+    TEST_ASSERT_TRUE(res);
+
+    res = TLSConfiguration_addAllowedCertificateFromFile(tlsConfig2, "server_CA1_1_chain.pem");
+    TEST_ASSERT_TRUE(res);
+
+    CS104_Slave slave = CS104_Slave_createSecure(100, 100, tlsConfig1);
+
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_createSecure("127.0.0.1", 20004, tlsConfig2);
+
+    TEST_ASSERT_NOT_NULL(con);
+
+    bool result = CS104_Connection_connect(con);
+
+    TEST_ASSERT_TRUE(result);
+
+    CS104_Slave_destroy(slave);
+
+    CS104_Connection_destroy(con);
+
+    TLSConfiguration_destroy(tlsConfig1);
+    TLSConfiguration_destroy(tlsConfig2);
+}
+
+void
+test_CS104_MasterSlave_TLSConnectFails(void)
+{
+    struct secEventInfo eventInfo;
+    memset(&eventInfo, 0, sizeof(struct secEventInfo));
+
+    bool res = false;
+
+    TLSConfiguration tlsConfig1 = TLSConfiguration_create();
+
+    TLSConfiguration_setEventHandler(tlsConfig1, securityEventHandler, &eventInfo);
+
+    TLSConfiguration_setChainValidation(tlsConfig1, true);
+
+    TLSConfiguration tlsConfig2 = TLSConfiguration_create();
+
+    TLSConfiguration_setChainValidation(tlsConfig2, true);
+    TLSConfiguration_setAllowOnlyKnownCertificates(tlsConfig2, true);
+
+    /* use valid certificate */
+    res = TLSConfiguration_setOwnKeyFromFile(tlsConfig2, "client_CA1_3.key", NULL);
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_setOwnCertificateFromFile(tlsConfig2, "client_CA1_3.pem");
+    TEST_ASSERT_TRUE(res);
+    res = TLSConfiguration_addCACertificateFromFile(tlsConfig2, "root_CA1.pem");
+    TEST_ASSERT_TRUE(res);
+
+    res = TLSConfiguration_addAllowedCertificateFromFile(tlsConfig2, "server_CA1_1.pem");
+    TEST_ASSERT_TRUE(res);
+
+    CS104_Slave slave = CS104_Slave_createSecure(100, 100, tlsConfig1);
+
+    TEST_ASSERT_NOT_NULL(slave);
+
+    CS104_Slave_setLocalPort(slave, 20004);
+
+    CS104_Slave_start(slave);
+
+    CS104_Connection con = CS104_Connection_createSecure("127.0.0.1", 20004, tlsConfig2);
+
+    TEST_ASSERT_NOT_NULL(con);
+
+    bool result = CS104_Connection_connect(con);
+
+    TEST_ASSERT_FALSE(result);
+
+    CS104_Slave_destroy(slave);
+
+    CS104_Connection_destroy(con);
 
     TLSConfiguration_destroy(tlsConfig1);
     TLSConfiguration_destroy(tlsConfig2);
@@ -6423,6 +9480,7 @@ main(int argc, char** argv)
     RUN_TEST(test_CP56Time2a);
     RUN_TEST(test_CP56Time2aToMsTimestamp);
     RUN_TEST(test_CP56Time2aConversionFunctions);
+    RUN_TEST(test_CP56Time2aBatchConversion);
     RUN_TEST(test_StepPositionInformation);
     RUN_TEST(test_addMaxNumberOfIOsToASDU);
     RUN_TEST(test_SingleEventType);
@@ -6508,6 +9566,39 @@ main(int argc, char** argv)
 
     RUN_TEST(test_CS104_Connection_async_success);
     RUN_TEST(test_CS104_Connection_async_timeout);
+    RUN_TEST(test_CS104_Connection_statistics);
+    RUN_TEST(test_CS104_ConnectionManager);
+    RUN_TEST(test_CS104_ConnectionManager_timeouts);
+    RUN_TEST(test_CS104_ConnectionManager_wakeup);
+    RUN_TEST(test_CS101_ASDU_initializeView);
+    RUN_TEST(test_CS101_ASDUIterator);
+    RUN_TEST(test_CS101_ASDU_decodeColumns);
+    RUN_TEST(test_CS101_ASDU_getValueAt);
+    RUN_TEST(test_CS101_ASDU_normalizedValueConversion);
+    RUN_TEST(test_CS101_ASDU_bulkEncoding);
+    RUN_TEST(test_CS104_Connection_asduQueue);
+    RUN_TEST(test_CS104_Connection_asduQueueLarge);
+    RUN_TEST(test_CS104_Connection_sendCommand);
+    RUN_TEST(test_CS104_Connection_sendQueue);
+    RUN_TEST(test_CS104_RedundantConnection_switchover);
+    RUN_TEST(test_CS104_RedundantConnection_startDTTimeout);
+    RUN_TEST(test_CS101_MirrorCache);
+    RUN_TEST(test_CS104_Connection_mirrorCache);
+    RUN_TEST(test_CS104_CaptureAndReplay);
+    RUN_TEST(test_CS104_CaptureReader_corruptFile);
+    RUN_TEST(test_CS104_Slave_socketPoller);
+    RUN_TEST(test_CS104_Connection_batchHandler);
+    RUN_TEST(test_CS104_UnixSocketConnection);
+    RUN_TEST(test_SerialTransceiverFT12_bufferedReceive);
+    RUN_TEST(test_CS104_LatencyHistogram);
+#if (CONFIG_CS104_SLAVE_LATENCY_STATISTICS == 1)
+    RUN_TEST(test_CS104_Slave_latencyStatistics);
+#endif
+
+    RUN_TEST(test_Lib60870_logLevels);
+#if ((CONFIG_DEBUG_OUTPUT == 1) && (CONFIG_DEBUG_OUTPUT_BINARY_LOG == 1))
+    RUN_TEST(test_Lib60870_binaryLog);
+#endif
 
     RUN_TEST(test_CS101_ASDU_addObjectOfWrongType);
     RUN_TEST(test_CS101_ASDU_addUntilOverflow);
@@ -6531,6 +9622,10 @@ main(int argc, char** argv)
 
     RUN_TEST(test_ASDUsetGetNumberOfElements);
     RUN_TEST(test_CS101_ASDU_clone);
+    RUN_TEST(test_MemoryPool);
+#if (CONFIG_MEMORY_ACCOUNTING == 1)
+    RUN_TEST(test_MemoryAccounting);
+#endif
 
     return UNITY_END();
 }